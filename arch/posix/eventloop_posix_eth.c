@@ -16,6 +16,7 @@
 #include <net/ethernet.h> /* ETH_P_*/
 #include <linux/if_packet.h>
 #include <linux/net_tstamp.h> /* txtime */
+#include <sys/mman.h> /* PACKET_MMAP rings */
 
 /* Configuration parameters */
 
@@ -26,7 +27,7 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
-#define ETH_PARAMETERSSIZE 15
+#define ETH_PARAMETERSSIZE 20
 #define ETH_PARAMINDEX_ADDR 0
 #define ETH_PARAMINDEX_LISTEN 1
 #define ETH_PARAMINDEX_IFACE 2
@@ -42,6 +43,11 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
 #define ETH_PARAMINDEX_TXTIME_PICO 12
 #define ETH_PARAMINDEX_TXTIME_DROP 13
 #define ETH_PARAMINDEX_VALIDATE 14
+#define ETH_PARAMINDEX_RING 15
+#define ETH_PARAMINDEX_RING_BLOCKSIZE 16
+#define ETH_PARAMINDEX_RING_BLOCKS 17
+#define ETH_PARAMINDEX_RING_FRAMESIZE 18
+#define ETH_PARAMINDEX_RING_TIMEOUT 19
 
 static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, false},
@@ -59,12 +65,26 @@ static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("txtime-pico")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
     {{0, UA_STRING_STATIC("txtime-drop-late")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
     {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring-blocksize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring-blocks")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring-framesize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring-timeout")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     /* Duplicated address parameter with a scalar value required. For the send-socket case. */
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], true, true, false},
 };
 
 #define UA_ETH_MAXHEADERLENGTH (2*ETHER_ADDR_LEN)+4+2+2
 
+/* Defaults for the optional PACKET_MMAP rings */
+#define UA_ETH_RING_BLOCKSIZE (1u << 16)
+#define UA_ETH_RING_BLOCKS 64
+#define UA_ETH_RING_FRAMESIZE 2048
+#define UA_ETH_RING_TIMEOUT 1 /* ms until a partially filled rx block is retired */
+
+/* Offset of the frame content in a TPACKET_V2 tx ring slot */
+#define UA_ETH_TXRING_DATAOFFSET TPACKET_ALIGN(sizeof(struct tpacket2_hdr))
+
 typedef struct {
     UA_RegisteredFD rfd;
 
@@ -84,6 +104,19 @@ typedef struct {
     unsigned char lengthOffset; /* No length field if zero */
 
     UA_Boolean txtimeEnabled;
+
+    /* Optional PACKET_MMAP ring shared with the kernel. Listen sockets use a
+     * TPACKET_V3 rx ring of blocks. Send sockets use a TPACKET_V2 tx ring of
+     * fixed-size frames. The ring is NULL if it is not enabled. */
+    UA_Byte *ring;
+    size_t ringSize;
+    size_t ringSlotSize;  /* Size of a block (rx) or frame (tx) */
+    size_t ringSlotCount;
+    size_t ringPos;       /* Next block (rx) to process or frame (tx) to
+                           * hand out */
+    size_t ringSlotsUsed; /* Tx frames handed out and not yet sent */
+    UA_Boolean ringTx;
+    UA_Boolean ringKick;  /* Tx frames are waiting for the kernel notification */
 } ETH_FD;
 
 /* The format of a Ethernet address is six groups of hexadecimal digits,
@@ -206,6 +239,64 @@ setETHHeader(unsigned char *buf,
     return (unsigned char)pos;
 }
 
+static UA_Boolean
+ETH_isRingBuffer(const ETH_FD *conn, const UA_ByteString *buf) {
+    return (conn->ring && buf->data >= conn->ring &&
+            buf->data < conn->ring + conn->ringSize);
+}
+
+/* Notify the kernel to send the frames of the tx ring that are marked for
+ * sending. Does not block. */
+static void
+ETH_kickRing(ETH_FD *conn) {
+    UA_sendto(conn->rfd.fd, NULL, 0, MSG_NOSIGNAL | MSG_DONTWAIT,
+              (struct sockaddr*)&conn->sll, sizeof(conn->sll));
+}
+
+/* Take the next frame of the tx ring. Returns the frame header or NULL if the
+ * ring is full. The frames are handed out in the ring order. */
+static struct tpacket2_hdr *
+ETH_acquireRingFrame(ETH_FD *conn) {
+    if(conn->ringSlotsUsed >= conn->ringSlotCount)
+        return NULL;
+    struct tpacket2_hdr *hdr = (struct tpacket2_hdr*)
+        &conn->ring[conn->ringPos * conn->ringSlotSize];
+    UA_UInt32 status = __atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE);
+    if(status != TP_STATUS_AVAILABLE && status != TP_STATUS_WRONG_FORMAT) {
+        /* The kernel might not have been notified for all frames yet */
+        ETH_kickRing(conn);
+        status = __atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE);
+        if(status != TP_STATUS_AVAILABLE && status != TP_STATUS_WRONG_FORMAT)
+            return NULL;
+    }
+    conn->ringPos = (conn->ringPos + 1) % conn->ringSlotCount;
+    conn->ringSlotsUsed++;
+    return hdr;
+}
+
+/* Hand a frame of the tx ring back to the kernel. Frames with zero length are
+ * malformed and skipped by the kernel (PACKET_LOSS is set). This is used to
+ * release frames that are not sent without blocking the frames behind. */
+static void
+ETH_submitRingFrame(ETH_FD *conn, struct tpacket2_hdr *hdr, size_t length) {
+    hdr->tp_len = (UA_UInt32)length;
+    __atomic_store_n(&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    UA_assert(conn->ringSlotsUsed > 0);
+    conn->ringSlotsUsed--;
+}
+
+/* Free a buffer that includes the Ethernet header */
+static void
+ETH_releaseBuffer(UA_ConnectionManager *cm, ETH_FD *conn, UA_ByteString *buf) {
+    if(ETH_isRingBuffer(conn, buf)) {
+        ETH_submitRingFrame(conn, (struct tpacket2_hdr*)
+                            (buf->data - UA_ETH_TXRING_DATAOFFSET), 0);
+        UA_ByteString_init(buf);
+        return;
+    }
+    UA_EventLoopPOSIX_freeNetworkBuffer(cm, (uintptr_t)conn->rfd.fd, buf);
+}
+
 static UA_StatusCode
 ETH_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
                        UA_ByteString *buf, size_t bufSize) {
@@ -216,6 +307,19 @@ ETH_allocNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     if(!erfd)
         return UA_STATUSCODE_BADCONNECTIONREJECTED;
 
+    /* Hand out the next frame of the tx ring directly (zero-copy). All frames
+     * of the socket are sent via the ring. */
+    if(erfd->ringTx) {
+        if(bufSize + erfd->headerSize > erfd->ringSlotSize - UA_ETH_TXRING_DATAOFFSET)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        struct tpacket2_hdr *hdr = ETH_acquireRingFrame(erfd);
+        if(!hdr)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        buf->data = (UA_Byte*)hdr + UA_ETH_TXRING_DATAOFFSET + erfd->headerSize;
+        buf->length = bufSize;
+        return UA_STATUSCODE_GOOD;
+    }
+
     /* Allocate the buffer with the hidden Ethernet header in front */
     UA_StatusCode res =
         UA_EventLoopPOSIX_allocNetworkBuffer(cm, connectionId, buf,
@@ -240,7 +344,7 @@ ETH_freeNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     /* Unhide the Ethernet header and free */
     buf->data   -= erfd->headerSize;
     buf->length += erfd->headerSize;
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    ETH_releaseBuffer(cm, erfd, buf);
 }
 
 /* Test if the ConnectionManager can be stopped */
@@ -282,6 +386,15 @@ ETH_close(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
                         UA_CONNECTIONSTATE_CLOSING,
                         &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
 
+    /* Release the PACKET_MMAP ring. Hand pending frames to the kernel first.
+     * This uses the socket and must be done before it is closed. */
+    if(conn->ringKick)
+        ETH_kickRing(conn);
+    if(conn->ring) {
+        munmap(conn->ring, conn->ringSize);
+        conn->ring = NULL;
+    }
+
     /* Close the socket */
     UA_RESET_ERRNO;
     int ret = UA_close(conn->rfd.fd);
@@ -317,6 +430,88 @@ ETH_delayedClose(void *application, void *context) {
     UA_free(conn);
 }
 
+/* Forward a received frame (including the Ethernet header) to the application */
+static void
+ETH_processFrame(UA_ConnectionManager *cm, ETH_FD *conn, UA_ByteString response) {
+    /* Parse the Ethernet header */
+    unsigned char destAddr[ETHER_ADDR_LEN];
+    unsigned char sourceAddr[ETHER_ADDR_LEN];
+    UA_UInt16 etherType = 0;
+    UA_UInt16 vid = 0;
+    UA_Byte pcp = 0;
+    UA_Boolean dei = 0;
+    size_t headerSize = parseETHHeader(&response, destAddr, sourceAddr,
+                                       &etherType, &vid, &pcp, &dei);
+    if(headerSize == 0)
+        return;
+
+    /* Set up the parameter arguments passed to the application */
+    unsigned char destAddrBytes[18];
+    unsigned char sourceAddrBytes[18];
+    setAddrString(destAddrBytes, destAddr);
+    setAddrString(sourceAddrBytes, sourceAddr);
+    UA_String destAddrStr = {17, destAddrBytes};
+    UA_String sourceAddrStr = {17, sourceAddrBytes};
+
+    size_t paramsSize = 2;
+    UA_KeyValuePair params[6];
+    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
+    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
+    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+
+    if(etherType > 0) {
+        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+        UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+        paramsSize++;
+    }
+
+    if(vid > 0) {
+        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
+        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
+        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
+        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
+        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
+        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        paramsSize += 3;
+    }
+
+    /* Callback to the application layer with the Ethernet header hidden */
+    UA_KeyValueMap map = {paramsSize, params};
+    response.data += headerSize;
+    response.length -= headerSize;
+    conn->applicationCB(cm, (uintptr_t)conn->rfd.fd, conn->application,
+                        &conn->context, UA_CONNECTIONSTATE_ESTABLISHED,
+                        &map, response);
+}
+
+/* Process all blocks of the rx ring that were retired by the kernel. The
+ * blocks are handed back to the kernel after their frames were processed. */
+static void
+ETH_processRing(UA_ConnectionManager *cm, ETH_FD *conn) {
+    for(size_t i = 0; i < conn->ringSlotCount; i++) {
+        struct tpacket_block_desc *bd = (struct tpacket_block_desc*)
+            &conn->ring[conn->ringPos * conn->ringSlotSize];
+        UA_UInt32 status =
+            __atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+        if(!(status & TP_STATUS_USER))
+            return;
+
+        UA_UInt32 numPkts = bd->hdr.bh1.num_pkts;
+        UA_Byte *pkt = (UA_Byte*)bd + bd->hdr.bh1.offset_to_first_pkt;
+        for(UA_UInt32 j = 0; j < numPkts; j++) {
+            struct tpacket3_hdr *ph = (struct tpacket3_hdr*)pkt;
+            UA_ByteString frame = {ph->tp_snaplen, pkt + ph->tp_mac};
+            ETH_processFrame(cm, conn, frame);
+            pkt += ph->tp_next_offset;
+        }
+
+        __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+                         __ATOMIC_RELEASE);
+        conn->ringPos = (conn->ringPos + 1) % conn->ringSlotCount;
+    }
+}
+
 /* Gets called when a socket receives data or closes */
 static void
 ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
@@ -336,6 +531,35 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
         return;
     }
 
+    /* Notify the kernel once for all tx ring frames that were submitted since
+     * the last iteration of the EventLoop */
+    if(event == UA_FDEVENT_OUT) {
+        UA_RESET_ERRNO;
+        ETH_kickRing(conn);
+        if(UA_ERRNO == UA_INTERRUPTED || UA_ERRNO == UA_WOULDBLOCK ||
+           UA_ERRNO == UA_AGAIN || UA_ERRNO == ENOBUFS)
+            return; /* Retry in the next iteration */
+        if(UA_ERRNO != 0) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "ETH %u\t| Send failed with error %s",
+                            (unsigned)rfd->fd, errno_str));
+            ETH_close(pcm, conn);
+            UA_free(rfd);
+            return;
+        }
+        conn->ringKick = false;
+        conn->rfd.listenEvents &= ~UA_FDEVENT_OUT;
+        UA_EventLoopPOSIX_modifyFD(el, rfd);
+        return;
+    }
+
+    /* Read the frames directly from the rx ring */
+    if(conn->ring) {
+        ETH_processRing(cm, conn);
+        return;
+    }
+
     /* Use the already allocated receive-buffer */
     UA_ByteString response = pcm->rxBuffer;
 
@@ -371,58 +595,7 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
                  (unsigned)rfd->fd, (unsigned)ret);
 
     response.length = (size_t)ret;
-
-    /* Parse the Ethernet header */
-    unsigned char destAddr[ETHER_ADDR_LEN];
-    unsigned char sourceAddr[ETHER_ADDR_LEN];
-    UA_UInt16 etherType = 0;
-    UA_UInt16 vid = 0;
-    UA_Byte pcp = 0;
-    UA_Boolean dei = 0;
-    size_t headerSize = parseETHHeader(&response, destAddr, sourceAddr,
-                                       &etherType, &vid, &pcp, &dei);
-    if(headerSize == 0)
-        return;
-
-    /* Set up the parameter arguments passed to the application */
-    unsigned char destAddrBytes[18];
-    unsigned char sourceAddrBytes[18];
-    setAddrString(destAddrBytes, destAddr);
-    setAddrString(sourceAddrBytes, sourceAddr);
-    UA_String destAddrStr = {17, destAddrBytes};
-    UA_String sourceAddrStr = {17, sourceAddrBytes};
-
-    size_t paramsSize = 2;
-    UA_KeyValuePair params[6];
-    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
-    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
-    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-
-    if(etherType > 0) {
-        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
-        UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
-        paramsSize++;
-    }
-
-    if(vid > 0) {
-        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
-        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
-        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
-        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
-        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
-        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
-        paramsSize += 3;
-    }
-
-    /* Callback to the application layer with the Ethernet header hidden */
-    UA_KeyValueMap map = {paramsSize, params};
-    response.data += headerSize;
-    response.length -= headerSize;
-    conn->applicationCB(cm, (uintptr_t)rfd->fd, conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED, &map, response);
-    response.data -= headerSize;
-    response.length += headerSize;
+    ETH_processFrame(cm, conn, response);
 }
 
 static UA_StatusCode
@@ -621,6 +794,134 @@ ETH_openSendConnection(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap
     return UA_STATUSCODE_GOOD;
 }
 
+/* Set up the optional PACKET_MMAP ring. Listen sockets get a TPACKET_V3 rx
+ * ring. Frames are collected in blocks and the blocks are handed over to
+ * userspace when they are full or after the retire timeout. Send sockets get a
+ * TPACKET_V2 tx ring. allocNetworkBuffer hands out the ring frames directly and
+ * the kernel is notified once the frame is ready for sending. */
+static UA_StatusCode
+ETH_setupRing(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap *params,
+              UA_Boolean listen) {
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    UA_UInt32 blockSize = UA_ETH_RING_BLOCKSIZE;
+    const UA_UInt32 *blockSizep = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_BLOCKSIZE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(blockSizep)
+        blockSize = *blockSizep;
+
+    UA_UInt32 blocks = UA_ETH_RING_BLOCKS;
+    const UA_UInt32 *blocksp = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_BLOCKS].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(blocksp)
+        blocks = *blocksp;
+
+    UA_UInt32 frameSize = UA_ETH_RING_FRAMESIZE;
+    const UA_UInt32 *frameSizep = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_FRAMESIZE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(frameSizep)
+        frameSize = *frameSizep;
+
+    UA_UInt32 timeout = UA_ETH_RING_TIMEOUT;
+    const UA_UInt32 *timeoutp = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_RING_TIMEOUT].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(timeoutp)
+        timeout = *timeoutp;
+
+    /* The kernel checks the page alignment of the blocks. The frames must
+     * divide the blocks for the tx ring frames to be contiguous. */
+    if(blocks == 0 || frameSize == 0 || frameSize % TPACKET_ALIGNMENT != 0 ||
+       blockSize < frameSize || blockSize % frameSize != 0) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "ETH %u\t| Invalid packet ring dimensions",
+                     (unsigned)conn->rfd.fd);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    UA_UInt32 frames = (blockSize / frameSize) * blocks;
+
+    /* Set the TPACKET version */
+    UA_RESET_ERRNO;
+    int version = (listen) ? TPACKET_V3 : TPACKET_V2;
+    int ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_VERSION,
+                            &version, sizeof(version));
+    if(ret < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not set the TPACKET version (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Create the ring */
+    if(listen) {
+        struct tpacket_req3 req;
+        memset(&req, 0, sizeof(struct tpacket_req3));
+        req.tp_block_size = blockSize;
+        req.tp_block_nr = blocks;
+        req.tp_frame_size = frameSize;
+        req.tp_frame_nr = frames;
+        req.tp_retire_blk_tov = timeout;
+        ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_RX_RING,
+                            &req, sizeof(req));
+        conn->ringSlotSize = blockSize;
+        conn->ringSlotCount = blocks;
+    } else {
+        /* Skip malformed frames instead of halting the tx ring */
+        int loss = 1;
+        ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_LOSS,
+                            &loss, sizeof(loss));
+        if(ret == 0) {
+            struct tpacket_req req;
+            memset(&req, 0, sizeof(struct tpacket_req));
+            req.tp_block_size = blockSize;
+            req.tp_block_nr = blocks;
+            req.tp_frame_size = frameSize;
+            req.tp_frame_nr = frames;
+            ret = UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_TX_RING,
+                                &req, sizeof(req));
+        }
+        conn->ringSlotSize = frameSize;
+        conn->ringSlotCount = frames;
+        conn->ringTx = true;
+    }
+    if(ret < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not create the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Map the ring into the process memory */
+    size_t ringSize = (size_t)blockSize * blocks;
+    void *ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, conn->rfd.fd, 0);
+    if(ring == MAP_FAILED) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Could not map the packet ring (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    conn->ring = (UA_Byte*)ring;
+    conn->ringSize = ringSize;
+    conn->ringPos = 0;
+
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                "ETH %u\t| Using a %s packet ring with %u slots of %u bytes",
+                (unsigned)conn->rfd.fd, (listen) ? "rx" : "tx",
+                (unsigned)conn->ringSlotCount, (unsigned)conn->ringSlotSize);
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
                    void *application, void *context,
@@ -744,6 +1045,13 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
         res = ETH_openListenConnection(el, conn, params, ifindex, etherType, validate);
     }
 
+    /* Set up the optional PACKET_MMAP ring */
+    const UA_Boolean *ring = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params, ethConnectionParams[ETH_PARAMINDEX_RING].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(!validate && res == UA_STATUSCODE_GOOD && ring && *ring)
+        res = ETH_setupRing(el, conn, params, (listen && *listen));
+
     /* Don't actually open or shut down */
     if(validate || res != UA_STATUSCODE_GOOD)
         goto cleanup;
@@ -765,6 +1073,8 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     return UA_STATUSCODE_GOOD;
 
  cleanup:
+    if(conn && conn->ring)
+        munmap(conn->ring, conn->ringSize);
     UA_close(sockfd);
     UA_free(conn);
     UA_UNLOCK(&el->elMutex);
@@ -888,6 +1198,94 @@ send_txtime(UA_EventLoopPOSIX *el, ETH_FD *conn, const UA_KeyValueMap *params,
 }
 #endif
 
+/* Submit the tx ring frame and notify the kernel. The kernel sends all frames
+ * in the ring that are marked for sending. A buffer that is not a ring frame
+ * is copied into the next frame first. With a txtime the notification is sent
+ * with sendmsg and the txtime applies to all frames sent by the kernel for
+ * that notification. */
+static UA_StatusCode
+ETH_sendRing(UA_POSIXConnectionManager *pcm, ETH_FD *conn,
+             const UA_KeyValueMap *params, const UA_DateTime *txtime,
+             UA_ByteString *buf) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    /* Get the ring frame */
+    size_t length = buf->length;
+    struct tpacket2_hdr *hdr;
+    if(ETH_isRingBuffer(conn, buf)) {
+        hdr = (struct tpacket2_hdr*)(buf->data - UA_ETH_TXRING_DATAOFFSET);
+    } else {
+        hdr = NULL;
+        if(length <= conn->ringSlotSize - UA_ETH_TXRING_DATAOFFSET)
+            hdr = ETH_acquireRingFrame(conn);
+        if(!hdr) {
+            UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                         "ETH %u\t| No tx ring frame available for sending",
+                         (unsigned)conn->rfd.fd);
+            UA_EventLoopPOSIX_freeNetworkBuffer(&pcm->cm, (uintptr_t)conn->rfd.fd, buf);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        memcpy((UA_Byte*)hdr + UA_ETH_TXRING_DATAOFFSET, buf->data, length);
+        UA_EventLoopPOSIX_freeNetworkBuffer(&pcm->cm, (uintptr_t)conn->rfd.fd, buf);
+    }
+
+    /* Mark the frame for sending */
+    ETH_submitRingFrame(conn, hdr, length);
+    UA_ByteString_init(buf);
+
+    /* Without a txtime the kernel is notified once for all frames submitted in
+     * the current iteration of the EventLoop. The notification is sent when
+     * the socket signals that it is writable. */
+    if(!txtime) {
+        if(!conn->ringKick) {
+            conn->ringKick = true;
+            conn->rfd.listenEvents |= UA_FDEVENT_OUT;
+            UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+        }
+        return UA_STATUSCODE_GOOD;
+    }
+
+#ifdef SO_TXTIME
+    struct pollfd tmp_poll_fd;
+    tmp_poll_fd.fd = conn->rfd.fd;
+    tmp_poll_fd.events = UA_POLLOUT;
+
+    /* Notify the kernel. Retry until the frames could be handed over. */
+    ssize_t n;
+    do {
+        UA_RESET_ERRNO;
+        n = send_txtime(el, conn, params, *txtime, NULL, 0);
+        if(n >= 0)
+            break;
+
+        /* An error we cannot recover from? */
+        if(UA_ERRNO != UA_INTERRUPTED && UA_ERRNO != UA_WOULDBLOCK &&
+           UA_ERRNO != UA_AGAIN && UA_ERRNO != ENOBUFS) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "ETH %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            ETH_shutdown(pcm, conn);
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+
+        /* Wait for the socket resources to become available */
+        UA_RESET_ERRNO;
+        if(UA_poll(&tmp_poll_fd, 1, 100) < 0 && UA_ERRNO != UA_INTERRUPTED) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "ETH %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            ETH_shutdown(pcm, conn);
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+    } while(true);
+#endif
+
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
@@ -923,10 +1321,17 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                      "ETH %u\t| txtime was not configured for the connection",
                      (unsigned)connectionId);
         UA_UNLOCK(&el->elMutex);
-        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        ETH_releaseBuffer(cm, conn, buf);
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* Send via the tx ring */
+    if(conn->ringTx) {
+        UA_StatusCode res = ETH_sendRing(pcm, conn, params, txtime, buf);
+        UA_UNLOCK(&el->elMutex);
+        return res;
+    }
+
     /* Prevent OS signals when sending to a closed socket */
     int flags = MSG_NOSIGNAL;
 
@@ -965,7 +1370,7 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                                     (unsigned)connectionId, errno_str));
                     ETH_shutdown(pcm, conn);
                     UA_UNLOCK(&el->elMutex);
-                    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+                    ETH_releaseBuffer(cm, conn, buf);
                     return UA_STATUSCODE_BADCONNECTIONCLOSED;
                 }
 
@@ -982,7 +1387,7 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                                         (unsigned)connectionId, errno_str));
                         ETH_shutdown(pcm, conn);
                         UA_UNLOCK(&el->elMutex);
-                        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+                        ETH_releaseBuffer(cm, conn, buf);
                         return UA_STATUSCODE_BADCONNECTIONCLOSED;
                     }
                 } while(poll_ret <= 0);
@@ -993,7 +1398,7 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
 
     /* Free the buffer */
     UA_UNLOCK(&el->elMutex);
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    ETH_releaseBuffer(cm, conn, buf);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -73,6 +73,9 @@ typedef struct {
     unsigned int max_tokens;
 
     bool stop_early;
+    cj5_token *(*grow_tokens)(void *context, cj5_token *tokens,
+                              unsigned int *max_tokens);
+    void *grow_context;
 } cj5__parser;
 
 static CJ5_INLINE bool
@@ -87,6 +90,20 @@ cj5__isrange(char ch, char from, char to) {
 static cj5_token *
 cj5__alloc_token(cj5__parser *parser) {
     cj5_token* token = NULL;
+
+    // Try to grow the token array. Only once the array is full for the first
+    // time. After an overflow the tokens are only counted.
+    if(parser->token_count == parser->max_tokens &&
+       parser->error != CJ5_ERROR_OVERFLOW && parser->grow_tokens) {
+        unsigned int max_tokens = parser->max_tokens;
+        cj5_token *tokens =
+            parser->grow_tokens(parser->grow_context, parser->tokens, &max_tokens);
+        if(tokens && max_tokens > parser->max_tokens) {
+            parser->tokens = tokens;
+            parser->max_tokens = max_tokens;
+        }
+    }
+
     if(parser->token_count < parser->max_tokens) {
         token = &parser->tokens[parser->token_count];
         memset(token, 0x0, sizeof(cj5_token));
@@ -312,8 +329,11 @@ cj5_parse(const char *json5, unsigned int len,
     parser.tokens = tokens;
     parser.max_tokens = max_tokens;
 
-    if(options)
+    if(options) {
         parser.stop_early = options->stop_early;
+        parser.grow_tokens = options->grow_tokens;
+        parser.grow_context = options->grow_context;
+    }
 
     unsigned short depth = 0; // Nesting depth zero means "outside the root object"
     char nesting[CJ5_MAX_NESTING]; // Contains either '\0', '{' or '[' for the
@@ -404,7 +424,7 @@ cj5_parse(const char *json5, unsigned int len,
                 // token).
                 if(parser.curr_tok_idx != token->parent_id) {
                     parser.curr_tok_idx = token->parent_id;
-                    token = &tokens[token->parent_id];
+                    token = &parser.tokens[token->parent_id];
                     token->size++;
                 }
             }
@@ -441,6 +461,8 @@ cj5_parse(const char *json5, unsigned int len,
         default: // Value or key
             if(next[depth] == 'v') {
                 cj5__parse_primitive(&parser); // Parse primitive value
+                if(token) // The token array might have grown
+                    token = &parser.tokens[parser.curr_tok_idx];
                 if(nesting[depth] != 0) {
                     // Parent is object or array
                     if(token)
@@ -458,8 +480,10 @@ cj5_parse(const char *json5, unsigned int len,
                 }
             } else if(next[depth] == 'k') {
                 cj5__parse_key(&parser);
-                if(token)
+                if(token) {
+                    token = &parser.tokens[parser.curr_tok_idx];
                     token->size++; // Keys count towards the length
+                }
                 next[depth] = ':';
             } else {
                 parser.error = CJ5_ERROR_INVALID;
@@ -483,7 +507,7 @@ cj5_parse(const char *json5, unsigned int len,
         // Check the we end after a complete key-value pair (or dangling comma)
         if(next[0] != 'k' && next[0] != ',')
             parser.error = CJ5_ERROR_INVALID;
-        tokens[0].end = parser.pos - 1;
+        parser.tokens[0].end = parser.pos - 1;
     }
 
  finish:
@@ -522,7 +546,7 @@ cj5_parse(const char *json5, unsigned int len,
 
     // Set the tokens and original string only if successfully parsed
     if(r.error == CJ5_ERROR_NONE) {
-        r.tokens = tokens;
+        r.tokens = parser.tokens;
         r.json5 = json5;
     }
 
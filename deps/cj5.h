@@ -63,6 +63,7 @@
 //  if(r.error != CJ5_ERROR_NONE) {
 //      if(r.error == CJ5_ERROR_OVERFLOW) {
 //          // you can use r.num_tokens to determine the actual token count and reparse
+//          // (or set the grow_tokens option to extend the tokens during parsing)
 //          printf("Error: line: %d, col: %d\n", r.error_line, r.error_code);    
 //      }
 //  }
@@ -121,6 +122,15 @@ typedef struct cj5_options {
     bool stop_early; /* Return when the first element was parsed. Otherwise an
                       * error is returned if the input was not fully
                       * processed. (default: false) */
+
+    /* Grow the token array when it is full instead of returning
+     * CJ5_ERROR_OVERFLOW. The callback returns a token array with the content
+     * of the old array and sets the increased max_tokens. Returning NULL makes
+     * the parser continue with the overflow behavior. The final token array is
+     * returned in cj5_result.tokens. (default: NULL) */
+    cj5_token *(*grow_tokens)(void *context, cj5_token *tokens,
+                              unsigned int *max_tokens);
+    void *grow_context;
 } cj5_options;
 
 /* Options can be NULL */
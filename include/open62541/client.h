@@ -681,6 +681,16 @@ struct UA_ClientConfig {
     UA_UInt32 connectivityCheckInterval;     /* Connectivity check interval in ms.
                                               * 0 = background task disabled */
 
+    /* Split Read, Write, Call and Browse requests that exceed the
+     * OperationLimits of the server or the maximum message size of the
+     * SecureChannel into several requests. This applies to the synchronous
+     * ``UA_Client_Service_*`` calls for these services. The OperationLimits are
+     * read from the server once per Session. Up to splitRequestsWindow partial
+     * requests are in flight at the same time (0 -> 1). The results are
+     * reassembled in the original order. */
+    UA_Boolean splitRequests;
+    UA_UInt16 splitRequestsWindow;
+
     /* Application Notification
      * ~~~~~~~~~~~~~~~~~~~~~~~~
      * The notification callbacks can be NULL. The global callback receives all
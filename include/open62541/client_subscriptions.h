@@ -133,6 +133,23 @@ UA_Client_Subscriptions_setContext(UA_Client *client,
                                    UA_UInt32 subscriptionId,
                                    void *subContext);
 
+/* Callback for all DataChange notifications of a NotificationMessage. The
+ * notifications point directly into the decoded PublishResponse and are only
+ * valid during the callback. monContexts[i] is the context of the
+ * MonitoredItem with notifications[i].clientHandle (NULL if the MonitoredItem
+ * is unknown to the client). */
+typedef void (*UA_Client_DataChangeBatchCallback)
+    (UA_Client *client, UA_UInt32 subId, void *subContext,
+     size_t notificationsSize, UA_MonitoredItemNotification *notifications,
+     void * const *monContexts);
+
+/* Deliver the DataChange notifications of the subscription in batches. If set,
+ * the DataChange callbacks of the individual MonitoredItems are no longer
+ * called. Set the callback to NULL to go back to the per-item callbacks. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Client_Subscriptions_setDataChangeBatchCallback(UA_Client *client,
+    UA_UInt32 subscriptionId, UA_Client_DataChangeBatchCallback callback);
+
 UA_SetPublishingModeResponse UA_EXPORT UA_THREADSAFE
 UA_Client_Subscriptions_setPublishingMode(UA_Client *client,
     const UA_SetPublishingModeRequest request);
@@ -679,6 +679,32 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
  *    creating any connection but solely validating the provided parameters
  *    (default: false)
  *
+ * On Linux the frames can be exchanged with the kernel via a memory-mapped
+ * PACKET_MMAP ring instead of a system call for every frame. A listening
+ * connection then receives all frames of a ring block in one iteration of the
+ * EventLoop. A send connection hands out the ring frames in
+ * `allocNetworkBuffer` (zero-copy). All frames sent within one iteration of
+ * the EventLoop are handed to the kernel at once. Messages must fit into the
+ * ring frames (with the Ethernet header).
+ *
+ * 0:packet-ring [bool]
+ *    Use a PACKET_MMAP ring for the connection (default: false).
+ *
+ * 0:packet-ring-blocksize [uint32]
+ *    Size of the ring blocks. Must be a multiple of the page size and of the
+ *    frame size (default: 64kB).
+ *
+ * 0:packet-ring-blocks [uint32]
+ *    Number of the ring blocks (default: 64).
+ *
+ * 0:packet-ring-framesize [uint32]
+ *    Size of the ring frames including the frame header of the kernel
+ *    (default: 2048).
+ *
+ * 0:packet-ring-timeout [uint32]
+ *    Timeout in milliseconds after which a partially filled ring block is
+ *    handed over for receiving (default: 1).
+ *
  * Sending with a txtime (for Time-Sensitive Networking) is possible on recent
  * Linux kernels, If enabled for the socket, then a txtime parameters can be
  * passed to `sendWithConnection`. Note that the clock source for txtime sending
@@ -694,6 +720,9 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
  *
  * **Send Parameters (only with txtime enabled for the connection)**
  *
+ * With a packet ring the txtime applies to all frames that are pending in the
+ * ring when the message is sent.
+ *
  * 0:txtime [datetime]
  *    Time when the message is sent out (Datetime has 100ns precision) for the
  *    "monotonic" clock source of the EventLoop.
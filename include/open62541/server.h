@@ -915,6 +915,17 @@ UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_setVariableNode_callbackValueSource(UA_Server *server,
     const UA_NodeId nodeId, const UA_CallbackValueSource evs);
 
+/* Cache the result of the read callback for up to maxAge milliseconds. Reads
+ * within that time are served from the cache without calling the callback.
+ * The maxAge of a Read request further limits the age of the cached value. A
+ * Read with maxAge zero always calls the callback. Reads with an IndexRange
+ * are served from a cached value but do not fill the cache. The cached value
+ * is dropped when the value is written or the value source is replaced. A
+ * maxAge <= 0 disables the cache (default). */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_setVariableNode_valueCache(UA_Server *server, const UA_NodeId nodeId,
+                                     UA_Double maxAge);
+
 /* Deprecated API */
 typedef UA_CallbackValueSource UA_DataSource;
 #define UA_Server_setVariableNode_dataSource(server, nodeId, dataSource) \
@@ -1872,6 +1883,22 @@ UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_getNamespaceByIndex(UA_Server *server, const size_t namespaceIndex,
                               UA_String *foundUri);
 
+/* Serialize the nodestore (all nodes with their attributes and references,
+ * the ReferenceType hierarchy and the namespace array) into a versioned binary
+ * image. Set the image as ``nodestoreImage`` in the configuration of a new
+ * server to skip the creation of the information model node by node.
+ *
+ * The image does not contain callbacks, node contexts, type lifecycles and
+ * values from data sources. The standard callbacks of namespace zero are set
+ * up again when the image is loaded. Callbacks of the application and the
+ * custom datatypes of companion nodesets need to be registered as usual. Take
+ * the image before Sessions are created, so that it does not contain their
+ * diagnostics objects.
+ *
+ * The image is allocated and has to be freed by the caller. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_saveNodestoreImage(UA_Server *server, UA_ByteString *image);
+
 /**
  * Some convenience functions are provided to simplify the interaction with
  * objects. */
@@ -2076,6 +2103,13 @@ struct UA_ServerConfig {
     UA_Nodestore *nodestore;
     UA_GlobalNodeLifecycle *nodeLifecycle;
 
+    /* Binary image of the nodestore created with UA_Server_saveNodestoreImage.
+     * If set, UA_Server_new loads the nodes from the image instead of creating
+     * namespace zero (and the nodesets of the nodeset injector) node by node.
+     * The image is not copied and must remain valid until UA_Server_new
+     * returns. Afterwards the field is reset. */
+    UA_ByteString nodestoreImage;
+
     /* Copy the HasModellingRule reference in instances from the type
      * definition in UA_Server_addObjectNode and UA_Server_addVariableNode.
      *
@@ -2085,6 +2119,15 @@ struct UA_ServerConfig {
      * ModellingRule of their InstanceDeclaration */
     UA_Boolean modellingRulesOnInstances;
 
+#ifdef UA_ENABLE_DIAGNOSTICS
+    /* Create the diagnostics objects of Sessions and Subscriptions (below
+     * Server/ServerDiagnostics/SessionsDiagnosticsSummary) only when the
+     * diagnostics branch is browsed or a Session object is accessed via its
+     * SessionId. This saves instantiating the objects for short-lived Sessions
+     * that are never inspected. */
+    UA_Boolean lazyDiagnostics;
+#endif
+
     /* Limits
      * ~~~~~~ */
     /* Limits for SecureChannels */
@@ -2108,6 +2151,17 @@ struct UA_ServerConfig {
     /* Limits for Requests */
     UA_UInt32 maxReferencesPerNode;
 
+    /* Number of cached TranslateBrowsePathsToNodeIds results (0 => disabled).
+     * The cache is invalidated when nodes or references are added or
+     * removed. */
+    UA_UInt32 translateBrowsePathCacheSize;
+
+    /* Number of cached method calls (0 => disabled). A cache entry holds the
+     * validated relation between the object and the method and the argument
+     * definitions of the method. The cache is invalidated when nodes or
+     * references are added, changed or removed. */
+    UA_UInt32 methodCallCacheSize;
+
 #ifdef UA_ENABLE_ENCRYPTION
     /* Limits for TrustList */
     UA_UInt32 maxTrustListSize; /* in bytes, 0 => unlimited */
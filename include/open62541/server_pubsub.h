@@ -279,6 +279,20 @@ typedef struct {
 
     UA_Boolean enableDeltaFrames;
 
+    /* DataSetReaders resolve their target variables once and write the
+     * received fields directly into the resolved nodes. This requires a
+     * nodestore where nodes are edited in-place (such as the default
+     * nodestore). If disabled, every field is written via the Write
+     * service. */
+    UA_Boolean enableDirectTargetWrites;
+
+    /* DataSetWriters sample the values of variables with an internal value
+     * source without copying them. The values are borrowed from the nodes
+     * until the DataSetMessage is encoded. Only enable if no onRead callback
+     * (or value source) of a published variable writes to other published
+     * variables during sampling. */
+    UA_Boolean enableZeroCopySampling;
+
 #ifdef UA_ENABLE_PUBSUB_INFORMATIONMODEL
     UA_Boolean enableInformationModelMethods;
 #endif
@@ -425,6 +439,11 @@ typedef struct {
     UA_PublishedVariableDataType *variablesToAdd;
 } UA_PublishedDataItemsTemplateConfig;
 
+/* PublishedEvents are emitted for every event of the EventNotifier node (or
+ * one of its children in the notifier hierarchy) that matches the filter. The
+ * DataSetFields of type UA_PUBSUB_DATASETFIELD_EVENT define the selected event
+ * fields. The events are queued in the DataSetWriters and sent as event
+ * DataSetMessages with the next publish interval. */
 typedef struct {
     UA_NodeId eventNotfier;
     UA_ContentFilter filter;
@@ -506,6 +525,17 @@ typedef struct {
     UA_Guid dataSetFieldId;
 } UA_DataSetVariableConfig;
 
+/* Event fields are selected from the events of a PublishedEvents DataSet. The
+ * selectedField has the same meaning as a SelectClause of an EventFilter. */
+typedef struct {
+    UA_String fieldNameAlias;
+    UA_SimpleAttributeOperand selectedField;
+    UA_LocalizedText description;
+    /* If dataSetFieldId is not set, the GUID will be generated on adding the
+     * field */
+    UA_Guid dataSetFieldId;
+} UA_DataSetEventConfig;
+
 typedef enum {
     UA_PUBSUB_DATASETFIELD_VARIABLE,
     UA_PUBSUB_DATASETFIELD_EVENT
@@ -514,8 +544,8 @@ typedef enum {
 typedef struct {
     UA_DataSetFieldType dataSetFieldType;
     union {
-        /* events need other config later */
         UA_DataSetVariableConfig variable;
+        UA_DataSetEventConfig event;
     } field;
 } UA_DataSetFieldConfig;
 
@@ -1323,6 +1323,23 @@ UA_StatusCode UA_EXPORT
 UA_encodeJson(const void *src, const UA_DataType *type, UA_ByteString *outBuf,
               const UA_EncodeJsonOptions *options);
 
+/* Receives the next chunk of the streaming JSON encoding. The chunk points into
+ * the buffer used for the encoding and is only valid during the callback. */
+typedef UA_StatusCode
+(*UA_EncodeJsonFlushCallback)(void *context, const UA_ByteString *chunk);
+
+/* Encodes the scalar value described by type to JSON encoding in a streaming
+ * fashion. The buffer buf is used for the output. Whenever it is full, the
+ * content is handed to the flushCallback and the buffer is reused. The
+ * remaining content is flushed when the encoding is done. The size of the
+ * encoded value is not limited by the buffer size and no prior call to
+ * UA_calcSizeJson is required. The options can be NULL. */
+UA_StatusCode UA_EXPORT
+UA_encodeJsonStream(const void *src, const UA_DataType *type,
+                    const UA_ByteString *buf,
+                    UA_EncodeJsonFlushCallback flushCallback, void *flushContext,
+                    const UA_EncodeJsonOptions *options);
+
 /* The structure with the decoding options may be extended in the future.
  * Zero-out the entire structure initially to ensure code-compatibility when
  * more fields are added in a later release. */
@@ -0,0 +1,1022 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <open62541/plugin/historydata/history_data_backend_file.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Layout of a segment file:
+ *
+ * Header: | magic (4) | version (4) | nodeId length (4) | reserved (4) |
+ *         | binary-encoded NodeId (padded to 8 bytes) |
+ * Record: | payload length (4) | checksum (4) | timestamp (8) |
+ *         | binary-encoded DataValue (padded to 8 bytes) |
+ *
+ * A record with length zero marks the end. Before a record is committed by
+ * writing its length, the header of the following record is cleared. So a torn
+ * write results in either a zero length or in a checksum mismatch. Both end
+ * the segment when it is loaded. */
+
+#define FILE_MAGIC 0x53484155 /* "UAHS" */
+#define FILE_VERSION 1
+#define FILE_HEADERSIZE 16
+#define FILE_RECORDHEADERSIZE 16
+#define FILE_MINSEGMENTSIZE 1024
+#define FILE_MAXPREFIXLENGTH 150
+
+/* Every FILE_INDEXSTRIDE'th record of a segment is added to the sparse index */
+#define FILE_INDEXSTRIDE 64
+
+#define FILE_PAD8(x) (((x) + 7) & ~(size_t)7)
+
+typedef struct {
+    UA_DateTime timestamp;
+    size_t offset;
+} UA_FileIndexEntry;
+
+typedef struct {
+    UA_Byte *data;        /* mmap'd file content */
+    size_t size;          /* Size of the mapping */
+    size_t used;          /* Offset after the last valid record */
+    size_t firstRecord;   /* Number of the first record in the segment */
+    size_t recordCount;
+    UA_UInt32 sequence;   /* Part of the filename */
+    UA_FileIndexEntry *index;
+    size_t indexSize;
+    size_t indexCapacity;
+} UA_FileSegment;
+
+typedef struct {
+    UA_NodeId nodeId;
+    char *prefix;          /* Path prefix of the segment files */
+    UA_ByteString encodedNodeId;
+    UA_FileSegment *segments;
+    size_t segmentsSize;
+    size_t firstRecord;    /* Records before were deleted by the retention */
+    size_t endRecord;      /* One after the last record */
+    UA_DateTime lastTimestamp;
+    UA_DataValue current;  /* Decoded value returned by getDataValue */
+} UA_FileNodeStore;
+
+typedef struct {
+    char *directory;
+    size_t segmentSize;
+    size_t maxSegments;
+    UA_FileNodeStore **nodes;
+    size_t nodesSize;
+} UA_FileStoreContext;
+
+/*********************/
+/* Helper Functions  */
+/*********************/
+
+static void
+writeUInt32_backend_file(UA_Byte *pos, UA_UInt32 v) {
+    memcpy(pos, &v, sizeof(UA_UInt32));
+}
+
+static UA_UInt32
+readUInt32_backend_file(const UA_Byte *pos) {
+    UA_UInt32 v;
+    memcpy(&v, pos, sizeof(UA_UInt32));
+    return v;
+}
+
+static UA_DateTime
+readTimestamp_backend_file(const UA_Byte *record) {
+    UA_DateTime t;
+    memcpy(&t, &record[8], sizeof(UA_DateTime));
+    return t;
+}
+
+/* FNV-1a over the timestamp and the payload of a record */
+static UA_UInt32
+checksum_backend_file(const UA_Byte *data, size_t length) {
+    UA_UInt32 h = 2166136261u;
+    for(size_t i = 0; i < length; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static size_t
+headerSize_backend_file(const UA_FileNodeStore *node) {
+    return FILE_HEADERSIZE + FILE_PAD8(node->encodedNodeId.length);
+}
+
+/* Returns the length of the record at the offset or zero if there is no valid
+ * record */
+static size_t
+validRecord_backend_file(const UA_FileSegment *seg, size_t offset) {
+    if(offset + FILE_RECORDHEADERSIZE > seg->size)
+        return 0;
+    const UA_Byte *rec = &seg->data[offset];
+    size_t length = readUInt32_backend_file(rec);
+    if(length == 0 || length > seg->size - offset - FILE_RECORDHEADERSIZE)
+        return 0;
+    UA_UInt32 checksum = checksum_backend_file(&rec[8], length + 8);
+    if(checksum != readUInt32_backend_file(&rec[4]))
+        return 0;
+    return length;
+}
+
+static size_t
+nextOffset_backend_file(const UA_FileSegment *seg, size_t offset) {
+    size_t length = readUInt32_backend_file(&seg->data[offset]);
+    return offset + FILE_RECORDHEADERSIZE + FILE_PAD8(length);
+}
+
+static UA_StatusCode
+addIndexEntry_backend_file(UA_FileSegment *seg, UA_DateTime timestamp,
+                           size_t offset) {
+    if(seg->indexSize == seg->indexCapacity) {
+        size_t newCapacity = (seg->indexCapacity == 0) ? 16 : seg->indexCapacity * 2;
+        UA_FileIndexEntry *newIndex = (UA_FileIndexEntry*)
+            UA_realloc(seg->index, newCapacity * sizeof(UA_FileIndexEntry));
+        if(!newIndex)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        seg->index = newIndex;
+        seg->indexCapacity = newCapacity;
+    }
+    seg->index[seg->indexSize].timestamp = timestamp;
+    seg->index[seg->indexSize].offset = offset;
+    seg->indexSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+UA_FileSegment_clear(UA_FileSegment *seg) {
+    if(seg->data)
+        munmap(seg->data, seg->size);
+    UA_free(seg->index);
+    memset(seg, 0, sizeof(UA_FileSegment));
+}
+
+static char *
+segmentPath_backend_file(const UA_FileNodeStore *node, UA_UInt32 sequence) {
+    size_t len = strlen(node->prefix) + 16;
+    char *path = (char*)UA_malloc(len);
+    if(path)
+        snprintf(path, len, "%s.%010u.seg", node->prefix, (unsigned)sequence);
+    return path;
+}
+
+/* Map a segment file and recover the valid records. Returns false if the
+ * segment is not usable (wrong format or a different NodeId). */
+static UA_Boolean
+loadSegment_backend_file(UA_FileNodeStore *node, UA_FileSegment *seg,
+                         const char *path) {
+    int fd = open(path, O_RDWR);
+    if(fd < 0)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < headerSize_backend_file(node)) {
+        close(fd);
+        return false;
+    }
+    seg->size = (size_t)st.st_size;
+    void *data = mmap(NULL, seg->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+        return false;
+    seg->data = (UA_Byte*)data;
+
+    /* Check the header */
+    if(readUInt32_backend_file(seg->data) != FILE_MAGIC ||
+       readUInt32_backend_file(&seg->data[4]) != FILE_VERSION ||
+       readUInt32_backend_file(&seg->data[8]) != node->encodedNodeId.length ||
+       memcmp(&seg->data[FILE_HEADERSIZE], node->encodedNodeId.data,
+              node->encodedNodeId.length) != 0) {
+        UA_FileSegment_clear(seg);
+        return false;
+    }
+
+    /* Scan the records and build the sparse index */
+    size_t offset = headerSize_backend_file(node);
+    while(validRecord_backend_file(seg, offset) > 0) {
+        UA_DateTime timestamp = readTimestamp_backend_file(&seg->data[offset]);
+        if(timestamp < node->lastTimestamp)
+            break;
+        if(seg->recordCount % FILE_INDEXSTRIDE == 0 &&
+           addIndexEntry_backend_file(seg, timestamp, offset) != UA_STATUSCODE_GOOD) {
+            UA_FileSegment_clear(seg);
+            return false;
+        }
+        node->lastTimestamp = timestamp;
+        seg->recordCount++;
+        offset = nextOffset_backend_file(seg, offset);
+    }
+    seg->used = offset;
+
+    /* Clear the header of a torn record to have a clean append position */
+    if(offset + FILE_RECORDHEADERSIZE <= seg->size)
+        memset(&seg->data[offset], 0, FILE_RECORDHEADERSIZE);
+    return true;
+}
+
+static int
+compareSequence_backend_file(const void *a, const void *b) {
+    UA_UInt32 sa = *(const UA_UInt32*)a;
+    UA_UInt32 sb = *(const UA_UInt32*)b;
+    return (sa > sb) - (sa < sb);
+}
+
+/* Find the existing segment files of the node */
+static UA_StatusCode
+loadSegments_backend_file(UA_FileStoreContext *ctx, UA_FileNodeStore *node) {
+    DIR *dir = opendir(ctx->directory);
+    if(!dir)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    const char *base = &node->prefix[strlen(ctx->directory) + 1];
+    size_t baseLen = strlen(base);
+    UA_UInt32 *sequences = NULL;
+    size_t sequencesSize = 0;
+    struct dirent *ent;
+    while((ent = readdir(dir))) {
+        const char *name = ent->d_name;
+        size_t nameLen = strlen(name);
+        if(nameLen != baseLen + 15 || strncmp(name, base, baseLen) != 0 ||
+           name[baseLen] != '.' || strcmp(&name[baseLen + 11], ".seg") != 0)
+            continue;
+        char *end = NULL;
+        unsigned long seq = strtoul(&name[baseLen + 1], &end, 10);
+        if(end != &name[baseLen + 11] || seq > UA_UINT32_MAX)
+            continue;
+        UA_UInt32 *newSequences = (UA_UInt32*)
+            UA_realloc(sequences, (sequencesSize + 1) * sizeof(UA_UInt32));
+        if(!newSequences) {
+            UA_free(sequences);
+            closedir(dir);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        sequences = newSequences;
+        sequences[sequencesSize++] = (UA_UInt32)seq;
+    }
+    closedir(dir);
+    if(sequencesSize == 0)
+        return UA_STATUSCODE_GOOD;
+
+    qsort(sequences, sequencesSize, sizeof(UA_UInt32), compareSequence_backend_file);
+    node->segments = (UA_FileSegment*)UA_calloc(sequencesSize, sizeof(UA_FileSegment));
+    if(!node->segments) {
+        UA_free(sequences);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* The record numbers start at zero after every restart */
+    for(size_t i = 0; i < sequencesSize; i++) {
+        char *path = segmentPath_backend_file(node, sequences[i]);
+        if(!path)
+            continue;
+        UA_FileSegment *seg = &node->segments[node->segmentsSize];
+        if(!loadSegment_backend_file(node, seg, path)) {
+            /* A segment without a valid header at the end is the leftover of
+             * a crash during its creation */
+            if(i == sequencesSize - 1)
+                unlink(path);
+            UA_free(path);
+            continue;
+        }
+        UA_free(path);
+        /* Only the last segment can be empty */
+        if(seg->recordCount == 0 && i < sequencesSize - 1) {
+            UA_FileSegment_clear(seg);
+            continue;
+        }
+        seg->sequence = sequences[i];
+        seg->firstRecord = node->endRecord;
+        node->endRecord += seg->recordCount;
+        node->segmentsSize++;
+    }
+    UA_free(sequences);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Escape the printed NodeId to get a file name */
+static char *
+nodePrefix_backend_file(const UA_FileStoreContext *ctx, const UA_NodeId *nodeId) {
+    UA_String out = UA_STRING_NULL;
+    if(UA_NodeId_print(nodeId, &out) != UA_STATUSCODE_GOOD)
+        return NULL;
+    size_t dirLen = strlen(ctx->directory);
+    char *prefix = (char*)UA_malloc(dirLen + 1 + FILE_MAXPREFIXLENGTH + 16);
+    if(!prefix) {
+        UA_String_clear(&out);
+        return NULL;
+    }
+    memcpy(prefix, ctx->directory, dirLen);
+    prefix[dirLen] = '/';
+    char *pos = &prefix[dirLen + 1];
+    size_t len = 0;
+    size_t i = 0;
+    for(; i < out.length && len + 3 <= FILE_MAXPREFIXLENGTH; i++) {
+        UA_Byte c = out.data[i];
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '=' || c == ';' || c == '-' || c == '_') {
+            pos[len++] = (char)c;
+        } else {
+            snprintf(&pos[len], 4, "%%%02X", c);
+            len += 3;
+        }
+    }
+    /* Long identifiers are truncated. Add the hash to keep them apart. The
+     * NodeId in the segment header is checked when the segments are loaded. */
+    if(i < out.length)
+        len += (size_t)snprintf(&pos[len], 10, "~%08X", UA_NodeId_hash(nodeId));
+    pos[len] = 0;
+    UA_String_clear(&out);
+    return prefix;
+}
+
+static void
+UA_FileNodeStore_delete(UA_FileNodeStore *node) {
+    for(size_t i = 0; i < node->segmentsSize; i++)
+        UA_FileSegment_clear(&node->segments[i]);
+    UA_free(node->segments);
+    UA_NodeId_clear(&node->nodeId);
+    UA_ByteString_clear(&node->encodedNodeId);
+    UA_DataValue_clear(&node->current);
+    UA_free(node->prefix);
+    UA_free(node);
+}
+
+static UA_FileNodeStore *
+getNewNodeStore_backend_file(UA_FileStoreContext *ctx, const UA_NodeId *nodeId) {
+    UA_FileNodeStore **nodes = (UA_FileNodeStore**)
+        UA_realloc(ctx->nodes, (ctx->nodesSize + 1) * sizeof(UA_FileNodeStore*));
+    if(!nodes)
+        return NULL;
+    ctx->nodes = nodes;
+    UA_FileNodeStore *node = (UA_FileNodeStore*)UA_calloc(1, sizeof(UA_FileNodeStore));
+    if(!node)
+        return NULL;
+    node->lastTimestamp = LLONG_MIN;
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &node->nodeId);
+    res |= UA_encodeBinary(nodeId, &UA_TYPES[UA_TYPES_NODEID],
+                           &node->encodedNodeId, NULL);
+    node->prefix = nodePrefix_backend_file(ctx, nodeId);
+    if(res != UA_STATUSCODE_GOOD || !node->prefix ||
+       loadSegments_backend_file(ctx, node) != UA_STATUSCODE_GOOD) {
+        UA_FileNodeStore_delete(node);
+        return NULL;
+    }
+    ctx->nodes[ctx->nodesSize++] = node;
+    return node;
+}
+
+static UA_FileNodeStore *
+getNodeStore_backend_file(UA_FileStoreContext *ctx, const UA_NodeId *nodeId) {
+    for(size_t i = 0; i < ctx->nodesSize; ++i) {
+        if(UA_NodeId_equal(nodeId, &ctx->nodes[i]->nodeId))
+            return ctx->nodes[i];
+    }
+    return getNewNodeStore_backend_file(ctx, nodeId);
+}
+
+/* Remove the oldest segment for the circular retention */
+static void
+dropOldestSegment_backend_file(UA_FileNodeStore *node) {
+    UA_FileSegment *seg = &node->segments[0];
+    char *path = segmentPath_backend_file(node, seg->sequence);
+    if(path) {
+        unlink(path);
+        UA_free(path);
+    }
+    node->firstRecord += seg->recordCount;
+    UA_FileSegment_clear(seg);
+    node->segmentsSize--;
+    memmove(node->segments, &node->segments[1],
+            node->segmentsSize * sizeof(UA_FileSegment));
+}
+
+static UA_FileSegment *
+addSegment_backend_file(UA_FileStoreContext *ctx, UA_FileNodeStore *node) {
+    UA_FileSegment *segments = (UA_FileSegment*)
+        UA_realloc(node->segments, (node->segmentsSize + 1) * sizeof(UA_FileSegment));
+    if(!segments)
+        return NULL;
+    node->segments = segments;
+
+    UA_UInt32 sequence = 0;
+    if(node->segmentsSize > 0)
+        sequence = node->segments[node->segmentsSize - 1].sequence + 1;
+    char *path = segmentPath_backend_file(node, sequence);
+    if(!path)
+        return NULL;
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+        UA_free(path);
+        return NULL;
+    }
+
+    /* Reserve the disk space. A sparse file would raise SIGBUS on the first
+     * write into the mapping when the disk is full. */
+    if(ftruncate(fd, (off_t)ctx->segmentSize) != 0 ||
+       posix_fallocate(fd, 0, (off_t)ctx->segmentSize) != 0) {
+        close(fd);
+        unlink(path);
+        UA_free(path);
+        return NULL;
+    }
+    void *data = mmap(NULL, ctx->segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        unlink(path);
+        UA_free(path);
+        return NULL;
+    }
+    UA_free(path);
+
+    UA_FileSegment *seg = &node->segments[node->segmentsSize];
+    memset(seg, 0, sizeof(UA_FileSegment));
+    seg->data = (UA_Byte*)data;
+    seg->size = ctx->segmentSize;
+    seg->sequence = sequence;
+    seg->firstRecord = node->endRecord;
+
+    /* Write the header. The magic comes last to mark it complete. */
+    writeUInt32_backend_file(&seg->data[4], FILE_VERSION);
+    writeUInt32_backend_file(&seg->data[8], (UA_UInt32)node->encodedNodeId.length);
+    memcpy(&seg->data[FILE_HEADERSIZE], node->encodedNodeId.data,
+           node->encodedNodeId.length);
+    writeUInt32_backend_file(seg->data, FILE_MAGIC);
+    seg->used = headerSize_backend_file(node);
+    node->segmentsSize++;
+
+    /* Drop the oldest segment only after the new segment was created. So a
+     * failure does not lose the history. */
+    if(ctx->maxSegments > 0 && node->segmentsSize > ctx->maxSegments)
+        dropOldestSegment_backend_file(node);
+    return &node->segments[node->segmentsSize - 1];
+}
+
+/* Encode the record at the end of the segment. Returns
+ * UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED if the remaining space is too
+ * small. */
+static UA_StatusCode
+appendRecord_backend_file(UA_FileSegment *seg, UA_DateTime timestamp,
+                          const UA_DataValue *value) {
+    if(seg->used + FILE_RECORDHEADERSIZE >= seg->size)
+        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    UA_Byte *rec = &seg->data[seg->used];
+    UA_ByteString buf;
+    buf.data = &rec[FILE_RECORDHEADERSIZE];
+    buf.length = seg->size - seg->used - FILE_RECORDHEADERSIZE;
+    UA_StatusCode res = UA_encodeBinary(value, &UA_TYPES[UA_TYPES_DATAVALUE], &buf, NULL);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    memcpy(&rec[8], &timestamp, sizeof(UA_DateTime));
+    writeUInt32_backend_file(&rec[4], checksum_backend_file(&rec[8], buf.length + 8));
+
+    /* Clear the header of the next record. Leftovers of a torn write after
+     * the new record are never interpreted as a record. */
+    size_t next = seg->used + FILE_RECORDHEADERSIZE + FILE_PAD8(buf.length);
+    if(next + FILE_RECORDHEADERSIZE <= seg->size)
+        memset(&seg->data[next], 0, FILE_RECORDHEADERSIZE);
+
+    /* Commit the record by writing the length */
+    writeUInt32_backend_file(rec, (UA_UInt32)buf.length);
+
+    if(seg->recordCount % FILE_INDEXSTRIDE == 0) {
+        res = addIndexEntry_backend_file(seg, timestamp, seg->used);
+        if(res != UA_STATUSCODE_GOOD) {
+            memset(rec, 0, FILE_RECORDHEADERSIZE);
+            return res;
+        }
+    }
+    seg->used = next;
+    seg->recordCount++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+append_backend_file(UA_FileStoreContext *ctx, UA_FileNodeStore *node,
+                    UA_DateTime timestamp, const UA_DataValue *value) {
+    if(timestamp < node->lastTimestamp)
+        return UA_STATUSCODE_BADHISTORYOPERATIONUNSUPPORTED;
+
+    /* Stored values always carry a server timestamp */
+    UA_DataValue v = *value;
+    if(!v.hasServerTimestamp) {
+        v.serverTimestamp = timestamp;
+        v.hasServerTimestamp = true;
+    }
+
+    UA_StatusCode res = UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    if(node->segmentsSize > 0)
+        res = appendRecord_backend_file(&node->segments[node->segmentsSize - 1],
+                                        timestamp, &v);
+    if(res == UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED) {
+        /* Don't start a new segment if the current one is still empty */
+        if(node->segmentsSize > 0 &&
+           node->segments[node->segmentsSize - 1].recordCount == 0)
+            return res;
+        UA_FileSegment *seg = addSegment_backend_file(ctx, node);
+        if(!seg)
+            return UA_STATUSCODE_BADINTERNALERROR;
+        res = appendRecord_backend_file(seg, timestamp, &v);
+    }
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    node->lastTimestamp = timestamp;
+    node->endRecord++;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Find the segment and the offset of a record */
+static UA_FileSegment *
+locateRecord_backend_file(const UA_FileNodeStore *node, size_t record,
+                          size_t *offset) {
+    if(record < node->firstRecord || record >= node->endRecord)
+        return NULL;
+    size_t lo = 0, hi = node->segmentsSize;
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(node->segments[mid].firstRecord <= record)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    UA_FileSegment *seg = &node->segments[lo];
+    size_t pos = record - seg->firstRecord;
+    size_t off = seg->index[pos / FILE_INDEXSTRIDE].offset;
+    for(size_t i = 0; i < pos % FILE_INDEXSTRIDE; i++)
+        off = nextOffset_backend_file(seg, off);
+    *offset = off;
+    return seg;
+}
+
+static UA_Boolean
+beforeBound_backend_file(UA_DateTime timestamp, UA_DateTime bound,
+                         UA_Boolean inclusive) {
+    return inclusive ? (timestamp <= bound) : (timestamp < bound);
+}
+
+/* Returns the number of the first record with a timestamp after the bound
+ * (inclusive: timestamp > bound; otherwise: timestamp >= bound). Returns
+ * endRecord if there is no such record. */
+static size_t
+findBound_backend_file(const UA_FileNodeStore *node, UA_DateTime bound,
+                       UA_Boolean inclusive) {
+    /* Find the last segment that begins before the bound */
+    size_t s = node->segmentsSize;
+    size_t lo = 0, hi = node->segmentsSize;
+    while(lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const UA_FileSegment *seg = &node->segments[mid];
+        if(seg->recordCount > 0 &&
+           beforeBound_backend_file(seg->index[0].timestamp, bound, inclusive)) {
+            s = mid;
+            lo = mid + 1;
+        } else if(seg->recordCount == 0) {
+            /* Empty segments only occur at the end */
+            hi = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    if(s == node->segmentsSize)
+        return node->firstRecord;
+
+    /* Find the last index entry before the bound */
+    const UA_FileSegment *seg = &node->segments[s];
+    size_t e = 0;
+    lo = 1;
+    hi = seg->indexSize;
+    while(lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if(beforeBound_backend_file(seg->index[mid].timestamp, bound, inclusive)) {
+            e = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* Scan the records of the index block */
+    size_t record = seg->firstRecord + e * FILE_INDEXSTRIDE;
+    size_t end = seg->firstRecord + seg->recordCount;
+    size_t offset = seg->index[e].offset;
+    for(size_t i = 0; i < FILE_INDEXSTRIDE && record < end; i++) {
+        if(!beforeBound_backend_file(readTimestamp_backend_file(&seg->data[offset]),
+                                     bound, inclusive))
+            break;
+        offset = nextOffset_backend_file(seg, offset);
+        record++;
+    }
+    return record;
+}
+
+static UA_StatusCode
+decodeRecord_backend_file(const UA_FileSegment *seg, size_t offset,
+                          UA_DataValue *value) {
+    UA_ByteString buf;
+    buf.length = readUInt32_backend_file(&seg->data[offset]);
+    buf.data = &seg->data[offset + FILE_RECORDHEADERSIZE];
+    return UA_decodeBinary(&buf, value, &UA_TYPES[UA_TYPES_DATAVALUE], NULL);
+}
+
+/*****************************/
+/* UA_HistoryDataBackend API */
+/*****************************/
+
+static size_t
+resultSize_backend_file(UA_Server *server,
+                        void *context,
+                        const UA_NodeId *sessionId,
+                        void *sessionContext,
+                        const UA_NodeId *nodeId,
+                        size_t startIndex,
+                        size_t endIndex) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node || node->endRecord == node->firstRecord ||
+       startIndex == node->endRecord || endIndex == node->endRecord)
+        return 0;
+    return endIndex - startIndex + 1;
+}
+
+static size_t
+getDateTimeMatch_backend_file(UA_Server *server,
+                              void *context,
+                              const UA_NodeId *sessionId,
+                              void *sessionContext,
+                              const UA_NodeId *nodeId,
+                              const UA_DateTime timestamp,
+                              const MatchStrategy strategy) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node)
+        return 0;
+    size_t end = node->endRecord;
+    size_t first = node->firstRecord;
+    size_t lower, upper, offset;
+    const UA_FileSegment *seg;
+    switch(strategy) {
+    case MATCH_EQUAL:
+        lower = findBound_backend_file(node, timestamp, false);
+        seg = locateRecord_backend_file(node, lower, &offset);
+        if(seg && readTimestamp_backend_file(&seg->data[offset]) == timestamp)
+            return lower;
+        return end;
+    case MATCH_AFTER:
+        return findBound_backend_file(node, timestamp, true);
+    case MATCH_EQUAL_OR_AFTER:
+        return findBound_backend_file(node, timestamp, false);
+    case MATCH_BEFORE:
+        lower = findBound_backend_file(node, timestamp, false);
+        return (lower > first) ? lower - 1 : end;
+    case MATCH_EQUAL_OR_BEFORE:
+        upper = findBound_backend_file(node, timestamp, true);
+        return (upper > first) ? upper - 1 : end;
+    default:
+        break;
+    }
+    return end;
+}
+
+static UA_StatusCode
+serverSetHistoryData_backend_file(UA_Server *server,
+                                  void *context,
+                                  const UA_NodeId *sessionId,
+                                  void *sessionContext,
+                                  const UA_NodeId *nodeId,
+                                  UA_Boolean historizing,
+                                  const UA_DataValue *value) {
+    UA_FileStoreContext *ctx = (UA_FileStoreContext*)context;
+    UA_FileNodeStore *node = getNodeStore_backend_file(ctx, nodeId);
+    if(!node)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_DateTime timestamp = 0;
+    if(value->hasSourceTimestamp) {
+        timestamp = value->sourceTimestamp;
+    } else if(value->hasServerTimestamp) {
+        timestamp = value->serverTimestamp;
+    } else {
+        timestamp = UA_DateTime_now();
+    }
+    return append_backend_file(ctx, node, timestamp, value);
+}
+
+static size_t
+getEnd_backend_file(UA_Server *server,
+                    void *context,
+                    const UA_NodeId *sessionId,
+                    void *sessionContext,
+                    const UA_NodeId *nodeId) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    return (node) ? node->endRecord : 0;
+}
+
+static size_t
+lastIndex_backend_file(UA_Server *server,
+                       void *context,
+                       const UA_NodeId *sessionId,
+                       void *sessionContext,
+                       const UA_NodeId *nodeId) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node)
+        return 0;
+    if(node->endRecord == node->firstRecord)
+        return node->endRecord;
+    return node->endRecord - 1;
+}
+
+static size_t
+firstIndex_backend_file(UA_Server *server,
+                        void *context,
+                        const UA_NodeId *sessionId,
+                        void *sessionContext,
+                        const UA_NodeId *nodeId) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    return (node) ? node->firstRecord : 0;
+}
+
+static UA_Boolean
+boundSupported_backend_file(UA_Server *server,
+                            void *context,
+                            const UA_NodeId *sessionId,
+                            void *sessionContext,
+                            const UA_NodeId *nodeId) {
+    return true;
+}
+
+static const UA_DataValue*
+getDataValue_backend_file(UA_Server *server,
+                          void *context,
+                          const UA_NodeId *sessionId,
+                          void *sessionContext,
+                          const UA_NodeId *nodeId, size_t index) {
+    UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node)
+        return NULL;
+    size_t offset;
+    const UA_FileSegment *seg = locateRecord_backend_file(node, index, &offset);
+    if(!seg)
+        return NULL;
+    UA_DataValue_clear(&node->current);
+    if(decodeRecord_backend_file(seg, offset, &node->current) != UA_STATUSCODE_GOOD)
+        return NULL;
+    return &node->current;
+}
+
+static UA_Boolean
+timestampsToReturnSupported_backend_file(UA_Server *server,
+                                         void *context,
+                                         const UA_NodeId *sessionId,
+                                         void *sessionContext,
+                                         const UA_NodeId *nodeId,
+                                         const UA_TimestampsToReturn timestampsToReturn) {
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node || node->endRecord == node->firstRecord)
+        return true;
+    const UA_DataValue *first =
+        getDataValue_backend_file(server, context, sessionId, sessionContext,
+                                  nodeId, node->firstRecord);
+    if(!first)
+        return false;
+    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER
+       || timestampsToReturn == UA_TIMESTAMPSTORETURN_INVALID
+       || (timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER
+           && !first->hasServerTimestamp)
+       || (timestampsToReturn == UA_TIMESTAMPSTORETURN_SOURCE
+           && !first->hasSourceTimestamp)
+       || (timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH
+           && !(first->hasSourceTimestamp && first->hasServerTimestamp))) {
+        return false;
+    }
+    return true;
+}
+
+static UA_StatusCode
+copyRecord_backend_file(const UA_FileSegment *seg, size_t offset,
+                        UA_NumericRange range, UA_DataValue *value) {
+    UA_StatusCode res = decodeRecord_backend_file(seg, offset, value);
+    if(res != UA_STATUSCODE_GOOD || range.dimensionsSize == 0 || !value->hasValue)
+        return res;
+    UA_Variant rangeValue;
+    res = UA_Variant_copyRange(&value->value, &rangeValue, range);
+    UA_Variant_clear(&value->value);
+    if(res == UA_STATUSCODE_GOOD) {
+        value->value = rangeValue;
+        return UA_STATUSCODE_GOOD;
+    }
+    if(res == UA_STATUSCODE_BADOUTOFMEMORY)
+        return res;
+
+    /* The range does not match the stored value. Return the status for this
+     * value instead of an empty value. */
+    value->hasValue = false;
+    value->hasStatus = true;
+    value->status = res;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+copyDataValues_backend_file(UA_Server *server,
+                            void *context,
+                            const UA_NodeId *sessionId,
+                            void *sessionContext,
+                            const UA_NodeId *nodeId,
+                            size_t startIndex,
+                            size_t endIndex,
+                            UA_Boolean reverse,
+                            size_t maxValues,
+                            UA_NumericRange range,
+                            UA_Boolean releaseContinuationPoints,
+                            const UA_ByteString *continuationPoint,
+                            UA_ByteString *outContinuationPoint,
+                            size_t *providedValues,
+                            UA_DataValue *values) {
+    size_t skip = 0;
+    if(continuationPoint->length > 0) {
+        if(continuationPoint->length == sizeof(size_t)) {
+            skip = *((size_t*)(continuationPoint->data));
+        } else {
+            return UA_STATUSCODE_BADCONTINUATIONPOINTINVALID;
+        }
+    }
+    const UA_FileNodeStore *node =
+        getNodeStore_backend_file((UA_FileStoreContext*)context, nodeId);
+    if(!node)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    size_t counter = 0;
+    size_t offset = 0;
+    const UA_FileSegment *seg;
+    if(reverse) {
+        /* Walk back from the start index */
+        if(startIndex < skip)
+            goto done;
+        size_t index = startIndex - skip;
+        while(index >= endIndex && index >= node->firstRecord &&
+              index < node->endRecord && counter < maxValues) {
+            seg = locateRecord_backend_file(node, index, &offset);
+            res = copyRecord_backend_file(seg, offset, range, &values[counter]);
+            if(res != UA_STATUSCODE_GOOD)
+                break;
+            ++counter;
+            if(index == 0)
+                break;
+            --index;
+        }
+    } else {
+        /* Walk forward through the segments */
+        size_t index = startIndex + skip;
+        seg = locateRecord_backend_file(node, index, &offset);
+        while(seg && index <= endIndex && counter < maxValues) {
+            res = copyRecord_backend_file(seg, offset, range, &values[counter]);
+            if(res != UA_STATUSCODE_GOOD)
+                break;
+            ++counter;
+            ++index;
+            if(index < seg->firstRecord + seg->recordCount) {
+                offset = nextOffset_backend_file(seg, offset);
+            } else {
+                seg = locateRecord_backend_file(node, index, &offset);
+            }
+        }
+    }
+
+ done:
+    if(res != UA_STATUSCODE_GOOD) {
+        for(size_t i = 0; i < counter; i++)
+            UA_DataValue_clear(&values[i]);
+        return res;
+    }
+
+    if(providedValues)
+        *providedValues = counter;
+
+    if((!reverse && (endIndex-startIndex-skip+1) > counter) ||
+       (reverse && (startIndex-endIndex-skip+1) > counter)) {
+        outContinuationPoint->length = sizeof(size_t);
+        size_t t = sizeof(size_t);
+        outContinuationPoint->data = (UA_Byte*)UA_malloc(t);
+        if(!outContinuationPoint->data) {
+            outContinuationPoint->length = 0;
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        *((size_t*)(outContinuationPoint->data)) = skip + counter;
+    }
+
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+insertDataValue_backend_file(UA_Server *server,
+                             void *hdbContext,
+                             const UA_NodeId *sessionId,
+                             void *sessionContext,
+                             const UA_NodeId *nodeId,
+                             const UA_DataValue *value) {
+    if(!value->hasSourceTimestamp && !value->hasServerTimestamp)
+        return UA_STATUSCODE_BADINVALIDTIMESTAMP;
+    const UA_DateTime timestamp =
+        value->hasSourceTimestamp ? value->sourceTimestamp : value->serverTimestamp;
+    UA_FileStoreContext *ctx = (UA_FileStoreContext*)hdbContext;
+    UA_FileNodeStore *node = getNodeStore_backend_file(ctx, nodeId);
+    if(!node)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    /* Only inserts at the end are possible */
+    if(getDateTimeMatch_backend_file(server, hdbContext, sessionId, sessionContext,
+                                     nodeId, timestamp, MATCH_EQUAL) != node->endRecord)
+        return UA_STATUSCODE_BADENTRYEXISTS;
+    return append_backend_file(ctx, node, timestamp, value);
+}
+
+static void
+UA_FileStoreContext_delete(UA_FileStoreContext *ctx) {
+    for(size_t i = 0; i < ctx->nodesSize; i++)
+        UA_FileNodeStore_delete(ctx->nodes[i]);
+    UA_free(ctx->nodes);
+    UA_free(ctx->directory);
+    UA_free(ctx);
+}
+
+static void
+deleteMembers_backend_file(UA_HistoryDataBackend *backend) {
+    if(backend == NULL || backend->context == NULL)
+        return;
+    UA_FileStoreContext_delete((UA_FileStoreContext*)backend->context);
+    backend->context = NULL;
+}
+
+UA_HistoryDataBackend
+UA_HistoryDataBackend_File(const char *directory, size_t segmentSize,
+                           size_t maxSegments) {
+    UA_HistoryDataBackend result;
+    memset(&result, 0, sizeof(UA_HistoryDataBackend));
+    if(!directory)
+        return result;
+    if(segmentSize < FILE_MINSEGMENTSIZE)
+        segmentSize = FILE_MINSEGMENTSIZE;
+    if(segmentSize > UA_UINT32_MAX)
+        segmentSize = UA_UINT32_MAX;
+
+    /* Create the directory if required */
+    if(mkdir(directory, 0755) != 0 && errno != EEXIST)
+        return result;
+
+    UA_FileStoreContext *ctx = (UA_FileStoreContext*)
+        UA_calloc(1, sizeof(UA_FileStoreContext));
+    if(!ctx)
+        return result;
+    size_t dirLen = strlen(directory);
+    while(dirLen > 1 && directory[dirLen - 1] == '/')
+        dirLen--;
+    ctx->directory = (char*)UA_malloc(dirLen + 1);
+    if(!ctx->directory) {
+        UA_free(ctx);
+        return result;
+    }
+    memcpy(ctx->directory, directory, dirLen);
+    ctx->directory[dirLen] = 0;
+    ctx->segmentSize = segmentSize;
+    ctx->maxSegments = maxSegments;
+
+    result.serverSetHistoryData = &serverSetHistoryData_backend_file;
+    result.resultSize = &resultSize_backend_file;
+    result.getEnd = &getEnd_backend_file;
+    result.lastIndex = &lastIndex_backend_file;
+    result.firstIndex = &firstIndex_backend_file;
+    result.getDateTimeMatch = &getDateTimeMatch_backend_file;
+    result.copyDataValues = &copyDataValues_backend_file;
+    result.getDataValue = &getDataValue_backend_file;
+    result.boundSupported = &boundSupported_backend_file;
+    result.timestampsToReturnSupported = &timestampsToReturnSupported_backend_file;
+    result.insertDataValue = &insertDataValue_backend_file;
+    result.updateDataValue = NULL;
+    result.replaceDataValue = NULL;
+    result.removeDataValue = NULL;
+    result.deleteMembers = &deleteMembers_backend_file;
+    result.getHistoryData = NULL;
+    result.context = ctx;
+    return result;
+}
+
+void
+UA_HistoryDataBackend_File_clear(UA_HistoryDataBackend *backend) {
+    if(backend->context)
+        UA_FileStoreContext_delete((UA_FileStoreContext*)backend->context);
+    memset(backend, 0, sizeof(UA_HistoryDataBackend));
+}
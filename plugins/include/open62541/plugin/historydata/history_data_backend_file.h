@@ -0,0 +1,49 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UA_HISTORYDATABACKEND_FILE_H_
+#define UA_HISTORYDATABACKEND_FILE_H_
+
+#include "history_data_backend.h"
+
+_UA_BEGIN_DECLS
+
+#define UA_HISTORYDATABACKEND_FILE_DEFAULT_SEGMENTSIZE (8 * 1024 * 1024)
+
+/* This function constructs a persistent UA_HistoryDataBackend. The DataValues
+ * of every historized NodeId are binary-encoded and appended to memory-mapped
+ * segment files in the given directory. The segment files are named after the
+ * NodeId. After a restart the existing segments are mapped again and the
+ * historical data is available right away. Records with an invalid length or
+ * checksum at the tail of a segment (e.g. from a crash during a write) are
+ * discarded when the segments are loaded.
+ *
+ * The backend is append-only. Values must arrive with non-decreasing
+ * timestamps. Values that are older than the last stored value are rejected.
+ * Replacing, updating and removing values is not supported.
+ *
+ * directory is the path where the segment files are stored. It is created if
+ *           it does not exist.
+ * segmentSize is the size in bytes of every segment file. The space is
+ *             reserved when a segment is created. Values are rejected if the
+ *             space for a new segment cannot be reserved.
+ * maxSegments is the maximum number of segments kept for each NodeId. When a
+ *             new segment was created, the oldest segment is deleted. This
+ *             implements a circular buffer. Zero means unlimited retention.
+ *
+ * The segment files use the host byte order and are not portable between
+ * architectures. Writes go to the page cache of the operating system. Data is
+ * preserved when the server process crashes, but not necessarily on power
+ * loss. */
+UA_HistoryDataBackend UA_EXPORT
+UA_HistoryDataBackend_File(const char *directory, size_t segmentSize,
+                           size_t maxSegments);
+
+void UA_EXPORT
+UA_HistoryDataBackend_File_clear(UA_HistoryDataBackend *backend);
+
+_UA_END_DECLS
+
+#endif /* UA_HISTORYDATABACKEND_FILE_H_ */
@@ -0,0 +1,46 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#ifndef UA_LOG_ASYNC_H_
+#define UA_LOG_ASYNC_H_
+
+#include <open62541/plugin/log.h>
+
+_UA_BEGIN_DECLS
+
+/* Asynchronous logger that writes to stdout in the same format as the stdout
+ * logger. The log call only formats the message text into a lock-free ring
+ * buffer owned by the calling thread. The timestamp, level and category are
+ * formatted in UA_Log_Async_flush and the messages are written in batches.
+ *
+ * Every thread that logs claims one of the maxThreads rings. The ring is
+ * released when the thread ends (POSIX with multithreading) or with
+ * UA_Log_Async_releaseThread. Pending messages of a released ring are still
+ * written by the next flush. Each ring holds ringSize messages (rounded up to a power of two).
+ * If no ring is available or the ring is full, the message is dropped. The
+ * number of dropped messages is reported with the next flush.
+ *
+ * The flush has to be called regularly, e.g. from a repeated callback in the
+ * EventLoop of the server. The logger is flushed before it is cleared. */
+UA_EXPORT UA_Logger *
+UA_Log_Async_new(UA_LogLevel minlevel, size_t maxThreads, size_t ringSize);
+
+/* Format and write the pending messages. Can be called from any thread.
+ * Returns the number of messages written. */
+UA_EXPORT size_t
+UA_Log_Async_flush(UA_Logger *logger);
+
+/* Release the ring of the calling thread so that it can be claimed by another
+ * thread. Call this before a thread ends on architectures where the ring is
+ * not released automatically. */
+UA_EXPORT void
+UA_Log_Async_releaseThread(UA_Logger *logger);
+
+/* Total number of dropped messages */
+UA_EXPORT size_t
+UA_Log_Async_dropped(const UA_Logger *logger);
+
+_UA_END_DECLS
+
+#endif /* UA_LOG_ASYNC_H_ */
@@ -524,6 +524,7 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
 #ifdef UA_ENABLE_PUBSUB
     conf->pubsubEnabled = true;
     conf->pubSubConfig.enableDeltaFrames = true;
+    conf->pubSubConfig.enableDirectTargetWrites = true;
 #ifdef UA_ENABLE_PUBSUB_INFORMATIONMODEL
     conf->pubSubConfig.enableInformationModelMethods = true;
 #endif
@@ -1679,6 +1680,7 @@ UA_ClientConfig_setDefault(UA_ClientConfig *config) {
      *  userTokenPolicy
      *  customDataTypes
      *  connectivityCheckInterval
+     *  splitRequests
      *  stateCallback
      *  inactivityCallback
      *  outStandingPublishRequests
@@ -1690,6 +1692,8 @@ UA_ClientConfig_setDefault(UA_ClientConfig *config) {
         config->timeout = 5 * 1000; /* 5 seconds */
     if(config->secureChannelLifeTime == 0)
         config->secureChannelLifeTime = 10 * 60 * 1000; /* 10 minutes */
+    if(config->splitRequestsWindow == 0)
+        config->splitRequestsWindow = 4;
 
     if(config->logging == NULL)
         config->logging = UA_Log_Stdout_new(UA_LOGLEVEL_INFO);
@@ -569,6 +569,10 @@ PARSE_JSON(PubsubConfigurationField) {
             cj5_get_str(&ctx->result, (unsigned int)ctx->index, field_str, &str_len);
             if(strcmp(field_str, "enableDeltaFrames") == 0)
                 parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &field->enableDeltaFrames, NULL);
+            else if(strcmp(field_str, "enableDirectTargetWrites") == 0)
+                parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &field->enableDirectTargetWrites, NULL);
+            else if(strcmp(field_str, "enableZeroCopySampling") == 0)
+                parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &field->enableZeroCopySampling, NULL);
 #ifdef UA_ENABLE_PUBSUB_INFORMATIONMODEL
             else if(strcmp(field_str, "enableInformationModelMethods") == 0)
                 parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &field->enableInformationModelMethods, NULL);
@@ -963,6 +967,10 @@ parseJSONConfig(UA_ServerConfig *config, UA_ByteString json_config) {
                     retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxMonitoredItemsPerCall, NULL);
                 else if(strcmp(field, "maxReferencesPerNode") == 0)
                     retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxReferencesPerNode, NULL);
+                else if(strcmp(field, "translateBrowsePathCacheSize") == 0)
+                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->translateBrowsePathCacheSize, NULL);
+                else if(strcmp(field, "methodCallCacheSize") == 0)
+                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->methodCallCacheSize, NULL);
                 else if(strcmp(field, "reverseReconnectInterval") == 0)
                     retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->reverseReconnectInterval, NULL);
 
@@ -0,0 +1,364 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include <open62541/plugin/log_async.h>
+#include <open62541/types.h>
+
+#include <stdio.h>
+
+#include "mp_printf.h"
+
+/* Release the ring automatically when a thread ends */
+#if UA_MULTITHREADING >= 100 && defined(UA_ARCHITECTURE_POSIX)
+# define UA_LOG_ASYNC_THREADKEY
+# include <pthread.h>
+#endif
+
+#ifdef UA_ARCHITECTURE_POSIX
+# define ANSI_COLOR_RED     "\x1b[31m"
+# define ANSI_COLOR_GREEN   "\x1b[32m"
+# define ANSI_COLOR_YELLOW  "\x1b[33m"
+# define ANSI_COLOR_MAGENTA "\x1b[35m"
+# define ANSI_COLOR_RESET   "\x1b[0m"
+#else
+# define ANSI_COLOR_RED     ""
+# define ANSI_COLOR_GREEN   ""
+# define ANSI_COLOR_YELLOW  ""
+# define ANSI_COLOR_MAGENTA ""
+# define ANSI_COLOR_RESET   ""
+#endif
+
+static
+const char *asyncLogLevelNames[6] = {"trace", "debug",
+                                     ANSI_COLOR_GREEN "info",
+                                     ANSI_COLOR_YELLOW "warn",
+                                     ANSI_COLOR_RED "error",
+                                     ANSI_COLOR_MAGENTA "fatal"};
+static const char *
+asyncLogCategoryNames[UA_LOGCATEGORIES] =
+    {"network", "channel", "session", "server", "client",
+     "userland", "security", "eventloop", "pubsub", "discovery"};
+
+#define ASYNC_LOG_MSGSIZE 512
+#define ASYNC_LOG_LINESIZE (ASYNC_LOG_MSGSIZE + 128)
+#define ASYNC_LOG_OUTBUFSIZE (16 * ASYNC_LOG_LINESIZE)
+
+typedef struct {
+    UA_DateTime time;
+    UA_LogLevel level;
+    UA_LogCategory category;
+    char msg[ASYNC_LOG_MSGSIZE]; /* Formatted by the caller */
+} AsyncLogEntry;
+
+/* Single-producer single-consumer ring. The counters are stored as pointers to
+ * use the atomic operations from config.h. The head and the dropped counter are
+ * written only by the owning thread. The tail is written only by the flush. */
+typedef struct {
+    void *owner; /* Token of the owning thread */
+    void *head;
+    void *tail;
+    void *dropped;
+    size_t reportedDropped;
+    AsyncLogEntry *entries;
+} AsyncLogRing;
+
+typedef struct {
+    uintptr_t id; /* Unique for every logger instance */
+    UA_LogLevel minLevel;
+    size_t ringSize; /* Power of two */
+    size_t ringsSize;
+    AsyncLogRing *rings;
+    void *unclaimedDropped; /* All rings have been claimed by other threads */
+    size_t reportedUnclaimedDropped;
+    void *flushLock;
+#ifdef UA_LOG_ASYNC_THREADKEY
+    pthread_key_t threadKey; /* Points to the ring of the thread */
+    UA_Boolean hasThreadKey;
+#endif
+    char outbuf[ASYNC_LOG_OUTBUFSIZE];
+} AsyncLogContext;
+
+static void *lastContextId = NULL;
+
+/* The address of the token identifies the thread. The ring of the last used
+ * logger is cached. */
+static UA_THREAD_LOCAL char threadToken;
+static UA_THREAD_LOCAL uintptr_t cachedContextId;
+static UA_THREAD_LOCAL AsyncLogRing *cachedRing;
+
+static uintptr_t
+atomicIncrement(void **counter) {
+    void *old = UA_atomic_load(counter);
+    while(true) {
+        void *next = (void*)((uintptr_t)old + 1);
+        void *prev = UA_atomic_cmpxchg(counter, old, next);
+        if(prev == old)
+            return (uintptr_t)next;
+        old = prev;
+    }
+}
+
+/* The ring is handed over with the pending entries. The head is continued by
+ * the next owner and the flush writes the entries in order. */
+static void
+releaseRing(void *ring) {
+    UA_atomic_xchg(&((AsyncLogRing*)ring)->owner, NULL);
+}
+
+static AsyncLogRing *
+getThreadRing(AsyncLogContext *ctx) {
+    if(cachedContextId == ctx->id)
+        return cachedRing;
+
+    /* Find the ring of the thread or claim a free one */
+    void *token = &threadToken;
+    AsyncLogRing *ring = NULL;
+    for(size_t i = 0; i < ctx->ringsSize; i++) {
+        if(UA_atomic_load(&ctx->rings[i].owner) == token) {
+            ring = &ctx->rings[i];
+            break;
+        }
+    }
+    /* Prefer a released ring that was already drained by the flush */
+    for(size_t i = 0; !ring && i < ctx->ringsSize; i++) {
+        AsyncLogRing *r = &ctx->rings[i];
+        if(UA_atomic_load(&r->owner) != NULL ||
+           UA_atomic_load(&r->head) != UA_atomic_load(&r->tail))
+            continue;
+        if(UA_atomic_cmpxchg(&r->owner, NULL, token) == NULL)
+            ring = r;
+    }
+    for(size_t i = 0; !ring && i < ctx->ringsSize; i++) {
+        if(UA_atomic_cmpxchg(&ctx->rings[i].owner, NULL, token) == NULL)
+            ring = &ctx->rings[i];
+    }
+    if(!ring)
+        return NULL;
+
+#ifdef UA_LOG_ASYNC_THREADKEY
+    if(ctx->hasThreadKey)
+        pthread_setspecific(ctx->threadKey, ring);
+#endif
+
+    cachedContextId = ctx->id;
+    cachedRing = ring;
+    return ring;
+}
+
+#ifdef __clang__
+__attribute__((__format__(__printf__, 4 , 0)))
+#endif
+static void
+UA_Log_Async_log(void *context, UA_LogLevel level, UA_LogCategory category,
+                 const char *msg, va_list args) {
+    AsyncLogContext *ctx = (AsyncLogContext*)context;
+    if(ctx->minLevel > level)
+        return;
+
+    AsyncLogRing *ring = getThreadRing(ctx);
+    if(!ring) {
+        atomicIncrement(&ctx->unclaimedDropped);
+        return;
+    }
+
+    /* Ring full -> drop */
+    uintptr_t head = (uintptr_t)ring->head;
+    uintptr_t tail = (uintptr_t)UA_atomic_load(&ring->tail);
+    if(head - tail >= ctx->ringSize) {
+        UA_atomic_xchg(&ring->dropped, (void*)((uintptr_t)ring->dropped + 1));
+        return;
+    }
+
+    /* Only the message text is formatted here. The arguments can point to
+     * memory of the caller that is gone when the flush happens. */
+    AsyncLogEntry *entry = &ring->entries[head & (ctx->ringSize - 1)];
+    entry->time = UA_DateTime_now();
+    entry->level = level;
+    entry->category = category;
+    mp_vsnprintf(entry->msg, ASYNC_LOG_MSGSIZE, msg, args);
+
+    /* Publish the entry */
+    UA_atomic_xchg(&ring->head, (void*)(head + 1));
+}
+
+static size_t
+writeLine(char *pos, UA_Int64 tOffset, UA_DateTime time,
+          const char *level, const char *category, const char *msg) {
+    UA_DateTimeStruct dts = UA_DateTime_toStruct(time + tOffset);
+    int len = snprintf(pos, ASYNC_LOG_LINESIZE,
+                       "[%04u-%02u-%02u %02u:%02u:%02u.%03u (UTC%+05d)] %s/%s"
+                       ANSI_COLOR_RESET "\t%s\n",
+                       dts.year, dts.month, dts.day, dts.hour, dts.min, dts.sec,
+                       dts.milliSec, (int)(tOffset / UA_DATETIME_SEC / 36),
+                       level, category, msg);
+    if(len < 0)
+        return 0;
+    if(len >= ASYNC_LOG_LINESIZE)
+        len = ASYNC_LOG_LINESIZE - 1; /* Truncated */
+    return (size_t)len;
+}
+
+static size_t
+writeDropped(char *pos, UA_Int64 tOffset, size_t dropped) {
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%lu log messages dropped", (unsigned long)dropped);
+    return writeLine(pos, tOffset, UA_DateTime_now(),
+                     asyncLogLevelNames[3], "logger", msg);
+}
+
+size_t
+UA_Log_Async_flush(UA_Logger *logger) {
+    AsyncLogContext *ctx = (AsyncLogContext*)logger->context;
+    while(UA_atomic_cmpxchg(&ctx->flushLock, NULL, (void*)0x1) != NULL) {}
+
+    /* The offset is computed once per batch */
+    UA_Int64 tOffset = UA_DateTime_localTimeUtcOffset();
+    size_t written = 0;
+    size_t outPos = 0;
+    for(size_t i = 0; i < ctx->ringsSize; i++) {
+        AsyncLogRing *ring = &ctx->rings[i];
+        uintptr_t head = (uintptr_t)UA_atomic_load(&ring->head);
+        uintptr_t tail = (uintptr_t)ring->tail;
+        for(; tail != head; tail++) {
+            if(ASYNC_LOG_OUTBUFSIZE - outPos < ASYNC_LOG_LINESIZE) {
+                fwrite(ctx->outbuf, 1, outPos, stdout);
+                outPos = 0;
+            }
+            AsyncLogEntry *entry = &ring->entries[tail & (ctx->ringSize - 1)];
+            int logLevelSlot = ((int)entry->level / 100) - 1;
+            if(logLevelSlot < 0 || logLevelSlot > 5)
+                logLevelSlot = 5; /* Set to fatal if the level is outside the range */
+            outPos += writeLine(&ctx->outbuf[outPos], tOffset, entry->time,
+                                asyncLogLevelNames[logLevelSlot],
+                                asyncLogCategoryNames[entry->category], entry->msg);
+            written++;
+        }
+
+        /* Release the entries */
+        UA_atomic_xchg(&ring->tail, (void*)tail);
+
+        /* Report dropped messages */
+        size_t dropped = (size_t)(uintptr_t)UA_atomic_load(&ring->dropped);
+        if(dropped != ring->reportedDropped) {
+            if(ASYNC_LOG_OUTBUFSIZE - outPos < ASYNC_LOG_LINESIZE) {
+                fwrite(ctx->outbuf, 1, outPos, stdout);
+                outPos = 0;
+            }
+            outPos += writeDropped(&ctx->outbuf[outPos], tOffset,
+                                   dropped - ring->reportedDropped);
+            ring->reportedDropped = dropped;
+        }
+    }
+
+    size_t unclaimed = (size_t)(uintptr_t)UA_atomic_load(&ctx->unclaimedDropped);
+    if(unclaimed != ctx->reportedUnclaimedDropped) {
+        if(ASYNC_LOG_OUTBUFSIZE - outPos < ASYNC_LOG_LINESIZE) {
+            fwrite(ctx->outbuf, 1, outPos, stdout);
+            outPos = 0;
+        }
+        outPos += writeDropped(&ctx->outbuf[outPos], tOffset,
+                               unclaimed - ctx->reportedUnclaimedDropped);
+        ctx->reportedUnclaimedDropped = unclaimed;
+    }
+
+    if(outPos > 0) {
+        fwrite(ctx->outbuf, 1, outPos, stdout);
+        fflush(stdout);
+    }
+
+    UA_atomic_xchg(&ctx->flushLock, NULL);
+    return written;
+}
+
+size_t
+UA_Log_Async_dropped(const UA_Logger *logger) {
+    AsyncLogContext *ctx = (AsyncLogContext*)logger->context;
+    size_t dropped = (size_t)(uintptr_t)UA_atomic_load(&ctx->unclaimedDropped);
+    for(size_t i = 0; i < ctx->ringsSize; i++)
+        dropped += (size_t)(uintptr_t)UA_atomic_load(&ctx->rings[i].dropped);
+    return dropped;
+}
+
+void
+UA_Log_Async_releaseThread(UA_Logger *logger) {
+    AsyncLogContext *ctx = (AsyncLogContext*)logger->context;
+    void *token = &threadToken;
+    for(size_t i = 0; i < ctx->ringsSize; i++) {
+        if(UA_atomic_load(&ctx->rings[i].owner) == token) {
+            releaseRing(&ctx->rings[i]);
+            break;
+        }
+    }
+#ifdef UA_LOG_ASYNC_THREADKEY
+    if(ctx->hasThreadKey)
+        pthread_setspecific(ctx->threadKey, NULL);
+#endif
+    if(cachedContextId == ctx->id) {
+        cachedContextId = 0;
+        cachedRing = NULL;
+    }
+}
+
+static void
+UA_Log_Async_clear(UA_Logger *logger) {
+    AsyncLogContext *ctx = (AsyncLogContext*)logger->context;
+    UA_Log_Async_flush(logger);
+#ifdef UA_LOG_ASYNC_THREADKEY
+    if(ctx->hasThreadKey)
+        pthread_key_delete(ctx->threadKey);
+#endif
+    for(size_t i = 0; i < ctx->ringsSize; i++)
+        UA_free(ctx->rings[i].entries);
+    UA_free(ctx->rings);
+    UA_free(ctx);
+    UA_free(logger);
+}
+
+UA_Logger *
+UA_Log_Async_new(UA_LogLevel minlevel, size_t maxThreads, size_t ringSize) {
+    if(maxThreads == 0 || ringSize == 0)
+        return NULL;
+
+    /* Round up to a power of two */
+    size_t size = 1;
+    while(size < ringSize)
+        size <<= 1;
+
+    UA_Logger *logger = (UA_Logger*)UA_malloc(sizeof(UA_Logger));
+    AsyncLogContext *ctx = (AsyncLogContext*)UA_calloc(1, sizeof(AsyncLogContext));
+    AsyncLogRing *rings = (AsyncLogRing*)UA_calloc(maxThreads, sizeof(AsyncLogRing));
+    if(!logger || !ctx || !rings)
+        goto error;
+
+    ctx->id = atomicIncrement(&lastContextId);
+    ctx->minLevel = minlevel;
+    ctx->ringSize = size;
+    ctx->ringsSize = maxThreads;
+    ctx->rings = rings;
+    for(size_t i = 0; i < maxThreads; i++) {
+        rings[i].entries = (AsyncLogEntry*)UA_malloc(size * sizeof(AsyncLogEntry));
+        if(!rings[i].entries)
+            goto error;
+    }
+
+#ifdef UA_LOG_ASYNC_THREADKEY
+    /* Without the key, the rings are released only explicitly */
+    ctx->hasThreadKey = (pthread_key_create(&ctx->threadKey, releaseRing) == 0);
+#endif
+
+    logger->log = UA_Log_Async_log;
+    logger->context = ctx;
+    logger->clear = UA_Log_Async_clear;
+    return logger;
+
+ error:
+    if(rings) {
+        for(size_t i = 0; i < maxThreads; i++)
+            UA_free(rings[i].entries);
+    }
+    UA_free(rings);
+    UA_free(ctx);
+    UA_free(logger);
+    return NULL;
+}
@@ -28,6 +28,40 @@
 static void
 clientHouseKeeping(UA_Client *client, void *_);
 
+/* The outstanding AsyncServiceCalls are indexed by their RequestId (to match
+ * responses) and by their deadline (to time out the oldest first) */
+static enum ZIP_CMP
+cmpRequestId(const UA_UInt32 *a, const UA_UInt32 *b) {
+    if(*a == *b)
+        return ZIP_CMP_EQ;
+    return (*a < *b) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+}
+
+static enum ZIP_CMP
+cmpDeadline(const UA_DateTime *a, const UA_DateTime *b) {
+    if(*a == *b)
+        return ZIP_CMP_EQ;
+    return (*a < *b) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+}
+
+ZIP_FUNCTIONS(UA_AsyncServiceIdTree, AsyncServiceCall, idTreeEntry,
+              UA_UInt32, requestId, cmpRequestId)
+ZIP_FUNCTIONS(UA_AsyncServiceTimeoutTree, AsyncServiceCall, timeoutTreeEntry,
+              UA_DateTime, deadline, cmpDeadline)
+
+static void
+insertAsyncServiceCall(UA_Client *client, AsyncServiceCall *ac) {
+    ac->deadline = ac->start + ((UA_DateTime)ac->timeout * UA_DATETIME_MSEC);
+    ZIP_INSERT(UA_AsyncServiceIdTree, &client->asyncServiceCalls, ac);
+    ZIP_INSERT(UA_AsyncServiceTimeoutTree, &client->asyncServiceTimeouts, ac);
+}
+
+static void
+removeAsyncServiceCall(UA_Client *client, AsyncServiceCall *ac) {
+    ZIP_REMOVE(UA_AsyncServiceIdTree, &client->asyncServiceCalls, ac);
+    ZIP_REMOVE(UA_AsyncServiceTimeoutTree, &client->asyncServiceTimeouts, ac);
+}
+
 /********************/
 /* Client Lifecycle */
 /********************/
@@ -63,6 +97,8 @@ UA_ClientConfig_copy(UA_ClientConfig const *src, UA_ClientConfig *dst){
 
     dst->sessionLocaleIdsSize = src->sessionLocaleIdsSize;
     dst->connectivityCheckInterval = src->connectivityCheckInterval;
+    dst->splitRequests = src->splitRequests;
+    dst->splitRequestsWindow = src->splitRequestsWindow;
     dst->certificateVerification = src->certificateVerification;
     dst->clientContext = src->clientContext;
     dst->customDataTypes = src->customDataTypes;
@@ -432,11 +468,8 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     UA_ClientConfig *config = &client->config;
 
     /* Find the callback */
-    AsyncServiceCall *ac;
-    LIST_FOREACH(ac, &client->asyncServiceCalls, pointers) {
-        if(ac->requestId == requestId)
-            break;
-    }
+    AsyncServiceCall *ac =
+        ZIP_FIND(UA_AsyncServiceIdTree, &client->asyncServiceCalls, &requestId);
 
     /* Part 6, 6.7.6: After the security validation is complete the receiver
      * shall verify the RequestId and the SequenceNumber. If these checks fail a
@@ -454,7 +487,7 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     const UA_DataType *responseType = ac->responseType;
 
     /* Dequeue ac. We might disconnect the client (remove all ac) in the callback. */
-    LIST_REMOVE(ac, pointers);
+    removeAsyncServiceCall(client, ac);
 
     /* Decode the response type */
     size_t offset = 0;
@@ -693,10 +726,10 @@ __Client_Service(UA_Client *client, const void *request,
     if(ac.timeout == 0)
         ac.timeout = UA_UINT32_MAX; /* 0 -> unlimited */
 
-    LIST_INSERT_HEAD(&client->asyncServiceCalls, &ac, pointers);
+    insertAsyncServiceCall(client, &ac);
 
     /* Time until which the request has to be answered */
-    UA_DateTime maxDate = ac.start + ((UA_DateTime)ac.timeout * UA_DATETIME_MSEC);
+    UA_DateTime maxDate = ac.deadline;
 
     /* Run the EventLoop until the request was processed, the request has timed
      * out or the client connection fails */
@@ -730,7 +763,7 @@ __Client_Service(UA_Client *client, const void *request,
         }
 
         /* Update the remaining timeout or break */
-        UA_DateTime now = ac.start = el->dateTime_nowMonotonic(el);
+        UA_DateTime now = el->dateTime_nowMonotonic(el);
         if(now > maxDate) {
             retval = UA_STATUSCODE_BADTIMEOUT;
             break;
@@ -738,8 +771,8 @@ __Client_Service(UA_Client *client, const void *request,
         timeout_remaining = (UA_UInt32)((maxDate - now) / UA_DATETIME_MSEC);
     }
 
-    /* Detach from the internal async service list */
-    LIST_REMOVE(&ac, pointers);
+    /* Detach from the internal async service trees */
+    removeAsyncServiceCall(client, &ac);
 
     /* Return the status code */
     respHeader->serviceResult = retval;
@@ -777,17 +810,18 @@ __Client_AsyncService_cancel(UA_Client *client, AsyncServiceCall *ac,
 void
 __Client_AsyncService_removeAll(UA_Client *client, UA_StatusCode statusCode) {
     /* Make this function reentrant. One of the async callbacks could indirectly
-     * operate on the list. Moving all elements to a local list before iterating
-     * that. */
-    UA_AsyncServiceList asyncServiceCalls = client->asyncServiceCalls;
-    LIST_INIT(&client->asyncServiceCalls);
-    if(asyncServiceCalls.lh_first)
-        asyncServiceCalls.lh_first->pointers.le_prev = &asyncServiceCalls.lh_first;
-
-    /* Cancel and remove the elements from the local list */
-    AsyncServiceCall *ac, *ac_tmp;
-    LIST_FOREACH_SAFE(ac, &asyncServiceCalls, pointers, ac_tmp) {
-        LIST_REMOVE(ac, pointers);
+     * operate on the trees. Moving all elements to local trees before iterating
+     * them. */
+    UA_AsyncServiceIdTree asyncServiceCalls = client->asyncServiceCalls;
+    UA_AsyncServiceTimeoutTree asyncServiceTimeouts = client->asyncServiceTimeouts;
+    ZIP_INIT(&client->asyncServiceCalls);
+    ZIP_INIT(&client->asyncServiceTimeouts);
+
+    /* Cancel and remove the elements from the local trees */
+    AsyncServiceCall *ac;
+    while((ac = ZIP_MIN(UA_AsyncServiceIdTree, &asyncServiceCalls))) {
+        ZIP_REMOVE(UA_AsyncServiceIdTree, &asyncServiceCalls, ac);
+        ZIP_REMOVE(UA_AsyncServiceTimeoutTree, &asyncServiceTimeouts, ac);
         __Client_AsyncService_cancel(client, ac, statusCode);
     }
 }
@@ -837,7 +871,7 @@ __Client_AsyncService(UA_Client *client, const void *request,
     if(ac->timeout == 0)
         ac->timeout = UA_UINT32_MAX; /* 0 -> unlimited */
 
-    LIST_INSERT_HEAD(&client->asyncServiceCalls, ac, pointers);
+    insertAsyncServiceCall(client, ac);
 
     /* Return the generated request id */
     if(requestId)
@@ -879,13 +913,10 @@ UA_Client_cancelByRequestId(UA_Client *client, UA_UInt32 requestId,
                             UA_UInt32 *cancelCount) {
     lockClient(client);
     UA_StatusCode res = UA_STATUSCODE_BADNOTFOUND;
-    AsyncServiceCall *ac;
-    LIST_FOREACH(ac, &client->asyncServiceCalls, pointers) {
-        if(ac->requestId != requestId)
-            continue;
+    AsyncServiceCall *ac =
+        ZIP_FIND(UA_AsyncServiceIdTree, &client->asyncServiceCalls, &requestId);
+    if(ac)
         res = cancelByRequestHandle(client, ac->requestHandle, cancelCount);
-        break;
-    }
     unlockClient(client);
     return res;
 }
@@ -948,26 +979,16 @@ UA_Client_removeCallback(UA_Client *client, UA_UInt64 callbackId) {
 
 static void
 asyncServiceTimeoutCheck(UA_Client *client) {
-    /* Make this function reentrant. One of the async callbacks could indirectly
-     * operate on the list. Moving all elements to a local list before iterating
-     * that. */
+    /* Only the calls with the earliest deadlines are visited. The minimum is
+     * looked up again after every callback, as the callbacks could indirectly
+     * operate on the trees. */
     UA_EventLoop *el = client->config.eventLoop;
     UA_DateTime now = el->dateTime_nowMonotonic(el);
-    UA_AsyncServiceList asyncServiceCalls;
-    AsyncServiceCall *ac, *ac_tmp;
-    LIST_INIT(&asyncServiceCalls);
-    LIST_FOREACH_SAFE(ac, &client->asyncServiceCalls, pointers, ac_tmp) {
-        if(!ac->timeout)
-           continue;
-        if(ac->start + (UA_DateTime)(ac->timeout * UA_DATETIME_MSEC) <= now) {
-            LIST_REMOVE(ac, pointers);
-            LIST_INSERT_HEAD(&asyncServiceCalls, ac, pointers);
-        }
-    }
-
-    /* Cancel and remove the elements from the local list */
-    LIST_FOREACH_SAFE(ac, &asyncServiceCalls, pointers, ac_tmp) {
-        LIST_REMOVE(ac, pointers);
+    AsyncServiceCall *ac;
+    while((ac = ZIP_MIN(UA_AsyncServiceTimeoutTree, &client->asyncServiceTimeouts))) {
+        if(ac->deadline > now)
+            break;
+        removeAsyncServiceCall(client, ac);
         __Client_AsyncService_cancel(client, ac, UA_STATUSCODE_BADTIMEOUT);
     }
 }
@@ -1319,6 +1340,352 @@ UA_Client_connectUsername(UA_Client *client, const char *endpointUrl,
 /* Service Shorthands */
 /**********************/
 
+/*****************************/
+/* Splitting of Large Requests */
+/*****************************/
+
+/* Describes where the operations and results are located in the request and
+ * response of a service that can be split */
+typedef struct {
+    UA_UInt16 requestTypeIndex;
+    UA_UInt16 responseTypeIndex;
+    UA_UInt16 operationTypeIndex;
+    UA_UInt16 resultTypeIndex;
+    size_t operationsSizeOffset;
+    size_t operationsOffset;
+    size_t resultsSizeOffset;
+    size_t resultsOffset;
+    size_t diagnosticInfosSizeOffset;
+    size_t diagnosticInfosOffset;
+} SplitService;
+
+#define SPLIT_SERVICE(REQ, RESP, OP, RES, ops)                          \
+    {UA_TYPES_##REQ##REQUEST, UA_TYPES_##REQ##RESPONSE, UA_TYPES_##OP,   \
+     UA_TYPES_##RES, offsetof(UA_##RESP##Request, ops##Size),           \
+     offsetof(UA_##RESP##Request, ops),                                 \
+     offsetof(UA_##RESP##Response, resultsSize),                        \
+     offsetof(UA_##RESP##Response, results),                            \
+     offsetof(UA_##RESP##Response, diagnosticInfosSize),                \
+     offsetof(UA_##RESP##Response, diagnosticInfos)}
+
+/* In the order of client->operationLimits */
+static const SplitService splitServices[4] = {
+    SPLIT_SERVICE(READ, Read, READVALUEID, DATAVALUE, nodesToRead),
+    SPLIT_SERVICE(WRITE, Write, WRITEVALUE, STATUSCODE, nodesToWrite),
+    SPLIT_SERVICE(CALL, Call, CALLMETHODREQUEST, CALLMETHODRESULT, methodsToCall),
+    SPLIT_SERVICE(BROWSE, Browse, BROWSEDESCRIPTION, BROWSERESULT, nodesToBrowse)
+};
+
+enum {
+    SPLIT_READ = 0,
+    SPLIT_WRITE = 1,
+    SPLIT_CALL = 2,
+    SPLIT_BROWSE = 3
+};
+
+#define SPLIT_FIELD(ptr, offset, type) (*(type*)((uintptr_t)(ptr) + (offset)))
+
+/* Reserved in the message for the request header and the security overhead */
+#define SPLIT_MESSAGE_RESERVE 1024
+
+static void
+readOperationLimits(UA_Client *client) {
+    static const UA_UInt32 limitIds[4] = {
+        UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD,
+        UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERWRITE,
+        UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERMETHODCALL,
+        UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE};
+
+    UA_ReadValueId rvid[4];
+    for(size_t i = 0; i < 4; i++) {
+        UA_ReadValueId_init(&rvid[i]);
+        rvid[i].nodeId = UA_NODEID_NUMERIC(0, limitIds[i]);
+        rvid[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = rvid;
+    request.nodesToReadSize = 4;
+    UA_ReadResponse response;
+    __Client_Service(client, &request, &UA_TYPES[UA_TYPES_READREQUEST],
+                     &response, &UA_TYPES[UA_TYPES_READRESPONSE]);
+
+    /* Don't retry if the connection is not established. Otherwise the limits
+     * are considered as read also if the server does not provide them. */
+    if(response.responseHeader.serviceResult == UA_STATUSCODE_GOOD ||
+       isFullyConnected(client)) {
+        client->operationLimitsRead = true;
+        for(size_t i = 0; i < 4; i++) {
+            client->operationLimits[i] = 0;
+            if(i < response.resultsSize && response.results[i].hasValue &&
+               UA_Variant_hasScalarType(&response.results[i].value,
+                                        &UA_TYPES[UA_TYPES_UINT32]))
+                client->operationLimits[i] = *(UA_UInt32*)response.results[i].value.data;
+        }
+    }
+    UA_ReadResponse_clear(&response);
+}
+
+/* Returns the end of the chunk that begins at the operation index start. The
+ * end is given by the OperationLimit and the maximum message size. The
+ * operations are only sized for the next chunk, while the previous chunks are
+ * already in flight. */
+static size_t
+nextSplitEnd(const SplitService *ss, const void *ops, size_t opsSize,
+             size_t start, UA_UInt32 limit, size_t maxSize) {
+    size_t end = opsSize;
+    if(limit > 0 && opsSize - start > limit)
+        end = start + limit;
+    if(maxSize == 0)
+        return end;
+
+    const UA_DataType *opType = &UA_TYPES[ss->operationTypeIndex];
+    size_t size = 0;
+    for(size_t i = start; i < end; i++) {
+        size += UA_calcSizeBinary((const void*)((uintptr_t)ops + i * opType->memSize),
+                                  opType, NULL);
+        if(i > start && size > maxSize)
+            return i;
+    }
+    return end;
+}
+
+typedef struct SplitContext SplitContext;
+
+typedef struct SplitChunk SplitChunk;
+
+struct SplitChunk {
+    SplitContext *ctx;
+    size_t start;
+    size_t count;
+    UA_UInt32 requestId;
+    UA_Boolean done;
+    SplitChunk *next;
+};
+
+struct SplitContext {
+    const SplitService *ss;
+    void *response;
+    size_t inFlight;
+    UA_StatusCode status;
+};
+
+static void
+splitChunkCallback(UA_Client *client, void *userdata,
+                   UA_UInt32 requestId, void *chunkResponse) {
+    SplitChunk *chunk = (SplitChunk*)userdata;
+    SplitContext *ctx = chunk->ctx;
+    const SplitService *ss = ctx->ss;
+    chunk->done = true;
+    ctx->inFlight--;
+
+    /* Take the ResponseHeader of the first chunk */
+    UA_ResponseHeader *rh = (UA_ResponseHeader*)chunkResponse;
+    if(chunk->start == 0) {
+        UA_ResponseHeader *dst = (UA_ResponseHeader*)ctx->response;
+        UA_ResponseHeader_clear(dst);
+        *dst = *rh;
+        UA_ResponseHeader_init(rh);
+    }
+
+    if(ctx->status != UA_STATUSCODE_GOOD)
+        return;
+    if(rh->serviceResult != UA_STATUSCODE_GOOD) {
+        ctx->status = rh->serviceResult;
+        return;
+    }
+
+    /* Move the results into the position in the overall response */
+    size_t *resultsSize = &SPLIT_FIELD(chunkResponse, ss->resultsSizeOffset, size_t);
+    void **results = &SPLIT_FIELD(chunkResponse, ss->resultsOffset, void*);
+    if(*resultsSize != chunk->count) {
+        ctx->status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        return;
+    }
+    const UA_DataType *resultType = &UA_TYPES[ss->resultTypeIndex];
+    void *dst = SPLIT_FIELD(ctx->response, ss->resultsOffset, void*);
+    memcpy((void*)((uintptr_t)dst + chunk->start * resultType->memSize),
+           *results, chunk->count * resultType->memSize);
+    UA_free(*results);
+    *results = NULL;
+    *resultsSize = 0;
+
+    /* Move the DiagnosticInfos if they were returned */
+    size_t *diagSize = &SPLIT_FIELD(chunkResponse, ss->diagnosticInfosSizeOffset, size_t);
+    UA_DiagnosticInfo **diag =
+        &SPLIT_FIELD(chunkResponse, ss->diagnosticInfosOffset, UA_DiagnosticInfo*);
+    if(*diagSize != chunk->count)
+        return;
+    size_t totalSize = SPLIT_FIELD(ctx->response, ss->resultsSizeOffset, size_t);
+    UA_DiagnosticInfo **dstDiag =
+        &SPLIT_FIELD(ctx->response, ss->diagnosticInfosOffset, UA_DiagnosticInfo*);
+    if(!*dstDiag) {
+        *dstDiag = (UA_DiagnosticInfo*)
+            UA_Array_new(totalSize, &UA_TYPES[UA_TYPES_DIAGNOSTICINFO]);
+        if(!*dstDiag)
+            return;
+        SPLIT_FIELD(ctx->response, ss->diagnosticInfosSizeOffset, size_t) = totalSize;
+    }
+    memcpy(&(*dstDiag)[chunk->start], *diag, chunk->count * sizeof(UA_DiagnosticInfo));
+    UA_free(*diag);
+    *diag = NULL;
+    *diagSize = 0;
+}
+
+/* Synchronous service call that splits the request according to the
+ * OperationLimits. The partial requests are pipelined through the async
+ * service machinery with a window of splitRequestsWindow. */
+static void
+__Client_Service_split(UA_Client *client, size_t splitIndex,
+                       const void *request, void *response) {
+    const SplitService *ss = &splitServices[splitIndex];
+    const UA_DataType *requestType = &UA_TYPES[ss->requestTypeIndex];
+    const UA_DataType *responseType = &UA_TYPES[ss->responseTypeIndex];
+    if(!client->config.splitRequests)
+        goto nosplit;
+
+    /* Read the limits once per Session */
+    if(!client->operationLimitsRead)
+        readOperationLimits(client);
+    UA_UInt32 limit = client->operationLimits[splitIndex];
+    size_t maxSize = client->channel.config.remoteMaxMessageSize;
+    if(maxSize > 0)
+        maxSize = (maxSize > 2 * SPLIT_MESSAGE_RESERVE) ?
+            maxSize - SPLIT_MESSAGE_RESERVE : maxSize / 2;
+
+    /* Is a split required? */
+    size_t opsSize = SPLIT_FIELD(request, ss->operationsSizeOffset, size_t);
+    const void *ops = SPLIT_FIELD(request, ss->operationsOffset, void*);
+    if(opsSize <= 1 || (limit == 0 && maxSize == 0))
+        goto nosplit;
+    size_t end = nextSplitEnd(ss, ops, opsSize, 0, limit, maxSize);
+    if(end == opsSize)
+        goto nosplit;
+
+    /* Prepare the overall response */
+    UA_init(response, responseType);
+    const UA_DataType *resultType = &UA_TYPES[ss->resultTypeIndex];
+    void *results = UA_Array_new(opsSize, resultType);
+    if(!results) {
+        ((UA_ResponseHeader*)response)->serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+    SPLIT_FIELD(response, ss->resultsSizeOffset, size_t) = opsSize;
+    SPLIT_FIELD(response, ss->resultsOffset, void*) = results;
+
+    SplitContext ctx;
+    memset(&ctx, 0, sizeof(SplitContext));
+    ctx.ss = ss;
+    ctx.response = response;
+
+    /* The partial requests are shallow copies with a slice of the operations */
+    union {
+        UA_ReadRequest read;
+        UA_WriteRequest write;
+        UA_CallRequest call;
+        UA_BrowseRequest browse;
+    } chunkRequest;
+    memcpy(&chunkRequest, request, requestType->memSize);
+
+    const UA_RequestHeader *rh = (const UA_RequestHeader*)request;
+    UA_UInt32 timeout = (rh->timeoutHint > 0) ? rh->timeoutHint : client->config.timeout;
+    if(timeout == 0)
+        timeout = UA_UINT32_MAX; /* 0 -> unlimited */
+    UA_EventLoop *el = client->config.eventLoop;
+    UA_DateTime maxDate = el->dateTime_nowMonotonic(el) +
+        ((UA_DateTime)timeout * UA_DATETIME_MSEC);
+    UA_UInt32 channelId = client->channel.securityToken.channelId;
+    size_t window = (client->config.splitRequestsWindow > 0) ?
+        client->config.splitRequestsWindow : 1;
+    const UA_DataType *opType = &UA_TYPES[ss->operationTypeIndex];
+    SplitChunk *chunks = NULL; /* List of the sent chunks */
+    size_t start = 0;
+    while(true) {
+        /* Fill the window */
+        while(ctx.status == UA_STATUSCODE_GOOD && start < opsSize &&
+              ctx.inFlight < window) {
+            if(start > 0)
+                end = nextSplitEnd(ss, ops, opsSize, start, limit, maxSize);
+            SplitChunk *chunk = (SplitChunk*)UA_calloc(1, sizeof(SplitChunk));
+            if(!chunk) {
+                ctx.status = UA_STATUSCODE_BADOUTOFMEMORY;
+                break;
+            }
+            chunk->ctx = &ctx;
+            chunk->start = start;
+            chunk->count = end - start;
+            chunk->next = chunks;
+            chunks = chunk;
+            SPLIT_FIELD(&chunkRequest, ss->operationsSizeOffset, size_t) = chunk->count;
+            SPLIT_FIELD(&chunkRequest, ss->operationsOffset, const void*) =
+                (const void*)((uintptr_t)ops + start * opType->memSize);
+            UA_StatusCode res =
+                __Client_AsyncService(client, &chunkRequest, requestType,
+                                      splitChunkCallback, responseType,
+                                      chunk, &chunk->requestId);
+            if(res != UA_STATUSCODE_GOOD) {
+                chunk->done = true;
+                ctx.status = res;
+                break;
+            }
+            ctx.inFlight++;
+            start = end;
+        }
+
+        /* All done or aborted */
+        if((start == opsSize && ctx.inFlight == 0) ||
+           ctx.status != UA_STATUSCODE_GOOD)
+            break;
+
+        /* Process the responses */
+        UA_DateTime now = el->dateTime_nowMonotonic(el);
+        if(now > maxDate) {
+            ctx.status = UA_STATUSCODE_BADTIMEOUT;
+            break;
+        }
+        UA_StatusCode res = el->run(el, (UA_UInt32)((maxDate - now) / UA_DATETIME_MSEC));
+        if(res == UA_STATUSCODE_GOOD)
+            res = client->connectStatus;
+        if(res == UA_STATUSCODE_GOOD &&
+           channelId != client->channel.securityToken.channelId)
+            res = UA_STATUSCODE_BADSECURECHANNELCLOSED;
+        if(res != UA_STATUSCODE_GOOD) {
+            ctx.status = res;
+            break;
+        }
+    }
+
+    /* Detach the partial requests that are still outstanding. Their responses
+     * are dropped when they arrive. */
+    while(chunks) {
+        SplitChunk *chunk = chunks;
+        chunks = chunk->next;
+        if(!chunk->done) {
+            AsyncServiceCall *ac =
+                ZIP_FIND(UA_AsyncServiceIdTree, &client->asyncServiceCalls,
+                         &chunk->requestId);
+            if(ac) {
+                ac->callback = NULL;
+                ac->userdata = NULL;
+            }
+        }
+        UA_free(chunk);
+    }
+
+    /* Return only the status code if a partial request failed */
+    if(ctx.status != UA_STATUSCODE_GOOD) {
+        UA_ResponseHeader rhCopy = *(UA_ResponseHeader*)response;
+        UA_ResponseHeader_init((UA_ResponseHeader*)response);
+        UA_clear(response, responseType);
+        *(UA_ResponseHeader*)response = rhCopy;
+        ((UA_ResponseHeader*)response)->serviceResult = ctx.status;
+    }
+    return;
+
+ nosplit:
+    __Client_Service(client, request, requestType, response, responseType);
+}
+
 void
 __UA_Client_Service(UA_Client *client, const void *request,
                     const UA_DataType *requestType, void *response,
@@ -1331,16 +1698,18 @@ __UA_Client_Service(UA_Client *client, const void *request,
 UA_ReadResponse
 UA_Client_Service_read(UA_Client *client, const UA_ReadRequest request) {
     UA_ReadResponse response;
-    __UA_Client_Service(client, &request, &UA_TYPES[UA_TYPES_READREQUEST],
-                        &response, &UA_TYPES[UA_TYPES_READRESPONSE]);
+    lockClient(client);
+    __Client_Service_split(client, SPLIT_READ, &request, &response);
+    unlockClient(client);
     return response;
 }
 
 UA_WriteResponse
 UA_Client_Service_write(UA_Client *client, const UA_WriteRequest request) {
     UA_WriteResponse response;
-    __UA_Client_Service(client, &request, &UA_TYPES[UA_TYPES_WRITEREQUEST],
-                        &response, &UA_TYPES[UA_TYPES_WRITERESPONSE]);
+    lockClient(client);
+    __Client_Service_split(client, SPLIT_WRITE, &request, &response);
+    unlockClient(client);
     return response;
 }
 
@@ -1366,8 +1735,9 @@ UA_CallResponse
 UA_Client_Service_call(UA_Client *client,
                        const UA_CallRequest request) {
     UA_CallResponse response;
-    __UA_Client_Service(client, &request, &UA_TYPES[UA_TYPES_CALLREQUEST],
-                        &response, &UA_TYPES[UA_TYPES_CALLRESPONSE]);
+    lockClient(client);
+    __Client_Service_split(client, SPLIT_CALL, &request, &response);
+    unlockClient(client);
     return response;
 }
 
@@ -1411,8 +1781,9 @@ UA_BrowseResponse
 UA_Client_Service_browse(UA_Client *client,
                          const UA_BrowseRequest request) {
     UA_BrowseResponse response;
-    __UA_Client_Service(client, &request, &UA_TYPES[UA_TYPES_BROWSEREQUEST],
-                        &response, &UA_TYPES[UA_TYPES_BROWSERESPONSE]);
+    lockClient(client);
+    __Client_Service_split(client, SPLIT_BROWSE, &request, &response);
+    unlockClient(client);
     return response;
 }
 
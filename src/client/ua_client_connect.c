@@ -2444,6 +2444,7 @@ cleanupSession(UA_Client *client) {
     UA_NodeId_clear(&client->sessionId);
     UA_NodeId_clear(&client->authenticationToken);
     client->requestHandle = 0;
+    client->operationLimitsRead = false;
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* We need to clean up the subscriptions */
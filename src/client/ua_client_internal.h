@@ -54,17 +54,22 @@ typedef struct MonitorItemsTree MonitorItemsTree;
 
 typedef struct UA_Client_Subscription {
     LIST_ENTRY(UA_Client_Subscription) listEntry;
+    ZIP_ENTRY(UA_Client_Subscription) idTreeEntry; /* Sorted by the subscriptionId */
     UA_UInt32 subscriptionId;
     void *context;
     UA_Double publishingInterval;
     UA_UInt32 maxKeepAliveCount;
     UA_Client_StatusChangeNotificationCallback statusChangeCallback;
     UA_Client_DeleteSubscriptionCallback deleteCallback;
+    UA_Client_DataChangeBatchCallback dataChangeBatchCallback; /* Replaces the
+                                                                * per-item callbacks */
     UA_UInt32 sequenceNumber;
     UA_DateTime lastActivity;
     MonitorItemsTree monitoredItems;
 } UA_Client_Subscription;
 
+typedef ZIP_HEAD(UA_SubscriptionIdTree, UA_Client_Subscription) UA_SubscriptionIdTree;
+
 void
 __Client_Subscriptions_clear(UA_Client *client);
 
@@ -72,6 +77,11 @@ __Client_Subscriptions_clear(UA_Client *client);
 UA_StatusCode
 __Client_preparePublishRequest(UA_Client *client, UA_PublishRequest *request);
 
+/* Exposed for testing */
+void
+__Client_Subscriptions_processPublishResponse(UA_Client *client, UA_PublishRequest *request,
+                                              UA_PublishResponse *response);
+
 void
 __Client_Subscriptions_backgroundPublish(UA_Client *client);
 
@@ -83,7 +93,8 @@ __Client_Subscriptions_backgroundPublishInactivityCheck(UA_Client *client);
 /**********/
 
 typedef struct AsyncServiceCall {
-    LIST_ENTRY(AsyncServiceCall) pointers;
+    ZIP_ENTRY(AsyncServiceCall) idTreeEntry;      /* Sorted by the requestId */
+    ZIP_ENTRY(AsyncServiceCall) timeoutTreeEntry; /* Sorted by the deadline */
     UA_UInt32 requestId;     /* Unique id */
     UA_UInt32 requestHandle; /* Potentially non-unique if manually defined in
                               * the request header*/
@@ -92,12 +103,14 @@ typedef struct AsyncServiceCall {
     void *userdata;
     UA_DateTime start;
     UA_UInt32 timeout;
+    UA_DateTime deadline; /* start + timeout */
     UA_Response *syncResponse; /* If non-null, then this is the synchronous
                                 * response to be filled. Set back to null to
                                 * indicate that the response was filled. */
 } AsyncServiceCall;
 
-typedef LIST_HEAD(UA_AsyncServiceList, AsyncServiceCall) UA_AsyncServiceList;
+typedef ZIP_HEAD(UA_AsyncServiceIdTree, AsyncServiceCall) UA_AsyncServiceIdTree;
+typedef ZIP_HEAD(UA_AsyncServiceTimeoutTree, AsyncServiceCall) UA_AsyncServiceTimeoutTree;
 
 void
 __Client_AsyncService_removeAll(UA_Client *client, UA_StatusCode statusCode);
@@ -169,11 +182,18 @@ struct UA_Client {
     UA_Boolean pendingConnectivityCheck;
 
     /* Async Service */
-    UA_AsyncServiceList asyncServiceCalls;
+    UA_AsyncServiceIdTree asyncServiceCalls;
+    UA_AsyncServiceTimeoutTree asyncServiceTimeouts;
+
+    /* OperationLimits of the server for splitting large requests (0 ->
+     * unlimited). Read once per Session if config.splitRequests is set. */
+    UA_Boolean operationLimitsRead;
+    UA_UInt32 operationLimits[4]; /* Read, Write, Call, Browse */
 
     /* Subscriptions */
     LIST_HEAD(, UA_Client_NotificationsAckNumber) pendingNotificationsAcks;
     LIST_HEAD(, UA_Client_Subscription) subscriptions;
+    UA_SubscriptionIdTree subscriptionIds; /* Index of the subscriptions */
     UA_UInt32 monitoredItemHandles;
     UA_UInt16 currentlyOutStandingPublishRequests;
 
@@ -41,6 +41,20 @@ UA_ClientHandle_cmp(const void *a, const void *b) {
 ZIP_FUNCTIONS(MonitorItemsTree, UA_Client_MonitoredItem, zipfields,
               UA_Client_MonitoredItem, zipfields, UA_ClientHandle_cmp)
 
+static enum ZIP_CMP
+cmpSubscriptionId(const void *a, const void *b) {
+    const UA_UInt32 *aa = (const UA_UInt32*)a;
+    const UA_UInt32 *bb = (const UA_UInt32*)b;
+    if(*aa < *bb)
+        return ZIP_CMP_LESS;
+    if(*aa > *bb)
+        return ZIP_CMP_MORE;
+    return ZIP_CMP_EQ;
+}
+
+ZIP_FUNCTIONS(UA_SubscriptionIdTree, UA_Client_Subscription, idTreeEntry,
+              UA_UInt32, subscriptionId, cmpSubscriptionId)
+
 static void
 MonitoredItem_delete(UA_Client *client, UA_Client_Subscription *sub,
                      UA_Client_MonitoredItem *mon);
@@ -57,8 +71,10 @@ ua_Subscriptions_create(UA_Client *client, UA_Client_Subscription *newSub,
     newSub->lastActivity = el->dateTime_nowMonotonic(el);
     newSub->publishingInterval = response->revisedPublishingInterval;
     newSub->maxKeepAliveCount = response->revisedMaxKeepAliveCount;
+    newSub->dataChangeBatchCallback = NULL;
     ZIP_INIT(&newSub->monitoredItems);
     LIST_INSERT_HEAD(&client->subscriptions, newSub, listEntry);
+    ZIP_INSERT(UA_SubscriptionIdTree, &client->subscriptionIds, newSub);
 
     /* Immediately send the first publish requests if there are none
      * outstanding */
@@ -155,13 +171,8 @@ UA_Client_Subscriptions_create_async(UA_Client *client, const UA_CreateSubscript
 }
 
 static UA_Client_Subscription *
-findSubscriptionById(const UA_Client *client, UA_UInt32 subscriptionId) {
-    UA_Client_Subscription *sub = NULL;
-    LIST_FOREACH(sub, &client->subscriptions, listEntry) {
-        if(sub->subscriptionId == subscriptionId)
-            break;
-    }
-    return sub;
+findSubscriptionById(UA_Client *client, UA_UInt32 subscriptionId) {
+    return ZIP_FIND(UA_SubscriptionIdTree, &client->subscriptionIds, &subscriptionId);
 }
 
 static void
@@ -229,6 +240,25 @@ UA_Client_Subscriptions_setContext(UA_Client *client, UA_UInt32 subscriptionId,
 	return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_Client_Subscriptions_setDataChangeBatchCallback(UA_Client *client,
+                                                   UA_UInt32 subscriptionId,
+                                                   UA_Client_DataChangeBatchCallback callback) {
+    if(!client)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    lockClient(client);
+    UA_Client_Subscription *sub = findSubscriptionById(client, subscriptionId);
+    if(!sub) {
+        unlockClient(client);
+        return UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID;
+    }
+
+    sub->dataChangeBatchCallback = callback;
+    unlockClient(client);
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_ModifySubscriptionResponse
 UA_Client_Subscriptions_modify(UA_Client *client,
                                const UA_ModifySubscriptionRequest request) {
@@ -328,6 +358,7 @@ __Client_Subscription_deleteInternal(UA_Client *client,
 
     /* Remove */
     LIST_REMOVE(sub, listEntry);
+    ZIP_REMOVE(UA_SubscriptionIdTree, &client->subscriptionIds, sub);
     UA_free(sub);
 }
 
@@ -1188,11 +1219,69 @@ __nextSequenceNumber(UA_UInt32 sequenceNumber) {
     return nextSequenceNumber;
 }
 
+/* Stack space for the contexts of a batch. Larger batches are allocated. */
+#define UA_CLIENT_BATCH_CONTEXTS 64
+
+static void
+processDataChangeNotificationBatch(UA_Client *client, UA_Client_Subscription *sub,
+                                   UA_DataChangeNotification *dataChangeNotification) {
+    UA_LOCK_ASSERT(&client->clientMutex);
+
+    size_t notificationsSize = dataChangeNotification->monitoredItemsSize;
+    if(notificationsSize == 0)
+        return;
+
+    void *contextsBuf[UA_CLIENT_BATCH_CONTEXTS];
+    void **contexts = contextsBuf;
+    if(notificationsSize > UA_CLIENT_BATCH_CONTEXTS) {
+        contexts = (void**)UA_malloc(notificationsSize * sizeof(void*));
+        if(!contexts) {
+            UA_LOG_WARNING(client->config.logging, UA_LOGCATEGORY_CLIENT,
+                           "Not enough memory to process the DataChangeNotification "
+                           "on subscription %" PRIu32, sub->subscriptionId);
+            return;
+        }
+    }
+
+    /* Look up the MonitoredItem contexts. Notifications from the queue of the
+     * same MonitoredItem are adjacent and reuse the last lookup. */
+    UA_Client_MonitoredItem *mon = NULL;
+    for(size_t j = 0; j < notificationsSize; ++j) {
+        UA_UInt32 clientHandle = dataChangeNotification->monitoredItems[j].clientHandle;
+        if(!mon || mon->clientHandle != clientHandle) {
+            UA_Client_MonitoredItem dummy;
+            dummy.clientHandle = clientHandle;
+            mon = ZIP_FIND(MonitorItemsTree, &sub->monitoredItems, &dummy);
+        }
+        if(!mon || mon->isEventMonitoredItem) {
+            UA_LOG_WARNING(client->config.logging, UA_LOGCATEGORY_CLIENT,
+                           "Could not process a notification with clienthandle %" PRIu32
+                           " on subscription %" PRIu32, clientHandle, sub->subscriptionId);
+            contexts[j] = NULL;
+            continue;
+        }
+        contexts[j] = mon->context;
+    }
+
+    /* The notifications are handed over directly from the decoded message */
+    sub->dataChangeBatchCallback(client, sub->subscriptionId, sub->context,
+                                 notificationsSize, dataChangeNotification->monitoredItems,
+                                 contexts);
+
+    if(contexts != contextsBuf)
+        UA_free(contexts);
+}
+
 static void
 processDataChangeNotification(UA_Client *client, UA_Client_Subscription *sub,
                               UA_DataChangeNotification *dataChangeNotification) {
     UA_LOCK_ASSERT(&client->clientMutex);
 
+    if(sub->dataChangeBatchCallback) {
+        processDataChangeNotificationBatch(client, sub, dataChangeNotification);
+        return;
+    }
+
     for(size_t j = 0; j < dataChangeNotification->monitoredItemsSize; ++j) {
         UA_MonitoredItemNotification *min = &dataChangeNotification->monitoredItems[j];
 
@@ -1314,7 +1403,7 @@ processNotificationMessage(UA_Client *client, UA_Client_Subscription *sub,
                    "Unknown notification message type");
 }
 
-static void
+void
 __Client_Subscriptions_processPublishResponse(UA_Client *client, UA_PublishRequest *request,
                                               UA_PublishResponse *response) {
     UA_LOCK_ASSERT(&client->clientMutex);
@@ -34,6 +34,13 @@ UA_PublishedDataSetConfig_copy(const UA_PublishedDataSetConfig *src,
             //no additional items
             break;
 
+        case UA_PUBSUB_DATASET_PUBLISHEDEVENTS:
+            res |= UA_NodeId_copy(&src->config.event.eventNotfier,
+                                  &dst->config.event.eventNotfier);
+            res |= UA_ContentFilter_copy(&src->config.event.filter,
+                                         &dst->config.event.filter);
+            break;
+
         case UA_PUBSUB_DATASET_PUBLISHEDITEMS_TEMPLATE:
             if(src->config.itemsTemplate.variablesToAddSize > 0) {
                 dst->config.itemsTemplate.variablesToAdd = (UA_PublishedVariableDataType *)
@@ -97,6 +104,10 @@ UA_PublishedDataSetConfig_clear(UA_PublishedDataSetConfig *pdsConfig) {
         case UA_PUBSUB_DATASET_PUBLISHEDITEMS:
             //no additional items
             break;
+        case UA_PUBSUB_DATASET_PUBLISHEDEVENTS:
+            UA_NodeId_clear(&pdsConfig->config.event.eventNotfier);
+            UA_ContentFilter_clear(&pdsConfig->config.event.filter);
+            break;
         case UA_PUBSUB_DATASET_PUBLISHEDITEMS_TEMPLATE:
             if(pdsConfig->config.itemsTemplate.variablesToAddSize > 0){
                 for(size_t i = 0; i < pdsConfig->config.itemsTemplate.variablesToAddSize; i++){
@@ -111,10 +122,36 @@ UA_PublishedDataSetConfig_clear(UA_PublishedDataSetConfig *pdsConfig) {
     }
 }
 
+/* The type of an event field is only known when the event is emitted. Event
+ * fields are always encoded as Variant. */
+static UA_StatusCode
+generateEventFieldMetaData(UA_PubSubManager *psm, UA_DataSetField *field) {
+    UA_FieldMetaData *fmd = &field->fieldMetaData;
+    const UA_DataSetEventConfig *ev = &field->config.field.event;
+
+    UA_StatusCode res = UA_String_copy(&ev->fieldNameAlias, &fmd->name);
+    res |= UA_LocalizedText_copy(&ev->description, &fmd->description);
+    UA_CHECK_STATUS(res, return res);
+
+    fmd->fieldFlags = UA_DATASETFIELDFLAGS_NONE;
+    fmd->dataType = UA_NS0ID(BASEDATATYPE);
+    fmd->builtInType = UA_DATATYPEKIND_VARIANT + 1; /* Builtin type index from Part 6 */
+    fmd->valueRank = UA_VALUERANK_ANY;
+
+    if(!UA_Guid_equal(&ev->dataSetFieldId, &UA_GUID_NULL)) {
+        fmd->dataSetFieldId = ev->dataSetFieldId;
+    } else {
+        fmd->dataSetFieldId = UA_PubSubManager_generateUniqueGuid(psm);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
 /* The fieldMetaData variable has to be cleaned up external in case of an error */
 static UA_StatusCode
 generateFieldMetaData(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
                       UA_DataSetField *field) {
+    if(field->config.dataSetFieldType == UA_PUBSUB_DATASETFIELD_EVENT)
+        return generateEventFieldMetaData(psm, field);
     if(field->config.dataSetFieldType != UA_PUBSUB_DATASETFIELD_VARIABLE)
         return UA_STATUSCODE_BADNOTSUPPORTED;
 
@@ -224,6 +261,31 @@ generateFieldMetaData(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
     return UA_STATUSCODE_GOOD;
 }
 
+/* Collect the SelectClauses of the event fields in a contiguous array. They are
+ * evaluated together with the filter of the PublishedDataSet as one
+ * EventFilter. */
+static void
+compileSelectClauses(UA_PubSubManager *psm, UA_PublishedDataSet *pds) {
+    UA_free(pds->selectClauses);
+    pds->selectClauses = NULL;
+    pds->selectClausesSize = 0;
+    if(pds->config.publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDEVENTS ||
+       pds->fieldSize == 0)
+        return;
+
+    pds->selectClauses = (UA_SimpleAttributeOperand*)
+        UA_malloc(pds->fieldSize * sizeof(UA_SimpleAttributeOperand));
+    if(!pds->selectClauses) {
+        UA_LOG_ERROR_PUBSUB(psm->logging, pds,
+                            "Compiling the SelectClauses failed. Out of Memory.");
+        return;
+    }
+
+    UA_DataSetField *dsf;
+    TAILQ_FOREACH(dsf, &pds->fields, listEntry)
+        pds->selectClauses[pds->selectClausesSize++] = dsf->config.field.event.selectedField;
+}
+
 UA_DataSetFieldResult
 UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
                        const UA_DataSetFieldConfig *fieldConfig,
@@ -250,10 +312,27 @@ UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
         return result;
     }
 
-    if(currDS->config.publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDITEMS) {
+    /* Variables are published in PublishedItems and event fields in
+     * PublishedEvents */
+    UA_DataSetFieldType fieldType;
+    switch(currDS->config.publishedDataSetType) {
+    case UA_PUBSUB_DATASET_PUBLISHEDITEMS:
+        fieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+        break;
+    case UA_PUBSUB_DATASET_PUBLISHEDEVENTS:
+        fieldType = UA_PUBSUB_DATASETFIELD_EVENT;
+        break;
+    default:
         result.result = UA_STATUSCODE_BADNOTIMPLEMENTED;
         return result;
     }
+    if(fieldConfig->dataSetFieldType != fieldType) {
+        UA_LOG_WARNING_PUBSUB(psm->logging, currDS,
+                              "Adding DataSetField failed: The field type does "
+                              "not match the PublishedDataSet type");
+        result.result = UA_STATUSCODE_BADCONFIGURATIONERROR;
+        return result;
+    }
 
     UA_DataSetField *newField = (UA_DataSetField*)UA_calloc(1, sizeof(UA_DataSetField));
     if(!newField) {
@@ -300,11 +379,15 @@ UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
 
     /* Register the field. The order of DataSetFields should be the same in both
      * creating and publishing. So adding DataSetFields at the the end of the
-     * DataSets using the TAILQ structure. */
+     * DataSets using the TAILQ structure. The field nodes are resolved again
+     * for the next sample. */
+    UA_PublishedDataSet_releaseFieldNodes(psm, currDS);
     TAILQ_INSERT_TAIL(&currDS->fields, newField, listEntry);
     currDS->fieldSize++;
+    compileSelectClauses(psm, currDS);
 
-    if(newField->config.field.variable.promotedField)
+    if(newField->config.dataSetFieldType == UA_PUBSUB_DATASETFIELD_VARIABLE &&
+       newField->config.field.variable.promotedField)
         currDS->promotedFieldsCount++;
 
     /* Update major version of parent published data set */
@@ -345,7 +428,8 @@ UA_DataSetField_remove(UA_PubSubManager *psm, UA_DataSetField *currentField) {
     }
 
     /* Reduce the counters before the config is cleaned up */
-    if(currentField->config.field.variable.promotedField)
+    if(currentField->config.dataSetFieldType == UA_PUBSUB_DATASETFIELD_VARIABLE &&
+       currentField->config.field.variable.promotedField)
         pds->promotedFieldsCount--;
 
     /* Remove field from DataSetMetaData */
@@ -368,10 +452,12 @@ UA_DataSetField_remove(UA_PubSubManager *psm, UA_DataSetField *currentField) {
     }
 
     /* Remove */
+    UA_PublishedDataSet_releaseFieldNodes(psm, pds);
     pds->fieldSize--;
     TAILQ_REMOVE(&pds->fields, currentField, listEntry);
     UA_DataSetField_clear(currentField);
     UA_free(currentField);
+    compileSelectClauses(psm, pds);
 
     /* Update major version of PublishedDataSet */
     UA_EventLoop *el = psm->sc.server->config.eventLoop;
@@ -389,16 +475,26 @@ UA_DataSetField_remove(UA_PubSubManager *psm, UA_DataSetField *currentField) {
 UA_StatusCode
 UA_DataSetFieldConfig_copy(const UA_DataSetFieldConfig *src,
                            UA_DataSetFieldConfig *dst) {
-    if(src->dataSetFieldType != UA_PUBSUB_DATASETFIELD_VARIABLE)
+    if(src->dataSetFieldType != UA_PUBSUB_DATASETFIELD_VARIABLE &&
+       src->dataSetFieldType != UA_PUBSUB_DATASETFIELD_EVENT)
         return UA_STATUSCODE_BADNOTSUPPORTED;
     memcpy(dst, src, sizeof(UA_DataSetFieldConfig));
     UA_StatusCode res = UA_STATUSCODE_GOOD;
-    res |= UA_String_copy(&src->field.variable.fieldNameAlias,
-                          &dst->field.variable.fieldNameAlias);
-    res |= UA_PublishedVariableDataType_copy(&src->field.variable.publishParameters,
-                                             &dst->field.variable.publishParameters);
-    res |= UA_LocalizedText_copy(&src->field.variable.description,
-                                   &dst->field.variable.description);
+    if(src->dataSetFieldType == UA_PUBSUB_DATASETFIELD_EVENT) {
+        res |= UA_String_copy(&src->field.event.fieldNameAlias,
+                              &dst->field.event.fieldNameAlias);
+        res |= UA_SimpleAttributeOperand_copy(&src->field.event.selectedField,
+                                              &dst->field.event.selectedField);
+        res |= UA_LocalizedText_copy(&src->field.event.description,
+                                     &dst->field.event.description);
+    } else {
+        res |= UA_String_copy(&src->field.variable.fieldNameAlias,
+                              &dst->field.variable.fieldNameAlias);
+        res |= UA_PublishedVariableDataType_copy(&src->field.variable.publishParameters,
+                                                 &dst->field.variable.publishParameters);
+        res |= UA_LocalizedText_copy(&src->field.variable.description,
+                                       &dst->field.variable.description);
+    }
     if(res != UA_STATUSCODE_GOOD)
         UA_DataSetFieldConfig_clear(dst);
     return res;
@@ -425,23 +521,71 @@ UA_DataSetFieldConfig_clear(UA_DataSetFieldConfig *dataSetFieldConfig) {
         UA_String_clear(&dataSetFieldConfig->field.variable.fieldNameAlias);
         UA_PublishedVariableDataType_clear(&dataSetFieldConfig->field.variable.publishParameters);
         UA_LocalizedText_clear(&dataSetFieldConfig->field.variable.description);
+    } else if(dataSetFieldConfig->dataSetFieldType == UA_PUBSUB_DATASETFIELD_EVENT) {
+        UA_String_clear(&dataSetFieldConfig->field.event.fieldNameAlias);
+        UA_SimpleAttributeOperand_clear(&dataSetFieldConfig->field.event.selectedField);
+        UA_LocalizedText_clear(&dataSetFieldConfig->field.event.description);
     }
 }
 
-/* Obtain the latest value for a specific DataSetField. This method is currently
- * called inside the DataSetMessage generation process. */
 void
-UA_PubSubDataSetField_sampleValue(UA_PubSubManager *psm, UA_DataSetField *field,
-                                  UA_DataValue *value) {
-    UA_PublishedVariableDataType *params = &field->config.field.variable.publishParameters;
+UA_PublishedDataSet_releaseFieldNodes(UA_PubSubManager *psm,
+                                      UA_PublishedDataSet *pds) {
+    UA_DataSetField *dsf;
+    TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
+        if(dsf->node)
+            UA_NODESTORE_RELEASE(psm->sc.server, dsf->node);
+        dsf->node = NULL;
+    }
+    pds->fieldNodesResolved = false;
+}
 
-    UA_ReadValueId rvid;
-    UA_ReadValueId_init(&rvid);
-    rvid.nodeId = params->publishedVariable;
-    rvid.attributeId = params->attributeId;
-    rvid.indexRange = params->indexRange;
-    *value = readWithSession(psm->sc.server, &psm->sc.server->adminSession,
-                             &rvid, UA_TIMESTAMPSTORETURN_BOTH);
+/* Resolve the nodes of the published variables. The nodes are kept until no
+ * DataSetWriter uses the PublishedDataSet or the nodestoreGeneration changes.
+ * Fields that cannot be resolved are sampled via the Read service. */
+static void
+resolveFieldNodes(UA_PubSubManager *psm, UA_PublishedDataSet *pds) {
+    UA_Server *server = psm->sc.server;
+    UA_PublishedDataSet_releaseFieldNodes(psm, pds);
+    UA_DataSetField *dsf;
+    TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
+        const UA_NodeId *nodeId =
+            UA_Session_resolveNodeId(&server->adminSession,
+                                     &dsf->config.field.variable.publishParameters.
+                                     publishedVariable);
+        dsf->node = UA_NODESTORE_GET(server, nodeId);
+    }
+    pds->fieldNodesResolved = true;
+    pds->fieldNodesGeneration = server->nodestoreGeneration;
+}
+
+/* Obtain the latest values of the DataSetFields. This method is currently
+ * called inside the DataSetMessage generation process. */
+void
+UA_PublishedDataSet_sampleValues(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
+                                 UA_DataValue *values, UA_Boolean borrow) {
+    UA_Server *server = psm->sc.server;
+    if(!pds->fieldNodesResolved ||
+       pds->fieldNodesGeneration != server->nodestoreGeneration)
+        resolveFieldNodes(psm, pds);
+
+    size_t i = 0;
+    UA_DataSetField *dsf;
+    TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
+        UA_PublishedVariableDataType *params =
+            &dsf->config.field.variable.publishParameters;
+        UA_ReadValueId rvid;
+        UA_ReadValueId_init(&rvid);
+        rvid.nodeId = params->publishedVariable;
+        rvid.attributeId = params->attributeId;
+        rvid.indexRange = params->indexRange;
+        values[i] = (dsf->node) ?
+            readResolvedAttribute(server, &server->adminSession, dsf->node,
+                                  &rvid, UA_TIMESTAMPSTORETURN_BOTH, borrow) :
+            readWithSession(server, &server->adminSession,
+                            &rvid, UA_TIMESTAMPSTORETURN_BOTH);
+        i++;
+    }
 }
 
 UA_AddPublishedDataSetResult
@@ -460,7 +604,11 @@ UA_PublishedDataSet_create(UA_PubSubManager *psm,
         return result;
     }
 
-    if(publishedDataSetConfig->publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDITEMS){
+    if(publishedDataSetConfig->publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDITEMS
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+       && publishedDataSetConfig->publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDEVENTS
+#endif
+       ) {
         UA_LOG_ERROR(psm->logging, UA_LOGCATEGORY_PUBSUB,
                      "PublishedDataSet creation failed. Unsupported PublishedDataSet type.");
         return result;
@@ -518,9 +666,9 @@ UA_PublishedDataSet_create(UA_PubSubManager *psm,
         UA_PubSubConfigurationVersionTimeDifference(el->dateTime_now(el));
     switch(newConfig->publishedDataSetType) {
     case UA_PUBSUB_DATASET_PUBLISHEDEVENTS_TEMPLATE:
-    case UA_PUBSUB_DATASET_PUBLISHEDEVENTS:
         res = UA_STATUSCODE_BADNOTSUPPORTED;
         break;
+    case UA_PUBSUB_DATASET_PUBLISHEDEVENTS:
     case UA_PUBSUB_DATASET_PUBLISHEDITEMS:
         newPDS->dataSetMetaData.configurationVersion.majorVersion =
             UA_PubSubConfigurationVersionTimeDifference(el->dateTime_now(el));
@@ -549,6 +697,8 @@ UA_PublishedDataSet_create(UA_PubSubManager *psm,
     /* Insert into the queue of the manager */
     TAILQ_INSERT_TAIL(&psm->publishedDataSets, newPDS, listEntry);
     psm->publishedDataSetsSize++;
+    if(newConfig->publishedDataSetType == UA_PUBSUB_DATASET_PUBLISHEDEVENTS)
+        psm->publishedEventsSize++;
 
 #ifdef UA_ENABLE_PUBSUB_INFORMATIONMODEL
     /* Create representation and unique id */
@@ -602,14 +752,18 @@ UA_PublishedDataSet_remove(UA_PubSubManager *psm, UA_PublishedDataSet *pds) {
     /* Unlink from the server */
     TAILQ_REMOVE(&psm->publishedDataSets, pds, listEntry);
     psm->publishedDataSetsSize--;
+    if(pds->config.publishedDataSetType == UA_PUBSUB_DATASET_PUBLISHEDEVENTS)
+        psm->publishedEventsSize--;
 
     /* Clean up the PublishedDataSet */
+    UA_PublishedDataSet_releaseFieldNodes(psm, pds);
     UA_DataSetField *field, *tmpField;
     TAILQ_FOREACH_SAFE(field, &pds->fields, listEntry, tmpField) {
         UA_DataSetField_clear(field);
         TAILQ_REMOVE(&pds->fields, field, listEntry);
         UA_free(field);
     }
+    UA_free(pds->selectClauses);
     UA_PublishedDataSetConfig_clear(&pds->config);
     UA_DataSetMetaDataType_clear(&pds->dataSetMetaData);
     UA_PubSubComponentHead_clear(&pds->head);
@@ -618,6 +772,101 @@ UA_PublishedDataSet_remove(UA_PubSubManager *psm, UA_PublishedDataSet *pds) {
     return UA_STATUSCODE_GOOD;
 }
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+static UA_Boolean
+isEmitNode(const UA_NodeId *nodeId, const UA_ExpandedNodeId *emitNodes,
+           size_t emitNodesSize) {
+    for(size_t i = 0; i < emitNodesSize; i++) {
+        if(UA_ExpandedNodeId_isLocal(&emitNodes[i]) &&
+           UA_NodeId_equal(nodeId, &emitNodes[i].nodeId))
+            return true;
+    }
+    return false;
+}
+
+/* The EventFilter of the PublishedDataSet is evaluated once per event. The
+ * selected fields are then queued in all operational DataSetWriters. */
+static void
+publishEvent(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
+             UA_FilterEvalContext *ctx) {
+    ctx->session = &psm->sc.server->adminSession;
+    ctx->filter.selectClausesSize = pds->selectClausesSize;
+    ctx->filter.selectClauses = pds->selectClauses;
+    ctx->filter.whereClause = pds->config.config.event.filter;
+
+    UA_EventFieldList efl;
+    UA_EventFieldList_init(&efl);
+    UA_StatusCode res = evaluateWhereClause(ctx);
+    if(res == UA_STATUSCODE_GOOD)
+        res = evaluateSelectClause(ctx, &efl);
+    UA_FilterEvalContext_reset(ctx);
+    if(res != UA_STATUSCODE_GOOD) {
+        if(res != UA_STATUSCODE_BADNOMATCH)
+            UA_LOG_WARNING_PUBSUB(psm->logging, pds,
+                                  "Evaluating the EventFilter failed with "
+                                  "StatusCode %s", UA_StatusCode_name(res));
+        UA_EventFieldList_clear(&efl);
+        return;
+    }
+
+    /* The last DataSetWriter takes ownership of the fields */
+    UA_DataSetWriter *last = NULL;
+    UA_PubSubConnection *c;
+    TAILQ_FOREACH(c, &psm->connections, listEntry) {
+        UA_WriterGroup *wg;
+        LIST_FOREACH(wg, &c->writerGroups, listEntry) {
+            UA_DataSetWriter *dsw;
+            LIST_FOREACH(dsw, &wg->writers, listEntry) {
+                if(dsw->connectedDataSet != pds ||
+                   dsw->head.state != UA_PUBSUBSTATE_OPERATIONAL)
+                    continue;
+                if(last) {
+                    UA_Variant *fields = NULL;
+                    res = UA_Array_copy(efl.eventFields, efl.eventFieldsSize,
+                                        (void**)&fields, &UA_TYPES[UA_TYPES_VARIANT]);
+                    if(res == UA_STATUSCODE_GOOD)
+                        UA_DataSetWriter_enqueueEvent(psm, last, fields,
+                                                      efl.eventFieldsSize);
+                }
+                last = dsw;
+            }
+        }
+    }
+
+    if(last) {
+        UA_DataSetWriter_enqueueEvent(psm, last, efl.eventFields, efl.eventFieldsSize);
+        efl.eventFields = NULL;
+        efl.eventFieldsSize = 0;
+    }
+    UA_EventFieldList_clear(&efl);
+}
+
+void
+UA_PubSubManager_createEvent(UA_Server *server, const UA_ExpandedNodeId *emitNodes,
+                             size_t emitNodesSize, UA_FilterEvalContext *ctx) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_PubSubManager *psm = getPSM(server);
+    if(!psm || psm->publishedEventsSize == 0)
+        return;
+
+    UA_PublishedDataSet *pds;
+    TAILQ_FOREACH(pds, &psm->publishedDataSets, listEntry) {
+        /* Skip if no DataSetWriter is enabled or the SelectClauses could not
+         * be compiled */
+        if(pds->config.publishedDataSetType != UA_PUBSUB_DATASET_PUBLISHEDEVENTS ||
+           pds->configurationFreezeCounter == 0 || pds->fieldSize == 0 ||
+           pds->selectClausesSize != pds->fieldSize)
+            continue;
+        if(!isEmitNode(&pds->config.config.event.eventNotfier,
+                       emitNodes, emitNodesSize))
+            continue;
+        publishEvent(psm, pds, ctx);
+    }
+}
+
+#endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
+
 UA_SubscribedDataSet *
 UA_SubscribedDataSet_find(UA_PubSubManager *psm, const UA_NodeId id) {
     if(!psm)
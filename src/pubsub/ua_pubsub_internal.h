@@ -172,6 +172,17 @@ typedef struct UA_PublishedDataSet {
     /* The counter is required because the PDS has not state.
      * Check if it is actively used when changes are introduced. */
     UA_UInt16 configurationFreezeCounter;
+
+    /* The nodes of the fields are resolved when the fields are first sampled.
+     * Resolved again if the nodestoreGeneration has changed. */
+    UA_Boolean fieldNodesResolved;
+    UA_UInt64 fieldNodesGeneration;
+
+    /* PublishedEvents: The SelectClauses of the event fields in the order of
+     * the fields. Shallow copies of the field configs. Rebuilt when a field is
+     * added or removed. */
+    size_t selectClausesSize;
+    UA_SimpleAttributeOperand *selectClauses;
 } UA_PublishedDataSet;
 
 UA_StatusCode
@@ -277,6 +288,16 @@ typedef struct UA_DataSetWriterSample {
     UA_DataValue value;
 } UA_DataSetWriterSample;
 
+/* Events are queued in the DataSetWriter until the next publish. If the queue
+ * is full, the oldest event is dropped. */
+#define UA_DATASETWRITER_MAXEVENTQUEUESIZE 256
+
+typedef struct UA_DataSetWriterEvent {
+    TAILQ_ENTRY(UA_DataSetWriterEvent) listEntry;
+    size_t fieldsSize;
+    UA_Variant *fields;
+} UA_DataSetWriterEvent;
+
 typedef struct UA_DataSetWriter {
     UA_PubSubComponentHead head;
     LIST_ENTRY(UA_DataSetWriter) listEntry;
@@ -291,6 +312,12 @@ typedef struct UA_DataSetWriter {
     size_t lastSamplesCount;
     UA_DataSetWriterSample *lastSamples;
 
+    /* PublishedEvents */
+    TAILQ_HEAD(, UA_DataSetWriterEvent) eventQueue;
+    size_t eventQueueSize;
+    size_t eventQueueOverflows; /* Dropped since the last publish */
+    UA_DateTime lastEventMessage; /* Event or KeepAlive, for the KeepAliveTime */
+
     UA_UInt16 actualDataSetMessageSequenceCount;
     UA_Boolean configurationFrozen;
     UA_UInt64 pubSubStateTimerId;
@@ -321,6 +348,12 @@ UA_DataSetWriter_create(UA_PubSubManager *psm,
 UA_StatusCode
 UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw);
 
+/* Queue the selected fields of an event. Takes ownership of the fields array
+ * also if an error is returned. */
+UA_StatusCode
+UA_DataSetWriter_enqueueEvent(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
+                              UA_Variant *fields, size_t fieldsSize);
+
 /**********************************************/
 /*               WriterGroup                  */
 /**********************************************/
@@ -400,6 +433,7 @@ typedef struct UA_DataSetField {
     UA_FieldMetaData fieldMetaData; /* contains the dataSetFieldId */
     UA_UInt64 sampleCallbackId;
     UA_Boolean sampleCallbackIsRegistered;
+    const UA_Node *node; /* Resolved for sampling. NULL -> Read service */
 } UA_DataSetField;
 
 UA_StatusCode
@@ -417,24 +451,68 @@ UA_DataSetField_create(UA_PubSubManager *psm, const UA_NodeId publishedDataSet,
                        const UA_DataSetFieldConfig *fieldConfig,
                        UA_NodeId *fieldIdentifier);
 
+/* Sample the values of all fields in one pass. The values array has
+ * pds->fieldSize entries. With borrow, values stored in the nodes are not
+ * copied. They must be cleared before the server is unlocked. */
 void
-UA_PubSubDataSetField_sampleValue(UA_PubSubManager *psm,
-                                  UA_DataSetField *field,
-                                  UA_DataValue *value);
+UA_PublishedDataSet_sampleValues(UA_PubSubManager *psm, UA_PublishedDataSet *pds,
+                                 UA_DataValue *values, UA_Boolean borrow);
+
+/* Release the resolved nodes of the fields */
+void
+UA_PublishedDataSet_releaseFieldNodes(UA_PubSubManager *psm,
+                                      UA_PublishedDataSet *pds);
 
 /**********************************************/
 /*               DataSetReader                */
 /**********************************************/
 
+/* Identifies the DataSetMessages that are processed by a DataSetReader. The
+ * PublisherId is a shallow copy from the config. */
+typedef struct {
+    UA_PublisherId publisherId;
+    UA_UInt16 writerGroupId;
+    UA_UInt16 dataSetWriterId;
+} UA_DataSetReaderKey;
+
+/* Target variable of a DataSetReader that was resolved from the nodestore. The
+ * node is held until the Reader leaves the (pre)operational state. */
+typedef struct {
+    UA_VariableNode *node; /* NULL -> write via the Write service */
+    const UA_DataType *checkedType; /* Passed the type check for the node */
+} UA_DataSetReaderTarget;
+
 struct UA_DataSetReader {
     UA_PubSubComponentHead head;
     LIST_ENTRY(UA_DataSetReader) listEntry;
 
+    /* Index of the Readers in the ReaderGroup. Set up when the Reader is
+     * created and when the config is updated. */
+    ZIP_ENTRY(UA_DataSetReader) keyTreeEntry;
+    UA_DataSetReaderKey key;
+    UA_Boolean indexed;
+
     UA_DataSetReaderConfig config;
     UA_ReaderGroup *linkedReaderGroup;
 
-    /* MessageReceiveTimeout handling */
+    /* MessageReceiveTimeout handling. The timer is not modified for every
+     * received message. When it fires, it is moved to expire
+     * MessageReceiveTimeout after the last received message (monotonic
+     * time). */
     UA_UInt64 msgRcvTimeoutTimerId;
+    UA_DateTime lastMessageReceived;
+
+    /* DeltaFrames are applied only on top of a received KeyFrame and without
+     * gaps in the SequenceNumbers of the DataSetMessages */
+    UA_Boolean keyFrameReceived;
+    UA_Boolean hasSequenceNr;
+    UA_UInt16 lastSequenceNr;
+
+    /* Resolved with the first received message. Resolved again if the
+     * nodestoreGeneration has changed. */
+    size_t targetsSize;
+    UA_DataSetReaderTarget *targets;
+    UA_UInt64 targetsGeneration;
 };
 
 UA_DataSetReader *
@@ -476,6 +554,8 @@ UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
 /*                ReaderGroup                 */
 /**********************************************/
 
+typedef ZIP_HEAD(UA_DataSetReaderKeyTree, UA_DataSetReader) UA_DataSetReaderKeyTree;
+
 struct UA_ReaderGroup {
     UA_PubSubComponentHead head;
     LIST_ENTRY(UA_ReaderGroup) listEntry;
@@ -484,6 +564,7 @@ struct UA_ReaderGroup {
 
     LIST_HEAD(, UA_DataSetReader) readers;
     UA_UInt32 readersCount;
+    UA_DataSetReaderKeyTree readersByKey; /* Dispatch of received messages */
 
     UA_Boolean hasReceived; /* Received a message since the last _connect */
 
@@ -517,6 +598,14 @@ UA_ReaderGroup_connect(UA_PubSubManager *psm, UA_ReaderGroup *rg,
 UA_Boolean
 UA_ReaderGroup_canConnect(UA_ReaderGroup *rg);
 
+/* Add the Reader to the index of the ReaderGroup with the identifiers from the
+ * current config. And remove it from the index again. */
+void
+UA_ReaderGroup_indexReader(UA_ReaderGroup *rg, UA_DataSetReader *dsr);
+
+void
+UA_ReaderGroup_unindexReader(UA_ReaderGroup *rg, UA_DataSetReader *dsr);
+
 void
 UA_ReaderGroup_disconnect(UA_ReaderGroup *rg);
 
@@ -629,6 +718,7 @@ struct UA_PubSubManager {
 
     size_t publishedDataSetsSize;
     TAILQ_HEAD(, UA_PublishedDataSet) publishedDataSets;
+    size_t publishedEventsSize; /* PublishedDataSets of type PublishedEvents */
 
     size_t subscribedDataSetsSize;
     TAILQ_HEAD(, UA_SubscribedDataSet) subscribedDataSets;
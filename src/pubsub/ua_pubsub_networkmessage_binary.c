@@ -1405,6 +1405,16 @@ UA_DataSetMessage_deltaFrame_encodeBinary(PubSubEncodeCtx *ctx,
     return rv;
 }
 
+/* Part 14: The event fields are always encoded as Variant */
+static UA_StatusCode
+UA_DataSetMessage_event_encodeBinary(PubSubEncodeCtx *ctx,
+                                     const UA_DataSetMessage *src) {
+    UA_StatusCode rv = _ENCODE_BINARY(&src->fieldCount, UINT16);
+    for(UA_UInt16 i = 0; i < src->fieldCount; i++)
+        rv |= _ENCODE_BINARY(&src->data.keyFrameFields[i].value, VARIANT);
+    return rv;
+}
+
 UA_StatusCode
 UA_DataSetMessage_encodeBinary(PubSubEncodeCtx *ctx,
                                const UA_DataSetMessage_EncodingMetaData *emd,
@@ -1424,6 +1434,9 @@ UA_DataSetMessage_encodeBinary(PubSubEncodeCtx *ctx,
     case UA_DATASETMESSAGE_DATADELTAFRAME:
         rv = UA_DataSetMessage_deltaFrame_encodeBinary(ctx, src);
         break;
+    case UA_DATASETMESSAGE_EVENT:
+        rv = UA_DataSetMessage_event_encodeBinary(ctx, src);
+        break;
     case UA_DATASETMESSAGE_KEEPALIVE:
         break; /* Keep-Alive Message contains no Payload Data */
     default:
@@ -1603,6 +1616,27 @@ UA_DataSetMessage_deltaFrame_decodeBinary(PubSubDecodeCtx *ctx,
     return rv;
 }
 
+static UA_StatusCode
+UA_DataSetMessage_event_decodeBinary(PubSubDecodeCtx *ctx,
+                                     UA_DataSetMessage *dsm) {
+    UA_StatusCode rv = _DECODE_BINARY(&dsm->fieldCount, UINT16);
+    UA_CHECK_STATUS(rv, return rv);
+    if(dsm->fieldCount == 0)
+        return UA_STATUSCODE_GOOD;
+
+    dsm->data.keyFrameFields = (UA_DataValue *)
+        ctxCalloc(&ctx->ctx, dsm->fieldCount, sizeof(UA_DataValue));
+    if(!dsm->data.keyFrameFields)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    for(UA_UInt16 i = 0; i < dsm->fieldCount; i++) {
+        rv = _DECODE_BINARY(&dsm->data.keyFrameFields[i].value, VARIANT);
+        UA_CHECK_STATUS(rv, return rv);
+        dsm->data.keyFrameFields[i].hasValue = true;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_StatusCode
 UA_DataSetMessage_decodeBinary(PubSubDecodeCtx *ctx,
                                const UA_DataSetMessage_EncodingMetaData *em,
@@ -1618,6 +1652,9 @@ UA_DataSetMessage_decodeBinary(PubSubDecodeCtx *ctx,
     case UA_DATASETMESSAGE_DATADELTAFRAME:
         rv = UA_DataSetMessage_deltaFrame_decodeBinary(ctx, dsm);
         break;
+    case UA_DATASETMESSAGE_EVENT:
+        rv = UA_DataSetMessage_event_decodeBinary(ctx, dsm);
+        break;
     case UA_DATASETMESSAGE_KEEPALIVE:
         return UA_STATUSCODE_GOOD; /* Keep-Alive Message contains no Payload Data */
     default:
@@ -1824,6 +1861,14 @@ UA_DataSetMessage_calcSizeBinary(PubSubEncodeCtx *ctx,
             else if(p->header.fieldEncoding == UA_FIELDENCODING_DATAVALUE)
                 size += UA_calcSizeBinary(v, &UA_TYPES[UA_TYPES_DATAVALUE], NULL);
         }
+    } else if(p->header.dataSetMessageType == UA_DATASETMESSAGE_EVENT) {
+        if(ot)
+            return 0; /* Not supported for RT */
+
+        size += 2; /* p->fieldCount */
+        for(UA_UInt16 i = 0; i < p->fieldCount; i++)
+            size += UA_calcSizeBinary(&p->data.keyFrameFields[i].value,
+                                      &UA_TYPES[UA_TYPES_VARIANT], NULL);
     } else {
         /* Unknown message type */
         return 0;
@@ -1842,7 +1887,8 @@ UA_DataSetMessage_calcSizeBinary(PubSubEncodeCtx *ctx,
 
 void
 UA_DataSetMessage_clear(UA_DataSetMessage* p) {
-    if(p->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME) {
+    if(p->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME ||
+       p->header.dataSetMessageType == UA_DATASETMESSAGE_EVENT) {
         if(p->data.keyFrameFields)
             UA_Array_delete(p->data.keyFrameFields, p->fieldCount,
                             &UA_TYPES[UA_TYPES_DATAVALUE]);
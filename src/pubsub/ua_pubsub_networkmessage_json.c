@@ -96,6 +96,10 @@ UA_DataSetMessage_encodeJson_internal(CtxJson *ctx,
         UA_String s = UA_STRING("ua-keyframe");
         rv |= writeJsonObjElm(ctx, UA_DECODEKEY_MESSAGETYPE,
                               &s, &UA_TYPES[UA_TYPES_STRING]);
+    } else if(src->header.dataSetMessageType == UA_DATASETMESSAGE_EVENT) {
+        UA_String s = UA_STRING("ua-event");
+        rv |= writeJsonObjElm(ctx, UA_DECODEKEY_MESSAGETYPE,
+                              &s, &UA_TYPES[UA_TYPES_STRING]);
     } else {
         /* TODO: Support other message types */
         return UA_STATUSCODE_BADNOTSUPPORTED;
@@ -1315,12 +1315,18 @@ addPublishedDataItemsRepresentation(UA_Server *server,
     memcpy(pdsName, publishedDataSet->config.name.data, publishedDataSet->config.name.length);
     pdsName[publishedDataSet->config.name.length] = '\0';
 
+    /* PublishedEvents use the base PublishedDataSetType. The PublishedEventsType
+     * is not part of the minimal PubSub nodeset. */
+    UA_Boolean events = (publishedDataSet->config.publishedDataSetType ==
+                         UA_PUBSUB_DATASET_PUBLISHEDEVENTS);
+
     UA_ObjectAttributes object_attr = UA_ObjectAttributes_default;
     object_attr.displayName = UA_LOCALIZEDTEXT("", pdsName);
     retVal = addNode(server, UA_NODECLASS_OBJECT, UA_NODEID_NUMERIC(1, 0), /* Create a new id */
                      UA_NS0ID(PUBLISHSUBSCRIBE_PUBLISHEDDATASETS),
                      UA_NS0ID(HASCOMPONENT),
                      UA_QUALIFIEDNAME(0, pdsName),
+                     (events) ? UA_NS0ID(PUBLISHEDDATASETTYPE) :
                      UA_NS0ID(PUBLISHEDDATAITEMSTYPE),
                      &object_attr, &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES],
                      NULL, &publishedDataSet->head.identifier);
@@ -1345,20 +1351,6 @@ addPublishedDataItemsRepresentation(UA_Server *server,
     retVal |= setVariableValueSource(server, valueCallback, configurationVersionNode,
                                      configurationVersionContext);
 
-    UA_NodeId publishedDataNode =
-        findSingleChildNode(server, UA_QUALIFIEDNAME(0, "PublishedData"),
-                            UA_NS0ID(HASPROPERTY), publishedDataSet->head.identifier);
-    if(UA_NodeId_isNull(&publishedDataNode))
-        return UA_STATUSCODE_BADNOTFOUND;
-
-    UA_NodePropertyContext * publishingIntervalContext = (UA_NodePropertyContext *)
-        UA_malloc(sizeof(UA_NodePropertyContext));
-    publishingIntervalContext->parentNodeId = publishedDataSet->head.identifier;
-    publishingIntervalContext->parentClassifier = UA_NS0ID_PUBLISHEDDATAITEMSTYPE;
-    publishingIntervalContext->elementClassiefier = UA_NS0ID_PUBLISHEDDATAITEMSTYPE_PUBLISHEDDATA;
-    retVal |= setVariableValueSource(server, valueCallback, publishedDataNode,
-                                     publishingIntervalContext);
-
     UA_NodeId dataSetMetaDataNode =
         findSingleChildNode(server, UA_QUALIFIEDNAME(0, "DataSetMetaData"),
                             UA_NS0ID(HASPROPERTY), publishedDataSet->head.identifier);
@@ -1373,6 +1365,23 @@ addPublishedDataItemsRepresentation(UA_Server *server,
     retVal |= setVariableValueSource(server, valueCallback,
                                      dataSetMetaDataNode, metaDataContext);
 
+    if(events)
+        return retVal;
+
+    UA_NodeId publishedDataNode =
+        findSingleChildNode(server, UA_QUALIFIEDNAME(0, "PublishedData"),
+                            UA_NS0ID(HASPROPERTY), publishedDataSet->head.identifier);
+    if(UA_NodeId_isNull(&publishedDataNode))
+        return UA_STATUSCODE_BADNOTFOUND;
+
+    UA_NodePropertyContext * publishingIntervalContext = (UA_NodePropertyContext *)
+        UA_malloc(sizeof(UA_NodePropertyContext));
+    publishingIntervalContext->parentNodeId = publishedDataSet->head.identifier;
+    publishingIntervalContext->parentClassifier = UA_NS0ID_PUBLISHEDDATAITEMSTYPE;
+    publishingIntervalContext->elementClassiefier = UA_NS0ID_PUBLISHEDDATAITEMSTYPE_PUBLISHEDDATA;
+    retVal |= setVariableValueSource(server, valueCallback, publishedDataNode,
+                                     publishingIntervalContext);
+
     if(server->config.pubSubConfig.enableInformationModelMethods) {
         retVal |= addRef(server, publishedDataSet->head.identifier, UA_NS0ID(HASCOMPONENT),
                          UA_NS0ID(PUBLISHEDDATAITEMSTYPE_ADDVARIABLES), true);
@@ -2402,6 +2411,7 @@ initPubSubNS0(UA_Server *server) {
 
     lifeCycle.destructor = publishedDataItemsTypeDestructor;
     retVal |= setNodeTypeLifecycle(server, UA_NS0ID(PUBLISHEDDATAITEMSTYPE), lifeCycle);
+    retVal |= setNodeTypeLifecycle(server, UA_NS0ID(PUBLISHEDDATASETTYPE), lifeCycle);
 
     lifeCycle.destructor = dataSetReaderTypeDestructor;
     retVal |= setNodeTypeLifecycle(server, UA_NS0ID(DATASETREADERTYPE), lifeCycle);
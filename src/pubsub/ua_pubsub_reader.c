@@ -251,8 +251,8 @@ UA_DataSetReader_create(UA_PubSubManager *psm, UA_NodeId readerGroupIdentifier,
 
     /* Add the new reader to the group. Add to the end of the linked list to
      * ensure the order for the realtime offsets is as expected. The received
-     * DataSetMessages are matched via UA_DataSetReader_checkIdentifier for the
-     * non-RT path. */
+     * DataSetMessages are matched via the index of the ReaderGroup (or
+     * UA_DataSetReader_checkIdentifier) for the non-RT path. */
     UA_DataSetReader *after = LIST_FIRST(&rg->readers);
     if(!after) {
         LIST_INSERT_HEAD(&rg->readers, dsr, listEntry);
@@ -318,6 +318,10 @@ UA_DataSetReader_create(UA_PubSubManager *psm, UA_NodeId readerGroupIdentifier,
         }
     }
 
+    /* Index the reader with the final config for the dispatch of received
+     * DataSetMessages */
+    UA_ReaderGroup_indexReader(rg, dsr);
+
     UA_LOG_INFO_PUBSUB(psm->logging, dsr, "DataSetReader created (State: %s)",
                        UA_PubSubState_name(dsr->head.state));
 
@@ -375,6 +379,7 @@ UA_DataSetReader_remove(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
         sds->connectedReader = NULL;
 
     /* Remove DataSetReader from group */
+    UA_ReaderGroup_unindexReader(rg, dsr);
     LIST_REMOVE(dsr, listEntry);
     rg->readersCount--;
 
@@ -428,6 +433,54 @@ UA_DataSetReaderConfig_clear(UA_DataSetReaderConfig *cfg) {
     }
 }
 
+static void
+releaseTargets(UA_Server *server, UA_DataSetReader *dsr) {
+    for(size_t i = 0; i < dsr->targetsSize; i++) {
+        if(dsr->targets[i].node)
+            UA_NODESTORE_RELEASE(server, (const UA_Node*)dsr->targets[i].node);
+    }
+    UA_free(dsr->targets);
+    dsr->targets = NULL;
+    dsr->targetsSize = 0;
+}
+
+/* Resolve the nodes of the target variables. The nodes are kept until the
+ * Reader is no longer (pre)operational or the nodestoreGeneration changes.
+ * Targets that cannot be resolved are written via the Write service. */
+static void
+resolveTargets(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
+    UA_Server *server = psm->sc.server;
+    releaseTargets(server, dsr);
+
+    UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
+    if(tvs->targetVariablesSize == 0)
+        return;
+    dsr->targets = (UA_DataSetReaderTarget*)
+        UA_calloc(tvs->targetVariablesSize, sizeof(UA_DataSetReaderTarget));
+    if(!dsr->targets)
+        return;
+    dsr->targetsSize = tvs->targetVariablesSize;
+    dsr->targetsGeneration = server->nodestoreGeneration;
+
+    for(size_t i = 0; i < tvs->targetVariablesSize; i++) {
+        UA_FieldTargetDataType *tv = &tvs->targetVariables[i];
+        if(tv->attributeId != UA_ATTRIBUTEID_VALUE)
+            continue;
+        UA_Node *node = UA_NODESTORE_GET_EDIT(server, &tv->targetNodeId);
+        if(!node) {
+            UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
+                                  "The target variable %N does not exist",
+                                  tv->targetNodeId);
+            continue;
+        }
+        if(node->head.nodeClass != UA_NODECLASS_VARIABLE) {
+            UA_NODESTORE_RELEASE(server, node);
+            continue;
+        }
+        dsr->targets[i].node = &node->variableNode;
+    }
+}
+
 UA_StatusCode
 UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
                                 UA_PubSubState targetState, UA_StatusCode errorReason) {
@@ -493,6 +546,15 @@ UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
 
  finalize_state_machine:
 
+    /* Release the resolved target variables and restart the sequence if no
+     * messages are received */
+    if(dsr->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
+       dsr->head.state != UA_PUBSUBSTATE_PREOPERATIONAL) {
+        releaseTargets(server, dsr);
+        dsr->keyFrameReceived = false;
+        dsr->hasSequenceNr = false;
+    }
+
     /* No state change has happened */
     if(dsr->head.state == oldState)
         return res;
@@ -541,19 +603,92 @@ UA_DataSetReader_handleMessageReceiveTimeout(UA_PubSubManager *psm,
                                              UA_DataSetReader *dsr) {
     UA_assert(dsr->head.componentType == UA_PUBSUBCOMPONENT_DATASETREADER);
 
+    lockServer(psm->sc.server);
+
     /* Don't signal an error if we don't expect messages to arrive */
     if(dsr->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
-       dsr->head.state != UA_PUBSUBSTATE_PREOPERATIONAL)
+       dsr->head.state != UA_PUBSUBSTATE_PREOPERATIONAL) {
+        unlockServer(psm->sc.server);
         return;
+    }
+
+    /* Messages were received since the timer was set. Move the timer to
+     * expire MessageReceiveTimeout after the last received message. */
+    UA_EventLoop *el = psm->sc.server->config.eventLoop;
+    UA_DateTime timeout = (UA_DateTime)
+        (dsr->config.messageReceiveTimeout * UA_DATETIME_MSEC);
+    if(el->dateTime_nowMonotonic(el) - dsr->lastMessageReceived < timeout) {
+        el->modifyTimer(el, dsr->msgRcvTimeoutTimerId,
+                        dsr->config.messageReceiveTimeout,
+                        &dsr->lastMessageReceived, UA_TIMERPOLICY_BASETIME);
+        unlockServer(psm->sc.server);
+        return;
+    }
 
     UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "Message receive timeout occurred");
 
-    lockServer(psm->sc.server);
     UA_DataSetReader_setPubSubState(psm, dsr, UA_PUBSUBSTATE_ERROR,
                                     UA_STATUSCODE_BADTIMEOUT);
     unlockServer(psm->sc.server);
 }
 
+/* DataSetMessages with a SequenceNumber that is up to 16384 ahead of the last
+ * received SequenceNumber are newer. Up to 16384 behind are older (duplicates
+ * or reordered). Otherwise the sequence restarts (e.g. after a restart of
+ * the Publisher). Returns false if the message is not newer. Sets gap if
+ * messages were skipped. */
+#define UA_SEQUENCENUMBER_WINDOW 16384
+
+static UA_Boolean
+checkSequenceNumber(UA_DataSetReader *dsr, const UA_DataSetMessageHeader *header,
+                    UA_Boolean *gap) {
+    if(!header->dataSetMessageSequenceNrEnabled)
+        return true;
+    UA_UInt16 seq = header->dataSetMessageSequenceNr;
+    if(dsr->hasSequenceNr) {
+        UA_UInt16 diff = (UA_UInt16)(seq - dsr->lastSequenceNr);
+        if(diff == 0 || diff > UA_UINT16_MAX - UA_SEQUENCENUMBER_WINDOW)
+            return false;
+        *gap = (diff != 1);
+    }
+    dsr->hasSequenceNr = true;
+    dsr->lastSequenceNr = seq;
+    return true;
+}
+
+static void
+writeTargetField(UA_PubSubManager *psm, UA_DataSetReader *dsr,
+                 UA_DataSetReaderTarget *targets, size_t index,
+                 UA_DataValue *field) {
+    if(!field->hasValue)
+        return;
+
+    UA_Server *server = psm->sc.server;
+    UA_FieldTargetDataType *tv =
+        &dsr->config.subscribedDataSet.target.targetVariables[index];
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(targets && targets[index].node) {
+        /* Write directly into the resolved node */
+        res = writeResolvedValueAttribute(server, &server->adminSession,
+                                          targets[index].node, field,
+                                          &tv->receiverIndexRange,
+                                          &targets[index].checkedType);
+    } else {
+        /* Write via the Write-Service */
+        UA_WriteValue writeVal;
+        UA_WriteValue_init(&writeVal);
+        writeVal.attributeId = tv->attributeId;
+        writeVal.indexRange = tv->receiverIndexRange;
+        writeVal.nodeId = tv->targetNodeId;
+        writeVal.value = *field;
+        Operation_Write(server, &server->adminSession, &writeVal, &res);
+    }
+    if(res != UA_STATUSCODE_GOOD)
+        UA_LOG_INFO_PUBSUB(psm->logging, dsr,
+                           "Error writing field %u: %s",
+                           (unsigned)index, UA_StatusCode_name(res));
+}
+
 void
 UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
                          UA_DataSetMessage *msg) {
@@ -564,8 +699,14 @@ UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
 
     /* Received a (first) message for the Reader.
      * Transition from PreOperational to Operational. */
-    if(dsr->head.state == UA_PUBSUBSTATE_PREOPERATIONAL)
+    if(dsr->head.state == UA_PUBSUBSTATE_PREOPERATIONAL) {
+        UA_ReaderGroup *rg = dsr->linkedReaderGroup;
         UA_DataSetReader_setPubSubState(psm, dsr, dsr->head.state, UA_STATUSCODE_GOOD);
+        /* The state callback can disable the ReaderGroup and remove the
+         * Reader. Don't touch the Reader afterwards. */
+        if(!UA_PubSubState_isEnabled(rg->head.state))
+            return;
+    }
 
     if(dsr->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
        dsr->head.state != UA_PUBSUBSTATE_PREOPERATIONAL) {
@@ -591,24 +732,51 @@ UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
      *     }
      * } */
 
-    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATAKEYFRAME) {
+    /* KeepAlives have no fields. They only reset the MessageReceiveTimeout. */
+    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATAKEYFRAME &&
+       msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATADELTAFRAME &&
+       msg->header.dataSetMessageType != UA_DATASETMESSAGE_EVENT &&
+       msg->header.dataSetMessageType != UA_DATASETMESSAGE_KEEPALIVE) {
         UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
-                              "DataSetMessage is discarded: Only keyframes are supported");
+                              "DataSetMessage is discarded: Only keyframes, "
+                              "deltaframes, events and keepalives are supported");
         return;
     }
 
-    /* Configure / Update the timeout callback */
+    /* Configure the timeout callback. Only the time of the last received
+     * message is stored. The timer is moved forward lazily when it fires. */
     if(dsr->config.messageReceiveTimeout > 0.0) {
         UA_EventLoop *el = psm->sc.server->config.eventLoop;
-        if(dsr->msgRcvTimeoutTimerId == 0) {
+        dsr->lastMessageReceived = el->dateTime_nowMonotonic(el);
+        if(dsr->msgRcvTimeoutTimerId == 0)
             el->addTimer(el, (UA_Callback)UA_DataSetReader_handleMessageReceiveTimeout,
-                         psm, dsr, dsr->config.messageReceiveTimeout, NULL,
-                         UA_TIMERPOLICY_CURRENTTIME, &dsr->msgRcvTimeoutTimerId);
-        } else {
-            /* Reset the next execution time to now + interval */
-            el->modifyTimer(el, dsr->msgRcvTimeoutTimerId,
-                            dsr->config.messageReceiveTimeout, NULL,
-                            UA_TIMERPOLICY_CURRENTTIME);
+                         psm, dsr, dsr->config.messageReceiveTimeout,
+                         &dsr->lastMessageReceived, UA_TIMERPOLICY_BASETIME,
+                         &dsr->msgRcvTimeoutTimerId);
+    }
+
+    /* Discard duplicate and reordered messages */
+    UA_Boolean gap = false;
+    if(!checkSequenceNumber(dsr, &msg->header, &gap)) {
+        UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "DataSetMessage is discarded: "
+                            "SequenceNumber %u is not newer than %u",
+                            (unsigned)msg->header.dataSetMessageSequenceNr,
+                            (unsigned)dsr->lastSequenceNr);
+        return;
+    }
+
+    /* DeltaFrames are applied only on top of the last KeyFrame and if no
+     * message was lost in between. Otherwise wait for the next KeyFrame. */
+    if(msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATADELTAFRAME) {
+        if(gap && dsr->keyFrameReceived) {
+            UA_LOG_INFO_PUBSUB(psm->logging, dsr, "DataSetMessages were lost. "
+                               "Waiting for the next KeyFrame.");
+            dsr->keyFrameReceived = false;
+        }
+        if(!dsr->keyFrameReceived) {
+            UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "DeltaFrame is discarded: "
+                                "Waiting for the next KeyFrame");
+            return;
         }
     }
 
@@ -618,33 +786,44 @@ UA_DataSetReader_process(UA_PubSubManager *psm, UA_DataSetReader *dsr,
 
     /* Check whether the field count matches the configuration */
     UA_TargetVariablesDataType *tvs = &dsr->config.subscribedDataSet.target;
-    if(tvs->targetVariablesSize != msg->fieldCount) {
+    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATADELTAFRAME &&
+       tvs->targetVariablesSize != msg->fieldCount) {
         UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
                               "Number of fields does not match the "
                               "TargetVariables configuration");
         return;
     }
 
-    /* Write the message fields. RT has the external data value configured. */
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    /* Resolve the target variables with the first message. And again if the
+     * information model has changed in the meantime. */
+    UA_Server *server = psm->sc.server;
+    UA_DataSetReaderTarget *targets = NULL;
+    if(server->config.pubSubConfig.enableDirectTargetWrites) {
+        if(!dsr->targets || dsr->targetsGeneration != server->nodestoreGeneration)
+            resolveTargets(psm, dsr);
+        targets = dsr->targets;
+    }
+
+    /* Write the fields of a KeyFrame or Event. Events contain all fields but
+     * are not the base for DeltaFrames. */
+    if(msg->header.dataSetMessageType != UA_DATASETMESSAGE_DATADELTAFRAME) {
+        for(size_t i = 0; i < msg->fieldCount; i++)
+            writeTargetField(psm, dsr, targets, i, &msg->data.keyFrameFields[i]);
+        if(msg->header.dataSetMessageType == UA_DATASETMESSAGE_DATAKEYFRAME)
+            dsr->keyFrameReceived = true;
+        return;
+    }
+
+    /* Write the changed fields of a DeltaFrame */
     for(size_t i = 0; i < msg->fieldCount; i++) {
-        UA_FieldTargetDataType *tv = &tvs->targetVariables[i];
-        UA_DataValue *field = &msg->data.keyFrameFields[i];
-        if(!field->hasValue)
+        UA_DataSetMessage_DeltaFrameField *dff = &msg->data.deltaFrameFields[i];
+        if(dff->index >= tvs->targetVariablesSize) {
+            UA_LOG_WARNING_PUBSUB(psm->logging, dsr,
+                                  "DeltaFrame field index %u is out of range",
+                                  (unsigned)dff->index);
             continue;
-
-        /* Write via the Write-Service */
-        UA_WriteValue writeVal;
-        UA_WriteValue_init(&writeVal);
-        writeVal.attributeId = tv->attributeId;
-        writeVal.indexRange = tv->receiverIndexRange;
-        writeVal.nodeId = tv->targetNodeId;
-        writeVal.value = *field;
-        Operation_Write(psm->sc.server, &psm->sc.server->adminSession, &writeVal, &res);
-        if(res != UA_STATUSCODE_GOOD)
-            UA_LOG_INFO_PUBSUB(psm->logging, dsr,
-                               "Error writing KeyFrame field %u: %s",
-                               (unsigned)i, UA_StatusCode_name(res));
+        }
+        writeTargetField(psm, dsr, targets, dff->index, &dff->value);
     }
 }
 
@@ -779,8 +958,9 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
-    /* Store the old config */
+    /* Store the old config. The index points into the config. */
     UA_DataSetReaderConfig oldConfig = dsr->config;
+    UA_ReaderGroup_unindexReader(dsr->linkedReaderGroup, dsr);
 
     /* Copy the config into the new dataSetReader */
     UA_StatusCode retVal = UA_DataSetReaderConfig_copy(config, &dsr->config);
@@ -803,6 +983,7 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
 
     /* Clean up and return */
     UA_DataSetReaderConfig_clear(&oldConfig);
+    UA_ReaderGroup_indexReader(dsr->linkedReaderGroup, dsr);
     unlockServer(server);
     return UA_STATUSCODE_GOOD;
 
@@ -810,6 +991,7 @@ UA_Server_updateDataSetReaderConfig(UA_Server *server, const UA_NodeId dsrId,
  errout:
     UA_DataSetReaderConfig_clear(&dsr->config);
     dsr->config = oldConfig;
+    UA_ReaderGroup_indexReader(dsr->linkedReaderGroup, dsr);
     unlockServer(server);
     return retVal;
 }
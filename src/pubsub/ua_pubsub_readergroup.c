@@ -33,6 +33,75 @@ UA_ReaderGroup_find(UA_PubSubManager *psm, const UA_NodeId id) {
     return NULL;
 }
 
+/* Reader Index */
+
+static enum ZIP_CMP
+cmpReaderKey(const void *a, const void *b) {
+    const UA_DataSetReaderKey *aa = (const UA_DataSetReaderKey*)a;
+    const UA_DataSetReaderKey *bb = (const UA_DataSetReaderKey*)b;
+    if(aa->dataSetWriterId != bb->dataSetWriterId)
+        return (aa->dataSetWriterId < bb->dataSetWriterId) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    if(aa->writerGroupId != bb->writerGroupId)
+        return (aa->writerGroupId < bb->writerGroupId) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    const UA_PublisherId *pa = &aa->publisherId;
+    const UA_PublisherId *pb = &bb->publisherId;
+    if(pa->idType != pb->idType)
+        return (pa->idType < pb->idType) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    switch(pa->idType) {
+    case UA_PUBLISHERIDTYPE_BYTE:
+        if(pa->id.byte == pb->id.byte)
+            return ZIP_CMP_EQ;
+        return (pa->id.byte < pb->id.byte) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    case UA_PUBLISHERIDTYPE_UINT16:
+        if(pa->id.uint16 == pb->id.uint16)
+            return ZIP_CMP_EQ;
+        return (pa->id.uint16 < pb->id.uint16) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    case UA_PUBLISHERIDTYPE_UINT32:
+        if(pa->id.uint32 == pb->id.uint32)
+            return ZIP_CMP_EQ;
+        return (pa->id.uint32 < pb->id.uint32) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    case UA_PUBLISHERIDTYPE_UINT64:
+        if(pa->id.uint64 == pb->id.uint64)
+            return ZIP_CMP_EQ;
+        return (pa->id.uint64 < pb->id.uint64) ? ZIP_CMP_LESS : ZIP_CMP_MORE;
+    case UA_PUBLISHERIDTYPE_STRING:
+        return (enum ZIP_CMP)UA_order(&pa->id.string, &pb->id.string,
+                                      &UA_TYPES[UA_TYPES_STRING]);
+    default:
+        return ZIP_CMP_EQ;
+    }
+}
+
+ZIP_FUNCTIONS(UA_DataSetReaderKeyTree, UA_DataSetReader, keyTreeEntry,
+              UA_DataSetReaderKey, key, cmpReaderKey)
+
+void
+UA_ReaderGroup_indexReader(UA_ReaderGroup *rg, UA_DataSetReader *dsr) {
+    UA_ReaderGroup_unindexReader(rg, dsr);
+    dsr->key.publisherId = dsr->config.publisherId;
+    dsr->key.writerGroupId = dsr->config.writerGroupId;
+    dsr->key.dataSetWriterId = dsr->config.dataSetWriterId;
+    ZIP_INSERT(UA_DataSetReaderKeyTree, &rg->readersByKey, dsr);
+    dsr->indexed = true;
+}
+
+void
+UA_ReaderGroup_unindexReader(UA_ReaderGroup *rg, UA_DataSetReader *dsr) {
+    if(!dsr->indexed)
+        return;
+    ZIP_REMOVE(UA_DataSetReaderKeyTree, &rg->readersByKey, dsr);
+    dsr->indexed = false;
+}
+
+/* The index can be used if the NetworkMessage contains all identifiers.
+ * Otherwise the missing identifiers match every Reader. */
+static UA_Boolean
+canDispatchByKey(const UA_ReaderGroup *rg, const UA_NetworkMessage *nm) {
+    return rg->config.encodingMimeType != UA_PUBSUB_ENCODING_JSON &&
+        nm->publisherIdEnabled && nm->groupHeaderEnabled &&
+        nm->groupHeader.writerGroupIdEnabled && nm->payloadHeaderEnabled;
+}
+
 /* ReaderGroup Config Handling */
 
 UA_StatusCode
@@ -430,6 +499,27 @@ UA_ReaderGroup_setEncryptionKeys(UA_PubSubManager *psm, UA_ReaderGroup *rg,
                         &encryptingKey, &keyNonce);
 }
 
+struct DispatchContext {
+    UA_DataSetReader **done; /* Readers that have processed the message */
+    size_t doneSize;
+};
+
+/* Find the next enabled Reader for the key that has not processed the message
+ * yet. The pointers in the done-list are only compared and never
+ * dereferenced. */
+static void *
+findNextReader(void *context, UA_DataSetReader *reader) {
+    struct DispatchContext *ctx = (struct DispatchContext*)context;
+    if(reader->head.state != UA_PUBSUBSTATE_OPERATIONAL &&
+       reader->head.state != UA_PUBSUBSTATE_PREOPERATIONAL)
+        return NULL;
+    for(size_t i = 0; i < ctx->doneSize; i++) {
+        if(ctx->done[i] == reader)
+            return NULL;
+    }
+    return reader;
+}
+
 UA_Boolean
 UA_ReaderGroup_process(UA_PubSubManager *psm, UA_ReaderGroup *rg,
                        UA_NetworkMessage *nm) {
@@ -442,9 +532,39 @@ UA_ReaderGroup_process(UA_PubSubManager *psm, UA_ReaderGroup *rg,
     rg->hasReceived = true;
     UA_ReaderGroup_setPubSubState(psm, rg, rg->head.state);
 
+    /* Dispatch each DataSetMessage to the Readers with a matching key. The
+     * state callbacks of a Reader can disable the ReaderGroup and remove
+     * Readers. So the tree is searched again from the root after each Reader
+     * has processed the message. */
+    UA_Boolean processed = false;
+    if(canDispatchByKey(rg, nm)) {
+        if(rg->readersCount == 0)
+            return false;
+        UA_STACKARRAY(UA_DataSetReader*, done, rg->readersCount);
+        UA_DataSetReaderKey key;
+        key.publisherId = nm->publisherId;
+        key.writerGroupId = nm->groupHeader.writerGroupId;
+        for(size_t i = 0; i < nm->messageCount; i++) {
+            key.dataSetWriterId = nm->dataSetWriterIds[i];
+            struct DispatchContext ctx = {done, 0};
+            while(rg->head.state == UA_PUBSUBSTATE_OPERATIONAL ||
+                  rg->head.state == UA_PUBSUBSTATE_PREOPERATIONAL) {
+                UA_DataSetReader *reader = (UA_DataSetReader*)
+                    ZIP_ITER_KEY(UA_DataSetReaderKeyTree, &rg->readersByKey,
+                                 &key, findNextReader, &ctx);
+                if(!reader || ctx.doneSize >= rg->readersCount)
+                    break;
+                done[ctx.doneSize++] = reader;
+                processed = true;
+                UA_LOG_TRACE_PUBSUB(psm->logging, reader, "Processing a DataSetMessage");
+                UA_DataSetReader_process(psm, reader, &nm->payload.dataSetMessages[i]);
+            }
+        }
+        return processed;
+    }
+
     /* Safe iteration. The current Reader might be deleted in the ReaderGroup
      * _setPubSubState callback. */
-    UA_Boolean processed = false;
     UA_DataSetReader *reader, *reader_tmp;
     LIST_FOREACH_SAFE(reader, &rg->readers, listEntry, reader_tmp) {
         /* Check if the reader is enabled */
@@ -507,11 +627,21 @@ UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
     }
 
     /* Find a matching reader. Otherwise skip for this ReaderGroup */
-    UA_DataSetReader *dsr;
-    LIST_FOREACH(dsr, &rg->readers, listEntry) {
-        rv = UA_DataSetReader_checkIdentifier(psm, dsr, nm);
-        if(rv == UA_STATUSCODE_GOOD)
-            break;
+    UA_DataSetReader *dsr = NULL;
+    if(canDispatchByKey(rg, nm)) {
+        UA_DataSetReaderKey key;
+        key.publisherId = nm->publisherId;
+        key.writerGroupId = nm->groupHeader.writerGroupId;
+        for(size_t i = 0; i < nm->messageCount && !dsr; i++) {
+            key.dataSetWriterId = nm->dataSetWriterIds[i];
+            dsr = ZIP_FIND(UA_DataSetReaderKeyTree, &rg->readersByKey, &key);
+        }
+    } else {
+        LIST_FOREACH(dsr, &rg->readers, listEntry) {
+            rv = UA_DataSetReader_checkIdentifier(psm, dsr, nm);
+            if(rv == UA_STATUSCODE_GOOD)
+                break;
+        }
     }
 
     if(!dsr) {
@@ -57,6 +57,18 @@ UA_DataSetWriterConfig_clear(UA_DataSetWriterConfig *pdsConfig) {
     memset(pdsConfig, 0, sizeof(UA_DataSetWriterConfig));
 }
 
+static void
+UA_DataSetWriter_clearEventQueue(UA_DataSetWriter *dsw) {
+    UA_DataSetWriterEvent *e, *e_tmp;
+    TAILQ_FOREACH_SAFE(e, &dsw->eventQueue, listEntry, e_tmp) {
+        TAILQ_REMOVE(&dsw->eventQueue, e, listEntry);
+        UA_Array_delete(e->fields, e->fieldsSize, &UA_TYPES[UA_TYPES_VARIANT]);
+        UA_free(e);
+    }
+    dsw->eventQueueSize = 0;
+    dsw->eventQueueOverflows = 0;
+}
+
 static void
 UA_DataSetWriter_freezeConfiguration(UA_DataSetWriter *dsw) {
     if(dsw->configurationFrozen)
@@ -69,7 +81,8 @@ UA_DataSetWriter_freezeConfiguration(UA_DataSetWriter *dsw) {
 }
 
 static void
-UA_DataSetWriter_unfreezeConfiguration(UA_DataSetWriter *dsw) {
+UA_DataSetWriter_unfreezeConfiguration(UA_PubSubManager *psm,
+                                       UA_DataSetWriter *dsw) {
     if(!dsw->configurationFrozen)
         return;
     dsw->configurationFrozen = false;
@@ -77,6 +90,10 @@ UA_DataSetWriter_unfreezeConfiguration(UA_DataSetWriter *dsw) {
     if(!pds) /* Skip for heartbeat writers */
         return;
     pds->configurationFreezeCounter--;
+
+    /* Release the field nodes when the PublishedDataSet is no longer used */
+    if(pds->configurationFreezeCounter == 0)
+        UA_PublishedDataSet_releaseFieldNodes(psm, pds);
 }
 
 UA_StatusCode
@@ -101,7 +118,7 @@ UA_DataSetWriter_setPubSubState(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
                                              &dsw->head.state, targetState);
         if(dsw->head.state == UA_PUBSUBSTATE_DISABLED ||
            dsw->head.state == UA_PUBSUBSTATE_ERROR)
-            UA_DataSetWriter_unfreezeConfiguration(dsw);
+            UA_DataSetWriter_unfreezeConfiguration(psm, dsw);
         else
             UA_DataSetWriter_freezeConfiguration(dsw);
         goto finalize_state_machine;
@@ -113,7 +130,8 @@ UA_DataSetWriter_setPubSubState(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
     case UA_PUBSUBSTATE_DISABLED:
     case UA_PUBSUBSTATE_ERROR:
         dsw->head.state = targetState;
-        UA_DataSetWriter_unfreezeConfiguration(dsw);
+        UA_DataSetWriter_unfreezeConfiguration(psm, dsw);
+        UA_DataSetWriter_clearEventQueue(dsw);
         break;
 
         /* Enabled */
@@ -133,7 +151,7 @@ UA_DataSetWriter_setPubSubState(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
     default:
         dsw->head.state = UA_PUBSUBSTATE_ERROR;
         res = UA_STATUSCODE_BADINTERNALERROR;
-        UA_DataSetWriter_unfreezeConfiguration(dsw);
+        UA_DataSetWriter_unfreezeConfiguration(psm, dsw);
         break;
     }
 
@@ -202,6 +220,7 @@ UA_DataSetWriter_create(UA_PubSubManager *psm,
 
     dsw->head.componentType = UA_PUBSUBCOMPONENT_DATASETWRITER;
     dsw->linkedWriterGroup = wg;
+    TAILQ_INIT(&dsw->eventQueue);
 
     /* Copy the config into the new dataSetWriter */
     UA_StatusCode res = UA_DataSetWriterConfig_copy(dswConfig, &dsw->config);
@@ -341,6 +360,7 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw) {
         dsw->lastSamplesCount = 0;
     }
 
+    UA_DataSetWriter_clearEventQueue(dsw);
     UA_DataSetWriterConfig_clear(&dsw->config);
     UA_PubSubComponentHead_clear(&dsw->head);
     UA_free(dsw);
@@ -352,6 +372,37 @@ UA_DataSetWriter_remove(UA_PubSubManager *psm, UA_DataSetWriter *dsw) {
 /*               PublishValues handling                  */
 /*********************************************************/
 
+/* Remove the parts of a sampled field that are not configured to be sent */
+static void
+applyFieldContentMask(const UA_DataSetWriter *dsw, UA_DataValue *dfv) {
+    /* Deactivate statuscode? */
+    if(((u64)dsw->config.dataSetFieldContentMask &
+        (u64)UA_DATASETFIELDCONTENTMASK_STATUSCODE) == 0)
+        dfv->hasStatus = false;
+
+    /* Deactivate timestamps */
+    if(((u64)dsw->config.dataSetFieldContentMask &
+        (u64)UA_DATASETFIELDCONTENTMASK_SOURCETIMESTAMP) == 0)
+        dfv->hasSourceTimestamp = false;
+    if(((u64)dsw->config.dataSetFieldContentMask &
+        (u64)UA_DATASETFIELDCONTENTMASK_SOURCEPICOSECONDS) == 0)
+        dfv->hasSourcePicoseconds = false;
+    if(((u64)dsw->config.dataSetFieldContentMask &
+        (u64)UA_DATASETFIELDCONTENTMASK_SERVERTIMESTAMP) == 0)
+        dfv->hasServerTimestamp = false;
+    if(((u64)dsw->config.dataSetFieldContentMask &
+        (u64)UA_DATASETFIELDCONTENTMASK_SERVERPICOSECONDS) == 0)
+        dfv->hasServerPicoseconds = false;
+}
+
+/* Has the sample changed compared to the last sample? */
+static UA_Boolean
+sampleChanged(const UA_DataValue *last, const UA_DataValue *sample) {
+    if(last->hasStatus != sample->hasStatus || last->status != sample->status)
+        return true;
+    return !UA_Variant_equal(&last->value, &sample->value);
+}
+
 static UA_StatusCode
 UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
                                                UA_DataSetMessage *dataSetMessage,
@@ -369,45 +420,30 @@ UA_PubSubDataSetWriter_generateKeyFrameMessage(UA_PubSubManager *psm,
     if(!dataSetMessage->data.keyFrameFields)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
-    /* Loop over the fields */
-    size_t counter = 0;
-    UA_DataSetField *dsf;
-    TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
-        /* Sample the value */
-        UA_DataValue *dfv = &dataSetMessage->data.keyFrameFields[counter];
-        UA_PubSubDataSetField_sampleValue(psm, dsf, dfv);
-
-        /* Deactivate statuscode? */
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_STATUSCODE) == 0)
-            dfv->hasStatus = false;
-
-        /* Deactivate timestamps */
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SOURCETIMESTAMP) == 0)
-            dfv->hasSourceTimestamp = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SOURCEPICOSECONDS) == 0)
-            dfv->hasSourcePicoseconds = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SERVERTIMESTAMP) == 0)
-            dfv->hasServerTimestamp = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SERVERPICOSECONDS) == 0)
-            dfv->hasServerPicoseconds = false;
+    /* Sample the values. They can be borrowed from the nodes as the message
+     * is encoded and cleared before the server is unlocked. */
+    UA_PubSubConfiguration *config = &psm->sc.server->config.pubSubConfig;
+    UA_PublishedDataSet_sampleValues(psm, pds, dataSetMessage->data.keyFrameFields,
+                                     config->enableZeroCopySampling);
 
-        if(psm->sc.server->config.pubSubConfig.enableDeltaFrames) {
-            /* Update lastValue store */
-            UA_DataValue_clear(&dsw->lastSamples[counter].value);
-            UA_DataValue_copy(dfv, &dsw->lastSamples[counter].value);
+    for(size_t i = 0; i < pds->fieldSize; i++) {
+        /* Update lastValue store before the content mask is applied. So that
+         * the change detection for DeltaFrames sees the full sample. */
+        UA_DataValue *dfv = &dataSetMessage->data.keyFrameFields[i];
+        if(config->enableDeltaFrames && i < dsw->lastSamplesCount &&
+           sampleChanged(&dsw->lastSamples[i].value, dfv)) {
+            UA_DataValue_clear(&dsw->lastSamples[i].value);
+            UA_DataValue_copy(dfv, &dsw->lastSamples[i].value);
         }
-        counter++;
+
+        applyFieldContentMask(dsw, dfv);
     }
     return UA_STATUSCODE_GOOD;
 }
 
-/* the input message is already initialized and that the method 
- * must not be called twice for the same message */
+/* Contains only the fields that have changed since the last DataSetMessage.
+ * The input message is already initialized and that the method must not be
+ * called twice for the same message. */
 static UA_StatusCode
 UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
                                                  UA_DataSetMessage *dsm,
@@ -422,78 +458,135 @@ UA_PubSubDataSetWriter_generateDeltaFrameMessage(UA_PubSubManager *psm,
     if(pds->fieldSize == 0)
         return UA_STATUSCODE_GOOD;
 
-    UA_DataSetField *dsf;
-    UA_UInt16 counter = 0;
-    TAILQ_FOREACH(dsf, &pds->fields, listEntry) {
-        /* Sample the value */
-        UA_DataValue value;
-        UA_DataValue_init(&value);
-        UA_PubSubDataSetField_sampleValue(psm, dsf, &value);
-
-        /* Check if the value has changed */
-        UA_DataSetWriterSample *ls = &dsw->lastSamples[counter];
-        if(!UA_Variant_equal(&ls->value.value, &value.value)) {
-            /* increase fieldCount for current delta message */
-            dsm->fieldCount++;
-            ls->valueChanged = true;
-
-            /* Update last stored sample */
+    /* Sample the values and compare with the last samples. Only the changed
+     * values are copied if the samples are borrowed from the nodes. */
+    UA_DataValue *values = (UA_DataValue*)
+        UA_Array_new(pds->fieldSize, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    if(!values)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_PublishedDataSet_sampleValues(psm, pds, values, psm->sc.server->
+                                     config.pubSubConfig.enableZeroCopySampling);
+
+    size_t counter = pds->fieldSize;
+    if(counter > dsw->lastSamplesCount)
+        counter = dsw->lastSamplesCount;
+    UA_UInt16 changed = 0;
+    for(size_t i = 0; i < counter; i++) {
+        UA_DataSetWriterSample *ls = &dsw->lastSamples[i];
+        ls->valueChanged = sampleChanged(&ls->value, &values[i]);
+        if(ls->valueChanged) {
             UA_DataValue_clear(&ls->value);
-            ls->value = value;
-        } else {
-            UA_DataValue_clear(&value);
-            ls->valueChanged = false;
+            UA_DataValue_copy(&values[i], &ls->value);
+            changed++;
         }
-
-        counter++;
     }
+    UA_Array_delete(values, pds->fieldSize, &UA_TYPES[UA_TYPES_DATAVALUE]);
+
+    /* Nothing has changed */
+    if(changed == 0)
+        return UA_STATUSCODE_GOOD;
 
-    /* Allocate DeltaFrameFields */
+    /* Allocate DeltaFrameFields only for the changed fields */
     UA_DataSetMessage_DeltaFrameField *deltaFields = (UA_DataSetMessage_DeltaFrameField *)
-        UA_calloc(counter, sizeof(UA_DataSetMessage_DeltaFrameField));
+        UA_calloc(changed, sizeof(UA_DataSetMessage_DeltaFrameField));
     if(!deltaFields)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
-    dsm->fieldCount = counter;
+    dsm->fieldCount = changed;
     dsm->data.deltaFrameFields = deltaFields;
 
     size_t currentDeltaField = 0;
-    for(size_t i = 0; i < pds->fieldSize; i++) {
+    for(size_t i = 0; i < counter; i++) {
         if(!dsw->lastSamples[i].valueChanged)
             continue;
 
         UA_DataSetMessage_DeltaFrameField *dff = &deltaFields[currentDeltaField];
-
         dff->index = (UA_UInt16)i;
         UA_DataValue_copy(&dsw->lastSamples[i].value, &dff->value);
+        applyFieldContentMask(dsw, &dff->value);
 
         /* Reset the changed flag */
         dsw->lastSamples[i].valueChanged = false;
-
-        /* Deactivate statuscode? */
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_STATUSCODE) == 0)
-            dff->value.hasStatus = false;
-
-        /* Deactivate timestamps? */
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SOURCETIMESTAMP) == 0)
-            dff->value.hasSourceTimestamp = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SOURCEPICOSECONDS) == 0)
-            dff->value.hasServerPicoseconds = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SERVERTIMESTAMP) == 0)
-            dff->value.hasServerTimestamp = false;
-        if(((u64)dsw->config.dataSetFieldContentMask &
-            (u64)UA_DATASETFIELDCONTENTMASK_SERVERPICOSECONDS) == 0)
-            dff->value.hasServerPicoseconds = false;
-
         currentDeltaField++;
     }
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_DataSetWriter_enqueueEvent(UA_PubSubManager *psm, UA_DataSetWriter *dsw,
+                              UA_Variant *fields, size_t fieldsSize) {
+    UA_DataSetWriterEvent *e = (UA_DataSetWriterEvent*)
+        UA_malloc(sizeof(UA_DataSetWriterEvent));
+    if(!e) {
+        UA_Array_delete(fields, fieldsSize, &UA_TYPES[UA_TYPES_VARIANT]);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    e->fields = fields;
+    e->fieldsSize = fieldsSize;
+
+    /* Drop the oldest event if the queue is full */
+    if(dsw->eventQueueSize >= UA_DATASETWRITER_MAXEVENTQUEUESIZE) {
+        UA_DataSetWriterEvent *oldest = TAILQ_FIRST(&dsw->eventQueue);
+        TAILQ_REMOVE(&dsw->eventQueue, oldest, listEntry);
+        UA_Array_delete(oldest->fields, oldest->fieldsSize, &UA_TYPES[UA_TYPES_VARIANT]);
+        UA_free(oldest);
+        dsw->eventQueueSize--;
+        dsw->eventQueueOverflows++;
+    }
+
+    TAILQ_INSERT_TAIL(&dsw->eventQueue, e, listEntry);
+    dsw->eventQueueSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Move the oldest queued event into the DataSetMessage. Event fields are
+ * always encoded as Variant. Without a queued event a KeepAlive message is
+ * generated. */
+static UA_StatusCode
+UA_PubSubDataSetWriter_generateEventMessage(UA_PubSubManager *psm,
+                                            UA_DataSetMessage *dsm,
+                                            UA_DataSetWriter *dsw) {
+    if(dsw->eventQueueOverflows > 0) {
+        UA_LOG_WARNING_PUBSUB(psm->logging, dsw, "%lu events were dropped "
+                              "because the event queue was full",
+                              (long unsigned)dsw->eventQueueOverflows);
+        dsw->eventQueueOverflows = 0;
+    }
+
+    dsm->header.dataSetMessageValid = true;
+    UA_DataSetWriterEvent *e = TAILQ_FIRST(&dsw->eventQueue);
+    if(!e) {
+        dsm->header.dataSetMessageType = UA_DATASETMESSAGE_KEEPALIVE;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    TAILQ_REMOVE(&dsw->eventQueue, e, listEntry);
+    dsw->eventQueueSize--;
+
+    dsm->header.dataSetMessageType = UA_DATASETMESSAGE_EVENT;
+    dsm->header.fieldEncoding = UA_FIELDENCODING_VARIANT;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(e->fieldsSize > 0) {
+        dsm->data.keyFrameFields = (UA_DataValue*)
+            UA_Array_new(e->fieldsSize, &UA_TYPES[UA_TYPES_DATAVALUE]);
+        if(dsm->data.keyFrameFields) {
+            dsm->fieldCount = (UA_UInt16)e->fieldsSize;
+            for(size_t i = 0; i < e->fieldsSize; i++) {
+                /* Move the field into the DataValue */
+                dsm->data.keyFrameFields[i].value = e->fields[i];
+                dsm->data.keyFrameFields[i].hasValue = true;
+                UA_Variant_init(&e->fields[i]);
+            }
+        } else {
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+    }
+
+    UA_Array_delete(e->fields, e->fieldsSize, &UA_TYPES[UA_TYPES_VARIANT]);
+    UA_free(e);
+    return res;
+}
+
 /* Generate a DataSetMessage for the given writer. */
 UA_StatusCode
 UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
@@ -650,6 +743,9 @@ UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
         return UA_STATUSCODE_GOOD;
     }
 
+    if(pds->config.publishedDataSetType == UA_PUBSUB_DATASET_PUBLISHEDEVENTS)
+        return UA_PubSubDataSetWriter_generateEventMessage(psm, dataSetMessage, dsw);
+
     /* JSON does not differ between deltaframes and keyframes, only keyframes
      * are currently used. */
     if(dsm && psm->sc.server->config.pubSubConfig.enableDeltaFrames) {
@@ -676,19 +772,20 @@ UA_DataSetWriter_generateDataSetMessage(UA_PubSubManager *psm,
 
             dsw->connectedDataSetVersion =
                 pds->dataSetMetaData.configurationVersion;
-            UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw);
-            dsw->deltaFrameCounter = 0;
-            return UA_STATUSCODE_GOOD;
+            dsw->deltaFrameCounter = 1;
+            return UA_PubSubDataSetWriter_generateKeyFrameMessage(psm, dataSetMessage, dsw);
         }
 
         /* The standard defines: if a PDS contains only one fields no delta messages
          * should be generated because they need more memory than a keyframe with 1
-         * field. */
+         * field. The KeyFrameCount is the number of DataSetMessages (including
+         * the KeyFrame) until the next KeyFrame is sent. RawData encoding has no
+         * DeltaFrames. */
         if(pds->fieldSize > 1 && dsw->deltaFrameCounter > 0 &&
-           dsw->deltaFrameCounter <= dsw->config.keyFrameCount) {
-            UA_PubSubDataSetWriter_generateDeltaFrameMessage(psm, dataSetMessage, dsw);
+           dsw->deltaFrameCounter < dsw->config.keyFrameCount &&
+           dataSetMessage->header.fieldEncoding != UA_FIELDENCODING_RAWDATA) {
             dsw->deltaFrameCounter++;
-            return UA_STATUSCODE_GOOD;
+            return UA_PubSubDataSetWriter_generateDeltaFrameMessage(psm, dataSetMessage, dsw);
         }
 
         dsw->deltaFrameCounter = 1;
@@ -961,8 +961,39 @@ UA_WriterGroup_publishCallback(UA_PubSubManager *psm, UA_WriterGroup *wg) {
         /* PDS can be NULL -> Heartbeat */
         UA_PublishedDataSet *pds = dsw->connectedDataSet;
 
-        /* Generate the DSM */
+        /* Queued events are sent right away. One DataSetMessage per event.
+         * Without queued events, a KeepAlive is sent when no message was sent
+         * for the KeepAliveTime. */
         dsWriterIds[dsmCount] = dsw->config.dataSetWriterId;
+        if(pds && pds->config.publishedDataSetType ==
+           UA_PUBSUB_DATASET_PUBLISHEDEVENTS) {
+            UA_DateTime now = el->dateTime_nowMonotonic(el);
+            UA_DateTime keepAliveTime = (UA_DateTime)
+                (wg->config.keepAliveTime * UA_DATETIME_MSEC);
+            if(dsw->eventQueueSize == 0 &&
+               now - dsw->lastEventMessage < keepAliveTime)
+                continue;
+            do {
+                UA_StatusCode res =
+                    UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount]);
+                if(res != UA_STATUSCODE_GOOD) {
+                    UA_LOG_ERROR_PUBSUB(psm->logging, dsw,
+                                        "PubSub Publish: DataSetMessage creation failed");
+                    UA_DataSetMessage_clear(&dsmStore[dsmCount]);
+                    UA_DataSetWriter_setPubSubState(psm, dsw, UA_PUBSUBSTATE_ERROR);
+                    break;
+                }
+                wg->lastPublishTimeStamp = now;
+                dsw->lastEventMessage = now;
+                sendNetworkMessage(psm, wg, connection, &dsmStore[dsmCount],
+                                   &dsWriterIds[dsmCount], 1);
+                UA_DataSetMessage_clear(&dsmStore[dsmCount]);
+            } while(dsw->eventQueueSize > 0 &&
+                    dsw->head.state == UA_PUBSUBSTATE_OPERATIONAL);
+            continue; /* Don't increase the dsmCount, reuse the slot */
+        }
+
+        /* Generate the DSM */
         UA_StatusCode res =
             UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsmStore[dsmCount]);
         if(res != UA_STATUSCODE_GOOD) {
@@ -1035,10 +1035,12 @@ UA_Node_deleteReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForwar
             /* Remove from array */
             UA_NodePointer_clear(&target->targetId);
 
-            /* Elements remaining. Realloc. */
+            /* Elements remaining. Move the following targets down to keep
+             * the order. Browse continuation points rely on it. Realloc. */
             if(refs->targetsSize > 0) {
-                if(target != &refs->targets.array[refs->targetsSize])
-                    *target = refs->targets.array[refs->targetsSize];
+                size_t pos = (size_t)(target - refs->targets.array);
+                memmove(target, &target[1],
+                        sizeof(UA_ReferenceTarget) * (refs->targetsSize - pos));
                 UA_ReferenceTarget *newRefs = (UA_ReferenceTarget*)
                     UA_realloc(refs->targets.array,
                                sizeof(UA_ReferenceTarget) * refs->targetsSize);
@@ -440,6 +440,11 @@ UA_Server_delete(UA_Server *server) {
         UA_Server_removeSession(server, current, UA_SHUTDOWNREASON_CLOSE);
     }
     UA_Array_delete(server->namespaces, server->namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+    clearValueCache(server);
+    clearTranslateCache(server);
+#ifdef UA_ENABLE_METHODCALLS
+    clearMethodCache(server);
+#endif
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* Remove subscriptions without a session */
@@ -577,10 +582,16 @@ UA_Server_init(UA_Server *server) {
 #endif
 
 #ifdef UA_ENABLE_NODESET_INJECTOR
-    res = UA_Server_injectNodesets(server);
-    UA_CHECK_STATUS(res, goto cleanup);
+    /* The injected nodesets are part of the image */
+    if(server->config.nodestoreImage.length == 0) {
+        res = UA_Server_injectNodesets(server);
+        UA_CHECK_STATUS(res, goto cleanup);
+    }
 #endif
 
+    /* The image is not owned by the server */
+    server->config.nodestoreImage = UA_BYTESTRING_NULL;
+
     /* Initialize the binay protocol support */
     addServerComponent(server, UA_BinaryProtocolManager_new(server), NULL);
 
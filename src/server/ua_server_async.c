@@ -557,7 +557,8 @@ Service_Read(UA_Server *server, UA_Session *session, const UA_ReadRequest *reque
     UA_AsyncOperation *aopArray = (UA_AsyncOperation*)&ar[1];
     for(size_t i = 0; i < request->nodesToReadSize; i++) {
         UA_Boolean done = Operation_Read(server, session, request->timestampsToReturn,
-                                         &request->nodesToRead[i], &response->results[i]);
+                                         request->maxAge, &request->nodesToRead[i],
+                                         &response->results[i]);
         if(!done)
             persistAsyncResponseOperation(server, &aopArray[i],
                                           UA_ASYNCOPERATIONTYPE_READ_REQUEST,
@@ -591,7 +592,8 @@ read_async(UA_Server *server, UA_Session *session, const UA_ReadValueId *operati
     }
 
     /* Call the operation */
-    UA_Boolean done = Operation_Read(server, session, ttr, operation, &op->output.directRead);
+    UA_Boolean done = Operation_Read(server, session, ttr, -1.0, operation,
+                                     &op->output.directRead);
     if(!done)
         return persistAsyncDirectOperation(server, op, UA_ASYNCOPERATIONTYPE_READ_DIRECT,
                                            context, (uintptr_t)callback, timeoutDate);
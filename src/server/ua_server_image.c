@@ -0,0 +1,597 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_server_internal.h"
+#include "../ua_types_encoding_binary.h"
+
+/* Binary image of the nodestore. All fields use the OPC UA binary encoding.
+ *
+ * Header:
+ *   UInt32 magic "UANI"
+ *   UInt32 version
+ *   UInt32 nameHashCheck (hash of a fixed QualifiedName)
+ *   UInt32 namespacesSize, String namespaces (starting at index 2)
+ *   UInt32 referenceTypesSize (stored first in the node list)
+ *   UInt32 nodesSize
+ *
+ * Node:
+ *   NodeClass, NodeId, QualifiedName browseName
+ *   UInt32 displayNameSize, LocalizedText displayName
+ *   UInt32 descriptionSize, LocalizedText description
+ *   UInt32 writeMask, Boolean constructed
+ *   Attributes depending on the NodeClass
+ *   UInt32 referencesSize
+ *     Byte referenceTypeIndex, Boolean isInverse, Boolean hasRefTree
+ *     UInt32 targetsSize, (ExpandedNodeId targetId, UInt32 targetNameHash)
+ *
+ * The open62541-specific members (context, callbacks, lifecycle, value
+ * sources) are not part of the image. Values from a callback or an external
+ * value source are stored as empty internal values.
+ *
+ * The targetNameHash is stored instead of recomputed when loading. The
+ * nameHashCheck in the header rejects images written with another hash
+ * function for the BrowseNames. */
+
+#define UA_NODESTOREIMAGE_MAGIC 0x494E4155 /* "UANI" */
+#define UA_NODESTOREIMAGE_VERSION 2
+
+static UA_UInt32
+imageNameHashCheck(void) {
+    UA_QualifiedName qn = UA_QUALIFIEDNAME(1, "open62541 nodestore image");
+    return UA_QualifiedName_hash(&qn);
+}
+
+/************/
+/* Encoding */
+/************/
+
+typedef struct {
+    UA_ByteString buf;
+    size_t pos;
+    UA_StatusCode res;
+} ImageEncoder;
+
+static void
+imageEncode(ImageEncoder *e, const void *p, const UA_DataType *type) {
+    if(e->res != UA_STATUSCODE_GOOD)
+        return;
+
+    /* Grow the buffer */
+    size_t size = UA_calcSizeBinary(p, type, NULL);
+    if(e->buf.length - e->pos < size) {
+        size_t newLength = e->buf.length * 2;
+        if(newLength < e->pos + size)
+            newLength = e->pos + size;
+        UA_Byte *newData = (UA_Byte*)UA_realloc(e->buf.data, newLength);
+        if(!newData) {
+            e->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        e->buf.data = newData;
+        e->buf.length = newLength;
+    }
+
+    UA_Byte *bufPos = &e->buf.data[e->pos];
+    const UA_Byte *bufEnd = &e->buf.data[e->buf.length];
+    e->res = UA_encodeBinaryInternal(p, type, &bufPos, &bufEnd, NULL, NULL, NULL);
+    e->pos = (size_t)(bufPos - e->buf.data);
+}
+
+static void
+imageEncodeUInt32(ImageEncoder *e, UA_UInt32 v) {
+    imageEncode(e, &v, &UA_TYPES[UA_TYPES_UINT32]);
+}
+
+static void
+imageEncodeBoolean(ImageEncoder *e, UA_Boolean v) {
+    imageEncode(e, &v, &UA_TYPES[UA_TYPES_BOOLEAN]);
+}
+
+static void
+imageEncodeLocalizedTextList(ImageEncoder *e, const UA_LocalizedTextListEntry *list) {
+    UA_UInt32 size = 0;
+    for(const UA_LocalizedTextListEntry *lt = list; lt; lt = lt->next)
+        size++;
+    imageEncodeUInt32(e, size);
+    for(const UA_LocalizedTextListEntry *lt = list; lt; lt = lt->next)
+        imageEncode(e, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+}
+
+static void *
+imageEncodeTarget(void *context, UA_ReferenceTarget *t) {
+    ImageEncoder *e = (ImageEncoder*)context;
+    UA_ExpandedNodeId id = UA_NodePointer_toExpandedNodeId(t->targetId);
+    imageEncode(e, &id, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    imageEncodeUInt32(e, t->targetNameHash);
+    return NULL;
+}
+
+static void
+imageEncodeVariableAttributes(ImageEncoder *e, const UA_Node *node) {
+    /* VariableNode and VariableTypeNode share the layout of the attributes */
+    const UA_VariableNode *vn = &node->variableNode;
+    imageEncode(e, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    imageEncode(e, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    imageEncodeUInt32(e, (UA_UInt32)vn->arrayDimensionsSize);
+    for(size_t i = 0; i < vn->arrayDimensionsSize; i++)
+        imageEncodeUInt32(e, vn->arrayDimensions[i]);
+    UA_DataValue empty;
+    UA_DataValue_init(&empty);
+    const UA_DataValue *value = (vn->valueSourceType == UA_VALUESOURCETYPE_INTERNAL) ?
+        &vn->valueSource.internal.value : &empty;
+    imageEncode(e, value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
+static void
+imageEncodeNode(ImageEncoder *e, const UA_Node *node) {
+    const UA_NodeHead *head = &node->head;
+    imageEncode(e, &head->nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    imageEncode(e, &head->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    imageEncode(e, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    imageEncodeLocalizedTextList(e, head->displayName);
+    imageEncodeLocalizedTextList(e, head->description);
+    imageEncodeUInt32(e, head->writeMask);
+    imageEncodeBoolean(e, head->constructed);
+
+    switch(head->nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        imageEncodeVariableAttributes(e, node);
+        imageEncode(e, &node->variableNode.accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        imageEncode(e, &node->variableNode.minimumSamplingInterval,
+                    &UA_TYPES[UA_TYPES_DOUBLE]);
+        imageEncodeBoolean(e, node->variableNode.historizing);
+        imageEncodeBoolean(e, node->variableNode.isDynamic);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        imageEncodeVariableAttributes(e, node);
+        imageEncodeBoolean(e, node->variableTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_METHOD:
+        imageEncodeBoolean(e, node->methodNode.executable);
+        break;
+    case UA_NODECLASS_OBJECT:
+        imageEncode(e, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        imageEncodeBoolean(e, node->objectTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        imageEncodeBoolean(e, node->referenceTypeNode.isAbstract);
+        imageEncodeBoolean(e, node->referenceTypeNode.symmetric);
+        imageEncode(e, &node->referenceTypeNode.inverseName,
+                    &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        imageEncodeUInt32(e, UA_REFERENCETYPESET_MAX / 32);
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX / 32; i++)
+            imageEncodeUInt32(e, node->referenceTypeNode.subTypes.bits[i]);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        imageEncodeBoolean(e, node->dataTypeNode.isAbstract);
+        break;
+    case UA_NODECLASS_VIEW:
+        imageEncode(e, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        imageEncodeBoolean(e, node->viewNode.containsNoLoops);
+        break;
+    default:
+        e->res = UA_STATUSCODE_BADINTERNALERROR;
+        return;
+    }
+
+    imageEncodeUInt32(e, (UA_UInt32)head->referencesSize);
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        imageEncode(e, &rk->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        imageEncodeBoolean(e, rk->isInverse);
+        imageEncodeBoolean(e, rk->hasRefTree);
+        imageEncodeUInt32(e, (UA_UInt32)rk->targetsSize);
+        UA_NodeReferenceKind_iterate(rk, imageEncodeTarget, e);
+    }
+}
+
+typedef struct {
+    ImageEncoder e;
+    UA_UInt32 nodesSize;
+} ImageSaveContext;
+
+static void
+imageSaveVisitor(void *context, const UA_Node *node) {
+    /* The ReferenceTypes were stored before */
+    ImageSaveContext *ctx = (ImageSaveContext*)context;
+    if(node->head.nodeClass == UA_NODECLASS_REFERENCETYPE)
+        return;
+    imageEncodeNode(&ctx->e, node);
+    ctx->nodesSize++;
+}
+
+UA_StatusCode
+saveNodestoreImage(UA_Server *server, UA_ByteString *image) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    ImageSaveContext ctx;
+    memset(&ctx, 0, sizeof(ImageSaveContext));
+    ImageEncoder *e = &ctx.e;
+
+    /* Header */
+    imageEncodeUInt32(e, UA_NODESTOREIMAGE_MAGIC);
+    imageEncodeUInt32(e, UA_NODESTOREIMAGE_VERSION);
+    imageEncodeUInt32(e, imageNameHashCheck());
+    imageEncodeUInt32(e, (UA_UInt32)(server->namespacesSize - 2));
+    for(size_t i = 2; i < server->namespacesSize; i++)
+        imageEncode(e, &server->namespaces[i], &UA_TYPES[UA_TYPES_STRING]);
+
+    /* The ReferenceTypes are stored first and in the order of their
+     * ReferenceTypeIndex. Then the index is the same after loading. */
+    UA_Nodestore *ns = server->config.nodestore;
+    UA_UInt32 refTypesSize = 0;
+    while(refTypesSize < UA_REFERENCETYPESET_MAX &&
+          ns->getReferenceTypeId(ns, (UA_Byte)refTypesSize))
+        refTypesSize++;
+    imageEncodeUInt32(e, refTypesSize);
+
+    /* The number of nodes is written when it is known */
+    size_t nodesSizePos = e->pos;
+    imageEncodeUInt32(e, 0);
+
+    for(UA_UInt32 i = 0; i < refTypesSize; i++) {
+        const UA_Node *node =
+            UA_NODESTORE_GET(server, ns->getReferenceTypeId(ns, (UA_Byte)i));
+        if(!node) {
+            e->res = UA_STATUSCODE_BADINTERNALERROR;
+            break;
+        }
+        imageEncodeNode(e, node);
+        UA_NODESTORE_RELEASE(server, node);
+        ctx.nodesSize++;
+    }
+
+    ns->iterate(ns, imageSaveVisitor, &ctx);
+
+    if(e->res != UA_STATUSCODE_GOOD) {
+        UA_ByteString_clear(&e->buf);
+        return e->res;
+    }
+
+    /* Patch the number of nodes */
+    UA_Byte *bufPos = &e->buf.data[nodesSizePos];
+    const UA_Byte *bufEnd = &e->buf.data[e->buf.length];
+    UA_StatusCode res = UA_encodeBinaryInternal(&ctx.nodesSize, &UA_TYPES[UA_TYPES_UINT32],
+                                                &bufPos, &bufEnd, NULL, NULL, NULL);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_ByteString_clear(&e->buf);
+        return res;
+    }
+
+    image->data = e->buf.data;
+    image->length = e->pos;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_saveNodestoreImage(UA_Server *server, UA_ByteString *image) {
+    if(!server || !image)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    lockServer(server);
+    UA_StatusCode res = saveNodestoreImage(server, image);
+    unlockServer(server);
+    return res;
+}
+
+/************/
+/* Decoding */
+/************/
+
+typedef struct {
+    const UA_ByteString *buf;
+    size_t offset;
+    UA_DecodeBinaryOptions options;
+    UA_StatusCode res;
+} ImageDecoder;
+
+static void
+imageDecode(ImageDecoder *d, void *p, const UA_DataType *type) {
+    if(d->res != UA_STATUSCODE_GOOD)
+        return;
+    d->res = UA_decodeBinaryInternal(d->buf, &d->offset, p, type, &d->options);
+}
+
+static UA_UInt32
+imageDecodeUInt32(ImageDecoder *d) {
+    UA_UInt32 v = 0;
+    imageDecode(d, &v, &UA_TYPES[UA_TYPES_UINT32]);
+    return v;
+}
+
+static UA_Boolean
+imageDecodeBoolean(ImageDecoder *d) {
+    UA_Boolean v = false;
+    imageDecode(d, &v, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    return v;
+}
+
+static void
+imageDecodeLocalizedTextList(ImageDecoder *d, UA_LocalizedTextListEntry **list) {
+    /* Append to keep the order */
+    UA_UInt32 size = imageDecodeUInt32(d);
+    for(UA_UInt32 i = 0; i < size && d->res == UA_STATUSCODE_GOOD; i++) {
+        UA_LocalizedTextListEntry *lt = (UA_LocalizedTextListEntry*)
+            UA_calloc(1, sizeof(UA_LocalizedTextListEntry));
+        if(!lt) {
+            d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        *list = lt;
+        list = &lt->next;
+        imageDecode(d, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    }
+}
+
+static void
+imageDecodeVariableAttributes(ImageDecoder *d, UA_Node *node) {
+    UA_VariableNode *vn = &node->variableNode;
+    imageDecode(d, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    imageDecode(d, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    UA_UInt32 dimsSize = imageDecodeUInt32(d);
+    if(dimsSize > 0 && d->res == UA_STATUSCODE_GOOD) {
+        if(dimsSize > d->buf->length - d->offset) {
+            d->res = UA_STATUSCODE_BADDECODINGERROR;
+            return;
+        }
+        vn->arrayDimensions = (UA_UInt32*)UA_malloc(dimsSize * sizeof(UA_UInt32));
+        if(!vn->arrayDimensions) {
+            d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        vn->arrayDimensionsSize = dimsSize;
+        for(UA_UInt32 i = 0; i < dimsSize; i++)
+            vn->arrayDimensions[i] = imageDecodeUInt32(d);
+    }
+    vn->valueSourceType = UA_VALUESOURCETYPE_INTERNAL;
+    imageDecode(d, &vn->valueSource.internal.value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
+static void
+imageDecodeReferences(ImageDecoder *d, UA_NodeHead *head) {
+    UA_UInt32 refsSize = imageDecodeUInt32(d);
+    if(refsSize == 0 || d->res != UA_STATUSCODE_GOOD)
+        return;
+    if(refsSize > d->buf->length - d->offset) {
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        return;
+    }
+
+    head->references = (UA_NodeReferenceKind*)
+        UA_calloc(refsSize, sizeof(UA_NodeReferenceKind));
+    if(!head->references) {
+        d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+    head->referencesSize = refsSize;
+
+    for(size_t i = 0; i < refsSize && d->res == UA_STATUSCODE_GOOD; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        imageDecode(d, &rk->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        rk->isInverse = imageDecodeBoolean(d);
+        UA_Boolean hasRefTree = imageDecodeBoolean(d);
+        UA_UInt32 targetsSize = imageDecodeUInt32(d);
+        if(targetsSize == 0 || d->res != UA_STATUSCODE_GOOD)
+            continue;
+        if(targetsSize > d->buf->length - d->offset) {
+            d->res = UA_STATUSCODE_BADDECODINGERROR;
+            return;
+        }
+
+        /* The targets are known to be unique. Fill the array directly instead
+         * of the lookup for duplicates in UA_Node_addReference. */
+        rk->targets.array = (UA_ReferenceTarget*)
+            UA_malloc(targetsSize * sizeof(UA_ReferenceTarget));
+        if(!rk->targets.array) {
+            d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        for(UA_UInt32 j = 0; j < targetsSize; j++) {
+            UA_ExpandedNodeId id;
+            imageDecode(d, &id, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            UA_UInt32 nameHash = imageDecodeUInt32(d);
+            if(d->res != UA_STATUSCODE_GOOD)
+                return;
+            UA_ReferenceTarget *t = &rk->targets.array[j];
+            t->targetNameHash = nameHash;
+            d->res = UA_NodePointer_copy(UA_NodePointer_fromExpandedNodeId(&id),
+                                         &t->targetId);
+            UA_ExpandedNodeId_clear(&id);
+            if(d->res != UA_STATUSCODE_GOOD)
+                return;
+            rk->targetsSize++;
+        }
+
+        if(hasRefTree)
+            d->res = UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/* Returns the node ready for insertion or NULL */
+static UA_Node *
+imageDecodeNode(UA_Server *server, ImageDecoder *d, UA_ReferenceTypeSet *subTypes) {
+    UA_NodeClass nodeClass = UA_NODECLASS_UNSPECIFIED;
+    imageDecode(d, &nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    if(d->res != UA_STATUSCODE_GOOD)
+        return NULL;
+    UA_Node *node = UA_NODESTORE_NEW(server, nodeClass);
+    if(!node) {
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        return NULL;
+    }
+
+    UA_NodeHead *head = &node->head;
+    imageDecode(d, &head->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    imageDecode(d, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    imageDecodeLocalizedTextList(d, &head->displayName);
+    imageDecodeLocalizedTextList(d, &head->description);
+    head->writeMask = imageDecodeUInt32(d);
+    head->constructed = imageDecodeBoolean(d);
+
+    switch(nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        imageDecodeVariableAttributes(d, node);
+        imageDecode(d, &node->variableNode.accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        imageDecode(d, &node->variableNode.minimumSamplingInterval,
+                    &UA_TYPES[UA_TYPES_DOUBLE]);
+        node->variableNode.historizing = imageDecodeBoolean(d);
+        node->variableNode.isDynamic = imageDecodeBoolean(d);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        imageDecodeVariableAttributes(d, node);
+        node->variableTypeNode.isAbstract = imageDecodeBoolean(d);
+        break;
+    case UA_NODECLASS_METHOD:
+        node->methodNode.executable = imageDecodeBoolean(d);
+        break;
+    case UA_NODECLASS_OBJECT:
+        imageDecode(d, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        node->objectTypeNode.isAbstract = imageDecodeBoolean(d);
+        break;
+    case UA_NODECLASS_REFERENCETYPE: {
+        node->referenceTypeNode.isAbstract = imageDecodeBoolean(d);
+        node->referenceTypeNode.symmetric = imageDecodeBoolean(d);
+        imageDecode(d, &node->referenceTypeNode.inverseName,
+                    &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        /* The bitfield of a build with a smaller UA_REFERENCETYPESET_MAX is
+         * zero-extended */
+        UA_UInt32 bitsSize = imageDecodeUInt32(d);
+        if(bitsSize > UA_REFERENCETYPESET_MAX / 32) {
+            d->res = UA_STATUSCODE_BADDECODINGERROR;
+            break;
+        }
+        *subTypes = UA_REFERENCETYPESET_NONE;
+        for(UA_UInt32 i = 0; i < bitsSize; i++)
+            subTypes->bits[i] = imageDecodeUInt32(d);
+        break;
+    }
+    case UA_NODECLASS_DATATYPE:
+        node->dataTypeNode.isAbstract = imageDecodeBoolean(d);
+        break;
+    case UA_NODECLASS_VIEW:
+        imageDecode(d, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        node->viewNode.containsNoLoops = imageDecodeBoolean(d);
+        break;
+    default:
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        break;
+    }
+
+    imageDecodeReferences(d, head);
+
+    if(d->res != UA_STATUSCODE_GOOD) {
+        UA_NODESTORE_DELETE(server, node);
+        return NULL;
+    }
+    return node;
+}
+
+UA_StatusCode
+loadNodestoreImage(UA_Server *server, const UA_ByteString *image) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    ImageDecoder d;
+    memset(&d, 0, sizeof(ImageDecoder));
+    d.buf = image;
+    d.options.customTypes = server->config.customDataTypes;
+
+    /* Header */
+    UA_UInt32 magic = imageDecodeUInt32(&d);
+    UA_UInt32 version = imageDecodeUInt32(&d);
+    UA_UInt32 nameHashCheck = imageDecodeUInt32(&d);
+    if(d.res != UA_STATUSCODE_GOOD || magic != UA_NODESTOREIMAGE_MAGIC ||
+       version != UA_NODESTOREIMAGE_VERSION ||
+       nameHashCheck != imageNameHashCheck()) {
+        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                     "The nodestore image has an unknown format or version");
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+
+    /* Namespaces. The NodeIds in the image require the same indices. */
+    UA_UInt32 namespacesSize = imageDecodeUInt32(&d);
+    for(UA_UInt32 i = 0; i < namespacesSize && d.res == UA_STATUSCODE_GOOD; i++) {
+        UA_String uri;
+        imageDecode(&d, &uri, &UA_TYPES[UA_TYPES_STRING]);
+        if(d.res != UA_STATUSCODE_GOOD)
+            break;
+        UA_UInt16 nsIndex = addNamespace(server, uri);
+        if(nsIndex != i + 2) {
+            UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                         "The namespace %S from the nodestore image cannot be "
+                         "added with the index %u", uri, (unsigned)(i + 2));
+            d.res = UA_STATUSCODE_BADINTERNALERROR;
+        }
+        UA_String_clear(&uri);
+    }
+
+    UA_UInt32 refTypesSize = imageDecodeUInt32(&d);
+    UA_UInt32 nodesSize = imageDecodeUInt32(&d);
+    if(refTypesSize > UA_REFERENCETYPESET_MAX || refTypesSize > nodesSize)
+        d.res = UA_STATUSCODE_BADDECODINGERROR;
+
+    /* Nodes. The type checks of AddNodes are skipped. */
+    UA_Nodestore *ns = server->config.nodestore;
+    for(UA_UInt32 i = 0; i < nodesSize && d.res == UA_STATUSCODE_GOOD; i++) {
+        UA_ReferenceTypeSet subTypes = UA_REFERENCETYPESET_NONE;
+        UA_Node *node = imageDecodeNode(server, &d, &subTypes);
+        if(!node)
+            break;
+
+        UA_Boolean isRefType = (i < refTypesSize);
+        if(isRefType != (node->head.nodeClass == UA_NODECLASS_REFERENCETYPE)) {
+            UA_NODESTORE_DELETE(server, node);
+            d.res = UA_STATUSCODE_BADDECODINGERROR;
+            break;
+        }
+
+        /* The node is deleted by the nodestore if the insertion fails */
+        UA_NodeId nodeId;
+        d.res = UA_NodeId_copy(&node->head.nodeId, &nodeId);
+        if(d.res != UA_STATUSCODE_GOOD) {
+            UA_NODESTORE_DELETE(server, node);
+            break;
+        }
+        d.res = UA_NODESTORE_INSERT(server, node, NULL);
+        if(d.res != UA_STATUSCODE_GOOD) {
+            UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                         "Could not insert the node %N from the nodestore image",
+                         nodeId);
+            UA_NodeId_clear(&nodeId);
+            break;
+        }
+
+        /* The nodestore assigns the ReferenceTypeIndex on insertion and only
+         * adds the type itself to the subtypes */
+        if(isRefType) {
+            const UA_NodeId *refTypeId = ns->getReferenceTypeId(ns, (UA_Byte)i);
+            if(!refTypeId || !UA_NodeId_equal(refTypeId, &nodeId)) {
+                d.res = UA_STATUSCODE_BADINTERNALERROR;
+            } else {
+                UA_Node *refNode = UA_NODESTORE_GET_EDIT(server, refTypeId);
+                if(refNode) {
+                    refNode->referenceTypeNode.subTypes = subTypes;
+                    UA_NODESTORE_RELEASE(server, refNode);
+                } else {
+                    d.res = UA_STATUSCODE_BADINTERNALERROR;
+                }
+            }
+        }
+        UA_NodeId_clear(&nodeId);
+    }
+
+    if(d.res != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_SERVER,
+                     "Loading the nodestore image failed with %s",
+                     UA_StatusCode_name(d.res));
+        return d.res;
+    }
+
+    UA_LOG_INFO(server->config.logging, UA_LOGCATEGORY_SERVER,
+                "Loaded %u nodes from the nodestore image", (unsigned)nodesSize);
+    return UA_STATUSCODE_GOOD;
+}
@@ -180,6 +180,81 @@ addServerComponent(UA_Server *server, UA_ServerComponent *sc,
 UA_ServerComponent *
 getServerComponentByName(UA_Server *server, UA_String name);
 
+/*************************/
+/* Value Attribute Cache */
+/*************************/
+
+/* Last result of the read callback of a VariableNode with a callback value
+ * source. Entries are created with UA_Server_setVariableNode_valueCache. */
+typedef struct UA_ValueCacheEntry {
+    ZIP_ENTRY(UA_ValueCacheEntry) treeEntry;
+    UA_NodeId nodeId;
+    UA_Double maxAge;     /* Configured max age in milliseconds */
+    UA_Boolean valid;     /* Is a cached value present? */
+    UA_DateTime readTime; /* Monotonic time of the last read callback */
+    UA_DataValue value;
+} UA_ValueCacheEntry;
+
+enum ZIP_CMP
+cmpValueCacheEntry(const void *a, const void *b);
+
+typedef ZIP_HEAD(UA_ValueCacheTree, UA_ValueCacheEntry) UA_ValueCacheTree;
+
+ZIP_FUNCTIONS(UA_ValueCacheTree, UA_ValueCacheEntry, treeEntry,
+              UA_NodeId, nodeId, cmpValueCacheEntry)
+
+/* Drop the cached value. The configuration of the node is retained. */
+void
+invalidateValueCache(UA_Server *server, const UA_NodeId *nodeId);
+
+/* Remove the cache entry of a node (e.g. when the node is deleted) */
+void
+removeValueCache(UA_Server *server, const UA_NodeId *nodeId);
+
+void
+clearValueCache(UA_Server *server);
+
+/*****************************/
+/* TranslateBrowsePath Cache */
+/*****************************/
+
+/* Cached result of TranslateBrowsePathsToNodeIds. The entry is valid only as
+ * long as the generation matches the nodestore generation of the server. */
+typedef struct {
+    UA_Boolean valid;
+    UA_UInt64 generation;
+    UA_UInt32 hash;
+    UA_UInt32 nodeClassMask;
+    UA_BrowsePath path;
+    UA_BrowsePathResult result;
+} UA_TranslateCacheEntry;
+
+void
+clearTranslateCache(UA_Server *server);
+
+/*********************/
+/* Method Call Cache */
+/*********************/
+
+#ifdef UA_ENABLE_METHODCALLS
+/* Validated object-method relation together with the argument definitions of
+ * the method. The entry is valid only as long as the generation matches the
+ * nodestore generation of the server. */
+typedef struct {
+    UA_Boolean valid;
+    UA_UInt64 generation;
+    UA_UInt32 hash;
+    UA_NodeId objectId;
+    UA_NodeId methodId;
+    size_t inputArgumentsSize;
+    UA_Argument *inputArguments;
+    size_t outputArgumentsSize;
+} UA_MethodCacheEntry;
+
+void
+clearMethodCache(UA_Server *server);
+#endif
+
 /********************/
 /* Server Structure */
 /********************/
@@ -229,6 +304,25 @@ struct UA_Server {
      * the parent and member instantiation */
     UA_Boolean bootstrapNS0;
 
+    /* Cached values of callback value sources */
+    UA_ValueCacheTree valueCache;
+
+    /* Incremented for every structural change of the information model (added,
+     * replaced or removed nodes and references) */
+    UA_UInt64 nodestoreGeneration;
+
+    /* Direct-mapped cache of TranslateBrowsePathsToNodeIds results. Allocated
+     * on first use with config.translateBrowsePathCacheSize entries. */
+    size_t translateCacheSize;
+    UA_TranslateCacheEntry *translateCache;
+
+#ifdef UA_ENABLE_METHODCALLS
+    /* Direct-mapped cache of validated method calls. Allocated on first use
+     * with config.methodCallCacheSize entries. */
+    size_t methodCacheSize;
+    UA_MethodCacheEntry *methodCache;
+#endif
+
     /* Subscriptions */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* The admin session is initialized with a special subscription. This
@@ -245,6 +339,14 @@ struct UA_Server {
 
 # ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
     LIST_HEAD(, UA_ConditionSource) conditionSources;
+    /* Index of the ConditionSources and Conditions by their NodeId */
+    UA_ConditionSourceTree conditionSourceTree;
+    UA_ConditionTree conditionTree;
+    /* Branches with Retain == true that have been triggered. Only these are
+     * emitted during a ConditionRefresh. */
+    LIST_HEAD(, UA_ConditionBranch) retainedConditionBranches;
+    UA_UInt32 conditionRefreshCounter; /* Validity of the per-source memo of
+                                        * the notifier reachability */
     UA_NodeId refreshEvents[2];
 # endif
 #endif
@@ -256,6 +358,11 @@ struct UA_Server {
     /* Statistics */
     UA_SecureChannelStatistics secureChannelStatistics;
     UA_ServerDiagnosticsSummaryDataType serverDiagnosticsSummary;
+#ifdef UA_ENABLE_DIAGNOSTICS
+    /* Diagnostics objects of Sessions or Subscriptions are not yet created
+     * (config.lazyDiagnostics) */
+    UA_Boolean diagnosticsPending;
+#endif
 
     /* GDS Manager for certificate management */
     UA_GDSManager gdsManager;
@@ -504,6 +611,15 @@ writeAttribute(UA_Server *server, UA_Session *session,
                const UA_NodeId *nodeId, const UA_AttributeId attributeId,
                const void *attr, const UA_DataType *attr_type);
 
+/* Write the value of a VariableNode that was already resolved from the
+ * nodestore (with _getEditNode). The type check is skipped for scalar values of
+ * checkedType. And checkedType is set when the type check succeeded. */
+UA_StatusCode
+writeResolvedValueAttribute(UA_Server *server, UA_Session *session,
+                            UA_VariableNode *node, const UA_DataValue *value,
+                            const UA_String *indexRange,
+                            const UA_DataType **checkedType);
+
 #define UA_WRITEATTRIBUTEFUNCS(ATTR, ATTRID, TYPE, TYPENAME)            \
     static UA_INLINE UA_StatusCode                                      \
     write##ATTR##Attribute(UA_Server *server, const UA_NodeId nodeId,   \
@@ -536,6 +652,16 @@ readWithSession(UA_Server *server, UA_Session *session,
                 const UA_ReadValueId *item,
                 UA_TimestampsToReturn timestampsToReturn);
 
+/* Read an attribute of a node that was already resolved from the nodestore.
+ * With borrow, the value of a variable with an internal value source (and no
+ * onRead callback and no index range) is not copied. The returned DataValue
+ * then points into the node and is only valid until the node is released or
+ * written. */
+UA_DataValue
+readResolvedAttribute(UA_Server *server, UA_Session *session,
+                      const UA_Node *node, const UA_ReadValueId *item,
+                      UA_TimestampsToReturn ttr, UA_Boolean borrow);
+
 UA_StatusCode
 readWithReadValue(UA_Server *server, const UA_NodeId *nodeId,
                   const UA_AttributeId attributeId, void *v);
@@ -770,6 +896,14 @@ addNode_finish(UA_Server *server, UA_Session *session, const UA_NodeId *nodeId);
 
 UA_StatusCode initNS0(UA_Server *server);
 
+/* Binary image of the nodestore (see UA_Server_saveNodestoreImage). Loading
+ * only works for an empty nodestore. */
+UA_StatusCode
+saveNodestoreImage(UA_Server *server, UA_ByteString *image);
+
+UA_StatusCode
+loadNodestoreImage(UA_Server *server, const UA_ByteString *image);
+
 #ifdef UA_ENABLE_GDS_PUSHMANAGEMENT
 UA_StatusCode
 initNS0PushManagement(UA_Server *server);
@@ -782,6 +916,12 @@ void createSessionObject(UA_Server *server, UA_Session *session);
 void createSubscriptionObject(UA_Server *server, UA_Session *session,
                               UA_Subscription *sub);
 
+/* Create the pending diagnostics objects (config.lazyDiagnostics) if the node
+ * is part of the diagnostics branch or is the object of a pending Session.
+ * Returns whether objects were created. Call only if
+ * server->diagnosticsPending is set. */
+UA_Boolean createLazyDiagnosticsObjects(UA_Server *server, const UA_NodeId *nodeId);
+
 UA_StatusCode
 readDiagnostics(UA_Server *server, const UA_NodeId *sessionId, void *sessionContext,
                 const UA_NodeId *nodeId, void *nodeContext, UA_Boolean sourceTimestamp,
@@ -819,21 +959,55 @@ readSessionSecurityDiagnostics(UA_Server *server,
 #define UA_NODESTORE_DELETE(server, node)                               \
     server->config.nodestore->deleteNode(server->config.nodestore, node)
 
+/* The diagnostics objects of Sessions and Subscriptions are created when a
+ * lookup of their node fails (config.lazyDiagnostics). This is the common path
+ * for the NodeIds used in all services. */
+#ifdef UA_ENABLE_DIAGNOSTICS
+# define UA_NODESTORE_LAZY_RETRY(server, nodeId)                        \
+    (UA_UNLIKELY((server)->diagnosticsPending) &&                       \
+     createLazyDiagnosticsObjects(server, nodeId))
+#else
+# define UA_NODESTORE_LAZY_RETRY(server, nodeId) false
+#endif
+
+/* Get the node with only the selected attributes and references */
+static UA_INLINE const UA_Node *
+UA_NODESTORE_GET_SELECTIVE(UA_Server *server, const UA_NodeId *nodeId,
+                           UA_UInt32 attrMask, UA_ReferenceTypeSet refs,
+                           UA_BrowseDirection refDirs) {
+    UA_Nodestore *ns = server->config.nodestore;
+    const UA_Node *node = ns->getNode(ns, nodeId, attrMask, refs, refDirs);
+    if(!node && UA_NODESTORE_LAZY_RETRY(server, nodeId))
+        node = ns->getNode(ns, nodeId, attrMask, refs, refDirs);
+    return node;
+}
+
+/* Get the editable node with only the selected attributes and references */
+static UA_INLINE UA_Node *
+UA_NODESTORE_GET_EDIT_SELECTIVE(UA_Server *server, const UA_NodeId *nodeId,
+                                UA_UInt32 attrMask, UA_ReferenceTypeSet refs,
+                                UA_BrowseDirection refDirs) {
+    UA_Nodestore *ns = server->config.nodestore;
+    UA_Node *node = ns->getEditNode(ns, nodeId, attrMask, refs, refDirs);
+    if(!node && UA_NODESTORE_LAZY_RETRY(server, nodeId))
+        node = ns->getEditNode(ns, nodeId, attrMask, refs, refDirs);
+    return node;
+}
+
 /* Get the node with all attributes and references */
 static UA_INLINE const UA_Node *
 UA_NODESTORE_GET(UA_Server *server, const UA_NodeId *nodeId) {
-    return server->config.nodestore->
-        getNode(server->config.nodestore, nodeId, UA_NODEATTRIBUTESMASK_ALL,
-                UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    return UA_NODESTORE_GET_SELECTIVE(server, nodeId, UA_NODEATTRIBUTESMASK_ALL,
+                                      UA_REFERENCETYPESET_ALL,
+                                      UA_BROWSEDIRECTION_BOTH);
 }
 
 /* Get the editable node with all attributes and references */
 static UA_INLINE UA_Node *
 UA_NODESTORE_GET_EDIT(UA_Server *server, const UA_NodeId *nodeId) {
-    return server->config.nodestore->
-        getEditNode(server->config.nodestore, nodeId,
-                    UA_NODEATTRIBUTESMASK_ALL, UA_REFERENCETYPESET_ALL,
-                    UA_BROWSEDIRECTION_BOTH);
+    return UA_NODESTORE_GET_EDIT_SELECTIVE(server, nodeId, UA_NODEATTRIBUTESMASK_ALL,
+                                           UA_REFERENCETYPESET_ALL,
+                                           UA_BROWSEDIRECTION_BOTH);
 }
 
 /* Get the node with all attributes and references */
@@ -845,14 +1019,6 @@ UA_NODESTORE_GETFROMREF(UA_Server *server, UA_NodePointer target) {
                        UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
 }
 
-#define UA_NODESTORE_GET_SELECTIVE(server, nodeid, attrMask, refs, refDirs) \
-    server->config.nodestore->getNode(server->config.nodestore,             \
-                                      nodeid, attrMask, refs, refDirs)
-
-#define UA_NODESTORE_GET_EDIT_SELECTIVE(server, nodeid, attrMask, refs, refDirs) \
-    server->config.nodestore->getEditNode(server->config.nodestore,              \
-                                          nodeid, attrMask, refs, refDirs)
-
 #define UA_NODESTORE_GETFROMREF_SELECTIVE(server, target, attrMask, refs, refDirs) \
     server->config.nodestore->getNodeFromPtr(server->config.nodestore,             \
                                              target, attrMask, refs, refDirs)
@@ -860,17 +1026,27 @@ UA_NODESTORE_GETFROMREF(UA_Server *server, UA_NodePointer target) {
 #define UA_NODESTORE_RELEASE(server, node)                              \
     server->config.nodestore->releaseNode(server->config.nodestore, node)
 
-#define UA_NODESTORE_GETCOPY(server, nodeid, outnode)                      \
-    server->config.nodestore->getNodeCopy(server->config.nodestore, nodeid, outnode)
+static UA_INLINE UA_StatusCode
+UA_NODESTORE_GETCOPY(UA_Server *server, const UA_NodeId *nodeId, UA_Node **outNode) {
+    UA_Nodestore *ns = server->config.nodestore;
+    UA_StatusCode res = ns->getNodeCopy(ns, nodeId, outNode);
+    if(res == UA_STATUSCODE_BADNODEIDUNKNOWN &&
+       UA_NODESTORE_LAZY_RETRY(server, nodeId))
+        res = ns->getNodeCopy(ns, nodeId, outNode);
+    return res;
+}
 
-#define UA_NODESTORE_INSERT(server, node, addedNodeId)                    \
-    server->config.nodestore->insertNode(server->config.nodestore, node, addedNodeId)
+#define UA_NODESTORE_INSERT(server, node, addedNodeId)                  \
+    ((server)->nodestoreGeneration++,                                   \
+     server->config.nodestore->insertNode(server->config.nodestore, node, addedNodeId))
 
 #define UA_NODESTORE_REPLACE(server, node)                              \
-    server->config.nodestore->replaceNode(server->config.nodestore, node)
+    ((server)->nodestoreGeneration++,                                   \
+     server->config.nodestore->replaceNode(server->config.nodestore, node))
 
 #define UA_NODESTORE_REMOVE(server, nodeId)                             \
-    server->config.nodestore->removeNode(server->config.nodestore, nodeId)
+    ((server)->nodestoreGeneration++,                                   \
+     server->config.nodestore->removeNode(server->config.nodestore, nodeId))
 
 #define UA_NODESTORE_GETREFERENCETYPEID(server, index)                  \
     server->config.nodestore->getReferenceTypeId(server->config.nodestore, index)
@@ -909,19 +909,25 @@ UA_StatusCode
 initNS0(UA_Server *server) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    /* Initialize base nodes which are always required an cannot be created
-     * through the NS compiler */
+    UA_StatusCode retVal = UA_STATUSCODE_GOOD;
     server->bootstrapNS0 = true;
-    UA_StatusCode retVal = createNS0_base(server);
+    if(server->config.nodestoreImage.length > 0) {
+        /* Load the nodes from the binary image instead of creating them one by
+         * one. The callbacks are set up below as usual. */
+        retVal = loadNodestoreImage(server, &server->config.nodestoreImage);
+    } else {
+        /* Initialize base nodes which are always required an cannot be created
+         * through the NS compiler */
+        retVal = createNS0_base(server);
 
 #ifdef UA_GENERATED_NAMESPACE_ZERO
-    /* Load nodes and references generated from the XML ns0 definition */
-    retVal |= namespace0_generated(server);
+        /* Load nodes and references generated from the XML ns0 definition */
+        retVal |= namespace0_generated(server);
 #else
-    /* Create a minimal server object */
-    retVal |= minimalServerObject(server);
+        /* Create a minimal server object */
+        retVal |= minimalServerObject(server);
 #endif
-
+    }
     server->bootstrapNS0 = false;
 
     if(retVal != UA_STATUSCODE_GOOD) {
@@ -161,9 +161,9 @@ readSubscriptionDiagnosticsArray(UA_Server *server,
     return UA_STATUSCODE_GOOD;
 }
 
-void
-createSubscriptionObject(UA_Server *server, UA_Session *session,
-                         UA_Subscription *sub) {
+static void
+addSubscriptionObject(UA_Server *server, UA_Session *session,
+                      UA_Subscription *sub) {
     UA_ExpandedNodeId *children = NULL;
     size_t childrenSize = 0;
     UA_ReferenceTypeSet refTypes;
@@ -235,6 +235,17 @@ createSubscriptionObject(UA_Server *server, UA_Session *session,
     }
 }
 
+void
+createSubscriptionObject(UA_Server *server, UA_Session *session,
+                         UA_Subscription *sub) {
+    /* Deferred until the diagnostics branch is accessed */
+    if(server->config.lazyDiagnostics) {
+        server->diagnosticsPending = true;
+        return;
+    }
+    addSubscriptionObject(server, session, sub);
+}
+
 /***********************/
 /* Session Diagnostics */
 /***********************/
@@ -478,8 +489,8 @@ readSessionSecurityDiagnostics(UA_Server *server,
     return UA_STATUSCODE_GOOD;
 }
 
-void
-createSessionObject(UA_Server *server, UA_Session *session) {
+static void
+addSessionObject(UA_Server *server, UA_Session *session) {
     UA_ExpandedNodeId *children = NULL;
     size_t childrenSize = 0;
     UA_ReferenceTypeSet refTypes;
@@ -499,6 +510,7 @@ createSessionObject(UA_Server *server, UA_Session *session) {
                                 &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES], NULL, NULL);
     if(res != UA_STATUSCODE_GOOD)
         goto cleanup;
+    session->diagnosticsObject = true;
 
     /* Recursively browse all children */
     res = referenceTypeIndices(server, &hasComponent, &refTypes, false);
@@ -525,6 +537,109 @@ createSessionObject(UA_Server *server, UA_Session *session) {
     UA_Array_delete(children, childrenSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
 }
 
+void
+createSessionObject(UA_Server *server, UA_Session *session) {
+    /* Deferred until the diagnostics branch is accessed */
+    if(server->config.lazyDiagnostics) {
+        server->diagnosticsPending = true;
+        return;
+    }
+    addSessionObject(server, session);
+}
+
+/* The Session objects are found below SessionsDiagnosticsSummary. The
+ * Subscription objects are additionally referenced from the server-wide
+ * SubscriptionDiagnosticsArray. Accessing these nodes creates all pending
+ * objects. */
+static UA_Boolean
+isDiagnosticsBranch(const UA_NodeId *nodeId) {
+    if(nodeId->namespaceIndex != 0 ||
+       nodeId->identifierType != UA_NODEIDTYPE_NUMERIC)
+        return false;
+    switch(nodeId->identifier.numeric) {
+    case UA_NS0ID_SERVER_SERVERDIAGNOSTICS:
+    case UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY:
+    case UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SUBSCRIPTIONDIAGNOSTICSARRAY:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static UA_Boolean
+sessionObjectsPending(UA_Session *session) {
+    if(!session->diagnosticsObject)
+        return true;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    UA_Subscription *sub;
+    TAILQ_FOREACH(sub, &session->subscriptions, sessionListEntry) {
+        if(UA_NodeId_isNull(&sub->ns0Id))
+            return true;
+    }
+#endif
+    return false;
+}
+
+static void
+addPendingSessionObjects(UA_Server *server, UA_Session *session) {
+    if(!session->diagnosticsObject)
+        addSessionObject(server, session);
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    UA_Subscription *sub;
+    TAILQ_FOREACH(sub, &session->subscriptions, sessionListEntry) {
+        if(UA_NodeId_isNull(&sub->ns0Id))
+            addSubscriptionObject(server, session, sub);
+    }
+#endif
+}
+
+/* Session objects can also be accessed directly with the SessionId (a Guid in
+ * namespace 1) from the CreateSessionResponse. Only the objects of that
+ * Session are created. */
+static UA_Session *
+findPendingSession(UA_Server *server, const UA_NodeId *nodeId) {
+    if(nodeId->namespaceIndex != 1 ||
+       nodeId->identifierType != UA_NODEIDTYPE_GUID)
+        return NULL;
+    session_list_entry *sentry;
+    LIST_FOREACH(sentry, &server->sessions, pointers) {
+        if(UA_NodeId_equal(&sentry->session.sessionId, nodeId))
+            return (sessionObjectsPending(&sentry->session)) ? &sentry->session : NULL;
+    }
+    return NULL;
+}
+
+UA_Boolean
+createLazyDiagnosticsObjects(UA_Server *server, const UA_NodeId *nodeId) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_Session *pending = NULL;
+    if(!isDiagnosticsBranch(nodeId)) {
+        pending = findPendingSession(server, nodeId);
+        if(!pending)
+            return false;
+    }
+
+    /* Reset first. Adding the objects internally reads and browses nodes. */
+    server->diagnosticsPending = false;
+
+    session_list_entry *sentry;
+    if(pending) {
+        addPendingSessionObjects(server, pending);
+        /* Other Sessions remain pending */
+        LIST_FOREACH(sentry, &server->sessions, pointers) {
+            if(sessionObjectsPending(&sentry->session)) {
+                server->diagnosticsPending = true;
+                break;
+            }
+        }
+        return true;
+    }
+
+    LIST_FOREACH(sentry, &server->sessions, pointers)
+        addPendingSessionObjects(server, &sentry->session);
+    return true;
+}
+
 /***************************/
 /* Server-Wide Diagnostics */
 /***************************/
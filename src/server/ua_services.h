@@ -163,7 +163,7 @@ Service_Read(UA_Server *server, UA_Session *session,
 
 UA_Boolean
 Operation_Read(UA_Server *server, UA_Session *session,
-               UA_TimestampsToReturn ttr,
+               UA_TimestampsToReturn ttr, UA_Double maxAge,
                const UA_ReadValueId *rvi, UA_DataValue *dv);
 
 UA_Boolean
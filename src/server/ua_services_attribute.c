@@ -190,16 +190,153 @@ readExternalValueAttribute(UA_Server *server, UA_Session *session,
     return (!rangeptr) ? UA_DataValue_copy(val, v) : UA_DataValue_copyRange(val, v, *rangeptr);
 }
 
+/*************************/
+/* Value Attribute Cache */
+/*************************/
+
+enum ZIP_CMP
+cmpValueCacheEntry(const void *a, const void *b) {
+    return (enum ZIP_CMP)UA_NodeId_order((const UA_NodeId*)a, (const UA_NodeId*)b);
+}
+
+static void *
+deleteValueCacheEntry(void *context, UA_ValueCacheEntry *entry) {
+    UA_NodeId_clear(&entry->nodeId);
+    UA_DataValue_clear(&entry->value);
+    UA_free(entry);
+    return NULL;
+}
+
+void
+invalidateValueCache(UA_Server *server, const UA_NodeId *nodeId) {
+    if(!ZIP_ROOT(&server->valueCache))
+        return;
+    UA_ValueCacheEntry *entry =
+        ZIP_FIND(UA_ValueCacheTree, &server->valueCache, nodeId);
+    if(!entry || !entry->valid)
+        return;
+    UA_DataValue_clear(&entry->value);
+    entry->valid = false;
+}
+
+void
+removeValueCache(UA_Server *server, const UA_NodeId *nodeId) {
+    if(!ZIP_ROOT(&server->valueCache))
+        return;
+    UA_ValueCacheEntry *entry =
+        ZIP_FIND(UA_ValueCacheTree, &server->valueCache, nodeId);
+    if(!entry)
+        return;
+    ZIP_REMOVE(UA_ValueCacheTree, &server->valueCache, entry);
+    deleteValueCacheEntry(NULL, entry);
+}
+
+void
+clearValueCache(UA_Server *server) {
+    ZIP_ITER(UA_ValueCacheTree, &server->valueCache, deleteValueCacheEntry, NULL);
+    ZIP_INIT(&server->valueCache);
+}
+
+UA_StatusCode
+UA_Server_setVariableNode_valueCache(UA_Server *server, const UA_NodeId nodeId,
+                                     UA_Double maxAge) {
+    if(!server || maxAge != maxAge) /* NaN */
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    lockServer(server);
+
+    /* Only variables can have a value cache */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    const UA_Node *node = UA_NODESTORE_GET(server, &nodeId);
+    if(!node) {
+        res = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        goto out;
+    }
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        res = UA_STATUSCODE_BADNODECLASSINVALID;
+    UA_NODESTORE_RELEASE(server, node);
+    if(res != UA_STATUSCODE_GOOD)
+        goto out;
+
+    /* Disable the cache */
+    if(maxAge <= 0.0) {
+        removeValueCache(server, &nodeId);
+        goto out;
+    }
+
+    /* Update an existing entry. Drop the cached value as it might be older
+     * than the new maxAge allows. */
+    UA_ValueCacheEntry *entry =
+        ZIP_FIND(UA_ValueCacheTree, &server->valueCache, &nodeId);
+    if(entry) {
+        invalidateValueCache(server, &nodeId);
+        entry->maxAge = maxAge;
+        goto out;
+    }
+
+    /* Create a new entry */
+    entry = (UA_ValueCacheEntry*)UA_calloc(1, sizeof(UA_ValueCacheEntry));
+    if(!entry) {
+        res = UA_STATUSCODE_BADOUTOFMEMORY;
+        goto out;
+    }
+    res = UA_NodeId_copy(&nodeId, &entry->nodeId);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_free(entry);
+        goto out;
+    }
+    entry->maxAge = maxAge;
+    ZIP_INSERT(UA_ValueCacheTree, &server->valueCache, entry);
+
+ out:
+    unlockServer(server);
+    return res;
+}
+
+/* Returns the cache entry if the read callback of the node shall be cached */
+static UA_ValueCacheEntry *
+getValueCacheEntry(UA_Server *server, const UA_VariableNode *vn) {
+    if(!ZIP_ROOT(&server->valueCache))
+        return NULL;
+    return ZIP_FIND(UA_ValueCacheTree, &server->valueCache, &vn->head.nodeId);
+}
+
+/* The cached value is used if it is younger than both the configured maxAge of
+ * the node and the maxAge of the request. A negative request maxAge is used for
+ * internal reads that are only bounded by the configuration of the node. */
+static UA_Boolean
+isValueCacheFresh(UA_Server *server, const UA_ValueCacheEntry *entry,
+                  UA_Double maxAge) {
+    if(!entry->valid)
+        return false;
+    if(maxAge < 0.0 || maxAge > entry->maxAge)
+        maxAge = entry->maxAge;
+    UA_EventLoop *el = server->config.eventLoop;
+    UA_DateTime age = el->dateTime_nowMonotonic(el) - entry->readTime;
+    return ((UA_Double)age < maxAge * (UA_Double)UA_DATETIME_MSEC);
+}
+
 static UA_StatusCode
 readCallbackValueAttribute(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
                            UA_TimestampsToReturn timestamps,
-                           UA_NumericRange *rangeptr) {
+                           UA_NumericRange *rangeptr, UA_Double maxAge) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     if(!vn->valueSource.callback.read)
         return UA_STATUSCODE_BADINTERNALERROR;
-    UA_Boolean sourceTimeStamp = (timestamps == UA_TIMESTAMPSTORETURN_SOURCE ||
+
+    /* Serve from the cache */
+    UA_ValueCacheEntry *entry = getValueCacheEntry(server, vn);
+    if(entry && isValueCacheFresh(server, entry, maxAge)) {
+        return (!rangeptr) ? UA_DataValue_copy(&entry->value, v) :
+            UA_DataValue_copyRange(&entry->value, v, *rangeptr);
+    }
+
+    /* Cached values always include the source timestamp. It is removed
+     * afterwards if it was not requested. */
+    UA_Boolean sourceTimeStamp = (entry != NULL ||
+                                  timestamps == UA_TIMESTAMPSTORETURN_SOURCE ||
                                   timestamps == UA_TIMESTAMPSTORETURN_BOTH);
     UA_StatusCode retval = vn->valueSource.callback.
         read(server,
@@ -213,13 +350,23 @@ readCallbackValueAttribute(UA_Server *server, UA_Session *session,
         retval = UA_DataValue_copy(v, &v2);
         *v = v2;
     }
+
+    /* Update the cache. Only complete (non-range, synchronous) reads are
+     * cached. If the copy fails, the cache remains empty. */
+    if(entry && !rangeptr && retval == UA_STATUSCODE_GOOD) {
+        UA_DataValue_clear(&entry->value);
+        entry->valid = (UA_DataValue_copy(v, &entry->value) == UA_STATUSCODE_GOOD);
+        UA_EventLoop *el = server->config.eventLoop;
+        entry->readTime = el->dateTime_nowMonotonic(el);
+    }
     return retval;
 }
 
 static UA_StatusCode
 readValueAttributeComplete(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_TimestampsToReturn timestamps,
-                           const UA_String *indexRange, UA_DataValue *v) {
+                           const UA_String *indexRange, UA_Double maxAge,
+                           UA_DataValue *v) {
     UA_EventLoop *el = server->config.eventLoop;
 
     /* Parse the index range */
@@ -242,7 +389,8 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
         retval = readExternalValueAttribute(server, session, vn, v, rangeptr);
         break;
     case UA_VALUESOURCETYPE_CALLBACK:
-        retval = readCallbackValueAttribute(server, session, vn, v, timestamps, rangeptr);
+        retval = readCallbackValueAttribute(server, session, vn, v,
+                                            timestamps, rangeptr, maxAge);
         break;
     default:
         retval = UA_STATUSCODE_BADINTERNALERROR;
@@ -266,7 +414,7 @@ UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v) {
     return readValueAttributeComplete(server, session, vn,
-                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, v);
+                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, 0.0, v);
 }
 
 static const UA_String binEncoding = {sizeof("Default Binary")-1, (UA_Byte*)"Default Binary"};
@@ -279,11 +427,35 @@ static const UA_String jsonEncoding = {sizeof("Default JSON")-1, (UA_Byte*)"Defa
         break;                                                  \
     }
 
+static void
+setReadTimestamps(UA_Server *server, UA_TimestampsToReturn timestampsToReturn,
+                  UA_DataValue *v) {
+    /* Always use the current time as the server-timestamp */
+    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
+       timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH) {
+        UA_EventLoop *el = server->config.eventLoop;
+        v->serverTimestamp = el->dateTime_now(el);
+        v->hasServerTimestamp = true;
+        v->hasServerPicoseconds = false;
+    } else {
+        v->hasServerTimestamp = false;
+        v->hasServerPicoseconds = false;
+    }
+
+    /* Don't "invent" source timestamps. But remove them when not required. */
+    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
+       timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER) {
+        v->hasSourceTimestamp = false;
+        v->hasSourcePicoseconds = false;
+    }
+}
+
 /* Returns whether the operation is done or an async operation has been
- * triggered. */
+ * triggered. The maxAge (in ms) bounds the age of cached values. Negative
+ * values use the maxAge configured for the node. */
 static UA_Boolean
 ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *session,
-                       UA_TimestampsToReturn timestampsToReturn,
+                       UA_TimestampsToReturn timestampsToReturn, UA_Double maxAge,
                        const UA_ReadValueId *id, UA_DataValue *v) {
     UA_LOG_TRACE_SESSION(server->config.logging, session,
                          "Read attribute %"PRIi32 " of Node %N",
@@ -392,7 +564,8 @@ ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *sessi
             }
         }
         retval = readValueAttributeComplete(server, session, &node->variableNode,
-                                            timestampsToReturn, &id->indexRange, v);
+                                            timestampsToReturn, &id->indexRange,
+                                            maxAge, v);
         break;
     }
     case UA_ATTRIBUTEID_DATATYPE:
@@ -514,24 +687,7 @@ ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *sessi
         v->status = retval;
     }
 
-    /* Always use the current time as the server-timestamp */
-    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
-       timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH) {
-        UA_EventLoop *el = server->config.eventLoop;
-        v->serverTimestamp = el->dateTime_now(el);
-        v->hasServerTimestamp = true;
-        v->hasServerPicoseconds = false;
-    } else {
-        v->hasServerTimestamp = false;
-        v->hasServerPicoseconds = false;
-    }
-
-    /* Don't "invent" source timestamps. But remove them when not required. */
-    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
-       timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER) {
-        v->hasSourceTimestamp = false;
-        v->hasSourcePicoseconds = false;
-    }
+    setReadTimestamps(server, timestampsToReturn, v);
 
     /* Are we done or is this an async read? */
     return (retval != UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY);
@@ -539,13 +695,15 @@ ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *sessi
 
 UA_Boolean
 Operation_Read(UA_Server *server, UA_Session *session,
-               UA_TimestampsToReturn ttr,
+               UA_TimestampsToReturn ttr, UA_Double maxAge,
                const UA_ReadValueId *rvi, UA_DataValue *dv) {
+    const UA_NodeId *nodeId = UA_Session_resolveNodeId(session, &rvi->nodeId);
+
     /* Get the node (with only the selected attribute if the NodeStore supports that) */
     UA_UInt32 attrMask = attributeId2AttributeMask((UA_AttributeId)rvi->attributeId);
     const UA_Node *node =
-        UA_NODESTORE_GET_SELECTIVE(server, &rvi->nodeId, attrMask,
-                                   UA_REFERENCETYPESET_NONE, UA_BROWSEDIRECTION_INVALID);
+        UA_NODESTORE_GET_SELECTIVE(server, nodeId, attrMask, UA_REFERENCETYPESET_NONE,
+                                   UA_BROWSEDIRECTION_INVALID);
     if(!node) {
         dv->hasStatus = true;
         dv->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
@@ -553,7 +711,7 @@ Operation_Read(UA_Server *server, UA_Session *session,
     }
 
     /* Perform the read operation */
-    UA_Boolean done = ReadWithNodeMaybeAsync(node, server, session, ttr, rvi, dv);
+    UA_Boolean done = ReadWithNodeMaybeAsync(node, server, session, ttr, maxAge, rvi, dv);
     UA_NODESTORE_RELEASE(server, node);
     return done;
 }
@@ -575,7 +733,47 @@ readWithSession(UA_Server *server, UA_Session *session,
         return dv;
     }
 
-    UA_Boolean done = Operation_Read(server, session, ttr, item, &dv);
+    UA_Boolean done = Operation_Read(server, session, ttr, -1.0, item, &dv);
+    if(!done) {
+        if(server->config.asyncOperationCancelCallback)
+            server->config.asyncOperationCancelCallback(server, &dv);
+        dv.hasStatus = true;
+        dv.status = UA_STATUSCODE_BADWAITINGFORRESPONSE;
+    }
+    return dv;
+}
+
+UA_DataValue
+readResolvedAttribute(UA_Server *server, UA_Session *session,
+                      const UA_Node *node, const UA_ReadValueId *item,
+                      UA_TimestampsToReturn ttr, UA_Boolean borrow) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    UA_DataValue dv;
+    UA_DataValue_init(&dv);
+
+    /* Borrow the value stored in the node */
+    if(borrow && item->attributeId == UA_ATTRIBUTEID_VALUE &&
+       item->indexRange.length == 0 && item->dataEncoding.name.length == 0 &&
+       node->head.nodeClass == UA_NODECLASS_VARIABLE &&
+       node->variableNode.valueSourceType == UA_VALUESOURCETYPE_INTERNAL &&
+       !node->variableNode.valueSource.internal.notifications.onRead &&
+       (getUserAccessLevel(server, session, &node->variableNode) &
+        UA_ACCESSLEVELMASK_READ)) {
+        dv = node->variableNode.valueSource.internal.value;
+        dv.value.storageType = UA_VARIANT_DATA_NODELETE;
+        dv.hasValue = true;
+        if(!dv.hasSourceTimestamp) {
+            UA_EventLoop *el = server->config.eventLoop;
+            dv.sourceTimestamp = el->dateTime_now(el);
+            dv.hasSourceTimestamp = true;
+        }
+        setReadTimestamps(server, ttr, &dv);
+        return dv;
+    }
+
+    UA_Boolean done = ReadWithNodeMaybeAsync(node, server, session, ttr,
+                                             -1.0, item, &dv);
     if(!done) {
         if(server->config.asyncOperationCancelCallback)
             server->config.asyncOperationCancelCallback(server, &dv);
@@ -1388,10 +1586,14 @@ writeInternalValueAttribute(UA_DataValue *oldValue,
     return retval;
 }
 
+/* If checkedType is non-NULL, then the type check is skipped for scalar values
+ * of that type. And the type is stored there when the check succeeds for a
+ * scalar value that needs no adjustment. */
 static UA_StatusCode
 writeNodeValueAttribute(UA_Server *server, UA_Session *session,
                         UA_VariableNode *node, const UA_DataValue *value,
-                        const UA_String *indexRange) {
+                        const UA_String *indexRange,
+                        const UA_DataType **checkedType) {
     UA_assert(node != NULL);
     UA_assert(session != NULL);
     UA_LOCK_ASSERT(&server->serviceMutex);
@@ -1413,7 +1615,11 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
 
     /* Type checking. May change the type of adjustedValue */
     const char *reason;
-    if(value->hasValue && value->value.type) {
+    UA_Boolean cacheType = (checkedType && !rangeptr && value->hasValue &&
+                            UA_Variant_isScalar(&value->value));
+    if(cacheType && *checkedType == value->value.type) {
+        /* The type was already checked for the node */
+    } else if(value->hasValue && value->value.type) {
         /* Try to correct the type */
         adjustValueType(server, &adjustedValue.value, &node->dataType);
 
@@ -1436,6 +1642,10 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
                 UA_free(rangeptr->dimensions);
             return UA_STATUSCODE_BADTYPEMISMATCH;
         }
+
+        /* Remember the checked type */
+        if(cacheType && adjustedValue.value.type == value->value.type)
+            *checkedType = value->value.type;
     }
 
     /* If no source timestamp is defined create one here.
@@ -1473,6 +1683,7 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
                 write(server, &session->sessionId, session->context,
                       &node->head.nodeId, node->head.context, rangeptr, value);
         *editValue = oldv; /* undo the above */
+        invalidateValueCache(server, &node->head.nodeId);
         break;
     }
     default:
@@ -1480,6 +1691,13 @@ writeNodeValueAttribute(UA_Server *server, UA_Session *session,
         break;
     }
 
+#ifdef UA_ENABLE_METHODCALLS
+    /* Invalidate the cached argument definitions of methods */
+    if(retval == UA_STATUSCODE_GOOD &&
+       adjustedValue.value.type == &UA_TYPES[UA_TYPES_ARGUMENT])
+        server->nodestoreGeneration++;
+#endif
+
     /* Write into the historical data backend. Not that the historical data
      * backend can be configured to "poll" data like a MonitoredItem also. */
 #ifdef UA_ENABLE_HISTORIZING
@@ -1588,7 +1806,7 @@ triggerImmediateDataChange(UA_Server *server, UA_Session *session,
         UA_DataValue_init(&value);
         UA_Boolean done =
             ReadWithNodeMaybeAsync(node, server, session, mon->timestampsToReturn,
-                                   &mon->itemToMonitor, &value);
+                                   0.0, &mon->itemToMonitor, &value);
         if(!done) {
             if(server->config.asyncOperationCancelCallback)
                 server->config.asyncOperationCancelCallback(server, &value);
@@ -1692,7 +1910,7 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
             CHECK_USERWRITEMASK(UA_WRITEMASK_VALUEFORVARIABLETYPE);
         }
         retval = writeNodeValueAttribute(server, session, &node->variableNode,
-                                         &wvalue->value, &wvalue->indexRange);
+                                         &wvalue->value, &wvalue->indexRange, NULL);
         break;
     case UA_ATTRIBUTEID_DATATYPE:
         CHECK_NODECLASS_WRITE(UA_NODECLASS_VARIABLE | UA_NODECLASS_VARIABLETYPE);
@@ -1765,6 +1983,12 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
         return retval;
     }
 
+    /* Invalidate the cached type checks of resolved nodes */
+    if(wvalue->attributeId == UA_ATTRIBUTEID_DATATYPE ||
+       wvalue->attributeId == UA_ATTRIBUTEID_VALUERANK ||
+       wvalue->attributeId == UA_ATTRIBUTEID_ARRAYDIMENSIONS)
+        server->nodestoreGeneration++;
+
     /* Trigger MonitoredItems with no SamplingInterval */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     triggerImmediateDataChange(server, session, node, wvalue);
@@ -1773,11 +1997,44 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+writeResolvedValueAttribute(UA_Server *server, UA_Session *session,
+                            UA_VariableNode *node, const UA_DataValue *value,
+                            const UA_String *indexRange,
+                            const UA_DataType **checkedType) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    if(!(getUserAccessLevel(server, session, node) & UA_ACCESSLEVELMASK_WRITE))
+        return UA_STATUSCODE_BADUSERACCESSDENIED;
+
+    UA_StatusCode res = writeNodeValueAttribute(server, session, node, value,
+                                                indexRange, checkedType);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Trigger MonitoredItems with no SamplingInterval */
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = node->head.nodeId;
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    wv.value = *value;
+    if(indexRange)
+        wv.indexRange = *indexRange;
+    triggerImmediateDataChange(server, session, (UA_Node*)node, &wv);
+#endif
+
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_Boolean
 Operation_Write(UA_Server *server, UA_Session *session,
                 const UA_WriteValue *wv, UA_StatusCode *result) {
     UA_assert(session != NULL);
-    *result = UA_Server_editNode(server, session, &wv->nodeId, wv->attributeId,
+    *result = UA_Server_editNode(server, session,
+                                 UA_Session_resolveNodeId(session, &wv->nodeId),
+                                 wv->attributeId,
                                  UA_REFERENCETYPESET_NONE, UA_BROWSEDIRECTION_INVALID,
                                  (UA_EditNodeCallback)copyAttributeIntoNode,
                                  (void*)(uintptr_t)wv);
@@ -2071,14 +2328,40 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
                                     data, historyDataType);
         historyData[i] = data;
     }
+
+    /* Resolve the aliases from RegisterNodes in a shallow copy of the
+     * nodesToRead. The copy is only made if aliases are used. */
+    const UA_HistoryReadValueId *nodesToRead = request->nodesToRead;
+    UA_HistoryReadValueId *resolved = NULL;
+    for(size_t i = 0; i < request->nodesToReadSize; ++i) {
+        const UA_NodeId *nodeId =
+            UA_Session_resolveNodeId(session, &request->nodesToRead[i].nodeId);
+        if(nodeId == &request->nodesToRead[i].nodeId)
+            continue;
+        if(!resolved) {
+            resolved = (UA_HistoryReadValueId*)
+                UA_malloc(request->nodesToReadSize * sizeof(UA_HistoryReadValueId));
+            if(!resolved) {
+                UA_free(historyData);
+                response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+                return true;
+            }
+            memcpy(resolved, request->nodesToRead,
+                   request->nodesToReadSize * sizeof(UA_HistoryReadValueId));
+            nodesToRead = resolved;
+        }
+        resolved[i].nodeId = *nodeId;
+    }
+
     readHistory(server, server->config.historyDatabase.context,
                 &session->sessionId, session->context,
                 &request->requestHeader,
                 request->historyReadDetails.content.decoded.data,
                 request->timestampsToReturn,
                 request->releaseContinuationPoints,
-                request->nodesToReadSize, request->nodesToRead,
+                request->nodesToReadSize, nodesToRead,
                 response, historyData);
+    UA_free(resolved); /* Shallow copy */
     UA_free(historyData);
 
     return true;
@@ -2111,16 +2394,19 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
             request->historyUpdateDetails[i].content.decoded.type;
         void *updateDetailsData = request->historyUpdateDetails[i].content.decoded.data;
 
+        /* The details are resolved in shallow copies with the NodeId from the
+         * aliases of RegisterNodes */
         if(updateDetailsType == &UA_TYPES[UA_TYPES_UPDATEDATADETAILS]) {
             if(!server->config.historyDatabase.updateData) {
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_UpdateDataDetails details = *(UA_UpdateDataDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 updateData(server, server->config.historyDatabase.context,
                            &session->sessionId, session->context,
-                           &request->requestHeader,
-                           (UA_UpdateDataDetails*)updateDetailsData,
+                           &request->requestHeader, &details,
                            &response->results[i]);
             continue;
         }
@@ -2130,11 +2416,13 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_DeleteRawModifiedDetails details =
+                *(UA_DeleteRawModifiedDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 deleteRawModified(server, server->config.historyDatabase.context,
                                   &session->sessionId, session->context,
-                                  &request->requestHeader,
-                                  (UA_DeleteRawModifiedDetails*)updateDetailsData,
+                                  &request->requestHeader, &details,
                                   &response->results[i]);
             continue;
         }
@@ -2144,11 +2432,12 @@ Service_HistoryUpdate(UA_Server *server, UA_Session *session,
                 response->results[i].statusCode = UA_STATUSCODE_BADNOTSUPPORTED;
                 continue;
             }
+            UA_DeleteEventDetails details = *(UA_DeleteEventDetails*)updateDetailsData;
+            details.nodeId = *UA_Session_resolveNodeId(session, &details.nodeId);
             server->config.historyDatabase.
                 deleteEvent(server, server->config.historyDatabase.context,
                             &session->sessionId, session->context,
-                            &request->requestHeader,
-                            (UA_DeleteEventDetails*)updateDetailsData,
+                            &request->requestHeader, &details,
                             &response->results[i]);
             continue;
         }
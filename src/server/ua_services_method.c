@@ -63,11 +63,16 @@ getArgumentsVariableNode(UA_Server *server, const UA_NodeHead *head,
     return NULL;
 }
 
-/* inputArgumentResults has the length request->inputArgumentsSize */
+/* Get the argument definitions from the "InputArguments" node. A missing node
+ * is the same as a method without arguments. */
 static UA_StatusCode
-checkAdjustArguments(UA_Server *server, UA_Session *session,
-                     const UA_VariableNode *argRequirements, size_t argsSize,
-                     UA_Variant *args, UA_StatusCode *inputArgumentResults) {
+getArgumentsDefinition(const UA_VariableNode *argRequirements,
+                       const UA_Argument **argReqs, size_t *argReqsSize) {
+    *argReqs = NULL;
+    *argReqsSize = 0;
+    if(!argRequirements)
+        return UA_STATUSCODE_GOOD;
+
     /* Verify that we have a Variant containing UA_Argument (scalar or array) in
      * the "InputArguments" node */
     if(argRequirements->valueSourceType != UA_VALUESOURCETYPE_INTERNAL)
@@ -79,11 +84,21 @@ checkAdjustArguments(UA_Server *server, UA_Session *session,
     if(argVal->type != &UA_TYPES[UA_TYPES_ARGUMENT])
         return UA_STATUSCODE_BADINTERNALERROR;
 
-    /* Verify the number of arguments. A scalar argument value is interpreted as
-     * an array of length 1. */
-    size_t argReqsSize = argVal->arrayLength;
+    /* A scalar argument value is interpreted as an array of length 1 */
+    *argReqs = (const UA_Argument*)argVal->data;
+    *argReqsSize = argVal->arrayLength;
     if(UA_Variant_isScalar(argVal))
-        argReqsSize = 1;
+        *argReqsSize = 1;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* inputArgumentResults has the length request->inputArgumentsSize */
+static UA_StatusCode
+checkAdjustArguments(UA_Server *server, UA_Session *session,
+                     const UA_Argument *argReqs, size_t argReqsSize,
+                     size_t argsSize, UA_Variant *args,
+                     UA_StatusCode *inputArgumentResults) {
+    /* Verify the number of arguments */
     if(argReqsSize > argsSize)
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     if(argReqsSize < argsSize)
@@ -91,7 +106,6 @@ checkAdjustArguments(UA_Server *server, UA_Session *session,
 
     /* Type-check every argument against the definition */
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
-    UA_Argument *argReqs = (UA_Argument*)argVal->data;
     const char *reason;
     for(size_t i = 0; i < argReqsSize; ++i) {
         /* Incompatible value. Try to correct the type if possible. */
@@ -237,6 +251,96 @@ checkFunctionalGroupMethodReference(UA_Server *server, const UA_NodeHead *h,
     return UA_STATUSCODE_GOOD;
 }
 
+/* The validation does not depend on the session. So the cache is shared
+ * between all sessions. Only successful validations are cached. */
+static UA_UInt32
+hashMethodCall(const UA_NodeId *objectId, const UA_NodeId *methodId) {
+    UA_UInt32 methodHash = UA_NodeId_hash(methodId);
+    return UA_ByteString_hash(UA_NodeId_hash(objectId),
+                              (const UA_Byte*)&methodHash, sizeof(UA_UInt32));
+}
+
+static void
+clearMethodCacheEntry(UA_MethodCacheEntry *entry) {
+    UA_NodeId_clear(&entry->objectId);
+    UA_NodeId_clear(&entry->methodId);
+    UA_Array_delete(entry->inputArguments, entry->inputArgumentsSize,
+                    &UA_TYPES[UA_TYPES_ARGUMENT]);
+    entry->inputArguments = NULL;
+    entry->inputArgumentsSize = 0;
+    entry->valid = false;
+}
+
+void
+clearMethodCache(UA_Server *server) {
+    for(size_t i = 0; i < server->methodCacheSize; i++)
+        clearMethodCacheEntry(&server->methodCache[i]);
+    UA_free(server->methodCache);
+    server->methodCache = NULL;
+    server->methodCacheSize = 0;
+}
+
+static const UA_MethodCacheEntry *
+lookupMethodCache(UA_Server *server, const UA_NodeId *objectId,
+                  const UA_NodeId *methodId) {
+    /* Cache disabled */
+    UA_UInt32 cacheSize = server->config.methodCallCacheSize;
+    if(cacheSize == 0) {
+        if(server->methodCacheSize > 0)
+            clearMethodCache(server);
+        return NULL;
+    }
+    if(server->methodCacheSize != cacheSize)
+        return NULL;
+
+    /* The entry is valid only if no nodes or references were changed in the
+     * meantime */
+    UA_UInt32 hash = hashMethodCall(objectId, methodId);
+    const UA_MethodCacheEntry *entry = &server->methodCache[hash % cacheSize];
+    if(!entry->valid || entry->generation != server->nodestoreGeneration ||
+       entry->hash != hash || !UA_NodeId_equal(&entry->objectId, objectId) ||
+       !UA_NodeId_equal(&entry->methodId, methodId))
+        return NULL;
+    return entry;
+}
+
+static void
+storeMethodCache(UA_Server *server, const UA_NodeId *objectId,
+                 const UA_NodeId *methodId, const UA_Argument *inputArgs,
+                 size_t inputArgsSize, size_t outputArgsSize) {
+    UA_UInt32 cacheSize = server->config.methodCallCacheSize;
+    if(cacheSize == 0)
+        return;
+
+    /* Allocate the cache on first use or when the configured size changed */
+    if(server->methodCacheSize != cacheSize) {
+        clearMethodCache(server);
+        server->methodCache = (UA_MethodCacheEntry*)
+            UA_calloc(cacheSize, sizeof(UA_MethodCacheEntry));
+        if(!server->methodCache)
+            return;
+        server->methodCacheSize = cacheSize;
+    }
+
+    /* Replace the entry */
+    UA_UInt32 hash = hashMethodCall(objectId, methodId);
+    UA_MethodCacheEntry *entry = &server->methodCache[hash % cacheSize];
+    clearMethodCacheEntry(entry);
+    UA_StatusCode res = UA_NodeId_copy(objectId, &entry->objectId);
+    res |= UA_NodeId_copy(methodId, &entry->methodId);
+    res |= UA_Array_copy(inputArgs, inputArgsSize, (void**)&entry->inputArguments,
+                         &UA_TYPES[UA_TYPES_ARGUMENT]);
+    if(res != UA_STATUSCODE_GOOD) {
+        clearMethodCacheEntry(entry);
+        return;
+    }
+    entry->inputArgumentsSize = inputArgsSize;
+    entry->outputArgumentsSize = outputArgsSize;
+    entry->generation = server->nodestoreGeneration;
+    entry->hash = hash;
+    entry->valid = true;
+}
+
 static void
 callWithMethodAndObject(UA_Server *server, UA_Session *session,
                         const UA_CallMethodRequest *request, UA_CallMethodResult *result,
@@ -262,16 +366,22 @@ callWithMethodAndObject(UA_Server *server, UA_Session *session,
         return;
     }
 
+    /* The object-method relation was validated before */
+    UA_Boolean found =
+        (lookupMethodCache(server, &request->objectId, &request->methodId) != NULL);
+
     /* Verify method/object relations. Object must have a hasComponent or a
      * subtype of hasComponent reference to the method node. Therefore, check
      * every reference between the parent object and the method node if there is
      * a hasComponent (or subtype) reference */
     UA_ExpandedNodeId methodId = UA_EXPANDEDNODEID_NODEID(request->methodId);
     UA_ReferenceTypeSet hasComponentRefs;
-    result->statusCode = referenceTypeIndices(server, &hasComponentNodeId,
-                                              &hasComponentRefs, true);
-    UA_CHECK_STATUS(result->statusCode, return);
-    UA_Boolean found = checkMethodReference(&object->head, hasComponentRefs, &methodId);
+    if(!found) {
+        result->statusCode = referenceTypeIndices(server, &hasComponentNodeId,
+                                                  &hasComponentRefs, true);
+        UA_CHECK_STATUS(result->statusCode, return);
+        found = checkMethodReference(&object->head, hasComponentRefs, &methodId);
+    }
 
     if(!found) {
         /* If the object doesn't have a hasComponent reference to the method node,
@@ -343,17 +453,37 @@ callWithMethodAndObject(UA_Server *server, UA_Session *session,
     }
     result->inputArgumentResultsSize = request->inputArgumentsSize;
 
-    /* Type-check the input arguments */
-    const UA_VariableNode *inputArguments =
-        getArgumentsVariableNode(server, &method->head, UA_STRING("InputArguments"));
-    if(inputArguments) {
+    /* Type-check the input arguments. Look up the cache again, the access
+     * control callback might have changed the information model. */
+    size_t outputArgsSize = 0;
+    const UA_MethodCacheEntry *entry =
+        lookupMethodCache(server, &request->objectId, &request->methodId);
+    if(entry) {
+        outputArgsSize = entry->outputArgumentsSize;
         result->statusCode =
-            checkAdjustArguments(server, session, inputArguments, request->inputArgumentsSize,
+            checkAdjustArguments(server, session, entry->inputArguments,
+                                 entry->inputArgumentsSize, request->inputArgumentsSize,
                                  mutableInputArgs, result->inputArgumentResults);
+    } else {
+        const UA_VariableNode *inputArguments =
+            getArgumentsVariableNode(server, &method->head, UA_STRING("InputArguments"));
+        const UA_VariableNode *outputArguments =
+            getArgumentsVariableNode(server, &method->head, UA_STRING("OutputArguments"));
+        if(outputArguments)
+            outputArgsSize = outputArguments->valueSource.internal.value.value.arrayLength;
+        const UA_Argument *argReqs;
+        size_t argReqsSize;
+        result->statusCode = getArgumentsDefinition(inputArguments, &argReqs, &argReqsSize);
+        if(result->statusCode == UA_STATUSCODE_GOOD) {
+            storeMethodCache(server, &request->objectId, &request->methodId,
+                             argReqs, argReqsSize, outputArgsSize);
+            result->statusCode =
+                checkAdjustArguments(server, session, argReqs, argReqsSize,
+                                     request->inputArgumentsSize, mutableInputArgs,
+                                     result->inputArgumentResults);
+        }
         UA_NODESTORE_RELEASE(server, (const UA_Node*)inputArguments);
-    } else if(request->inputArgumentsSize > 0) {
-        result->statusCode = UA_STATUSCODE_BADTOOMANYARGUMENTS;
-        return;
+        UA_NODESTORE_RELEASE(server, (const UA_Node*)outputArguments);
     }
 
     /* Return inputArgumentResults only for BADINVALIDARGUMENT */
@@ -368,17 +498,10 @@ callWithMethodAndObject(UA_Server *server, UA_Session *session,
     if(result->statusCode != UA_STATUSCODE_GOOD)
         return;
 
-    /* Get the output arguments node */
-    const UA_VariableNode *outputArguments =
-        getArgumentsVariableNode(server, &method->head, UA_STRING("OutputArguments"));
-
     /* Allocate the output arguments array. Always allocate memory, hence the
      * +1, even if the length is zero. Because we need a unique outputArguments
      * pointer as the key for async operations. The memory gets deleted in
      * UA_Array_delete even if the outputArgumentsSize is zero. */
-    size_t outputArgsSize = 0;
-    if(outputArguments)
-        outputArgsSize = outputArguments->valueSource.internal.value.value.arrayLength;
     result->outputArguments = (UA_Variant*)
         UA_Array_new(outputArgsSize+1, &UA_TYPES[UA_TYPES_VARIANT]);
     if(!result->outputArguments) {
@@ -387,9 +510,6 @@ callWithMethodAndObject(UA_Server *server, UA_Session *session,
     }
     result->outputArgumentsSize = outputArgsSize;
 
-    /* Release the output arguments node */
-    UA_NODESTORE_RELEASE(server, (const UA_Node*)outputArguments);
-
     /* Call the method. If this is an async method, unlock the server lock for
      * the duration of the (long-running) call. */
     result->statusCode = method->method(server, &session->sessionId, session->context,
@@ -407,6 +527,12 @@ Operation_CallMethod(UA_Server *server, UA_Session *session,
                      UA_CallMethodResult *result) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Resolve registered NodeIds (shallow copy of the request) */
+    UA_CallMethodRequest resolved = *request;
+    resolved.objectId = *UA_Session_resolveNodeId(session, &request->objectId);
+    resolved.methodId = *UA_Session_resolveNodeId(session, &request->methodId);
+    request = &resolved;
+
     /* Get the method node. We only need the nodeClass and executable attribute.
      * Take all forward hasProperty references to get the input/output argument
      * definition variables. */
@@ -458,6 +458,15 @@ Operation_CreateMonitoredItem(UA_Server *server, UA_Session *session,
     newMon->timestampsToReturn = cmc->timestampsToReturn;
     result->statusCode |= UA_ReadValueId_copy(&request->itemToMonitor,
                                               &newMon->itemToMonitor);
+
+    /* Store the canonical NodeId. Registered aliases are only valid within the
+     * Session while the MonitoredItem can outlive it. */
+    const UA_NodeId *monNodeId =
+        UA_Session_resolveNodeId(session, &request->itemToMonitor.nodeId);
+    if(monNodeId != &request->itemToMonitor.nodeId) {
+        UA_NodeId_clear(&newMon->itemToMonitor.nodeId);
+        result->statusCode |= UA_NodeId_copy(monNodeId, &newMon->itemToMonitor.nodeId);
+    }
     result->statusCode |= UA_MonitoringParameters_copy(&request->requestedParameters,
                                                        &newMon->parameters);
     result->statusCode |= checkAdjustMonitoredItemParams(server, session, newMon,
@@ -1585,6 +1585,15 @@ addNode_finish(UA_Server *server, UA_Session *session, const UA_NodeId *nodeId)
 static void
 Operation_addNode(UA_Server *server, UA_Session *session, void *nodeContext,
                   const UA_AddNodesItem *item, UA_AddNodesResult *result) {
+    /* Resolve the aliases from RegisterNodes */
+    UA_AddNodesItem resolved = *item;
+    resolved.parentNodeId.nodeId =
+        *UA_Session_resolveNodeId(session, &item->parentNodeId.nodeId);
+    resolved.referenceTypeId = *UA_Session_resolveNodeId(session, &item->referenceTypeId);
+    resolved.typeDefinition.nodeId =
+        *UA_Session_resolveNodeId(session, &item->typeDefinition.nodeId);
+    item = &resolved;
+
     result->statusCode =
         Operation_addNode_begin(server, session, nodeContext,
                                 item, &item->parentNodeId.nodeId,
@@ -2029,6 +2038,7 @@ deleteNodeSet(UA_Server *server, UA_Session *session,
         UA_NODESTORE_RELEASE(server, member);
         if(removeTargetRefs)
             removeIncomingReferences(server, session, &member->head);
+        removeValueCache(server, &member->head.nodeId);
         UA_NODESTORE_REMOVE(server, &member->head.nodeId);
     }
 }
@@ -2038,6 +2048,11 @@ deleteNodeOperation(UA_Server *server, UA_Session *session, void *context,
                     const UA_DeleteNodesItem *item, UA_StatusCode *result) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Resolve the aliases from RegisterNodes */
+    UA_DeleteNodesItem resolved = *item;
+    resolved.nodeId = *UA_Session_resolveNodeId(session, &item->nodeId);
+    item = &resolved;
+
     /* Do not check access for server */
     if(session != &server->adminSession && server->config.accessControl.allowDeleteNode) {
         if(!server->config.accessControl.
@@ -2160,6 +2175,14 @@ Operation_addReference(UA_Server *server, UA_Session *session, void *context,
     UA_assert(session);
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Resolve the aliases from RegisterNodes */
+    UA_AddReferencesItem resolved = *item;
+    resolved.sourceNodeId = *UA_Session_resolveNodeId(session, &item->sourceNodeId);
+    resolved.referenceTypeId = *UA_Session_resolveNodeId(session, &item->referenceTypeId);
+    resolved.targetNodeId.nodeId =
+        *UA_Session_resolveNodeId(session, &item->targetNodeId.nodeId);
+    item = &resolved;
+
     /* Check access rights */
     if(session != &server->adminSession && server->config.accessControl.allowAddReference) {
         if (!server->config.accessControl.
@@ -2236,6 +2259,9 @@ Operation_addReference(UA_Server *server, UA_Session *session, void *context,
         return;
     }
 
+    /* Invalidate cached TranslateBrowsePathsToNodeIds results */
+    server->nodestoreGeneration++;
+
     /* Add the first direction */
     UA_UInt32 targetNameHash = UA_QualifiedName_hash(&targetNode->head.browseName);
     *retval = UA_Node_addReference(sourceNode, refTypeIndex, item->isForward,
@@ -2330,6 +2356,14 @@ Operation_deleteReference(UA_Server *server, UA_Session *session, void *context,
                           const UA_DeleteReferencesItem *item, UA_StatusCode *retval) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* Resolve the aliases from RegisterNodes */
+    UA_DeleteReferencesItem resolved = *item;
+    resolved.sourceNodeId = *UA_Session_resolveNodeId(session, &item->sourceNodeId);
+    resolved.referenceTypeId = *UA_Session_resolveNodeId(session, &item->referenceTypeId);
+    resolved.targetNodeId.nodeId =
+        *UA_Session_resolveNodeId(session, &item->targetNodeId.nodeId);
+    item = &resolved;
+
     /* Do not check access for server */
     if(session != &server->adminSession &&
        server->config.accessControl.allowDeleteReference) {
@@ -2361,6 +2395,9 @@ Operation_deleteReference(UA_Server *server, UA_Session *session, void *context,
 
     // TODO: Check consistency constraints, remove the references.
 
+    /* Invalidate cached TranslateBrowsePathsToNodeIds results */
+    server->nodestoreGeneration++;
+
     /* Delete the reference in this direction */
     UA_Node *firstNode =
         UA_NODESTORE_GET_EDIT_SELECTIVE(server, &item->sourceNodeId, 0,
@@ -2598,6 +2635,9 @@ setCallbackValueSourceCB(UA_Server *server, UA_Session *session,
     vn->valueSource.callback = *evs;
     vn->valueSourceType = UA_VALUESOURCETYPE_CALLBACK;
 
+    /* Values cached from the previous callback are no longer valid */
+    invalidateValueCache(server, &vn->head.nodeId);
+
     return UA_STATUSCODE_GOOD;
 }
 
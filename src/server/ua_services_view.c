@@ -495,7 +495,6 @@ RefResult_clear(RefResult *rr) {
 }
 
 struct ContinuationPoint {
-    ContinuationPoint *next;
     UA_ByteString identifier;
 
     /* Parameters of the Browse Request */
@@ -503,20 +502,25 @@ struct ContinuationPoint {
     UA_UInt32 maxReferences;
     UA_ReferenceTypeSet relevantReferences;
 
-    /* The last reference target that was transmitted to the client. The results
-     * list may be incomplete if the last target is removed or references added
-     * between the calls to Browse/BrowseNext. */
+    /* The last reference target that was transmitted to the client. Targets
+     * added or removed between the calls to Browse/BrowseNext are returned at
+     * most once. Other targets are neither skipped nor repeated. */
     UA_NodePointer lastTarget;
     UA_Byte lastRefKindIndex;
     UA_Boolean lastRefInverse;
+
+    /* Position of the last target to resume without a search. For the tree
+     * the hash is the key to unzip at. For the array the index is checked
+     * against lastTarget and a search is done only if it no longer matches. */
+    UA_UInt32 lastTargetHash;
+    size_t lastTargetIndex;
 };
 
-ContinuationPoint *
+void
 ContinuationPoint_clear(ContinuationPoint *cp) {
     UA_ByteString_clear(&cp->identifier);
     UA_BrowseDescription_clear(&cp->browseDescription);
     UA_NodePointer_clear(&cp->lastTarget);
-    return cp->next;
 }
 
 struct BrowseContext {
@@ -525,6 +529,7 @@ struct BrowseContext {
     UA_Server *server;
     UA_Session *session;
     UA_NodeReferenceKind *rk;
+    size_t targetIndexOffset; /* Array entries skipped for the cp */
     UA_ReferenceTypeSet resultRefs; /* With additional references for type
                                      * lookups */
     UA_Boolean activeCP; /* true during "forwarding" to the position of the last
@@ -641,6 +646,11 @@ browseReferencTargetCallback(void *context, UA_ReferenceTarget *t) {
     cp->lastTarget = t->targetId;
     cp->lastRefKindIndex = bc->rk->referenceTypeIndex;
     cp->lastRefInverse = bc->rk->isInverse;
+    if(bc->rk->hasRefTree)
+        cp->lastTargetHash = ((UA_ReferenceTargetTreeElem*)t)->targetIdHash;
+    else
+        cp->lastTargetIndex = bc->targetIndexOffset +
+            (size_t)(t - bc->rk->targets.array);
 
     /* Abort if the status is not good. Also doesn't make a deep-copy of
      * cp->lastTarget after returning from here. */
@@ -688,29 +698,40 @@ browseWithNode(struct BrowseContext *bc, const UA_NodeHead *head ) {
             if(rk->hasRefTree) {
                 /* Unzip the tree until the continuation point. All NodeIds
                  * larger than the last target are guaranteed to sit on the
-                 * right-hand side. */
-                UA_ExpandedNodeId lastEn =
-                    UA_NodePointer_toExpandedNodeId(cp->lastTarget);
+                 * right-hand side. This takes O(log n) also if the last
+                 * target was removed in the meantime. */
                 UA_ReferenceTargetTreeElem key;
                 key.target.targetId = cp->lastTarget;
-                key.targetIdHash = UA_ExpandedNodeId_hash(&lastEn);
+                key.targetIdHash = cp->lastTargetHash;
                 ZIP_UNZIP(UA_ReferenceIdTree,
                           (UA_ReferenceIdTree*)&rk->targets.tree.idRoot,
                           &key, &left, &right);
                 rk->targets.tree.idRoot = right.root;
             } else {
-                /* Iterate over the array to find the match */
-                for(; nextTargetIndex < rk->targetsSize; nextTargetIndex++) {
-                    UA_ReferenceTarget *t = &rk->targets.array[nextTargetIndex];
-                    if(UA_NodePointer_equal(cp->lastTarget, t->targetId))
-                        break;
+                /* Resume after the stored index. Search the array only if
+                 * the targets were modified in between. Removing a target
+                 * keeps the order of the array. So if the last target was
+                 * removed, its successors have moved down to the stored
+                 * index. New targets are appended at the end. */
+                nextTargetIndex = cp->lastTargetIndex + 1;
+                if(cp->lastTargetIndex >= rk->targetsSize ||
+                   !UA_NodePointer_equal(cp->lastTarget,
+                                         rk->targets.array[cp->lastTargetIndex].targetId)) {
+                    nextTargetIndex = cp->lastTargetIndex;
+                    for(size_t j = 0; j < rk->targetsSize; j++) {
+                        if(UA_NodePointer_equal(cp->lastTarget,
+                                                rk->targets.array[j].targetId)) {
+                            nextTargetIndex = j + 1;
+                            break;
+                        }
+                    }
                 }
-                if(nextTargetIndex == rk->targetsSize) {
-                    /* Not found - assume that this reference kind is done */
+                if(nextTargetIndex >= rk->targetsSize) {
+                    /* This reference kind is done */
+                    UA_NodePointer_clear(&cp->lastTarget);
                     bc->activeCP = false;
                     continue;
                 }
-                nextTargetIndex++; /* From the last index to the next index */
                 rk->targets.array = &rk->targets.array[nextTargetIndex];
                 rk->targetsSize -= nextTargetIndex;
             }
@@ -722,6 +743,7 @@ browseWithNode(struct BrowseContext *bc, const UA_NodeHead *head ) {
 
         /* Iterate over all reference targets */
         bc->rk = rk;
+        bc->targetIndexOffset = nextTargetIndex;
         void *res = UA_NodeReferenceKind_iterate(rk, browseReferencTargetCallback, bc);
 
         /* Undo the "skipping ahead" for the continuation point */
@@ -832,6 +854,12 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     memset(&cp, 0, sizeof(ContinuationPoint));
     cp.maxReferences = *maxrefs;
     cp.browseDescription = *descr; /* Shallow copy. Deep-copy later if we persist the cp. */
+    cp.browseDescription.nodeId = *UA_Session_resolveNodeId(session, &descr->nodeId);
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+    if(server->diagnosticsPending)
+        createLazyDiagnosticsObjects(server, &cp.browseDescription.nodeId);
+#endif
 
     /* How many references can we return at most? */
     if(cp.maxReferences == 0) {
@@ -922,14 +950,24 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     UA_NodePointer_init(&cp.lastTarget); /* No longer clear below (cleanup) */
     cp2->lastRefKindIndex = cp.lastRefKindIndex;
     cp2->lastRefInverse = cp.lastRefInverse;
+    cp2->lastTargetHash = cp.lastTargetHash;
+    cp2->lastTargetIndex = cp.lastTargetIndex;
 
-    /* Create a random bytestring via a Guid */
+    /* Find a free slot */
+    size_t slot = 0;
+    while(session->continuationPoints[slot])
+        slot++;
+    UA_assert(slot < UA_MAXCONTINUATIONPOINTS);
+
+    /* Create a random bytestring via a Guid. The first four bytes contain the
+     * slot index. */
     ident = UA_Guid_new();
     if(!ident) {
         retval = UA_STATUSCODE_BADOUTOFMEMORY;
         goto cleanup;
     }
     *ident = UA_Guid_random();
+    ident->data1 = (UA_UInt32)slot;
     cp2->identifier.data = (UA_Byte*)ident;
     cp2->identifier.length = sizeof(UA_Guid);
 
@@ -939,8 +977,7 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
         goto cleanup;
 
     /* Attach the cp to the session */
-    cp2->next = session->continuationPoints;
-    session->continuationPoints = cp2;
+    session->continuationPoints[slot] = cp2;
     --session->availableContinuationPoints;
     return;
 
@@ -995,27 +1032,38 @@ UA_Server_browse(UA_Server *server, UA_UInt32 maxReferences,
     return result;
 }
 
+/* Look up the slot of the continuation point from the index in the identifier */
+static ContinuationPoint **
+findContinuationPoint(UA_Session *session, const UA_ByteString *identifier) {
+    if(identifier->length != sizeof(UA_Guid))
+        return NULL;
+    UA_UInt32 slot;
+    memcpy(&slot, identifier->data, sizeof(UA_UInt32));
+    if(slot >= UA_MAXCONTINUATIONPOINTS)
+        return NULL;
+    ContinuationPoint **prev = &session->continuationPoints[slot];
+    if(!*prev || !UA_ByteString_equal(&(*prev)->identifier, identifier))
+        return NULL;
+    return prev;
+}
+
 static void
 Operation_BrowseNext(UA_Server *server, UA_Session *session,
                      const UA_Boolean *releaseContinuationPoints,
                      const UA_ByteString *continuationPoint, UA_BrowseResult *result) {
     /* Find the continuation point */
-    ContinuationPoint **prev = &session->continuationPoints;
-    ContinuationPoint *cp;
-    while((cp = *prev)) {
-        if(UA_ByteString_equal(&cp->identifier, continuationPoint))
-            break;
-        prev = &cp->next;
-    }
-    if(!cp) {
+    ContinuationPoint **prev = findContinuationPoint(session, continuationPoint);
+    if(!prev) {
         result->statusCode = UA_STATUSCODE_BADCONTINUATIONPOINTINVALID;
         return;
     }
+    ContinuationPoint *cp = *prev;
 
     /* Remove the cp */
     if(*releaseContinuationPoints) {
-        *prev = ContinuationPoint_clear(cp);
+        ContinuationPoint_clear(cp);
         UA_free(cp);
+        *prev = NULL;
         ++session->availableContinuationPoints;
         return;
     }
@@ -1068,8 +1116,9 @@ Operation_BrowseNext(UA_Server *server, UA_Session *session,
 
  remove_cp:
     /* Remove the cp */
-    *prev = ContinuationPoint_clear(cp);
+    ContinuationPoint_clear(cp);
     UA_free(cp);
+    *prev = NULL;
     ++session->availableContinuationPoints;
 }
 
@@ -1232,12 +1281,9 @@ walkBrowsePathElement(UA_Server *server, UA_Session *session,
 }
 
 static void
-Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
-                                       const UA_UInt32 *nodeClassMask,
-                                       const UA_BrowsePath *path,
-                                       UA_BrowsePathResult *result) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
-
+translateBrowsePath(UA_Server *server, UA_Session *session,
+                    UA_UInt32 nodeClassMask, const UA_BrowsePath *path,
+                    UA_BrowsePathResult *result) {
     if(path->relativePath.elementsSize == 0) {
         result->statusCode = UA_STATUSCODE_BADNOTHINGTODO;
         return;
@@ -1303,7 +1349,7 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
          * Puts new results in the "next" tree. */
         result->statusCode =
             walkBrowsePathElement(server, session, &path->relativePath, i,
-                                  *nodeClassMask, browseNameFilter, result, current, next);
+                                  nodeClassMask, browseNameFilter, result, current, next);
         if(result->statusCode != UA_STATUSCODE_GOOD)
             goto cleanup;
 
@@ -1360,6 +1406,112 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
     }
 }
 
+/* The result does not depend on the session. So the cache is shared between
+ * all sessions. */
+static UA_UInt32
+hashBrowsePath(const UA_BrowsePath *path, UA_UInt32 nodeClassMask) {
+    UA_UInt32 hash = UA_NodeId_hash(&path->startingNode);
+    hash = UA_ByteString_hash(hash, (const UA_Byte*)&nodeClassMask,
+                              sizeof(UA_UInt32));
+    for(size_t i = 0; i < path->relativePath.elementsSize; i++) {
+        const UA_RelativePathElement *elem = &path->relativePath.elements[i];
+        UA_UInt32 elemHash[3];
+        elemHash[0] = UA_NodeId_hash(&elem->referenceTypeId);
+        elemHash[1] = UA_QualifiedName_hash(&elem->targetName);
+        elemHash[2] = ((UA_UInt32)elem->isInverse << 1) | elem->includeSubtypes;
+        hash = UA_ByteString_hash(hash, (const UA_Byte*)elemHash, sizeof(elemHash));
+    }
+    return hash;
+}
+
+static void
+clearTranslateCacheEntry(UA_TranslateCacheEntry *entry) {
+    UA_BrowsePath_clear(&entry->path);
+    UA_BrowsePathResult_clear(&entry->result);
+    entry->valid = false;
+}
+
+void
+clearTranslateCache(UA_Server *server) {
+    for(size_t i = 0; i < server->translateCacheSize; i++)
+        clearTranslateCacheEntry(&server->translateCache[i]);
+    UA_free(server->translateCache);
+    server->translateCache = NULL;
+    server->translateCacheSize = 0;
+}
+
+static void
+Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
+                                       const UA_UInt32 *nodeClassMask,
+                                       const UA_BrowsePath *path,
+                                       UA_BrowsePathResult *result) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    /* Resolve the alias from RegisterNodes. Also before the cache lookup, as
+     * the aliases differ between the Sessions. */
+    UA_BrowsePath resolved = *path;
+    resolved.startingNode = *UA_Session_resolveNodeId(session, &path->startingNode);
+    path = &resolved;
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+    /* Before the cache lookup. This changes the nodestore generation. */
+    if(server->diagnosticsPending)
+        createLazyDiagnosticsObjects(server, &path->startingNode);
+#endif
+
+    /* Cache disabled */
+    UA_UInt32 cacheSize = server->config.translateBrowsePathCacheSize;
+    if(cacheSize == 0) {
+        if(server->translateCacheSize > 0)
+            clearTranslateCache(server);
+        translateBrowsePath(server, session, *nodeClassMask, path, result);
+        return;
+    }
+
+    /* Allocate the cache on first use or when the configured size changed */
+    if(server->translateCacheSize != cacheSize) {
+        clearTranslateCache(server);
+        server->translateCache = (UA_TranslateCacheEntry*)
+            UA_calloc(cacheSize, sizeof(UA_TranslateCacheEntry));
+        if(!server->translateCache) {
+            translateBrowsePath(server, session, *nodeClassMask, path, result);
+            return;
+        }
+        server->translateCacheSize = cacheSize;
+    }
+
+    /* Cache hit. The entry is valid only if no nodes or references were added
+     * or removed in the meantime. */
+    UA_UInt32 hash = hashBrowsePath(path, *nodeClassMask);
+    UA_TranslateCacheEntry *entry = &server->translateCache[hash % cacheSize];
+    if(entry->valid && entry->generation == server->nodestoreGeneration &&
+       entry->hash == hash && entry->nodeClassMask == *nodeClassMask &&
+       UA_order(&entry->path, path, &UA_TYPES[UA_TYPES_BROWSEPATH]) == UA_ORDER_EQ) {
+        UA_StatusCode res = UA_BrowsePathResult_copy(&entry->result, result);
+        if(res != UA_STATUSCODE_GOOD)
+            result->statusCode = res;
+        return;
+    }
+
+    /* Compute the result */
+    translateBrowsePath(server, session, *nodeClassMask, path, result);
+    if(result->statusCode == UA_STATUSCODE_BADOUTOFMEMORY)
+        return; /* Don't cache transient errors */
+
+    /* Replace the entry */
+    clearTranslateCacheEntry(entry);
+    UA_StatusCode res = UA_BrowsePath_copy(path, &entry->path);
+    res |= UA_BrowsePathResult_copy(result, &entry->result);
+    if(res != UA_STATUSCODE_GOOD) {
+        clearTranslateCacheEntry(entry);
+        return;
+    }
+    entry->valid = true;
+    entry->generation = server->nodestoreGeneration;
+    entry->hash = hash;
+    entry->nodeClassMask = *nodeClassMask;
+}
+
 UA_BrowsePathResult
 translateBrowsePathToNodeIds(UA_Server *server,
                              const UA_BrowsePath *browsePath) {
@@ -1463,7 +1615,6 @@ Service_RegisterNodes(UA_Server *server, UA_Session *session,
                          "Processing RegisterNodesRequest");
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    //TODO: hang the nodeids to the session if really needed
     if(request->nodesToRegisterSize == 0) {
         response->responseHeader.serviceResult = UA_STATUSCODE_BADNOTHINGTODO;
         return true;
@@ -1476,11 +1627,33 @@ Service_RegisterNodes(UA_Server *server, UA_Session *session,
         return true;
     }
 
-    response->responseHeader.serviceResult =
-        UA_Array_copy(request->nodesToRegister, request->nodesToRegisterSize,
-                      (void**)&response->registeredNodeIds, &UA_TYPES[UA_TYPES_NODEID]);
-    if(response->responseHeader.serviceResult == UA_STATUSCODE_GOOD)
-        response->registeredNodeIdsSize = request->nodesToRegisterSize;
+    response->registeredNodeIds = (UA_NodeId*)
+        UA_Array_new(request->nodesToRegisterSize, &UA_TYPES[UA_TYPES_NODEID]);
+    if(!response->registeredNodeIds) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return true;
+    }
+    response->registeredNodeIdsSize = request->nodesToRegisterSize;
+
+    /* Replace the NodeIds with session-scoped numeric aliases. The NodeIds are
+     * not validated (Part 4, 5.8.5.1). */
+    for(size_t i = 0; i < request->nodesToRegisterSize; i++) {
+        UA_StatusCode res =
+            UA_Session_registerNode(session, &request->nodesToRegister[i],
+                                    &response->registeredNodeIds[i]);
+        if(res != UA_STATUSCODE_GOOD) {
+            /* Roll back the aliases created so far */
+            for(size_t j = 0; j < i; j++)
+                UA_Session_unregisterNode(session, &response->registeredNodeIds[j]);
+            UA_Array_delete(response->registeredNodeIds,
+                            response->registeredNodeIdsSize,
+                            &UA_TYPES[UA_TYPES_NODEID]);
+            response->registeredNodeIds = NULL;
+            response->registeredNodeIdsSize = 0;
+            response->responseHeader.serviceResult = res;
+            break;
+        }
+    }
 
     return true;
 }
@@ -1495,10 +1668,17 @@ Service_UnregisterNodes(UA_Server *server, UA_Session *session,
 
     if(request->nodesToUnregisterSize == 0) {
         response->responseHeader.serviceResult = UA_STATUSCODE_BADNOTHINGTODO;
-    } else if(server->config.maxNodesPerRegisterNodes != 0 &&
-              request->nodesToUnregisterSize > server->config.maxNodesPerRegisterNodes) {
+        return true;
+    }
+
+    if(server->config.maxNodesPerRegisterNodes != 0 &&
+       request->nodesToUnregisterSize > server->config.maxNodesPerRegisterNodes) {
         response->responseHeader.serviceResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+        return true;
     }
 
+    for(size_t i = 0; i < request->nodesToUnregisterSize; i++)
+        UA_Session_unregisterNode(session, &request->nodesToUnregister[i]);
+
     return true;
 }
@@ -38,7 +38,8 @@ void UA_Session_clear(UA_Session *session, UA_Server* server) {
 #endif
 
 #ifdef UA_ENABLE_DIAGNOSTICS
-    deleteNode(server, session->sessionId, true);
+    if(session->diagnosticsObject)
+        deleteNode(server, session->sessionId, true);
 #endif
 
     UA_Session_detachFromSecureChannel(session);
@@ -48,14 +49,22 @@ void UA_Session_clear(UA_Session *session, UA_Server* server) {
     UA_NodeId_clear(&session->sessionId);
     UA_String_clear(&session->sessionName);
     UA_ByteString_clear(&session->serverNonce);
-    struct ContinuationPoint *cp, *next = session->continuationPoints;
-    while((cp = next)) {
-        next = ContinuationPoint_clear(cp);
+    for(size_t i = 0; i < UA_MAXCONTINUATIONPOINTS; i++) {
+        ContinuationPoint *cp = session->continuationPoints[i];
+        if(!cp)
+            continue;
+        ContinuationPoint_clear(cp);
         UA_free(cp);
+        session->continuationPoints[i] = NULL;
     }
-    session->continuationPoints = NULL;
     session->availableContinuationPoints = UA_MAXCONTINUATIONPOINTS;
 
+    UA_Array_delete(session->registeredNodes, session->registeredNodesSize,
+                    &UA_TYPES[UA_TYPES_NODEID]);
+    session->registeredNodes = NULL;
+    session->registeredNodesSize = 0;
+    session->registeredNodesUsed = 0;
+
     UA_KeyValueMap_delete(session->attributes);
     session->attributes = NULL;
 
@@ -113,6 +122,59 @@ UA_Session_detachFromSecureChannel(UA_Session *session) {
     session->channel = NULL;
 }
 
+UA_StatusCode
+UA_Session_registerNode(UA_Session *session, const UA_NodeId *nodeId,
+                        UA_NodeId *alias) {
+    /* Numeric NodeIds are already compact. Don't register aliases twice. */
+    if(nodeId->identifierType == UA_NODEIDTYPE_NUMERIC ||
+       UA_Session_resolveNodeId(session, nodeId) != nodeId)
+        return UA_NodeId_copy(nodeId, alias);
+
+    /* Find a free slot */
+    size_t index = session->registeredNodesSize;
+    if(session->registeredNodesUsed < session->registeredNodesSize) {
+        for(index = 0; index < session->registeredNodesSize; index++) {
+            if(UA_NodeId_isNull(&session->registeredNodes[index]))
+                break;
+        }
+    }
+
+    /* Grow the table. Fall back to the original NodeId if the table is full. */
+    if(index == session->registeredNodesSize) {
+        if(session->registeredNodesSize >= UA_REGISTEREDNODEID_MAX)
+            return UA_NodeId_copy(nodeId, alias);
+        size_t newSize = (session->registeredNodesSize == 0) ?
+            8 : session->registeredNodesSize * 2;
+        if(newSize > UA_REGISTEREDNODEID_MAX)
+            newSize = UA_REGISTEREDNODEID_MAX;
+        UA_NodeId *newNodes = (UA_NodeId*)
+            UA_realloc(session->registeredNodes, newSize * sizeof(UA_NodeId));
+        if(!newNodes)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        for(size_t i = session->registeredNodesSize; i < newSize; i++)
+            UA_NodeId_init(&newNodes[i]);
+        session->registeredNodes = newNodes;
+        session->registeredNodesSize = newSize;
+    }
+
+    /* Store the canonical NodeId */
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &session->registeredNodes[index]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    session->registeredNodesUsed++;
+    *alias = UA_NODEID_NUMERIC(0, UA_REGISTEREDNODEID_BASE + (UA_UInt32)index);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_Session_unregisterNode(UA_Session *session, const UA_NodeId *alias) {
+    const UA_NodeId *canonical = UA_Session_resolveNodeId(session, alias);
+    if(canonical == alias)
+        return;
+    UA_NodeId_clear((UA_NodeId*)(uintptr_t)canonical);
+    session->registeredNodesUsed--;
+}
+
 UA_StatusCode
 UA_Session_generateNonce(UA_Session *session) {
     UA_SecureChannel *channel = session->channel;
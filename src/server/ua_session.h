@@ -20,8 +20,7 @@ _UA_BEGIN_DECLS
 struct ContinuationPoint;
 typedef struct ContinuationPoint ContinuationPoint;
 
-/* Returns the next entry in the linked list */
-ContinuationPoint *
+void
 ContinuationPoint_clear(ContinuationPoint *cp);
 
 struct UA_Subscription;
@@ -61,8 +60,17 @@ struct UA_Session {
     UA_UInt32 maxRequestMessageSize;
     UA_UInt32 maxResponseMessageSize;
 
+    /* The identifier of a ContinuationPoint encodes the slot index for a
+     * direct lookup */
     UA_UInt16         availableContinuationPoints;
-    ContinuationPoint *continuationPoints;
+    ContinuationPoint *continuationPoints[UA_MAXCONTINUATIONPOINTS];
+
+    /* NodeIds registered with the RegisterNodes service. The alias NodeId
+     * ns=0;i=UA_REGISTEREDNODEID_BASE+index resolves to the canonical NodeId
+     * at the index. Unused slots contain the null NodeId. */
+    size_t registeredNodesSize;
+    size_t registeredNodesUsed;
+    UA_NodeId *registeredNodes;
 
     /* Localization information */
     size_t localeIdsSize;
@@ -85,6 +93,7 @@ struct UA_Session {
 #ifdef UA_ENABLE_DIAGNOSTICS
     UA_SessionSecurityDiagnosticsDataType securityDiagnostics;
     UA_SessionDiagnosticsDataType diagnostics;
+    UA_Boolean diagnosticsObject; /* Object created in the information model */
 #endif
 };
 
@@ -102,6 +111,41 @@ UA_StatusCode UA_Session_generateNonce(UA_Session *session);
 void UA_Session_updateLifetime(UA_Session *session, UA_DateTime now,
                                UA_DateTime nowMonotonic);
 
+/**
+ * Registered Nodes
+ * ----------------
+ * Registered NodeIds are replaced by session-scoped numeric aliases from a
+ * reserved range in namespace zero. The aliases are resolved by a direct
+ * index into the table of the session. */
+
+#define UA_REGISTEREDNODEID_BASE 0xFFF00000
+#define UA_REGISTEREDNODEID_MAX 0x10000 /* Maximum aliases per session */
+
+/* Returns the alias for the NodeId. If no alias is created (e.g. the NodeId is
+ * already numeric or the table is full), then a copy of the original NodeId is
+ * returned. */
+UA_StatusCode
+UA_Session_registerNode(UA_Session *session, const UA_NodeId *nodeId,
+                        UA_NodeId *alias);
+
+/* Removes the alias. Other NodeIds are ignored. */
+void
+UA_Session_unregisterNode(UA_Session *session, const UA_NodeId *alias);
+
+/* Returns the canonical NodeId for an alias or the input NodeId otherwise */
+static UA_INLINE const UA_NodeId *
+UA_Session_resolveNodeId(const UA_Session *session, const UA_NodeId *nodeId) {
+    if(nodeId->namespaceIndex != 0 ||
+       nodeId->identifierType != UA_NODEIDTYPE_NUMERIC ||
+       nodeId->identifier.numeric < UA_REGISTEREDNODEID_BASE || !session)
+        return nodeId;
+    size_t index = nodeId->identifier.numeric - UA_REGISTEREDNODEID_BASE;
+    if(index >= session->registeredNodesSize ||
+       UA_NodeId_isNull(&session->registeredNodes[index]))
+        return nodeId;
+    return &session->registeredNodes[index];
+}
+
 /**
  * Subscription handling
  * --------------------- */
@@ -24,6 +24,7 @@
 
 #include "ua_session.h"
 #include "../util/ua_util_internal.h"
+#include "ziptree.h"
 
 _UA_BEGIN_DECLS
 
@@ -347,6 +348,10 @@ UA_Session_ensurePublishQueueSpace(UA_Server *server, UA_Session *session);
 /* Forward declaration for A&C used in ua_server_internal.h" */
 struct UA_ConditionSource;
 typedef struct UA_ConditionSource UA_ConditionSource;
+struct UA_Condition;
+typedef struct UA_Condition UA_Condition;
+typedef ZIP_HEAD(UA_ConditionSourceTree, UA_ConditionSource) UA_ConditionSourceTree;
+typedef ZIP_HEAD(UA_ConditionTree, UA_Condition) UA_ConditionTree;
 
 /* Event Handling */
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -372,6 +377,13 @@ UA_StatusCode
 createEvent(UA_Server *server, const UA_EventDescription *ed,
             UA_ByteString *outEventId);
 
+/* Emit the event only to the given MonitoredItem. The propagation through the
+ * notifier hierarchy and the historizing are skipped. Used for the
+ * ConditionRefresh where the recipient is known upfront. */
+UA_StatusCode
+createEventForMonitoredItem(UA_Server *server, const UA_EventDescription *ed,
+                            UA_MonitoredItem *mon, UA_ByteString *outEventId);
+
 typedef struct {
     UA_Server *server;
     UA_Session *session;
@@ -420,6 +432,15 @@ evaluateWhereClause(UA_FilterEvalContext *ctx);
 UA_StatusCode
 evaluateSelectClause(UA_FilterEvalContext *ctx, UA_EventFieldList *efl);
 
+#ifdef UA_ENABLE_PUBSUB
+/* Queue the event in the DataSetWriters of the PublishedEvents DataSets whose
+ * EventNotifier is one of the emitting nodes. Implemented in the PubSub
+ * module. */
+void
+UA_PubSubManager_createEvent(UA_Server *server, const UA_ExpandedNodeId *emitNodes,
+                             size_t emitNodesSize, UA_FilterEvalContext *ctx);
+#endif
+
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
 
 /***********/
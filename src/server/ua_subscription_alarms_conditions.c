@@ -25,16 +25,46 @@ typedef enum {
  * triggered (lastEventId). See Part 9, 5.5.2, BranchId. */
 typedef struct UA_ConditionBranch {
     LIST_ENTRY(UA_ConditionBranch) listEntry;
+    LIST_ENTRY(UA_ConditionBranch) retainedEntry; /* In the server-wide index
+                                                   * if isRetained is set */
+    UA_Condition *condition;
     UA_NodeId conditionBranchId;
     UA_ByteString lastEventId;
     UA_Boolean isCallerAC;
+    UA_Boolean isRetained;
 } UA_ConditionBranch;
 
+/* Standard fields of a Condition with a cached NodeId. The order matches the
+ * cachedConditionFields table below. */
+typedef enum {
+    CONDITIONFIELD_ENABLEDSTATE = 0,
+    CONDITIONFIELD_ENABLEDSTATE_ID,
+    CONDITIONFIELD_ACKEDSTATE,
+    CONDITIONFIELD_ACKEDSTATE_ID,
+    CONDITIONFIELD_CONFIRMEDSTATE,
+    CONDITIONFIELD_CONFIRMEDSTATE_ID,
+    CONDITIONFIELD_ACTIVESTATE,
+    CONDITIONFIELD_ACTIVESTATE_ID,
+    CONDITIONFIELD_RETAIN,
+    CONDITIONFIELD_SEVERITY,
+    CONDITIONFIELD_LASTSEVERITY,
+    CONDITIONFIELD_LASTSEVERITY_SOURCETIMESTAMP,
+    CONDITIONFIELD_MESSAGE,
+    CONDITIONFIELD_TIME,
+    CONDITIONFIELD_SOURCENODE,
+    CONDITIONFIELD_COMMENT,
+    CONDITIONFIELD_COMMENT_SOURCETIMESTAMP,
+    CONDITIONFIELD_QUALITY,
+    CONDITIONFIELD_COUNT
+} UA_ConditionField;
+
 /* In Alarms and Conditions first implementation, A Condition
  * have only one ConditionBranch entry. */
-typedef struct UA_Condition {
+struct UA_Condition {
     LIST_ENTRY(UA_Condition) listEntry;
+    ZIP_ENTRY(UA_Condition) treeEntry; /* Sorted by the conditionId */
     LIST_HEAD(, UA_ConditionBranch) conditionBranches;
+    UA_ConditionSource *source;
     UA_NodeId conditionId;
     UA_UInt16 lastSeverity;
     UA_DateTime lastSeveritySourceTimeStamp;
@@ -53,15 +83,38 @@ typedef struct UA_Condition {
     UA_ActiveState lastActiveState;
     UA_ActiveState currentActiveState;
     UA_Boolean isLimitAlarm;
-} UA_Condition;
+
+    /* NodeIds of the standard fields. Resolved when the condition is added and
+     * for (optional) fields added later upon the first access. This saves the
+     * browsing in each state transition. The fields of a condition are not
+     * expected to be removed. */
+    UA_NodeId fields[CONDITIONFIELD_COUNT];
+};
 
 /* A ConditionSource can have multiple Conditions. */
 struct UA_ConditionSource {
     LIST_ENTRY(UA_ConditionSource) listEntry;
+    ZIP_ENTRY(UA_ConditionSource) treeEntry; /* Sorted by the conditionSourceId */
     LIST_HEAD(, UA_Condition) conditions;
     UA_NodeId conditionSourceId;
+
+    /* Memo whether the source is below the node of the MonitoredItem that is
+     * currently refreshed. Valid if refreshCounter matches
+     * server->conditionRefreshCounter. */
+    UA_UInt32 refreshCounter;
+    UA_Boolean refreshMonitored;
 };
 
+static enum ZIP_CMP
+cmpConditionNodeId(const void *a, const void *b) {
+    return (enum ZIP_CMP)UA_NodeId_order((const UA_NodeId*)a, (const UA_NodeId*)b);
+}
+
+ZIP_FUNCTIONS(UA_ConditionSourceTree, UA_ConditionSource, treeEntry,
+              UA_NodeId, conditionSourceId, cmpConditionNodeId)
+ZIP_FUNCTIONS(UA_ConditionTree, UA_Condition, treeEntry,
+              UA_NodeId, conditionId, cmpConditionNodeId)
+
 #define CONDITIONOPTIONALFIELDS_SUPPORT // change array size!
 #define CONDITION_SEVERITYCHANGECALLBACK_ENABLE
 
@@ -168,6 +221,37 @@ static const UA_QualifiedName fieldExpirationDateQN = STATIC_QN(CONDITION_FIELD_
 
 static const UA_QualifiedName fieldExpirationLimitQN = STATIC_QN(CONDITION_FIELD_EXPIRATION_LIMIT);
 
+/* Browse path of a cached field. The property name is empty for the field
+ * itself. */
+typedef struct {
+    UA_QualifiedName field;
+    UA_QualifiedName property;
+} UA_ConditionFieldPath;
+
+#define NO_PROPERTY {0, {0, NULL}}
+static const UA_ConditionFieldPath cachedConditionFields[CONDITIONFIELD_COUNT] = {
+    {STATIC_QN(CONDITION_FIELD_ENABLEDSTATE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_ENABLEDSTATE), STATIC_QN(CONDITION_FIELD_TWOSTATEVARIABLE_ID)},
+    {STATIC_QN(CONDITION_FIELD_ACKEDSTATE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_ACKEDSTATE), STATIC_QN(CONDITION_FIELD_TWOSTATEVARIABLE_ID)},
+    {STATIC_QN(CONDITION_FIELD_CONFIRMEDSTATE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_CONFIRMEDSTATE), STATIC_QN(CONDITION_FIELD_TWOSTATEVARIABLE_ID)},
+    {STATIC_QN(CONDITION_FIELD_ACTIVESTATE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_ACTIVESTATE), STATIC_QN(CONDITION_FIELD_TWOSTATEVARIABLE_ID)},
+    {STATIC_QN(CONDITION_FIELD_RETAIN), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_SEVERITY), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_LASTSEVERITY), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_LASTSEVERITY),
+     STATIC_QN(CONDITION_FIELD_CONDITIONVARIABLE_SOURCETIMESTAMP)},
+    {STATIC_QN(CONDITION_FIELD_MESSAGE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_TIME), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_SOURCENODE), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_COMMENT), NO_PROPERTY},
+    {STATIC_QN(CONDITION_FIELD_COMMENT),
+     STATIC_QN(CONDITION_FIELD_CONDITIONVARIABLE_SOURCETIMESTAMP)},
+    {STATIC_QN(CONDITION_FIELD_QUALITY), NO_PROPERTY}
+};
+
 #define CONDITION_ASSERT_RETURN_RETVAL(retval, logMessage, deleteFunction)                \
     {                                                                                     \
         if(retval != UA_STATUSCODE_GOOD) {                                                \
@@ -207,29 +291,93 @@ addConditionOptionalField(UA_Server *server, const UA_NodeId condition,
                           const UA_NodeId conditionType, const UA_QualifiedName fieldName,
                           UA_NodeId *outOptionalNode);
 
+static UA_Boolean
+isRetained(UA_Server *server, const UA_NodeId *condition);
+
 static UA_ConditionSource *
 getConditionSource(UA_Server *server, const UA_NodeId *sourceId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
-    UA_ConditionSource *cs;
-    LIST_FOREACH(cs, &server->conditionSources, listEntry) {
-        if(UA_NodeId_equal(&cs->conditionSourceId, sourceId))
-            return cs;
-    }
-    return NULL;
+    return ZIP_FIND(UA_ConditionSourceTree, &server->conditionSourceTree, sourceId);
 }
 
 static UA_Condition *
 getCondition(UA_Server *server, const UA_NodeId *sourceId,
              const UA_NodeId *conditionId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
-    UA_ConditionSource *cs = getConditionSource(server, sourceId);
-    if(!cs)
+    UA_Condition *c = ZIP_FIND(UA_ConditionTree, &server->conditionTree, conditionId);
+    if(!c || !UA_NodeId_equal(&c->source->conditionSourceId, sourceId))
         return NULL;
+    return c;
+}
+
+/* Add or remove the branch from the index of retained branches. Only branches
+ * for which an event was triggered are refreshed. */
+static void
+updateRetainedBranch(UA_Server *server, UA_ConditionBranch *branch,
+                     UA_Boolean retained) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    retained = retained && branch->lastEventId.length > 0;
+    if(retained == branch->isRetained)
+        return;
+    if(retained)
+        LIST_INSERT_HEAD(&server->retainedConditionBranches, branch, retainedEntry);
+    else
+        LIST_REMOVE(branch, retainedEntry);
+    branch->isRetained = retained;
+}
 
-    UA_Condition *c;
-    LIST_FOREACH(c, &cs->conditions, listEntry) {
-        if(UA_NodeId_equal(&c->conditionId, conditionId))
-            return c;
+/* Returns the branch for the node of the main condition or of a non-main
+ * branch */
+static UA_ConditionBranch *
+getConditionBranch(UA_Server *server, const UA_NodeId *branchNode) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    UA_ConditionBranch *branch;
+    UA_Condition *cond = ZIP_FIND(UA_ConditionTree, &server->conditionTree, branchNode);
+    if(cond) {
+        LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
+            if(UA_NodeId_isNull(&branch->conditionBranchId))
+                return branch;
+        }
+        return NULL;
+    }
+
+    /* The branches are not indexed */
+    UA_ConditionSource *source;
+    LIST_FOREACH(source, &server->conditionSources, listEntry) {
+        LIST_FOREACH(cond, &source->conditions, listEntry) {
+            LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
+                if(!UA_NodeId_isNull(&branch->conditionBranchId) &&
+                   UA_NodeId_equal(&branch->conditionBranchId, branchNode))
+                    return branch;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Returns the cache entry for the NodeId of a standard field. NULL if the
+ * condition is not (yet) registered or if the field is not cached. A null
+ * NodeId in the entry indicates that the field was not resolved so far. */
+static UA_NodeId *
+getCachedConditionField(UA_Server *server, const UA_NodeId *conditionId,
+                        const UA_QualifiedName *field,
+                        const UA_QualifiedName *property) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_Condition *c = ZIP_FIND(UA_ConditionTree, &server->conditionTree, conditionId);
+    if(!c)
+        return NULL;
+    for(size_t i = 0; i < CONDITIONFIELD_COUNT; i++) {
+        const UA_ConditionFieldPath *path = &cachedConditionFields[i];
+        if(!UA_QualifiedName_equal(&path->field, field))
+            continue;
+        if(property) {
+            if(!UA_QualifiedName_equal(&path->property, property))
+                continue;
+        } else if(path->property.name.length > 0) {
+            continue;
+        }
+        return &c->fields[i];
     }
     return NULL;
 }
@@ -329,16 +477,17 @@ callConditionTwoStateVariableCallback(UA_Server *server, const UA_NodeId *condit
                                       UA_TwoStateVariableCallbackType callbackType) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    UA_Condition *cond = getCondition(server, conditionSource, condition);
+    if(cond)
+        return getConditionTwoStateVariableCallback(server, condition, cond,
+                                                    removeBranch, callbackType);
+
+    /* The branches are not indexed */
     UA_ConditionSource *source = getConditionSource(server, conditionSource);
     if(!source)
         return UA_STATUSCODE_BADNOTFOUND;
 
-    UA_Condition *cond;
     LIST_FOREACH(cond, &source->conditions, listEntry) {
-        if(UA_NodeId_equal(&cond->conditionId, condition)) {
-            return getConditionTwoStateVariableCallback(server, condition, cond,
-                                                        removeBranch, callbackType);
-        }
         UA_ConditionBranch *branch;
         LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
             if(!UA_NodeId_equal(&branch->conditionBranchId, condition))
@@ -414,12 +563,18 @@ getConditionFieldNodeId(UA_Server *server, const UA_NodeId *conditionNodeId,
                         const UA_QualifiedName* fieldName, UA_NodeId *outFieldNodeId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    UA_NodeId *cached = getCachedConditionField(server, conditionNodeId, fieldName, NULL);
+    if(cached && !UA_NodeId_isNull(cached))
+        return UA_NodeId_copy(cached, outFieldNodeId);
+
     UA_BrowsePathResult bpr =
         browseSimplifiedBrowsePath(server, *conditionNodeId, 1, fieldName);
     if(bpr.statusCode != UA_STATUSCODE_GOOD)
         return bpr.statusCode;
     UA_StatusCode retval = UA_NodeId_copy(&bpr.targets[0].targetId.nodeId, outFieldNodeId);
     UA_BrowsePathResult_clear(&bpr);
+    if(cached && retval == UA_STATUSCODE_GOOD)
+        UA_NodeId_copy(outFieldNodeId, cached);
     return retval;
 }
 
@@ -431,6 +586,11 @@ getConditionFieldPropertyNodeId(UA_Server *server, const UA_NodeId *originCondit
                                 UA_NodeId *outFieldPropertyNodeId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    UA_NodeId *cached = getCachedConditionField(server, originCondition, variableFieldName,
+                                                variablePropertyName);
+    if(cached && !UA_NodeId_isNull(cached))
+        return UA_NodeId_copy(cached, outFieldPropertyNodeId);
+
     /* 1) Find Variable Field of the Condition */
     UA_BrowsePathResult bprConditionVariableField =
         browseSimplifiedBrowsePath(server, *originCondition, 1, variableFieldName);
@@ -450,6 +610,8 @@ getConditionFieldPropertyNodeId(UA_Server *server, const UA_NodeId *originCondit
     UA_NodeId_init(&bprVariableFieldProperty.targets[0].targetId.nodeId);
     UA_BrowsePathResult_clear(&bprConditionVariableField);
     UA_BrowsePathResult_clear(&bprVariableFieldProperty);
+    if(cached)
+        UA_NodeId_copy(outFieldPropertyNodeId, cached);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -611,24 +773,18 @@ updateConditionLastEventId(UA_Server *server, const UA_NodeId *triggeredEvent,
                            const UA_ByteString *lastEventId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    UA_Condition *cond = getCondition(server, conditionSource, triggeredEvent);
-    if(!cond) {
+    UA_ConditionBranch *branch = getConditionBranch(server, triggeredEvent);
+    if(!branch || !UA_NodeId_equal(&branch->condition->source->conditionSourceId,
+                                   conditionSource)) {
         UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
                      "Entry not found in list!");
         return UA_STATUSCODE_BADNOTFOUND;
     }
 
-    UA_ConditionBranch *branch;
-    LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
-        if(UA_NodeId_isNull(&branch->conditionBranchId)) {
-            /* update main condition branch */
-            UA_ByteString_clear(&branch->lastEventId);
-            return UA_ByteString_copy(lastEventId, &branch->lastEventId);
-        }
-    }
-    UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
-                 "Condition Branch not implemented");
-    return UA_STATUSCODE_BADNOTFOUND;
+    UA_ByteString_clear(&branch->lastEventId);
+    UA_StatusCode res = UA_ByteString_copy(lastEventId, &branch->lastEventId);
+    updateRetainedBranch(server, branch, isRetained(server, triggeredEvent));
+    return res;
 }
 
 static void
@@ -1360,6 +1516,30 @@ afterWriteCallbackSeverityChange(UA_Server *server,
     UA_NodeId_clear(&condition);
 }
 
+/* The index of retained branches is updated for every write of the Retain
+ * field. Also when the field is written directly and not with
+ * UA_Server_setConditionField. */
+static void
+afterWriteCallbackRetainChange(UA_Server *server,
+                               const UA_NodeId *sessionId, void *sessionContext,
+                               const UA_NodeId *nodeId, void *nodeContext,
+                               const UA_NumericRange *range, const UA_DataValue *data) {
+    if(range || !data->hasValue ||
+       !UA_Variant_hasScalarType(&data->value, &UA_TYPES[UA_TYPES_BOOLEAN]))
+        return;
+
+    lockServer(server);
+    UA_NodeId condition;
+    UA_StatusCode retval = getFieldParentNodeId(server, nodeId, &condition);
+    if(retval == UA_STATUSCODE_GOOD) {
+        UA_ConditionBranch *branch = getConditionBranch(server, &condition);
+        if(branch)
+            updateRetainedBranch(server, branch, *(UA_Boolean*)data->value.data);
+        UA_NodeId_clear(&condition);
+    }
+    unlockServer(server);
+}
+
 static UA_StatusCode
 disableMethodCallback(UA_Server *server, const UA_NodeId *sessionId,
                       void *sessionContext, const UA_NodeId *methodId,
@@ -1683,75 +1863,86 @@ isConditionSourceInMonitoredItem(UA_Server *server, const UA_MonitoredItem *moni
     return isNodeInTree(server, conditionSource, &monitoredItem->itemToMonitor.nodeId, &refs);
 }
 
+/* Is the ConditionSource below the node of the MonitoredItem? The result is
+ * memoized in the source for the duration of one refresh. */
+static UA_Boolean
+isConditionSourceMonitored(UA_Server *server, const UA_MonitoredItem *monitoredItem,
+                           UA_ConditionSource *source) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    if(source->refreshCounter == server->conditionRefreshCounter)
+        return source->refreshMonitored;
+
+    /* If the Server Object is being monitored, then all Events of all
+     * monitoredItems should be refreshed */
+    UA_NodeId serverObjectNodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    const UA_NodeId *monitoredNode = &monitoredItem->itemToMonitor.nodeId;
+    source->refreshMonitored =
+        UA_NodeId_equal(monitoredNode, &source->conditionSourceId) ||
+        UA_NodeId_equal(monitoredNode, &serverObjectNodeId) ||
+        isConditionSourceInMonitoredItem(server, monitoredItem, &source->conditionSourceId);
+    source->refreshCounter = server->conditionRefreshCounter;
+    return source->refreshMonitored;
+}
+
+/* The events are emitted only to the refreshed MonitoredItem. Only the index
+ * of retained branches is visited, not all conditions of the server. */
 static UA_StatusCode
-refreshLogic(UA_Server *server, UA_Session *session,
-             UA_Subscription *sub, UA_MonitoredItem *monitoredItem) {
+refreshLogic(UA_Server *server, UA_MonitoredItem *monitoredItem) {
     UA_LOCK_ASSERT(&server->serviceMutex);
     UA_assert(monitoredItem != NULL);
 
+    /* Invalidate the reachability memo of the ConditionSources */
+    server->conditionRefreshCounter++;
+    if(server->conditionRefreshCounter == 0)
+        server->conditionRefreshCounter = 1;
+
     /* 1. Trigger RefreshStartEvent */
     UA_EventDescription ed = {0};
     ed.sourceNode = UA_NS0ID(SERVER);
     ed.eventType = UA_NS0ID(REFRESHSTARTEVENTTYPE);
     ed.severity = REFRESHEVENT_SEVERITY_DEFAULT;
-    ed.sessionId = &session->sessionId;
-    ed.subscriptionId = &sub->subscriptionId;
-    ed.monitoredItemId = (monitoredItem) ? &monitoredItem->monitoredItemId : NULL;
-    UA_StatusCode retval = createEvent(server, &ed, NULL);
-    CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to a listening node",);
+    UA_StatusCode retval = createEventForMonitoredItem(server, &ed, monitoredItem, NULL);
+    CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to the MonitoredItem",);
 
     /* 2. Refresh (see 5.5.7) */
-    /* Get ConditionSource Entry */
-    UA_ConditionSource *source;
-    LIST_FOREACH(source, &server->conditionSources, listEntry) {
-        UA_NodeId conditionSource = source->conditionSourceId;
-        UA_NodeId serverObjectNodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
-        /* Check if the conditionSource is being monitored. If the Server Object
-         * is being monitored, then all Events of all monitoredItems should be
-         * refreshed */
-        if(!UA_NodeId_equal(&monitoredItem->itemToMonitor.nodeId, &conditionSource) &&
-           !UA_NodeId_equal(&monitoredItem->itemToMonitor.nodeId, &serverObjectNodeId) &&
-           !isConditionSourceInMonitoredItem(server, monitoredItem, &conditionSource))
-            continue;
-
-        /* Get Condition Entry */
-        UA_Condition *cond;
-        LIST_FOREACH(cond, &source->conditions, listEntry) {
-            /* Get Branch Entry */
-            UA_ConditionBranch *branch;
-            LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
-                /* If no event was triggered for that branch, then check next
-                 * without refreshing */
-                if(UA_ByteString_equal(&branch->lastEventId, &UA_BYTESTRING_NULL))
-                    continue;
-
-                UA_NodeId triggeredNode;
-                if(UA_NodeId_isNull(&branch->conditionBranchId))
-                    triggeredNode = cond->conditionId;
-                else
-                    triggeredNode = branch->conditionBranchId;
+    UA_ConditionBranch *branch, *tmp_branch;
+    LIST_FOREACH_SAFE(branch, &server->retainedConditionBranches,
+                      retainedEntry, tmp_branch) {
+        UA_Condition *cond = branch->condition;
 
-                /* Check if Retain is set to true */
-                if(!isRetained(server, &triggeredNode))
-                    continue;
+        /* Check if the conditionSource is being monitored */
+        if(!isConditionSourceMonitored(server, monitoredItem, cond->source))
+            continue;
 
-                UA_ByteString_clear(&branch->lastEventId);
+        UA_NodeId triggeredNode;
+        if(UA_NodeId_isNull(&branch->conditionBranchId))
+            triggeredNode = cond->conditionId;
+        else
+            triggeredNode = branch->conditionBranchId;
 
-                /* Add the event */
-                ed.eventInstance = &triggeredNode;
-                ed.sourceNode = conditionSource;
-                ed.eventType = UA_NODEID_NULL; /* overwritten by the EventInstance */
-                retval = createEvent(server, &ed, &branch->lastEventId);
-                CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to a listening node",);
-            }
+        /* The Retain field might have been written directly. Then the branch
+         * is dropped from the index. */
+        if(!isRetained(server, &triggeredNode)) {
+            updateRetainedBranch(server, branch, false);
+            continue;
         }
+
+        /* Add the event */
+        UA_ByteString eventId = UA_BYTESTRING_NULL;
+        ed.eventInstance = &triggeredNode;
+        ed.sourceNode = cond->source->conditionSourceId;
+        ed.eventType = UA_NODEID_NULL; /* overwritten by the EventInstance */
+        retval = createEventForMonitoredItem(server, &ed, monitoredItem, &eventId);
+        CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to the MonitoredItem",);
+        UA_ByteString_clear(&branch->lastEventId);
+        branch->lastEventId = eventId;
     }
 
     /* 3. Trigger RefreshEndEvent */
     ed.eventInstance = NULL;
     ed.sourceNode = UA_NS0ID(SERVER);
     ed.eventType = UA_NS0ID(REFRESHENDEVENTTYPE);
-    return createEvent(server, &ed, NULL);
+    return createEventForMonitoredItem(server, &ed, monitoredItem, NULL);
 }
 
 static UA_StatusCode
@@ -1772,17 +1963,16 @@ refresh2MethodCallback(UA_Server *server, const UA_NodeId *sessionId,
         return UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID;
     }
 
-    /* Trigger RefreshStartEvent and RefreshEndEvent for the each monitoredItem
-     * in the subscription */
+    /* Trigger RefreshStartEvent and RefreshEndEvent for the monitoredItem */
     UA_MonitoredItem *monitoredItem =
         UA_Subscription_getMonitoredItem(subscription, *((UA_UInt32 *)input[1].data));
-    if(!monitoredItem) {
+    if(!monitoredItem ||
+       monitoredItem->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER) {
         unlockServer(server);
         return UA_STATUSCODE_BADMONITOREDITEMIDINVALID;
     }
 
-    // TODO when there are a lot of monitoreditems (not only events)?
-    UA_StatusCode retval = refreshLogic(server, session, subscription, monitoredItem);
+    UA_StatusCode retval = refreshLogic(server, monitoredItem);
     CONDITION_ASSERT_RETURN_RETVAL(retval, "Could not refresh Condition",
                                    unlockServer(server););
     unlockServer(server);
@@ -1808,11 +1998,16 @@ refreshMethodCallback(UA_Server *server, const UA_NodeId *sessionId,
         return UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID;
     }
 
-    /* Trigger RefreshStartEvent and RefreshEndEvent for the each monitoredItem
-     * in the subscription */
-    UA_StatusCode retval = refreshLogic(server, session, subscription, NULL);
-    CONDITION_ASSERT_RETURN_RETVAL(retval, "Could not refresh Condition",
-                                   unlockServer(server););
+    /* Trigger RefreshStartEvent and RefreshEndEvent for the each Event
+     * MonitoredItem in the subscription */
+    UA_MonitoredItem *monitoredItem;
+    LIST_FOREACH(monitoredItem, &subscription->monitoredItems, listEntry) {
+        if(monitoredItem->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER)
+            continue;
+        UA_StatusCode retval = refreshLogic(server, monitoredItem);
+        CONDITION_ASSERT_RETURN_RETVAL(retval, "Could not refresh Condition",
+                                       unlockServer(server););
+    }
     unlockServer(server);
     return UA_STATUSCODE_GOOD;
 }
@@ -1846,7 +2041,10 @@ setConditionInConditionList(UA_Server *server, const UA_NodeId *conditionNodeId,
     }
 
     memset(conditionBranchListEntry, 0, sizeof(UA_ConditionBranch));
+    conditionBranchListEntry->condition = conditionListEntry;
+    conditionListEntry->source = conditionSourceEntry;
     LIST_INSERT_HEAD(&conditionSourceEntry->conditions, conditionListEntry, listEntry);
+    ZIP_INSERT(UA_ConditionTree, &server->conditionTree, conditionListEntry);
     LIST_INSERT_HEAD(&conditionListEntry->conditionBranches, conditionBranchListEntry, listEntry);
     return UA_STATUSCODE_GOOD;
 }
@@ -1856,6 +2054,10 @@ appendConditionEntry(UA_Server *server, const UA_NodeId *conditionNodeId,
                      const UA_NodeId *conditionSourceNodeId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
+    /* The condition can only be registered once */
+    if(ZIP_FIND(UA_ConditionTree, &server->conditionTree, conditionNodeId))
+        return UA_STATUSCODE_BADNODEIDEXISTS;
+
     /* See if the ConditionSource Entry already exists*/
     UA_ConditionSource *source = getConditionSource(server, conditionSourceNodeId);
     if(source)
@@ -1877,13 +2079,16 @@ appendConditionEntry(UA_Server *server, const UA_NodeId *conditionNodeId,
     }
 
     LIST_INSERT_HEAD(&server->conditionSources, conditionSourceListEntry, listEntry);
+    ZIP_INSERT(UA_ConditionSourceTree, &server->conditionSourceTree,
+               conditionSourceListEntry);
     return setConditionInConditionList(server, conditionNodeId, conditionSourceListEntry);
 }
 
 static void
-deleteAllBranchesFromCondition(UA_Condition *cond) {
+deleteAllBranchesFromCondition(UA_Server *server, UA_Condition *cond) {
     UA_ConditionBranch *branch, *tmp_branch;
     LIST_FOREACH_SAFE(branch, &cond->conditionBranches, listEntry, tmp_branch) {
+        updateRetainedBranch(server, branch, false);
         UA_NodeId_clear(&branch->conditionBranchId);
         UA_ByteString_clear(&branch->lastEventId);
         LIST_REMOVE(branch, listEntry);
@@ -1892,26 +2097,35 @@ deleteAllBranchesFromCondition(UA_Condition *cond) {
 }
 
 static void
-deleteCondition(UA_Condition *cond) {
-    deleteAllBranchesFromCondition(cond);
+deleteCondition(UA_Server *server, UA_Condition *cond) {
+    deleteAllBranchesFromCondition(server, cond);
+    ZIP_REMOVE(UA_ConditionTree, &server->conditionTree, cond);
     UA_NodeId_clear(&cond->conditionId);
+    for(size_t i = 0; i < CONDITIONFIELD_COUNT; i++)
+        UA_NodeId_clear(&cond->fields[i]);
     LIST_REMOVE(cond, listEntry);
     UA_free(cond);
 }
 
+static void
+deleteConditionSource(UA_Server *server, UA_ConditionSource *source) {
+    UA_Condition *cond, *tmp_cond;
+    LIST_FOREACH_SAFE(cond, &source->conditions, listEntry, tmp_cond) {
+        deleteCondition(server, cond);
+    }
+    ZIP_REMOVE(UA_ConditionSourceTree, &server->conditionSourceTree, source);
+    UA_NodeId_clear(&source->conditionSourceId);
+    LIST_REMOVE(source, listEntry);
+    UA_free(source);
+}
+
 void
 UA_ConditionList_delete(UA_Server *server) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     UA_ConditionSource *source, *tmp_source;
     LIST_FOREACH_SAFE(source, &server->conditionSources, listEntry, tmp_source) {
-        UA_Condition *cond, *tmp_cond;
-        LIST_FOREACH_SAFE(cond, &source->conditions, listEntry, tmp_cond) {
-            deleteCondition(cond);
-        }
-        UA_NodeId_clear(&source->conditionSourceId);
-        LIST_REMOVE(source, listEntry);
-        UA_free(source);
+        deleteConditionSource(server, source);
     }
     /* Free memory allocated for RefreshEvents NodeIds */
     UA_NodeId_clear(&server->refreshEvents[REFRESHEVENT_START_IDX]);
@@ -1925,16 +2139,16 @@ UA_getConditionId(UA_Server *server, const UA_NodeId *conditionNodeId,
                   UA_NodeId *outConditionId) {
     UA_LOCK_ASSERT(&server->serviceMutex);
 
-    /* Get ConditionSource Entry */
+    UA_Condition *cond = ZIP_FIND(UA_ConditionTree, &server->conditionTree, conditionNodeId);
+    if(cond) {
+        *outConditionId = cond->conditionId;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* The branches are not indexed */
     UA_ConditionSource *source;
     LIST_FOREACH(source, &server->conditionSources, listEntry) {
-        /* Get Condition Entry */
-        UA_Condition *cond;
         LIST_FOREACH(cond, &source->conditions, listEntry) {
-            if(UA_NodeId_equal(&cond->conditionId, conditionNodeId)) {
-                *outConditionId = cond->conditionId;
-                return UA_STATUSCODE_GOOD;
-            }
             /* Get Branch Entry*/
             UA_ConditionBranch *branch;
             LIST_FOREACH(branch, &cond->conditionBranches, listEntry) {
@@ -2324,6 +2538,24 @@ setConditionMethodCallbacks(UA_Server *server, const UA_NodeId* condition,
     return retval;
 }
 
+/* Set the callback that keeps the index of retained branches up to date */
+static UA_StatusCode
+setRetainCallback(UA_Server *server, const UA_NodeId *condition) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    UA_NodeId retainNodeId;
+    UA_StatusCode retval =
+        getConditionFieldNodeId(server, condition, &fieldRetainQN, &retainNodeId);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+    UA_ValueSourceNotifications callback;
+    callback.onRead = NULL;
+    callback.onWrite = afterWriteCallbackRetainChange;
+    retval = setVariableNode_internalValueSource(server, retainNodeId, NULL, &callback);
+    UA_NodeId_clear(&retainNodeId);
+    return retval;
+}
+
 static UA_StatusCode
 setStandardConditionCallbacks(UA_Server *server, const UA_NodeId* condition,
                               const UA_NodeId* conditionType) {
@@ -2335,6 +2567,9 @@ setStandardConditionCallbacks(UA_Server *server, const UA_NodeId* condition,
     retval = setConditionVariableCallbacks(server, condition, conditionType);
     CONDITION_ASSERT_RETURN_RETVAL(retval, "Set ConditionVariable Callback failed",);
 
+    retval = setRetainCallback(server, condition);
+    CONDITION_ASSERT_RETURN_RETVAL(retval, "Set Retain Callback failed",);
+
     /* Set callbacks for Method Components (needs to be set only once!) */
     if(LIST_EMPTY(&server->conditionSources)) {
         retval = setConditionMethodCallbacks(server, condition, conditionType);
@@ -2344,6 +2579,24 @@ setStandardConditionCallbacks(UA_Server *server, const UA_NodeId* condition,
     return retval;
 }
 
+static void
+cacheConditionFields(UA_Server *server, const UA_NodeId *conditionId) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    /* Getting the NodeId fills the cache entry. Optional fields that are not
+     * present are resolved upon the first access. */
+    for(size_t i = 0; i < CONDITIONFIELD_COUNT; i++) {
+        const UA_ConditionFieldPath *path = &cachedConditionFields[i];
+        UA_NodeId fieldId;
+        UA_StatusCode res = (path->property.name.length > 0) ?
+            getConditionFieldPropertyNodeId(server, conditionId, &path->field,
+                                            &path->property, &fieldId) :
+            getConditionFieldNodeId(server, conditionId, &path->field, &fieldId);
+        if(res == UA_STATUSCODE_GOOD)
+            UA_NodeId_clear(&fieldId);
+    }
+}
+
 static UA_StatusCode
 addCondition_finish(UA_Server *server, const UA_NodeId conditionId,
                     const UA_NodeId conditionType, const UA_QualifiedName conditionName,
@@ -2411,7 +2664,12 @@ addCondition_finish(UA_Server *server, const UA_NodeId conditionId,
     }
 
     /* append Condition to list */
-    return appendConditionEntry(server, &conditionId, &conditionSource);
+    retval = appendConditionEntry(server, &conditionId, &conditionSource);
+    CONDITION_ASSERT_RETURN_RETVAL(retval, "Appending the Condition to the list failed",);
+
+    /* Resolve the NodeIds of the standard fields once */
+    cacheConditionFields(server, &conditionId);
+    return UA_STATUSCODE_GOOD;
 }
 
 /* Create condition instance. The function checks first whether the passed
@@ -2693,13 +2951,15 @@ setConditionField(UA_Server *server, const UA_NodeId condition,
                                      "Set Condition Field with Array value not implemented",);
     }
 
-    UA_BrowsePathResult bpr = browseSimplifiedBrowsePath(server, condition, 1, &fieldName);
-    if(bpr.statusCode != UA_STATUSCODE_GOOD)
-        return bpr.statusCode;
-
-    UA_StatusCode retval = writeValueAttribute(server, bpr.targets[0].targetId.nodeId, value);
-    UA_BrowsePathResult_clear(&bpr);
+    UA_NodeId fieldId;
+    UA_StatusCode retval = getConditionFieldNodeId(server, &condition, &fieldName, &fieldId);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
 
+    /* The index of retained branches is updated in the write callback of the
+     * Retain field */
+    retval = writeValueAttribute(server, fieldId, value);
+    UA_NodeId_clear(&fieldId);
     return retval;
 }
 
@@ -2726,25 +2986,15 @@ setConditionVariableFieldProperty(UA_Server *server, const UA_NodeId condition,
                                        "Set Property of Condition Field with Array value not implemented",);
     }
 
-    /* 1) find Variable Field of the Condition*/
-    UA_BrowsePathResult bprConditionVariableField =
-        browseSimplifiedBrowsePath(server, condition, 1, &variableFieldName);
-    if(bprConditionVariableField.statusCode != UA_STATUSCODE_GOOD)
-        return bprConditionVariableField.statusCode;
-
-    /* 2) find Property of the Variable Field of the Condition*/
-    UA_BrowsePathResult bprVariableFieldProperty =
-        browseSimplifiedBrowsePath(server, bprConditionVariableField.targets->targetId.nodeId,
-                                   1, &variablePropertyName);
-    if(bprVariableFieldProperty.statusCode != UA_STATUSCODE_GOOD) {
-        UA_BrowsePathResult_clear(&bprConditionVariableField);
-        return bprVariableFieldProperty.statusCode;
-    }
-
+    UA_NodeId propertyId;
     UA_StatusCode retval =
-        writeValueAttribute(server, bprVariableFieldProperty.targets[0].targetId.nodeId, value);
-    UA_BrowsePathResult_clear(&bprConditionVariableField);
-    UA_BrowsePathResult_clear(&bprVariableFieldProperty);
+        getConditionFieldPropertyNodeId(server, &condition, &variableFieldName,
+                                        &variablePropertyName, &propertyId);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+
+    retval = writeValueAttribute(server, propertyId, value);
+    UA_NodeId_clear(&propertyId);
     return retval;
 }
 
@@ -2815,31 +3065,16 @@ UA_Server_triggerConditionEvent(UA_Server *server, const UA_NodeId condition,
 UA_StatusCode
 UA_Server_deleteCondition(UA_Server *server, const UA_NodeId condition,
                           const UA_NodeId conditionSource) {
-    /* Get ConditionSource Entry */
-    UA_Boolean found = false; /* Delete from internal list */
-    UA_ConditionSource *source, *tmp_source;
-
+    /* Delete from internal list */
+    UA_Boolean found = false;
     lockServer(server);
-    LIST_FOREACH_SAFE(source, &server->conditionSources, listEntry, tmp_source) {
-        if(!UA_NodeId_equal(&source->conditionSourceId, &conditionSource))
-            continue;
-
-        /* Get Condition Entry */
-        UA_Condition *cond, *tmp_cond;
-        LIST_FOREACH_SAFE(cond, &source->conditions, listEntry, tmp_cond) {
-            if(!UA_NodeId_equal(&cond->conditionId, &condition))
-                continue;
-            deleteCondition(cond);
-            found = true;
-            break;
-        }
-
-        if(LIST_EMPTY(&source->conditions)){
-            UA_NodeId_clear(&source->conditionSourceId);
-            LIST_REMOVE(source, listEntry);
-            UA_free(source);
-        }
-        break;
+    UA_Condition *cond = getCondition(server, &conditionSource, &condition);
+    if(cond) {
+        UA_ConditionSource *source = cond->source;
+        deleteCondition(server, cond);
+        if(LIST_EMPTY(&source->conditions))
+            deleteConditionSource(server, source);
+        found = true;
     }
     unlockServer(server);
 
@@ -1681,6 +1681,13 @@ createEvent(UA_Server *server, const UA_EventDescription *ed,
 #endif
     }
 
+#ifdef UA_ENABLE_PUBSUB
+    /* Publish the event in the PublishedEvents DataSets. Events for a specific
+     * Session are not published. */
+    if(!ed->sessionId)
+        UA_PubSubManager_createEvent(server, emitNodes, emitNodesSize, &ctx);
+#endif
+
     /* Clean up and return */
     if(outEventId && res != UA_STATUSCODE_GOOD)
         UA_ByteString_clear(outEventId);
@@ -1688,6 +1695,44 @@ createEvent(UA_Server *server, const UA_EventDescription *ed,
     return res;
 }
 
+UA_StatusCode
+createEventForMonitoredItem(UA_Server *server, const UA_EventDescription *ed,
+                            UA_MonitoredItem *mon, UA_ByteString *outEventId) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+
+    if(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER ||
+       !UA_ExtensionObject_hasDecodedType(&mon->parameters.filter,
+                                          &UA_TYPES[UA_TYPES_EVENTFILTER]))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    UA_FilterEvalContext ctx;
+    UA_FilterEvalContext_init(&ctx);
+    ctx.server = server;
+    ctx.ed = *ed;
+    ctx.filter = *(UA_EventFilter*)mon->parameters.filter.content.decoded.data;
+    UA_Subscription *sub = mon->subscription;
+    ctx.session = (sub->session) ? sub->session : &server->adminSession;
+
+    /* Resolve the EventId first. It remains cached in the context for the
+     * evaluation of the select-clause. */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(outEventId) {
+        res = cacheEventId(&ctx);
+        if(res == UA_STATUSCODE_GOOD)
+            res = UA_ByteString_copy(&ctx.eventId, outEventId);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_FilterEvalContext_reset(&ctx);
+            return res;
+        }
+    }
+
+    res = UA_MonitoredItem_addEvent(mon, &ctx);
+    UA_FilterEvalContext_reset(&ctx);
+    if(outEventId && res != UA_STATUSCODE_GOOD)
+        UA_ByteString_clear(outEventId);
+    return res;
+}
+
 UA_StatusCode
 UA_Server_createEvent(UA_Server *server, const UA_NodeId sourceNode,
                       const UA_NodeId eventType, UA_UInt16 severity,
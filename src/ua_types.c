@@ -805,14 +805,112 @@ UA_NODEID_BYTESTRING_ALLOC(UA_UInt16 nsIndex,
     return id;
 }
 
-/* sdbm-hash (http://www.cse.yorku.ca/~oz/hash.html) */
+/* 64bit block hash following wyhash (https://github.com/wangyi-fudan/wyhash,
+ * public domain). The input is consumed in 8-byte words and mixed with a
+ * 64x64->128bit multiplication. The words are read as little-endian so that the
+ * hash values are the same on all platforms. */
+
+static const u64 hashSecret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+static UA_INLINE void
+hashMum(u64 *a, u64 *b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 r = *a;
+    r *= *b;
+    *a = (u64)r;
+    *b = (u64)(r >> 64);
+#else
+    u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+    u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    u64 t = rl + (rm0 << 32);
+    u64 c = t < rl;
+    u64 lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static UA_INLINE u64
+hashMix(u64 a, u64 b) {
+    hashMum(&a, &b);
+    return a ^ b;
+}
+
+static UA_INLINE u64
+hashRead8(const u8 *p) {
+#if UA_LITTLE_ENDIAN
+    u64 v;
+    memcpy(&v, p, 8);
+    return v;
+#else
+    return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24) |
+        ((u64)p[4] << 32) | ((u64)p[5] << 40) | ((u64)p[6] << 48) | ((u64)p[7] << 56);
+#endif
+}
+
+static UA_INLINE u64
+hashRead4(const u8 *p) {
+#if UA_LITTLE_ENDIAN
+    u32 v;
+    memcpy(&v, p, 4);
+    return v;
+#else
+    return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24);
+#endif
+}
+
+static u64
+hash64(u64 seed, const u8 *p, size_t len) {
+    seed ^= hashMix(seed ^ hashSecret[0], hashSecret[1]);
+    u64 a, b;
+    if(len <= 16) {
+        if(len >= 4) {
+            size_t off = (len >> 3) << 2;
+            a = (hashRead4(p) << 32) | hashRead4(p + off);
+            b = (hashRead4(p + len - 4) << 32) | hashRead4(p + len - 4 - off);
+        } else if(len > 0) {
+            a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if(i > 48) {
+            /* Three independent lanes */
+            u64 see1 = seed, see2 = seed;
+            do {
+                seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+                see1 = hashMix(hashRead8(p + 16) ^ hashSecret[2], hashRead8(p + 24) ^ see1);
+                see2 = hashMix(hashRead8(p + 32) ^ hashSecret[3], hashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* The last 16 bytes (overlapping with the previous block) */
+        a = hashRead8(p + i - 16);
+        b = hashRead8(p + i - 8);
+    }
+    a ^= hashSecret[1];
+    b ^= seed;
+    hashMum(&a, &b);
+    return hashMix(a ^ hashSecret[0] ^ (u64)len, b ^ hashSecret[1]);
+}
+
 u32
 UA_ByteString_hash(u32 initialHashValue,
                    const u8 *data, size_t size) {
-    u32 h = initialHashValue;
-    for(size_t i = 0; i < size; i++)
-        h = data[i] + (h << 6) + (h << 16) - h;
-    return h;
+    u64 h = hash64(initialHashValue, data, size);
+    return (u32)(h ^ (h >> 32));
 }
 
 u32
@@ -1249,6 +1249,34 @@ UA_encodeJson(const void *src, const UA_DataType *type, UA_ByteString *outBuf,
     return res;
 }
 
+/* The legacy encoding has no streaming support. Encode to a temporary buffer
+ * and hand it to the flush callback in chunks of the buffer size. */
+UA_StatusCode
+UA_encodeJsonStream(const void *src, const UA_DataType *type,
+                    const UA_ByteString *buf,
+                    UA_EncodeJsonFlushCallback flushCallback, void *flushContext,
+                    const UA_EncodeJsonOptions *options) {
+    if(!src || !type || !buf || buf->length == 0 || !flushCallback)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_ByteString out = UA_BYTESTRING_NULL;
+    status res = UA_encodeJson(src, type, &out, options);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    for(size_t pos = 0; pos < out.length && res == UA_STATUSCODE_GOOD;
+        pos += buf->length) {
+        UA_ByteString chunk = *buf;
+        if(chunk.length > out.length - pos)
+            chunk.length = out.length - pos;
+        memcpy(chunk.data, &out.data[pos], chunk.length);
+        res = flushCallback(flushContext, &chunk);
+    }
+
+    UA_ByteString_clear(&out);
+    return res;
+}
+
 UA_StatusCode
 UA_print(const void *p, const UA_DataType *type, UA_String *output) {
     if(!p || !type || !output)
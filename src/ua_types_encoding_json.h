@@ -37,6 +37,13 @@ typedef struct {
     UA_Boolean prettyPrint;
     UA_Boolean unquotedKeys;
     UA_Boolean stringNodeIds;
+
+    /* Streaming output. When the buffer is full, the content between begin and
+     * pos is handed to the flush callback and pos is reset to begin. */
+    uint8_t *begin;
+    UA_EncodeJsonFlushCallback flushCallback;
+    void *flushContext;
+    UA_StatusCode flushStatus; /* First error returned by the flush callback */
 } CtxJson;
 
 UA_StatusCode writeJsonObjStart(CtxJson *ctx);
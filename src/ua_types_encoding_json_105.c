@@ -51,10 +51,34 @@ decodeJsonStructure(ParseCtx *ctx, void *dst, const UA_DataType *type);
 #define ENCODE_DIRECT_JSON(SRC, TYPE) \
     TYPE##_encodeJson(ctx, (const UA_##TYPE*)SRC, NULL)
 
+/* Hand the encoded content of the buffer to the flush callback and start over
+ * at the beginning of the buffer. Without a flush callback the buffer cannot
+ * grow. If the callback fails, the encoding stops and its status code is
+ * retained. */
 static status UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT
-writeChar(CtxJson *ctx, char c) {
-    if(ctx->pos >= ctx->end)
+flushJson(CtxJson *ctx) {
+    if(!ctx->flushCallback)
+        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    UA_ByteString chunk = {(size_t)(ctx->pos - ctx->begin), ctx->begin};
+    ctx->pos = ctx->begin;
+    if(chunk.length == 0)
         return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    status res = ctx->flushCallback(ctx->flushContext, &chunk);
+    if(res != UA_STATUSCODE_GOOD) {
+        ctx->flushStatus = res;
+        ctx->flushCallback = NULL;
+        ctx->end = ctx->begin;
+    }
+    return res;
+}
+
+static status UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT
+writeChar(CtxJson *ctx, char c) {
+    if(ctx->pos >= ctx->end) {
+        status res = flushJson(ctx);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
     if(!ctx->calcOnly)
         *ctx->pos = (UA_Byte)c;
     ctx->pos++;
@@ -63,8 +87,19 @@ writeChar(CtxJson *ctx, char c) {
 
 static status UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT
 writeChars(CtxJson *ctx, const char *c, size_t len) {
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    /* Fill up and flush the buffer until the remainder fits */
+    while(ctx->pos + len > ctx->end) {
+        if(!ctx->flushCallback)
+            return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+        size_t part = (size_t)(ctx->end - ctx->pos);
+        memcpy(ctx->pos, c, part);
+        ctx->pos += part;
+        c += part;
+        len -= part;
+        status res = flushJson(ctx);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
     if(!ctx->calcOnly)
         memcpy(ctx->pos, c, len);
     ctx->pos += len;
@@ -206,14 +241,32 @@ static const char* UA_JSONKEY_INNERSTATUSCODE = "InnerStatusCode";
 static const char* UA_JSONKEY_INNERDIAGNOSTICINFO = "InnerDiagnosticInfo";
 
 /* Writes null terminated string to output buffer (current ctx->pos). Writes
- * comma in front of key if needed. Encapsulates key in quotes. */
+ * comma in front of key if needed. Encapsulates key in quotes.
+ *
+ * The keys are the member names of the generated datatypes and the constants
+ * above. They never contain characters that need escaping. So the quoted key
+ * is written with a single bounds check in the common case. */
 status UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT
 writeJsonKey(CtxJson *ctx, const char* key) {
     status ret = writeJsonBeforeElement(ctx, true);
     ctx->commaNeeded[ctx->depth] = true;
+
+    size_t keyLen = strlen(key);
+    if(!ctx->unquotedKeys && !ctx->prettyPrint &&
+       ctx->pos + keyLen + 3 <= ctx->end) {
+        if(!ctx->calcOnly) {
+            ctx->pos[0] = '\"';
+            memcpy(&ctx->pos[1], key, keyLen);
+            ctx->pos[keyLen + 1] = '\"';
+            ctx->pos[keyLen + 2] = ':';
+        }
+        ctx->pos += keyLen + 3;
+        return ret;
+    }
+
     if(!ctx->unquotedKeys)
         ret |= writeChar(ctx, '\"');
-    ret |= writeChars(ctx, key, strlen(key));
+    ret |= writeChars(ctx, key, keyLen);
     if(!ctx->unquotedKeys)
         ret |= writeChar(ctx, '\"');
     ret |= writeChar(ctx, ':');
@@ -242,84 +295,42 @@ ENCODE_JSON(Boolean) {
 ENCODE_JSON(Byte) {
     char buf[4];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    /* Ensure destination can hold the data- */
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    /* Copy digits to the output string/buffer. */
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* signed Byte */
 ENCODE_JSON(SByte) {
     char buf[5];
     UA_UInt16 digits = itoaSigned(*src, buf);
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt16 */
 ENCODE_JSON(UInt16) {
     char buf[6];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* Int16 */
 ENCODE_JSON(Int16) {
     char buf[7];
     UA_UInt16 digits = itoaSigned(*src, buf);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt32 */
 ENCODE_JSON(UInt32) {
     char buf[11];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* Int32 */
 ENCODE_JSON(Int32) {
     char buf[12];
     UA_UInt16 digits = itoaSigned(*src, buf);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt64 */
@@ -329,14 +340,7 @@ ENCODE_JSON(UInt64) {
     UA_UInt16 digits = itoaUnsigned(*src, buf + 1, 10);
     buf[digits + 1] = '\"';
     UA_UInt16 length = (UA_UInt16)(digits + 2);
-
-    if(ctx->pos + length > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, length);
-    ctx->pos += length;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, length);
 }
 
 /* Int64 */
@@ -346,14 +350,7 @@ ENCODE_JSON(Int64) {
     UA_UInt16 digits = itoaSigned(*src, buf + 1);
     buf[digits + 1] = '\"';
     UA_UInt16 length = (UA_UInt16)(digits + 2);
-
-    if(ctx->pos + length > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, length);
-    ctx->pos += length;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, length);
 }
 
 ENCODE_JSON(Float) {
@@ -372,13 +369,7 @@ ENCODE_JSON(Float) {
         len = dtoa((UA_Double)*src, buffer);
     }
 
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buffer, len);
-    ctx->pos += len;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buffer, len);
 }
 
 ENCODE_JSON(Double) {
@@ -397,13 +388,7 @@ ENCODE_JSON(Double) {
         len = dtoa(*src, buffer);
     }
 
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buffer, len);
-    ctx->pos += len;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buffer, len);
 }
 
 static status
@@ -430,6 +415,27 @@ encodeJsonArray(CtxJson *ctx, const void *ptr, size_t length,
     return ret | writeJsonArrEnd(ctx, type);
 }
 
+/* Returns true if one of the eight bytes at pos is a control character, DEL,
+ * a backslash or a quote. Uses the "determine if a word has a byte less than
+ * n" technique. The bytes of a word are tested independently of the byte
+ * order. */
+#define JSON_ONES ((u64)0x0101010101010101ULL)
+#define JSON_HIGHS ((u64)0x8080808080808080ULL)
+
+static UA_INLINE UA_Boolean
+jsonNeedsEscape8(const unsigned char *pos) {
+    u64 x;
+    memcpy(&x, pos, 8);
+    u64 quote = x ^ (JSON_ONES * '\"');
+    u64 backslash = x ^ (JSON_ONES * '\\');
+    u64 del = x ^ (JSON_ONES * 127);
+    u64 t = ((x - JSON_ONES * ' ') & ~x) |
+        ((quote - JSON_ONES) & ~quote) |
+        ((backslash - JSON_ONES) & ~backslash) |
+        ((del - JSON_ONES) & ~del);
+    return (t & JSON_HIGHS) != 0;
+}
+
 static const char hexmap[16] =
     {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
 
@@ -444,19 +450,20 @@ ENCODE_JSON(String) {
 
     const unsigned char *end = src->data + src->length;
     for(const unsigned char *pos = src->data; pos < end; pos++) {
-        /* Skip to the first character that needs escaping */
+        /* Skip to the first character that needs escaping. Test eight bytes
+         * at once for the common case without escapes. */
         const unsigned char *start = pos;
+        while(pos + 8 <= end && !jsonNeedsEscape8(pos))
+            pos += 8;
         for(; pos < end; pos++) {
             if(*pos < ' ' || *pos == 127 || *pos == '\\' || *pos == '\"')
                 break;
         }
 
         /* Write out the unescaped sequence */
-        if(ctx->pos + (pos - start) > ctx->end)
-            return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-        if(!ctx->calcOnly)
-            memcpy(ctx->pos, start, (size_t)(pos - start));
-        ctx->pos += pos - start;
+        ret |= writeChars(ctx, (const char*)start, (size_t)(pos - start));
+        if(ret != UA_STATUSCODE_GOOD)
+            return ret;
 
         /* The unescaped sequence reached the end */
         if(pos == end)
@@ -491,14 +498,10 @@ ENCODE_JSON(String) {
             break;
         }
 
-        /* Enough space? */
-        if(ctx->pos + escape_len > ctx->end)
-            return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
         /* Write the escaped character */
-        if(!ctx->calcOnly)
-            memcpy(ctx->pos, escape_text, escape_len);
-        ctx->pos += escape_len;
+        ret |= writeChars(ctx, escape_text, escape_len);
+        if(ret != UA_STATUSCODE_GOOD)
+            return ret;
     }
 
     return ret | writeJsonQuote(ctx);
@@ -522,15 +525,8 @@ ENCODE_JSON(ByteString) {
     if(!ba64)
         return UA_STATUSCODE_BADENCODINGERROR;
 
-    if(ctx->pos + flen > ctx->end) {
-        UA_free(ba64);
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    }
-
     /* Copy flen bytes to output stream. */
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, ba64, flen);
-    ctx->pos += flen;
+    ret |= writeChars(ctx, (const char*)ba64, flen);
 
     /* Base64 result no longer needed */
     UA_free(ba64);
@@ -540,13 +536,11 @@ ENCODE_JSON(ByteString) {
 
 /* Guid */
 ENCODE_JSON(Guid) {
-    if(ctx->pos + 38 > ctx->end) /* 36 + 2 (") */
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    status ret = writeJsonQuote(ctx);
-    if(!ctx->calcOnly)
-        UA_Guid_to_hex(src, ctx->pos, false);
-    ctx->pos += 36;
-    return ret | writeJsonQuote(ctx);
+    UA_Byte buf[38]; /* 36 + 2 (") */
+    buf[0] = '\"';
+    UA_Guid_to_hex(src, &buf[1], false);
+    buf[37] = '\"';
+    return writeChars(ctx, (const char*)buf, 38);
 }
 
 /* DateTime */
@@ -971,6 +965,42 @@ UA_encodeJson(const void *src, const UA_DataType *type, UA_ByteString *outBuf,
     return res;
 }
 
+UA_StatusCode
+UA_encodeJsonStream(const void *src, const UA_DataType *type,
+                    const UA_ByteString *buf,
+                    UA_EncodeJsonFlushCallback flushCallback, void *flushContext,
+                    const UA_EncodeJsonOptions *options) {
+    if(!src || !type || !buf || buf->length == 0 || !flushCallback)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Set up the context */
+    CtxJson ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.begin = buf->data;
+    ctx.pos = buf->data;
+    ctx.end = &buf->data[buf->length];
+    ctx.flushCallback = flushCallback;
+    ctx.flushContext = flushContext;
+    ctx.useReversible = true; /* default */
+    if(options) {
+        ctx.namespaceMapping = options->namespaceMapping;
+        ctx.serverUris = options->serverUris;
+        ctx.serverUrisSize = options->serverUrisSize;
+        ctx.useReversible = options->useReversible;
+        ctx.prettyPrint = options->prettyPrint;
+        ctx.unquotedKeys = options->unquotedKeys;
+        ctx.stringNodeIds = options->stringNodeIds;
+    }
+
+    /* Encode and flush the remainder */
+    status res = encodeJsonJumpTable[type->typeKind](&ctx, src, type);
+    if(res == UA_STATUSCODE_GOOD && ctx.pos > ctx.begin)
+        res = flushJson(&ctx);
+    if(ctx.flushStatus != UA_STATUSCODE_GOOD)
+        return ctx.flushStatus;
+    return res;
+}
+
 UA_StatusCode
 UA_print(const void *p, const UA_DataType *type, UA_String *output) {
     if(!p || !type || !output)
@@ -1095,8 +1125,8 @@ jsoneq(const char *json, const cj5_token *tok, const char *searchKey) {
 
     size_t len = getTokenLength(tok);
     if(tok->type == CJ5_TOKEN_STRING &&
-       strlen(searchKey) ==  len &&
-       strncmp(json + tok->start, (const char*)searchKey, len) == 0)
+       strlen(searchKey) == len &&
+       memcmp(json + tok->start, searchKey, len) == 0)
         return 0;
 
     return -1;
@@ -2209,6 +2239,34 @@ DiagnosticInfoInner_decodeJson(ParseCtx* ctx, void* dst, const UA_DataType* type
     return DiagnosticInfo_decodeJson(ctx, inner, type);
 }
 
+/* Field names are ordered by their length first and then bytewise. The key
+ * token can contain NUL bytes and is not terminated. So the key is never read
+ * as a C-string. */
+static int
+compareName(const char *a, size_t aLen, const char *b, size_t bLen) {
+    if(aLen != bLen)
+        return (aLen < bLen) ? -1 : 1;
+    return memcmp(a, b, aLen);
+}
+
+static int
+compareKey(const ParseCtx *ctx, const cj5_token *tok, const char *fieldName) {
+    return compareName(&ctx->json5[tok->start], getTokenLength(tok),
+                       fieldName, strlen(fieldName));
+}
+
+static int
+compareEntries(const void *a, const void *b) {
+    const DecodeEntry *ea = *(const DecodeEntry * const *)a;
+    const DecodeEntry *eb = *(const DecodeEntry * const *)b;
+    return compareName(ea->fieldName, strlen(ea->fieldName),
+                       eb->fieldName, strlen(eb->fieldName));
+}
+
+/* Objects with more fields than this use binary search over the sorted field
+ * names if the keys do not appear in the order of the entries */
+#define UA_JSON_SORTEDFIELDS_MIN 8
+
 status
 decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
     CHECK_TOKEN_BOUNDS;
@@ -2225,36 +2283,55 @@ decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
     ctx->index++; /* Go to first key - or jump after the empty object */
     ctx->depth++;
 
+    /* Field names sorted for binary search. Set up only when a key appears out
+     * of order in a wide object. */
+    UA_Boolean sorted = false;
+    UA_STACKARRAY(DecodeEntry*, sortedEntries, entryCount);
+
     status ret = UA_STATUSCODE_GOOD;
     for(size_t key = 0; key < keyCount; key++) {
         /* Key must be a string */
         UA_assert(ctx->index < ctx->tokensSize);
         UA_assert(currentTokenType(ctx) == CJ5_TOKEN_STRING);
+        const cj5_token *keyToken = &ctx->tokens[ctx->index];
 
         /* Search for the decoding entry matching the key. Start at the key
          * index to speed-up the case where they key-order is the same as the
          * entry-order. */
         DecodeEntry *entry = NULL;
-        for(size_t i = key; i < key + entryCount; i++) {
-            size_t ii = i;
-            while(ii >= entryCount)
-                ii -= entryCount;
-
-            /* Compare the key */
-            if(jsoneq(ctx->json5, &ctx->tokens[ctx->index],
-                      entries[ii].fieldName) != 0)
-                continue;
-
-            /* Key was already used -> duplicate, abort */
-            if(entries[ii].found) {
-                ctx->depth--;
-                return UA_STATUSCODE_BADDECODINGERROR;
+        size_t next = key % (entryCount > 0 ? entryCount : 1);
+        if(entryCount > 0 &&
+           jsoneq(ctx->json5, keyToken, entries[next].fieldName) == 0) {
+            entry = &entries[next];
+        } else if(entryCount >= UA_JSON_SORTEDFIELDS_MIN) {
+            /* Binary search in the sorted field names */
+            if(!sorted) {
+                for(size_t i = 0; i < entryCount; i++)
+                    sortedEntries[i] = &entries[i];
+                qsort(sortedEntries, entryCount, sizeof(DecodeEntry*), compareEntries);
+                sorted = true;
+            }
+            size_t lo = 0, hi = entryCount;
+            while(lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                int c = compareKey(ctx, keyToken, sortedEntries[mid]->fieldName);
+                if(c == 0) {
+                    entry = sortedEntries[mid];
+                    break;
+                }
+                if(c < 0)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+        } else {
+            /* Linear search for small objects */
+            for(size_t i = 0; i < entryCount; i++) {
+                if(jsoneq(ctx->json5, keyToken, entries[i].fieldName) == 0) {
+                    entry = &entries[i];
+                    break;
+                }
             }
-
-            /* Found the key */
-            entries[ii].found = true;
-            entry = &entries[ii];
-            break;
         }
 
         /* The key is unknown */
@@ -2263,6 +2340,13 @@ decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
             break;
         }
 
+        /* Key was already used -> duplicate, abort */
+        if(entry->found) {
+            ctx->depth--;
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        entry->found = true;
+
         /* Go from key to value */
         ctx->index++;
         UA_assert(ctx->index < ctx->tokensSize);
@@ -2417,25 +2501,59 @@ const decodeJsonSignature decodeJsonJumpTable[UA_DATATYPEKINDS] = {
     (decodeJsonSignature)decodeJsonNotImplemented /* BitfieldCluster */
 };
 
+/* The initial token array is provided by the caller (usually on the stack).
+ * When it runs full, the tokens are moved to the heap and the array grows
+ * during the parsing. */
+typedef struct {
+    cj5_token *initial;
+    cj5_token *tokens;
+} TokenBuffer;
+
+static cj5_token *
+growTokens(void *context, cj5_token *tokens, unsigned int *maxTokens) {
+    TokenBuffer *tb = (TokenBuffer*)context;
+    UA_assert(tokens == tb->tokens);
+    if(*maxTokens > UA_UINT32_MAX / 2)
+        return NULL;
+    unsigned int newMax = (*maxTokens > 0) ? *maxTokens * 2 : UA_JSON_MAXTOKENCOUNT;
+    size_t newSize = sizeof(cj5_token) * (size_t)newMax;
+    if(newSize / sizeof(cj5_token) != newMax)
+        return NULL;
+    cj5_token *newTokens;
+    if(tokens == tb->initial) {
+        newTokens = (cj5_token*)UA_malloc(newSize);
+        if(newTokens)
+            memcpy(newTokens, tokens, sizeof(cj5_token) * *maxTokens);
+    } else {
+        newTokens = (cj5_token*)UA_realloc(tokens, newSize);
+    }
+    if(!newTokens)
+        return NULL;
+    tb->tokens = newTokens;
+    *maxTokens = newMax;
+    return newTokens;
+}
+
 status
 tokenize(ParseCtx *ctx, const UA_ByteString *src, size_t tokensSize,
          size_t *decodedLength) {
-    /* Tokenize */
+    /* Tokenize. The token array is grown as needed. If ctx->tokens is replaced
+     * by a heap-allocated array, the caller has to free it. */
+    TokenBuffer tb;
+    tb.initial = ctx->tokens;
+    tb.tokens = ctx->tokens;
     cj5_options options;
+    memset(&options, 0, sizeof(cj5_options));
     options.stop_early = (decodedLength != NULL);
+    options.grow_tokens = growTokens;
+    options.grow_context = &tb;
     cj5_result r = cj5_parse((char*)src->data, (unsigned int)src->length,
                              ctx->tokens, (unsigned int)tokensSize, &options);
+    ctx->tokens = tb.tokens;
 
-    /* Handle overflow error by allocating the number of tokens the parser would
-     * have needed */
-    if(r.error == CJ5_ERROR_OVERFLOW &&
-       tokensSize != r.num_tokens) {
-        ctx->tokens = (cj5_token*)
-            UA_malloc(sizeof(cj5_token) * r.num_tokens);
-        if(!ctx->tokens)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        return tokenize(ctx, src, r.num_tokens, decodedLength);
-    }
+    /* The token array could not grow */
+    if(r.error == CJ5_ERROR_OVERFLOW)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
 
     /* Cannot recover from other errors */
     if(r.error != CJ5_ERROR_NONE)
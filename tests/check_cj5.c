@@ -7,6 +7,7 @@
 #include "cj5.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <float.h>
 
@@ -133,6 +134,7 @@ START_TEST(parseObjectNoRoot) {
 
 START_TEST(parseObjectStopEarly) {
     cj5_options opt;
+    memset(&opt, 0, sizeof(cj5_options));
     opt.stop_early = true;
     const char *json = "{'a':1}, x";
     cj5_token tokens[32];
@@ -168,6 +170,7 @@ START_TEST(parseArray) {
 
 START_TEST(parseArrayStopEarly) {
     cj5_options opt;
+    memset(&opt, 0, sizeof(cj5_options));
     opt.stop_early = true;
     const char *json = "[1] }";
     cj5_token tokens[32];
@@ -185,6 +188,7 @@ START_TEST(parseValue) {
 
 START_TEST(parseValueStopEarly) {
     cj5_options opt;
+    memset(&opt, 0, sizeof(cj5_options));
     opt.stop_early = true;
     const char *json = "1.0{";
     cj5_token tokens[32];
@@ -215,6 +219,57 @@ START_TEST(parseNegInf) {
     ck_assert_msg(val == -INFINITY, "val: %f", val);
 } END_TEST
 
+static cj5_token growBuf[64];
+
+static cj5_token *
+growTokens(void *context, cj5_token *tokens, unsigned int *max_tokens) {
+    unsigned int *growCount = (unsigned int*)context;
+    if(*max_tokens * 2 > 64)
+        return NULL;
+    memcpy(growBuf, tokens, sizeof(cj5_token) * *max_tokens);
+    *max_tokens *= 2;
+    (*growCount)++;
+    return growBuf;
+}
+
+START_TEST(parseGrowTokens) {
+    /* Nested objects and arrays to check the parent relations after moving
+     * the tokens */
+    const char *json = "{'a':[1,2,{'b':3,'c':[4,5]}],'d':{'e':6},'f':7}";
+    cj5_token tokens[2];
+    unsigned int growCount = 0;
+    cj5_options opt;
+    memset(&opt, 0, sizeof(cj5_options));
+    opt.grow_tokens = growTokens;
+    opt.grow_context = &growCount;
+    cj5_result r = cj5_parse(json, (unsigned int)strlen(json), tokens, 2, &opt);
+    ck_assert(r.error == CJ5_ERROR_NONE);
+    ck_assert_uint_eq(growCount, 4); /* 2 -> 32 */
+    ck_assert_ptr_eq(r.tokens, growBuf);
+    ck_assert_uint_eq(r.num_tokens, 18);
+    ck_assert_uint_eq(r.tokens[0].size, 6);
+    ck_assert_uint_eq(r.tokens[2].size, 3); /* 'a' array */
+    ck_assert_uint_eq(r.tokens[5].size, 4); /* nested object */
+    ck_assert_uint_eq(r.tokens[5].parent_id, 2);
+    ck_assert_uint_eq(r.tokens[9].size, 2); /* 'c' array */
+
+    /* Compare with parsing into a sufficient array */
+    cj5_token tokens2[32];
+    cj5_result r2 = cj5_parse(json, (unsigned int)strlen(json), tokens2, 32, NULL);
+    ck_assert(r2.error == CJ5_ERROR_NONE);
+    ck_assert_uint_eq(r2.num_tokens, r.num_tokens);
+    ck_assert(memcmp(r.tokens, r2.tokens, sizeof(cj5_token) * r.num_tokens) == 0);
+
+    /* Growing fails -> overflow */
+    const char *large = "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,"
+        "21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,"
+        "44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61,62,63,64,65]";
+    growCount = 0;
+    r = cj5_parse(large, (unsigned int)strlen(large), tokens, 2, &opt);
+    ck_assert(r.error == CJ5_ERROR_OVERFLOW);
+    ck_assert_uint_eq(r.num_tokens, 66);
+} END_TEST
+
 static Suite *testSuite_builtin_json(void) {
     TCase *tc_parse= tcase_create("cj5_parse");
     tcase_add_test(tc_parse, parseObject);
@@ -234,6 +289,7 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_parse, parseValueStopEarly);
     tcase_add_test(tc_parse, parseInf);
     tcase_add_test(tc_parse, parseNegInf);
+    tcase_add_test(tc_parse, parseGrowTokens);
 
     Suite *s = suite_create("Test JSON decoding with the cj5 library");
     suite_add_tcase(s, tc_parse);
@@ -16,10 +16,20 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
-#define ETHERNET_INTERFACE "lo" /* use the loopback interface for testing */
+/* Use the loopback interface for testing. Set the environment variable
+ * OPEN62541_TEST_ETH_INTERFACE to test with another interface (e.g. one end of
+ * a veth pair in a network namespace). */
+#define ETHERNET_INTERFACE "lo"
 #define MULTICAST_MAC_ADDRESS "00-00-00-00-00-00"
 
+static UA_String
+testInterface(void) {
+    char *iface = getenv("OPEN62541_TEST_ETH_INTERFACE");
+    return UA_STRING((iface) ? iface : ETHERNET_INTERFACE);
+}
+
 typedef struct TestContext {
     unsigned connCount;
 } TestContext;
@@ -63,6 +73,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -74,7 +85,7 @@ START_TEST(listenETH) {
 
     TestContext testContext = {0};
 
-    UA_String interface = UA_STRING(ETHERNET_INTERFACE);
+    UA_String interface = testInterface();
     UA_String address = UA_STRING(MULTICAST_MAC_ADDRESS);
     UA_Boolean listen = true;
 
@@ -119,7 +130,7 @@ START_TEST(connectETH) {
     el->registerEventSource(el, &cm->eventSource);
     el->start(el);
 
-    UA_String interface = UA_STRING(ETHERNET_INTERFACE);
+    UA_String interface = testInterface();
     UA_String address = UA_STRING(MULTICAST_MAC_ADDRESS);
     UA_Boolean listen = true;
     UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
@@ -197,11 +208,212 @@ START_TEST(connectETH) {
     el = NULL;
 } END_TEST
 
+
+/* Open a listen and a send connection with optional PACKET_MMAP rings */
+static void
+openRingConnections(UA_ConnectionManager *cm, TestContext *testContext,
+                    UA_Boolean ring, uintptr_t *sendId) {
+    UA_String interface = testInterface();
+    UA_String address = UA_STRING(MULTICAST_MAC_ADDRESS);
+    UA_Boolean listen = true;
+    UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
+
+    UA_KeyValuePair params[5];
+    params[0].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[0].value, &address, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "interface");
+    UA_Variant_setScalar(&params[1].value, &interface, &UA_TYPES[UA_TYPES_STRING]);
+    params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+    UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+    params[3].key = UA_QUALIFIEDNAME(0, "packet-ring");
+    UA_Variant_setScalar(&params[3].value, &ring, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[4].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[4].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    /* Listen connection without the address */
+    UA_KeyValueMap kvm = {4, &params[1]};
+    UA_StatusCode retval =
+        cm->openConnection(cm, &kvm, NULL, testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Send connection without the listen parameter */
+    kvm.map = params;
+    clientId = 0;
+    retval = cm->openConnection(cm, &kvm, NULL, testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(clientId != 0);
+    *sendId = clientId;
+}
+
+static void
+stopEventLoop(void) {
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+}
+
+START_TEST(connectETHRing) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("ethCM"));
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    TestContext testContext = {0};
+    uintptr_t sendId;
+    openRingConnections(cm, &testContext, true, &sendId);
+    ck_assert_uint_eq(testContext.connCount, 2);
+
+    /* A ring frame that is freed without sending is skipped by the kernel */
+    UA_ByteString snd;
+    UA_StatusCode retval = cm->allocNetworkBuffer(cm, sendId, &snd, strlen(testMsg));
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    cm->freeNetworkBuffer(cm, sendId, &snd);
+    ck_assert_ptr_eq(snd.data, NULL);
+
+    /* Two buffers from the ring are used at the same time */
+    retval = cm->allocNetworkBuffer(cm, sendId, &snd, strlen(testMsg));
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_ByteString snd2;
+    retval = cm->allocNetworkBuffer(cm, sendId, &snd2, strlen(testMsg));
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_ne(snd2.data, snd.data);
+
+    /* A frame that exceeds the ring frame size cannot be allocated */
+    UA_ByteString large;
+    retval = cm->allocNetworkBuffer(cm, sendId, &large, 1 << 16);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADOUTOFMEMORY);
+
+    /* Send both messages */
+    receivedCount = 0;
+    memcpy(snd.data, testMsg, strlen(testMsg));
+    retval = cm->sendWithConnection(cm, sendId, NULL, &snd);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    memcpy(snd2.data, testMsg, strlen(testMsg));
+    retval = cm->sendWithConnection(cm, sendId, NULL, &snd2);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Send more messages than the ring has frames. The frames are reused. */
+    for(size_t i = 0; i < 4096; i++) {
+        retval = cm->allocNetworkBuffer(cm, sendId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        retval = cm->sendWithConnection(cm, sendId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        if(i % 64 == 0)
+            el->run(el, 0);
+    }
+
+    /* Receive from the rx ring */
+    for(size_t i = 0; i < 1000 && receivedCount < 4098; i++) {
+        UA_DateTime next = el->run(el, 10);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_ge(receivedCount, 4098);
+
+    /* Close the send connection while frames are pending in the tx ring. The
+     * kernel is notified for the pending frames before the socket closes. */
+    receivedCount = 0;
+    for(size_t i = 0; i < 16; i++) {
+        retval = cm->allocNetworkBuffer(cm, sendId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        retval = cm->sendWithConnection(cm, sendId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    retval = cm->closeConnection(cm, sendId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 100 && receivedCount < 16; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(testContext.connCount, 1);
+    ck_assert_uint_eq(receivedCount, 16);
+
+    stopEventLoop();
+    ck_assert_uint_eq(testContext.connCount, 0);
+} END_TEST
+
+static double
+monotonicSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+#define ETH_SPEED_FRAMES 200000
+#define ETH_SPEED_BATCH 256
+
+/* Measure the frames per second sent and received with and without the
+ * PACKET_MMAP rings. A batch of frames is sent in every iteration of the
+ * EventLoop. Frames that are dropped by the kernel are not counted. */
+static void
+runSpeed(UA_Boolean ring, double *sentFps, double *receivedFps) {
+    /* Don't log every frame */
+    static UA_Logger logger;
+    logger = UA_Log_Stdout_withLevel(UA_LOGLEVEL_WARNING);
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("ethCM"));
+    el = UA_EventLoop_new_POSIX(&logger);
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    TestContext testContext = {0};
+    uintptr_t sendId;
+    openRingConnections(cm, &testContext, ring, &sendId);
+
+    receivedCount = 0;
+    size_t sent = 0;
+    double start = monotonicSeconds();
+    while(sent < ETH_SPEED_FRAMES) {
+        for(size_t i = 0; i < ETH_SPEED_BATCH; i++, sent++) {
+            UA_ByteString snd;
+            UA_StatusCode retval =
+                cm->allocNetworkBuffer(cm, sendId, &snd, strlen(testMsg));
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+            memcpy(snd.data, testMsg, strlen(testMsg));
+            retval = cm->sendWithConnection(cm, sendId, NULL, &snd);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        }
+        el->run(el, 0);
+    }
+    *sentFps = (double)sent / (monotonicSeconds() - start);
+
+    /* Receive the remaining frames */
+    size_t lastCount;
+    do {
+        lastCount = receivedCount;
+        el->run(el, 10);
+    } while(receivedCount != lastCount);
+    *receivedFps = (double)receivedCount / (monotonicSeconds() - start);
+    ck_assert_uint_gt(receivedCount, 0);
+
+    stopEventLoop();
+}
+
+START_TEST(speedETH) {
+    double sentSocket, receivedSocket, sentRing, receivedRing;
+    runSpeed(false, &sentSocket, &receivedSocket);
+    runSpeed(true, &sentRing, &receivedRing);
+    printf("Ethernet frames per second (sent / received): "
+           "socket %.0f / %.0f, packet ring %.0f / %.0f\n",
+           sentSocket, receivedSocket, sentRing, receivedRing);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test ETH EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenETH);
     tcase_add_test(tc, connectETH);
+    tcase_add_test(tc, connectETHRing);
+    tcase_add_test(tc, speedETH);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
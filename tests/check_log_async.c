@@ -0,0 +1,209 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_async.h>
+#include <open62541/plugin/log_stdout.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "check.h"
+
+#if UA_MULTITHREADING >= 100
+#include "thread_wrapper.h"
+#endif
+
+START_TEST(LogAsync_flush) {
+    UA_Logger *logger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, 8);
+    ck_assert_ptr_ne(logger, NULL);
+
+    UA_LOG_INFO(logger, UA_LOGCATEGORY_USERLAND, "Message %i", 1);
+    UA_LOG_WARNING(logger, UA_LOGCATEGORY_SERVER, "Message %i", 2);
+    UA_LOG_ERROR(logger, UA_LOGCATEGORY_CLIENT, "Message %s", "three");
+    UA_LOG_DEBUG(logger, UA_LOGCATEGORY_USERLAND, "Below the minimum level");
+
+    ck_assert_uint_eq(UA_Log_Async_flush(logger), 3);
+    ck_assert_uint_eq(UA_Log_Async_flush(logger), 0);
+    ck_assert_uint_eq(UA_Log_Async_dropped(logger), 0);
+
+    logger->clear(logger);
+} END_TEST
+
+START_TEST(LogAsync_dropWhenFull) {
+    UA_Logger *logger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, 3); /* Rounded to 4 */
+    ck_assert_ptr_ne(logger, NULL);
+
+    for(int i = 0; i < 10; i++)
+        UA_LOG_INFO(logger, UA_LOGCATEGORY_USERLAND, "Message %i", i);
+    ck_assert_uint_eq(UA_Log_Async_dropped(logger), 6);
+    ck_assert_uint_eq(UA_Log_Async_flush(logger), 4);
+
+    /* The ring is free again after the flush */
+    UA_LOG_INFO(logger, UA_LOGCATEGORY_USERLAND, "After the flush");
+    ck_assert_uint_eq(UA_Log_Async_flush(logger), 1);
+    ck_assert_uint_eq(UA_Log_Async_dropped(logger), 6);
+
+    logger->clear(logger);
+} END_TEST
+
+#if UA_MULTITHREADING >= 100
+
+#define LOG_THREADS 4
+#define LOG_THREAD_MESSAGES 100
+
+static UA_Logger *threadLogger;
+
+THREAD_CALLBACK(logThread) {
+    for(int i = 0; i < LOG_THREAD_MESSAGES; i++)
+        UA_LOG_INFO(threadLogger, UA_LOGCATEGORY_USERLAND, "Message %i", i);
+    return 0;
+}
+
+START_TEST(LogAsync_threads) {
+    threadLogger = UA_Log_Async_new(UA_LOGLEVEL_INFO, LOG_THREADS, LOG_THREAD_MESSAGES);
+    ck_assert_ptr_ne(threadLogger, NULL);
+
+    THREAD_HANDLE threads[LOG_THREADS];
+    for(size_t i = 0; i < LOG_THREADS; i++)
+        THREAD_CREATE(threads[i], logThread);
+
+    /* Flush concurrently to the logging threads */
+    size_t written = 0;
+    for(size_t i = 0; i < 100; i++)
+        written += UA_Log_Async_flush(threadLogger);
+
+    for(size_t i = 0; i < LOG_THREADS; i++)
+        THREAD_JOIN(threads[i]);
+    written += UA_Log_Async_flush(threadLogger);
+
+    ck_assert_uint_eq(written, LOG_THREADS * LOG_THREAD_MESSAGES);
+    ck_assert_uint_eq(UA_Log_Async_dropped(threadLogger), 0);
+
+    threadLogger->clear(threadLogger);
+} END_TEST
+
+START_TEST(LogAsync_noFreeRing) {
+    threadLogger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, LOG_THREAD_MESSAGES);
+    ck_assert_ptr_ne(threadLogger, NULL);
+
+    /* The main thread claims the only ring */
+    UA_LOG_INFO(threadLogger, UA_LOGCATEGORY_USERLAND, "Main thread");
+
+    THREAD_HANDLE thread;
+    THREAD_CREATE(thread, logThread);
+    THREAD_JOIN(thread);
+
+    ck_assert_uint_eq(UA_Log_Async_dropped(threadLogger), LOG_THREAD_MESSAGES);
+    ck_assert_uint_eq(UA_Log_Async_flush(threadLogger), 1);
+
+    threadLogger->clear(threadLogger);
+} END_TEST
+
+THREAD_CALLBACK(logThreadRelease) {
+    for(int i = 0; i < LOG_THREAD_MESSAGES; i++)
+        UA_LOG_INFO(threadLogger, UA_LOGCATEGORY_USERLAND, "Message %i", i);
+    UA_Log_Async_releaseThread(threadLogger);
+    return 0;
+}
+
+START_TEST(LogAsync_releaseThread) {
+    threadLogger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, 4 * LOG_THREAD_MESSAGES);
+    ck_assert_ptr_ne(threadLogger, NULL);
+
+    /* The threads run one after the other and share the only ring */
+    for(size_t i = 0; i < 3; i++) {
+        THREAD_HANDLE thread;
+        THREAD_CREATE(thread, logThreadRelease);
+        THREAD_JOIN(thread);
+    }
+    ck_assert_uint_eq(UA_Log_Async_dropped(threadLogger), 0);
+
+    /* The main thread can claim the ring after releasing it */
+    UA_LOG_INFO(threadLogger, UA_LOGCATEGORY_USERLAND, "Main thread");
+    UA_Log_Async_releaseThread(threadLogger);
+    UA_LOG_INFO(threadLogger, UA_LOGCATEGORY_USERLAND, "Main thread again");
+    ck_assert_uint_eq(UA_Log_Async_dropped(threadLogger), 0);
+    ck_assert_uint_eq(UA_Log_Async_flush(threadLogger), 3 * LOG_THREAD_MESSAGES + 2);
+
+    threadLogger->clear(threadLogger);
+} END_TEST
+
+#ifdef UA_ARCHITECTURE_POSIX
+START_TEST(LogAsync_releaseAtThreadExit) {
+    threadLogger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, LOG_THREAD_MESSAGES);
+    ck_assert_ptr_ne(threadLogger, NULL);
+
+    /* The ring of an ended thread is claimed by the next one. The pending
+     * messages of the first thread are flushed in between. */
+    for(size_t i = 0; i < 3; i++) {
+        THREAD_HANDLE thread;
+        THREAD_CREATE(thread, logThread);
+        THREAD_JOIN(thread);
+        ck_assert_uint_eq(UA_Log_Async_flush(threadLogger), LOG_THREAD_MESSAGES);
+    }
+    ck_assert_uint_eq(UA_Log_Async_dropped(threadLogger), 0);
+
+    threadLogger->clear(threadLogger);
+} END_TEST
+#endif
+
+#endif
+
+#define LOG_BENCHMARK_CALLS 4096
+
+static double
+timeLogCalls(const UA_Logger *logger) {
+    clock_t begin = clock();
+    for(int i = 0; i < LOG_BENCHMARK_CALLS; i++)
+        UA_LOG_INFO(logger, UA_LOGCATEGORY_SERVER,
+                    "Processing request %i from channel %u", i, 42);
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+START_TEST(LogAsync_benchmark) {
+    UA_Logger stdoutLogger = UA_Log_Stdout_withLevel(UA_LOGLEVEL_INFO);
+    double stdoutTime = timeLogCalls(&stdoutLogger);
+
+    UA_Logger *logger = UA_Log_Async_new(UA_LOGLEVEL_INFO, 1, LOG_BENCHMARK_CALLS);
+    ck_assert_ptr_ne(logger, NULL);
+    double asyncTime = timeLogCalls(logger);
+    clock_t begin = clock();
+    ck_assert_uint_eq(UA_Log_Async_flush(logger), LOG_BENCHMARK_CALLS);
+    double flushTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    logger->clear(logger);
+
+    printf("Caller-side cost per log call: stdout %f us, async %f us "
+           "(flush %f us per message)\n",
+           stdoutTime * 1e6 / LOG_BENCHMARK_CALLS, asyncTime * 1e6 / LOG_BENCHMARK_CALLS,
+           flushTime * 1e6 / LOG_BENCHMARK_CALLS);
+} END_TEST
+
+static Suite *testSuite_logAsync(void) {
+    Suite *s = suite_create("Async Logger");
+    TCase *tc = tcase_create("Core");
+    tcase_add_test(tc, LogAsync_flush);
+    tcase_add_test(tc, LogAsync_dropWhenFull);
+#if UA_MULTITHREADING >= 100
+    tcase_add_test(tc, LogAsync_threads);
+    tcase_add_test(tc, LogAsync_noFreeRing);
+    tcase_add_test(tc, LogAsync_releaseThread);
+#ifdef UA_ARCHITECTURE_POSIX
+    tcase_add_test(tc, LogAsync_releaseAtThreadExit);
+#endif
+#endif
+    tcase_add_test(tc, LogAsync_benchmark);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_logAsync();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -9,6 +9,8 @@
 #include "util/ua_util_internal.h"
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
 #include <check.h>
 #include <float.h>
 #include <math.h>
@@ -1159,6 +1161,152 @@ START_TEST(UA_ExpandedNodeId_hashIdentical) {
 }
 END_TEST
 
+#define HASH_CORPUS_SIZE 100000
+#define HASH_BUCKETS 256
+
+/* String NodeIds in the style of a generated information model (60-100 bytes) */
+static UA_NodeId *
+hashStringCorpus(void) {
+    UA_NodeId *ids = (UA_NodeId*)UA_Array_new(HASH_CORPUS_SIZE, &UA_TYPES[UA_TYPES_NODEID]);
+    char buf[128];
+    for(size_t i = 0; i < HASH_CORPUS_SIZE; i++) {
+        snprintf(buf, sizeof(buf), "Plant%02u/ProductionArea%02u/Line%03u/Machine%04u/"
+                 "Sensors/Temperature%u/Value",
+                 (unsigned)(i % 3), (unsigned)(i % 17), (unsigned)(i % 101),
+                 (unsigned)(i / 10), (unsigned)(i % 10));
+        ids[i] = UA_NODEID_STRING_ALLOC(2, buf);
+    }
+    return ids;
+}
+
+static int
+cmpUInt32(const void *a, const void *b) {
+    UA_UInt32 x = *(const UA_UInt32*)a;
+    UA_UInt32 y = *(const UA_UInt32*)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+/* Count the collisions and check that the buckets (low and high bits of the
+ * hash) are filled evenly */
+static void
+checkHashDistribution(UA_UInt32 *hashes) {
+    size_t lowBuckets[HASH_BUCKETS] = {0};
+    size_t highBuckets[HASH_BUCKETS] = {0};
+    for(size_t i = 0; i < HASH_CORPUS_SIZE; i++) {
+        lowBuckets[hashes[i] % HASH_BUCKETS]++;
+        highBuckets[hashes[i] >> 24]++;
+    }
+    size_t expected = HASH_CORPUS_SIZE / HASH_BUCKETS;
+    for(size_t i = 0; i < HASH_BUCKETS; i++) {
+        ck_assert_uint_gt(lowBuckets[i], expected * 3 / 4);
+        ck_assert_uint_lt(lowBuckets[i], expected * 5 / 4);
+        ck_assert_uint_gt(highBuckets[i], expected * 3 / 4);
+        ck_assert_uint_lt(highBuckets[i], expected * 5 / 4);
+    }
+
+    /* Expected are ~1.2 collisions for 100k random 32bit values */
+    qsort(hashes, HASH_CORPUS_SIZE, sizeof(UA_UInt32), cmpUInt32);
+    size_t collisions = 0;
+    for(size_t i = 1; i < HASH_CORPUS_SIZE; i++) {
+        if(hashes[i] == hashes[i-1])
+            collisions++;
+    }
+    ck_assert_uint_lt(collisions, 10);
+}
+
+START_TEST(UA_NodeId_hashDistributionNumeric) {
+    UA_UInt32 *hashes = (UA_UInt32*)UA_malloc(HASH_CORPUS_SIZE * sizeof(UA_UInt32));
+    for(size_t i = 0; i < HASH_CORPUS_SIZE; i++) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, 50000 + (UA_UInt32)i);
+        hashes[i] = UA_NodeId_hash(&id);
+    }
+    checkHashDistribution(hashes);
+    UA_free(hashes);
+}
+END_TEST
+
+START_TEST(UA_NodeId_hashDistributionString) {
+    UA_NodeId *ids = hashStringCorpus();
+    UA_UInt32 *hashes = (UA_UInt32*)UA_malloc(HASH_CORPUS_SIZE * sizeof(UA_UInt32));
+    for(size_t i = 0; i < HASH_CORPUS_SIZE; i++)
+        hashes[i] = UA_NodeId_hash(&ids[i]);
+    checkHashDistribution(hashes);
+    UA_free(hashes);
+    UA_Array_delete(ids, HASH_CORPUS_SIZE, &UA_TYPES[UA_TYPES_NODEID]);
+}
+END_TEST
+
+START_TEST(UA_ByteString_hashAllLengths) {
+    /* Every input length takes a different path. Flipping a single bit or
+     * changing the seed or the length changes the hash. */
+    UA_Byte data[200];
+    for(size_t i = 0; i < sizeof(data); i++)
+        data[i] = (UA_Byte)i;
+    for(size_t len = 1; len <= sizeof(data); len++) {
+        UA_UInt32 h = UA_ByteString_hash(0, data, len);
+        ck_assert_uint_eq(h, UA_ByteString_hash(0, data, len));
+        ck_assert_uint_ne(h, UA_ByteString_hash(1, data, len));
+        ck_assert_uint_ne(h, UA_ByteString_hash(0, data, len - 1));
+        for(size_t pos = 0; pos < len; pos++) {
+            data[pos] ^= 0x01;
+            ck_assert_uint_ne(h, UA_ByteString_hash(0, data, len));
+            data[pos] ^= 0x01;
+        }
+    }
+
+    /* A prefix of zeros is not ignored */
+    UA_Byte zeros[4] = {0, 0, 0, 0};
+    ck_assert_uint_ne(UA_ByteString_hash(0, zeros, 1), UA_ByteString_hash(0, zeros, 2));
+    ck_assert_uint_ne(UA_ByteString_hash(0, zeros, 2), UA_ByteString_hash(0, zeros, 3));
+}
+END_TEST
+
+/* The previous sdbm hash as the baseline */
+static UA_UInt32
+sdbmHash(UA_UInt32 h, const UA_Byte *data, size_t size) {
+    for(size_t i = 0; i < size; i++)
+        h = data[i] + (h << 6) + (h << 16) - h;
+    return h;
+}
+
+START_TEST(UA_NodeId_hashBenchmark) {
+    UA_NodeId *ids = hashStringCorpus();
+    volatile UA_UInt32 sink = 0;
+    const size_t rounds = 20;
+
+    clock_t begin = clock();
+    for(size_t r = 0; r < rounds; r++) {
+        for(size_t i = 0; i < HASH_CORPUS_SIZE; i++)
+            sink ^= UA_NodeId_hash(&ids[i]);
+    }
+    double hashTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    begin = clock();
+    for(size_t r = 0; r < rounds; r++) {
+        for(size_t i = 0; i < HASH_CORPUS_SIZE; i++)
+            sink ^= sdbmHash(ids[i].namespaceIndex, ids[i].identifier.string.data,
+                             ids[i].identifier.string.length);
+    }
+    double sdbmTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    begin = clock();
+    for(size_t r = 0; r < rounds; r++) {
+        for(size_t i = 0; i < HASH_CORPUS_SIZE; i++) {
+            UA_NodeId id = UA_NODEID_NUMERIC(1, (UA_UInt32)i);
+            sink ^= UA_NodeId_hash(&id);
+        }
+    }
+    double numericTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    size_t n = rounds * HASH_CORPUS_SIZE;
+    printf("NodeId hash per id: string %f ns (sdbm %f ns), numeric %f ns\n",
+           hashTime * 1e9 / (double)n, sdbmTime * 1e9 / (double)n,
+           numericTime * 1e9 / (double)n);
+    (void)sink;
+    UA_Array_delete(ids, HASH_CORPUS_SIZE, &UA_TYPES[UA_TYPES_NODEID]);
+}
+END_TEST
+
 START_TEST(UA_ExtensionObject_copyShallWorkOnExample) {
     // given
     /* UA_Byte data[3] = { 1, 2, 3 }; */
@@ -1823,6 +1971,10 @@ static Suite *testSuite_builtin(void) {
 
     TCase *tc_hash = tcase_create("hash");
     tcase_add_test(tc_hash, UA_ExpandedNodeId_hashIdentical);
+    tcase_add_test(tc_hash, UA_NodeId_hashDistributionNumeric);
+    tcase_add_test(tc_hash, UA_NodeId_hashDistributionString);
+    tcase_add_test(tc_hash, UA_ByteString_hashAllLengths);
+    tcase_add_test(tc_hash, UA_NodeId_hashBenchmark);
     suite_add_tcase(s, tc_hash);
 
     TCase *tc_copy = tcase_create("copy");
@@ -14,6 +14,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #if defined(_MSC_VER)
 # pragma warning(disable: 4146)
@@ -5237,6 +5238,95 @@ START_TEST(UA_DataTypeAttributes_json_decode) {
 }
 END_TEST
 
+START_TEST(UA_ServerDiagnosticsSummary_unorderedKeys_json_decode) {
+    /* Wide structure with keys in reverse order uses the sorted field names */
+    UA_ByteString buf = UA_STRING("{\"RejectedRequestsCount\":12,"
+            "\"SecurityRejectedRequestsCount\":11,"
+            "\"PublishingIntervalCount\":10,"
+            "\"CumulatedSubscriptionCount\":9,"
+            "\"CurrentSubscriptionCount\":8,"
+            "\"SessionAbortCount\":7,"
+            "\"SessionTimeoutCount\":6,"
+            "\"RejectedSessionCount\":5,"
+            "\"SecurityRejectedSessionCount\":4,"
+            "\"CumulatedSessionCount\":3,"
+            "\"CurrentSessionCount\":2,"
+            "\"ServerViewCount\":1}");
+    UA_ServerDiagnosticsSummaryDataType out;
+    UA_StatusCode retval =
+        UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(out.serverViewCount, 1);
+    ck_assert_uint_eq(out.currentSessionCount, 2);
+    ck_assert_uint_eq(out.cumulatedSessionCount, 3);
+    ck_assert_uint_eq(out.securityRejectedSessionCount, 4);
+    ck_assert_uint_eq(out.rejectedSessionCount, 5);
+    ck_assert_uint_eq(out.sessionTimeoutCount, 6);
+    ck_assert_uint_eq(out.sessionAbortCount, 7);
+    ck_assert_uint_eq(out.currentSubscriptionCount, 8);
+    ck_assert_uint_eq(out.cumulatedSubscriptionCount, 9);
+    ck_assert_uint_eq(out.publishingIntervalCount, 10);
+    ck_assert_uint_eq(out.securityRejectedRequestsCount, 11);
+    ck_assert_uint_eq(out.rejectedRequestsCount, 12);
+
+    /* Duplicate key */
+    buf = UA_STRING("{\"RejectedRequestsCount\":12,\"ServerViewCount\":1,"
+                    "\"RejectedRequestsCount\":13}");
+    retval = UA_decodeJson(&buf, &out,
+                           &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+
+    /* Unknown key and a prefix of a known key */
+    buf = UA_STRING("{\"RejectedRequestsCount\":12,\"ServerView\":1}");
+    retval = UA_decodeJson(&buf, &out,
+                           &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+    buf = UA_STRING("{\"RejectedRequestsCount\":12,\"ServerViewCountX\":1}");
+    retval = UA_decodeJson(&buf, &out,
+                           &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+
+    /* Keys with an embedded NUL byte (raw and escaped) do not match the field
+     * name before the NUL */
+    const char rawNul[] = "{\"ServerViewCount\0xyz\":1,\"RejectedRequestsCount\":12}";
+    buf.data = (UA_Byte*)(uintptr_t)rawNul;
+    buf.length = sizeof(rawNul) - 1;
+    retval = UA_decodeJson(&buf, &out,
+                           &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+    buf = UA_STRING("{\"ServerViewCount\\u0000xyz\":1,\"RejectedRequestsCount\":12}");
+    retval = UA_decodeJson(&buf, &out,
+                           &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+}
+END_TEST
+
+#define LARGE_ARRAY_SIZE 100000
+
+START_TEST(UA_Variant_largeArray_json_decode) {
+    /* Needs many more tokens than UA_JSON_MAXTOKENCOUNT */
+    UA_UInt32 *arr = (UA_UInt32*)
+        UA_Array_new(LARGE_ARRAY_SIZE, &UA_TYPES[UA_TYPES_UINT32]);
+    for(size_t i = 0; i < LARGE_ARRAY_SIZE; i++)
+        arr[i] = (UA_UInt32)i;
+    UA_Variant v;
+    UA_Variant_setArray(&v, arr, LARGE_ARRAY_SIZE, &UA_TYPES[UA_TYPES_UINT32]);
+
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeJson(&v, &UA_TYPES[UA_TYPES_VARIANT], &buf, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Variant out;
+    retval = UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_VARIANT], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(&v, &out, &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+
+    UA_Variant_clear(&out);
+    UA_Variant_clear(&v);
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
 //-------------------MISC heap free test cases--------------------------
 START_TEST(UA_VariantStringArrayBad_shouldFreeArray_json_decode) {
     // given
@@ -5407,6 +5497,258 @@ START_TEST(UA_Boolean_true_public_json_encode) {
 }
 END_TEST
 
+START_TEST(UA_String_escapeLong_json_encode) {
+    /* Escapes at different positions inside and between the eight-byte words
+     * of the fast scan */
+    UA_String src = UA_STRING("abcdefgh\"ijklmnopqrstuvw\x7f" "0123456789\\"
+                              "ABCDEFGHIJKLMNOPQRSTUVWXYZ\x01");
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    status s = UA_encodeJson(&src, &UA_TYPES[UA_TYPES_STRING], &buf, NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+
+    const char *result = "\"abcdefgh\\\"ijklmnopqrstuvw\\u007f0123456789\\\\"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ\\u0001\"";
+    ck_assert_uint_eq(buf.length, strlen(result));
+    ck_assert(memcmp(buf.data, result, buf.length) == 0);
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
+typedef struct {
+    UA_ByteString out;
+    size_t chunks;
+    UA_StatusCode res;
+} StreamResult;
+
+static UA_StatusCode
+appendChunk(void *context, const UA_ByteString *chunk) {
+    StreamResult *sr = (StreamResult*)context;
+    ck_assert_uint_gt(chunk->length, 0);
+    UA_Byte *data = (UA_Byte*)UA_realloc(sr->out.data, sr->out.length + chunk->length);
+    ck_assert_ptr_ne(data, NULL);
+    memcpy(&data[sr->out.length], chunk->data, chunk->length);
+    sr->out.data = data;
+    sr->out.length += chunk->length;
+    sr->chunks++;
+    return sr->res;
+}
+
+/* A DataValue with strings, numbers, a structure array and a nested Variant */
+static void
+setupStreamValue(UA_DataValue *dv, UA_Variant *inner, UA_ReadValueId *rv) {
+    UA_DataValue_init(dv);
+    for(size_t i = 0; i < 3; i++) {
+        UA_ReadValueId_init(&rv[i]);
+        rv[i].nodeId = UA_NODEID_STRING(1, "Some \"quoted\" node");
+        rv[i].attributeId = (UA_UInt32)i + 13;
+        rv[i].dataEncoding = UA_QUALIFIEDNAME(0, "Default JSON");
+    }
+    UA_Variant_setArray(inner, rv, 3, &UA_TYPES[UA_TYPES_READVALUEID]);
+    UA_Variant_setScalar(&dv->value, inner, &UA_TYPES[UA_TYPES_VARIANT]);
+    dv->hasValue = true;
+    dv->status = UA_STATUSCODE_BADINTERNALERROR;
+    dv->hasStatus = true;
+    dv->sourceTimestamp = UA_DateTime_fromUnixTime(1700000000);
+    dv->hasSourceTimestamp = true;
+}
+
+START_TEST(UA_encodeJsonStream_chunks) {
+    UA_DataValue dv;
+    UA_Variant inner;
+    UA_ReadValueId rv[3];
+    setupStreamValue(&dv, &inner, rv);
+
+    UA_EncodeJsonOptions options;
+    memset(&options, 0, sizeof(UA_EncodeJsonOptions));
+
+    UA_Byte mem[64];
+    const size_t bufSizes[4] = {1, 7, 32, 64};
+    for(size_t pretty = 0; pretty < 2; pretty++) {
+        options.prettyPrint = (pretty == 1);
+        UA_ByteString expected = UA_BYTESTRING_NULL;
+        status s = UA_encodeJson(&dv, &UA_TYPES[UA_TYPES_DATAVALUE],
+                                 &expected, &options);
+        ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+
+        for(size_t i = 0; i < 4; i++) {
+            StreamResult sr;
+            memset(&sr, 0, sizeof(StreamResult));
+            UA_ByteString buf = {bufSizes[i], mem};
+            s = UA_encodeJsonStream(&dv, &UA_TYPES[UA_TYPES_DATAVALUE], &buf,
+                                    appendChunk, &sr, &options);
+            ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+            ck_assert(UA_ByteString_equal(&sr.out, &expected));
+            ck_assert_uint_eq(sr.chunks, (expected.length + bufSizes[i] - 1) / bufSizes[i]);
+            UA_ByteString_clear(&sr.out);
+        }
+        UA_ByteString_clear(&expected);
+    }
+}
+END_TEST
+
+START_TEST(UA_encodeJsonStream_flushError) {
+    UA_DataValue dv;
+    UA_Variant inner;
+    UA_ReadValueId rv[3];
+    setupStreamValue(&dv, &inner, rv);
+
+    StreamResult sr;
+    memset(&sr, 0, sizeof(StreamResult));
+    sr.res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+    UA_Byte mem[16];
+    UA_ByteString buf = {sizeof(mem), mem};
+    status s = UA_encodeJsonStream(&dv, &UA_TYPES[UA_TYPES_DATAVALUE], &buf,
+                                   appendChunk, &sr, NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_BADCONNECTIONCLOSED);
+    ck_assert_uint_eq(sr.chunks, 1);
+    UA_ByteString_clear(&sr.out);
+
+    /* No buffer to stream into */
+    UA_ByteString empty = UA_BYTESTRING_NULL;
+    s = UA_encodeJsonStream(&dv, &UA_TYPES[UA_TYPES_DATAVALUE], &empty,
+                            appendChunk, &sr, NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_BADINTERNALERROR);
+}
+END_TEST
+
+static UA_StatusCode
+countChunk(void *context, const UA_ByteString *chunk) {
+    *(size_t*)context += chunk->length;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Encode with the calcSize pre-pass and with streaming into a bounded buffer.
+ * Print the throughput of both. */
+static void
+benchmarkEncode(const char *name, const void *src, const UA_DataType *type,
+                size_t iterations) {
+    size_t total = 0;
+    clock_t begin = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        UA_ByteString out = UA_BYTESTRING_NULL;
+        status s = UA_encodeJson(src, type, &out, NULL);
+        ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+        total += out.length;
+        UA_ByteString_clear(&out);
+    }
+    double allocTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    size_t streamed = 0;
+    UA_Byte mem[4096];
+    UA_ByteString buf = {sizeof(mem), mem};
+    begin = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        status s = UA_encodeJsonStream(src, type, &buf, countChunk, &streamed, NULL);
+        ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+    }
+    double streamTime = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    ck_assert_uint_eq(streamed, total);
+
+    double mb = (double)total / (1024.0 * 1024.0);
+    printf("%s: %lu bytes, calcSize+encode %.1f MB/s, stream %.1f MB/s\n", name,
+           (unsigned long)(total / iterations),
+           allocTime > 0 ? mb / allocTime : 0.0,
+           streamTime > 0 ? mb / streamTime : 0.0);
+}
+
+#define BENCH_ARRAY_SIZE 10000
+#define BENCH_NESTING 40
+
+START_TEST(UA_Variant_largeArray_json_benchmark) {
+    UA_Variant v;
+    UA_Variant *arr = (UA_Variant*)
+        UA_Array_new(BENCH_ARRAY_SIZE, &UA_TYPES[UA_TYPES_VARIANT]);
+    ck_assert_ptr_ne(arr, NULL);
+    for(size_t i = 0; i < BENCH_ARRAY_SIZE; i++) {
+        if(i % 2 == 0) {
+            UA_Double d = (UA_Double)i * 1.25;
+            UA_Variant_setScalarCopy(&arr[i], &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        } else {
+            UA_String s = UA_STRING("A string value that needs no escaping at all");
+            UA_Variant_setScalarCopy(&arr[i], &s, &UA_TYPES[UA_TYPES_STRING]);
+        }
+    }
+    UA_Variant_setArray(&v, arr, BENCH_ARRAY_SIZE, &UA_TYPES[UA_TYPES_VARIANT]);
+    benchmarkEncode("Variant array", &v, &UA_TYPES[UA_TYPES_VARIANT], 20);
+    UA_Variant_clear(&v);
+}
+END_TEST
+
+START_TEST(UA_ExtensionObject_deep_json_benchmark) {
+    /* Nested LiteralOperands. Every level is wrapped in an ExtensionObject
+     * inside the Variant of the parent. */
+    UA_LiteralOperand lo[BENCH_NESTING];
+    UA_Double d = 42.0;
+    UA_Variant_setScalar(&lo[BENCH_NESTING - 1].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+    for(size_t i = 0; i < BENCH_NESTING - 1; i++)
+        UA_Variant_setScalar(&lo[i].value, &lo[i + 1],
+                             &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_setValue(&eo, &lo[0], &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+    benchmarkEncode("Deep ExtensionObject", &eo,
+                    &UA_TYPES[UA_TYPES_EXTENSIONOBJECT], 5000);
+}
+END_TEST
+
+/* Decode the JSON encoding of src and print the throughput */
+static void
+benchmarkDecode(const char *name, const UA_ByteString *json,
+                const UA_DataType *type, size_t iterations) {
+    UA_STACKARRAY(UA_Byte, dst, type->memSize);
+    clock_t begin = clock();
+    for(size_t i = 0; i < iterations; i++) {
+        status s = UA_decodeJson(json, dst, type, NULL);
+        ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+        UA_clear(dst, type);
+    }
+    double time = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    double mb = (double)(json->length * iterations) / (1024.0 * 1024.0);
+    printf("%s: %lu bytes, decode %.1f MB/s\n", name,
+           (unsigned long)json->length, time > 0 ? mb / time : 0.0);
+}
+
+START_TEST(UA_Variant_largeArray_json_decode_benchmark) {
+    UA_Variant v;
+    UA_Variant *arr = (UA_Variant*)
+        UA_Array_new(BENCH_ARRAY_SIZE, &UA_TYPES[UA_TYPES_VARIANT]);
+    ck_assert_ptr_ne(arr, NULL);
+    for(size_t i = 0; i < BENCH_ARRAY_SIZE; i++) {
+        UA_Double d = (UA_Double)i * 1.25;
+        UA_Variant_setScalarCopy(&arr[i], &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+    }
+    UA_Variant_setArray(&v, arr, BENCH_ARRAY_SIZE, &UA_TYPES[UA_TYPES_VARIANT]);
+    UA_ByteString json = UA_BYTESTRING_NULL;
+    status s = UA_encodeJson(&v, &UA_TYPES[UA_TYPES_VARIANT], &json, NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+    benchmarkDecode("Variant array", &json, &UA_TYPES[UA_TYPES_VARIANT], 20);
+    UA_ByteString_clear(&json);
+    UA_Variant_clear(&v);
+}
+END_TEST
+
+START_TEST(UA_Structure_unorderedKeys_json_decode_benchmark) {
+    /* A wide structure with keys in member order and in reverse order */
+    UA_ByteString ordered = UA_STRING("{\"ServerViewCount\":1,"
+        "\"CurrentSessionCount\":2,\"CumulatedSessionCount\":3,"
+        "\"SecurityRejectedSessionCount\":4,\"RejectedSessionCount\":5,"
+        "\"SessionTimeoutCount\":6,\"SessionAbortCount\":7,"
+        "\"CurrentSubscriptionCount\":8,\"CumulatedSubscriptionCount\":9,"
+        "\"PublishingIntervalCount\":10,\"SecurityRejectedRequestsCount\":11,"
+        "\"RejectedRequestsCount\":12}");
+    UA_ByteString reversed = UA_STRING("{\"RejectedRequestsCount\":12,"
+        "\"SecurityRejectedRequestsCount\":11,\"PublishingIntervalCount\":10,"
+        "\"CumulatedSubscriptionCount\":9,\"CurrentSubscriptionCount\":8,"
+        "\"SessionAbortCount\":7,\"SessionTimeoutCount\":6,"
+        "\"RejectedSessionCount\":5,\"SecurityRejectedSessionCount\":4,"
+        "\"CumulatedSessionCount\":3,\"CurrentSessionCount\":2,"
+        "\"ServerViewCount\":1}");
+    const UA_DataType *type = &UA_TYPES[UA_TYPES_SERVERDIAGNOSTICSSUMMARYDATATYPE];
+    benchmarkDecode("Ordered structure keys", &ordered, type, 100000);
+    benchmarkDecode("Reversed structure keys", &reversed, type, 100000);
+}
+END_TEST
+
 static Suite *testSuite_builtin_json(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Json");
 
@@ -5594,8 +5936,19 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_json_encode, UA_WriteRequest_json_encode);
     tcase_add_test(tc_json_encode, UA_VariableAttributes_json_encode);
 
+    tcase_add_test(tc_json_encode, UA_String_escapeLong_json_encode);
+    tcase_add_test(tc_json_encode, UA_encodeJsonStream_chunks);
+    tcase_add_test(tc_json_encode, UA_encodeJsonStream_flushError);
+
     suite_add_tcase(s, tc_json_encode);
 
+    TCase *tc_json_benchmark = tcase_create("json_benchmark");
+    tcase_add_test(tc_json_benchmark, UA_Variant_largeArray_json_benchmark);
+    tcase_add_test(tc_json_benchmark, UA_ExtensionObject_deep_json_benchmark);
+    tcase_add_test(tc_json_benchmark, UA_Variant_largeArray_json_decode_benchmark);
+    tcase_add_test(tc_json_benchmark, UA_Structure_unorderedKeys_json_decode_benchmark);
+    suite_add_tcase(s, tc_json_benchmark);
+
     TCase *tc_json_decode = tcase_create("json_decode");
 
 
@@ -5742,6 +6095,8 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_json_decode, UA_wrongBoolean_json_decode);
     tcase_add_test(tc_json_decode, UA_ViewDescription_json_decode);
     tcase_add_test(tc_json_decode, UA_DataTypeAttributes_json_decode);
+    tcase_add_test(tc_json_decode, UA_ServerDiagnosticsSummary_unorderedKeys_json_decode);
+    tcase_add_test(tc_json_decode, UA_Variant_largeArray_json_decode);
     tcase_add_test(tc_json_decode, UA_VariantStringArrayBad_shouldFreeArray_json_decode);
     tcase_add_test(tc_json_decode, UA_VariantFuzzer1_json_decode);
     tcase_add_test(tc_json_decode, UA_VariantFuzzer2_json_decode);
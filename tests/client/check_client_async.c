@@ -13,6 +13,7 @@
 #include <check.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "test_helpers.h"
 #include "testing_clock.h"
@@ -279,6 +280,65 @@ START_TEST(Client_connectivity_check) {
         UA_Client_delete(client);
 }END_TEST
 
+static void
+benchmarkReadCallback(UA_Client *client, void *userdata,
+                      UA_UInt32 requestId, const UA_ReadResponse *response) {
+    size_t *received = (size_t*)userdata;
+    ck_assert_uint_eq(response->responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    (*received)++;
+}
+
+#define BENCHMARK_REQUESTS 10000
+
+/* Keep up to maxInFlight requests outstanding until all are answered */
+static void
+benchmarkInFlight(UA_Client *client, size_t maxInFlight) {
+    UA_ReadValueId rvid;
+    UA_ReadValueId_init(&rvid);
+    rvid.attributeId = UA_ATTRIBUTEID_VALUE;
+    rvid.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE);
+    UA_ReadRequest rr;
+    UA_ReadRequest_init(&rr);
+    rr.nodesToRead = &rvid;
+    rr.nodesToReadSize = 1;
+
+    size_t sent = 0;
+    size_t received = 0;
+    clock_t begin = clock();
+    while(received < BENCHMARK_REQUESTS) {
+        for(; sent < BENCHMARK_REQUESTS && sent - received < maxInFlight; sent++) {
+            UA_StatusCode retval =
+                __UA_Client_AsyncService(client, &rr, &UA_TYPES[UA_TYPES_READREQUEST],
+                                         (UA_ClientAsyncServiceCallback)benchmarkReadCallback,
+                                         &UA_TYPES[UA_TYPES_READRESPONSE], &received, NULL);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        }
+        UA_StatusCode retval = UA_Client_run_iterate(client, 10);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    printf("%u requests with max. %u in flight: %f requests/s (process cpu time)\n",
+           (unsigned)BENCHMARK_REQUESTS, (unsigned)maxInFlight,
+           (double)BENCHMARK_REQUESTS / elapsed);
+}
+
+START_TEST(Client_async_benchmark) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    clientConfig->outStandingPublishRequests = 0;
+#endif
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    benchmarkInFlight(client, 1);
+    benchmarkInFlight(client, 100);
+    benchmarkInFlight(client, BENCHMARK_REQUESTS);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
 static Suite* testSuite_Client(void) {
     Suite *s = suite_create("Client");
     TCase *tc_client = tcase_create("Client Basic");
@@ -288,6 +348,7 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_client, Client_read_async_timed);
     tcase_add_test(tc_client, Client_connectivity_check);
     tcase_add_test(tc_client, Client_highlevel_async_readValue);
+    tcase_add_test(tc_client, Client_async_benchmark);
 
     suite_add_tcase(s, tc_client);
     return s;
@@ -346,6 +346,106 @@ START_TEST(Node_Register) {
 }
 END_TEST
 
+#ifdef UA_ENABLE_NODEMANAGEMENT
+/* The aliases handed out by RegisterNodes are valid in all services that take
+ * NodeIds, not only Read and Write */
+START_TEST(Node_RegisterAliasInServices) {
+    UA_NodeId folderId = UA_NODEID_STRING(2, "RegisteredFolder");
+    UA_NodeId childId = UA_NODEID_STRING(2, "RegisteredChild");
+
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    UA_StatusCode retval =
+        UA_Client_addObjectNode(client, folderId,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(2, "RegisteredFolder"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE),
+                                oAttr, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    UA_Int32 value = 42;
+    UA_Variant_setScalar(&vAttr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    retval = UA_Client_addVariableNode(client, childId, folderId,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                       UA_QUALIFIEDNAME(2, "RegisteredChild"),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                       vAttr, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Register both nodes */
+    UA_NodeId toRegister[2] = {folderId, childId};
+    UA_RegisterNodesRequest req;
+    UA_RegisterNodesRequest_init(&req);
+    req.nodesToRegister = toRegister;
+    req.nodesToRegisterSize = 2;
+    UA_RegisterNodesResponse res = UA_Client_Service_registerNodes(client, req);
+    ck_assert_uint_eq(res.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(res.registeredNodeIdsSize, 2);
+    UA_NodeId folderAlias = res.registeredNodeIds[0];
+    UA_NodeId childAlias = res.registeredNodeIds[1];
+    ck_assert(!UA_NodeId_equal(&folderAlias, &folderId));
+    ck_assert(!UA_NodeId_equal(&childAlias, &childId));
+
+    /* TranslateBrowsePathsToNodeIds from the alias */
+    UA_RelativePathElement rpe;
+    UA_RelativePathElement_init(&rpe);
+    rpe.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    rpe.includeSubtypes = true;
+    rpe.targetName = UA_QUALIFIEDNAME(2, "RegisteredChild");
+    UA_BrowsePath bp;
+    UA_BrowsePath_init(&bp);
+    bp.startingNode = folderAlias;
+    bp.relativePath.elements = &rpe;
+    bp.relativePath.elementsSize = 1;
+    UA_TranslateBrowsePathsToNodeIdsRequest tReq;
+    UA_TranslateBrowsePathsToNodeIdsRequest_init(&tReq);
+    tReq.browsePaths = &bp;
+    tReq.browsePathsSize = 1;
+    UA_TranslateBrowsePathsToNodeIdsResponse tRes =
+        UA_Client_Service_translateBrowsePathsToNodeIds(client, tReq);
+    ck_assert_uint_eq(tRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(tRes.resultsSize, 1);
+    ck_assert_uint_eq(tRes.results[0].statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(tRes.results[0].targetsSize, 1);
+    ck_assert(UA_NodeId_equal(&tRes.results[0].targets[0].targetId.nodeId, &childId));
+    UA_TranslateBrowsePathsToNodeIdsResponse_clear(&tRes);
+
+    /* AddReferences and DeleteReferences between two aliases */
+    UA_ExpandedNodeId childAliasExp = UA_EXPANDEDNODEID_NUMERIC(0, 0);
+    childAliasExp.nodeId = childAlias;
+    retval = UA_Client_addReference(client, folderAlias,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), true,
+                                    UA_STRING_NULL, childAliasExp,
+                                    UA_NODECLASS_VARIABLE);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Client_deleteReference(client, folderAlias,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                       true, childAliasExp, true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* DeleteNodes through the alias removes the canonical node */
+    retval = UA_Client_deleteNode(client, childAlias, true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeClass nc = UA_NODECLASS_UNSPECIFIED;
+    retval = UA_Client_readNodeClassAttribute(client, childId, &nc);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNODEIDUNKNOWN);
+
+    retval = UA_Client_deleteNode(client, folderAlias, true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_UnregisterNodesRequest reqUn;
+    UA_UnregisterNodesRequest_init(&reqUn);
+    reqUn.nodesToUnregister = res.registeredNodeIds;
+    reqUn.nodesToUnregisterSize = res.registeredNodeIdsSize;
+    UA_UnregisterNodesResponse resUn = UA_Client_Service_unregisterNodes(client, reqUn);
+    ck_assert_uint_eq(resUn.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_UnregisterNodesResponse_clear(&resUn);
+    UA_RegisterNodesResponse_clear(&res);
+}
+END_TEST
+#endif
+
 
 
 // NodeIds for ReadWrite testing
@@ -1049,6 +1149,9 @@ static Suite *testSuite_Client(void) {
 #endif
     tcase_add_test(tc_nodes, Node_Browse);
     tcase_add_test(tc_nodes, Node_Register);
+#ifdef UA_ENABLE_NODEMANAGEMENT
+    tcase_add_test(tc_nodes, Node_RegisterAliasInServices);
+#endif
     suite_add_tcase(s, tc_nodes);
 
 #ifdef UA_ENABLE_NODEMANAGEMENT
@@ -468,6 +468,42 @@ START_TEST(Client_HistorizingUpdateRawSuccess)
 }
 END_TEST
 
+START_TEST(Client_HistorizingRegisteredNodeId)
+{
+    /* HistoryRead and HistoryUpdate accept the alias from RegisterNodes */
+    UA_RegisterNodesRequest req;
+    UA_RegisterNodesRequest_init(&req);
+    req.nodesToRegister = &outNodeId;
+    req.nodesToRegisterSize = 1;
+    UA_RegisterNodesResponse res = UA_Client_Service_registerNodes(client, req);
+    ck_assert_uint_eq(res.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(res.registeredNodeIdsSize, 1);
+    ck_assert(!UA_NodeId_equal(&res.registeredNodeIds[0], &outNodeId));
+
+    UA_StatusCode ret = UA_Client_HistoryRead_raw(client,
+                                                  &res.registeredNodeIds[0],
+                                                  receiveCallback,
+                                                  TESTDATA_START_TIME,
+                                                  TESTDATA_STOP_TIME,
+                                                  UA_STRING_NULL,
+                                                  false,
+                                                  100,
+                                                  UA_TIMESTAMPSTORETURN_BOTH,
+                                                  (void*)false);
+    ck_assert_str_eq(UA_StatusCode_name(ret), UA_StatusCode_name(UA_STATUSCODE_GOOD));
+    ck_assert_uint_eq(testDataSize, receivedTestDataPos);
+    ck_assert(checkTestData(false, testData, receivedTestData, testDataSize));
+
+    UA_DataValue value;
+    fillInt64DataValue(testReplaceDataSuccess[0], 0, &value);
+    ret = UA_Client_HistoryUpdate_replace(client, &res.registeredNodeIds[0], &value);
+    ck_assert_str_eq(UA_StatusCode_name(ret), UA_StatusCode_name(UA_STATUSCODE_GOOD));
+    UA_DataValue_clear(&value);
+
+    UA_RegisterNodesResponse_clear(&res);
+}
+END_TEST
+
 START_TEST(Client_HistorizingDeleteRaw)
 {
     for (size_t i = 0; i < testDeleteRangeDataSize; ++i) {
@@ -628,6 +664,7 @@ testSuite_Client(void) {
     tcase_add_test(tc_client, Client_HistorizingInsertRawSuccess);
     tcase_add_test(tc_client, Client_HistorizingReplaceRawSuccess);
     tcase_add_test(tc_client, Client_HistorizingUpdateRawSuccess);
+    tcase_add_test(tc_client, Client_HistorizingRegisteredNodeId);
     tcase_add_test(tc_client, Client_HistorizingDeleteRaw);
     tcase_add_test(tc_client, Client_HistorizingInsertRawFail);
     tcase_add_test(tc_client, Client_HistorizingReplaceRawFail);
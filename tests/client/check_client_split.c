@@ -0,0 +1,533 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/client.h>
+#include <open62541/client_config_default.h>
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef UA_ARCHITECTURE_POSIX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "test_helpers.h"
+#include "thread_wrapper.h"
+
+#define VARIABLES 1000
+#define VARIABLES_START 10000
+
+UA_Server *server;
+UA_Boolean running;
+THREAD_HANDLE server_thread;
+
+THREAD_CALLBACK(serverloop) {
+    while(running)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+static UA_StatusCode
+echoMethod(UA_Server *s, const UA_NodeId *sessionId, void *sessionHandle,
+           const UA_NodeId *methodId, void *methodContext,
+           const UA_NodeId *objectId, void *objectContext,
+           size_t inputSize, const UA_Variant *input,
+           size_t outputSize, UA_Variant *output) {
+    return UA_Variant_copy(input, output);
+}
+
+static void setup(void) {
+    running = true;
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    /* Small limits to force the splitting */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->maxNodesPerRead = 100;
+    config->maxNodesPerWrite = 100;
+    config->maxNodesPerMethodCall = 5;
+    config->maxNodesPerBrowse = 10;
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.accessLevel |= UA_ACCESSLEVELMASK_WRITE;
+    for(UA_Int32 i = 0; i < VARIABLES; i++) {
+        UA_Variant_setScalar(&attr.value, &i, &UA_TYPES[UA_TYPES_INT32]);
+        UA_StatusCode res =
+            UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, VARIABLES_START + (UA_UInt32)i),
+                                      UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "Variable"),
+                                      UA_NS0ID(BASEDATAVARIABLETYPE), attr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    UA_Argument arg;
+    UA_Argument_init(&arg);
+    arg.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    arg.valueRank = UA_VALUERANK_SCALAR;
+    UA_MethodAttributes methodAttr = UA_MethodAttributes_default;
+    methodAttr.executable = true;
+    methodAttr.userExecutable = true;
+    UA_StatusCode res =
+        UA_Server_addMethodNode(server, UA_NODEID_STRING(1, "echo"),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(HASCOMPONENT),
+                                UA_QUALIFIEDNAME(1, "echo"), methodAttr, echoMethod,
+                                1, &arg, 1, &arg, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Server_run_startup(server);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+static void teardown(void) {
+    running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+static UA_Client *
+newClientUrl(UA_Boolean splitRequests, UA_UInt16 window, const char *url) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_ClientConfig *cc = UA_Client_getConfig(client);
+    cc->splitRequests = splitRequests;
+    cc->splitRequestsWindow = window;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    cc->outStandingPublishRequests = 0;
+#endif
+    UA_StatusCode res = UA_Client_connect(client, url);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return client;
+}
+
+static UA_Client *
+newClient(UA_Boolean splitRequests, UA_UInt16 window) {
+    return newClientUrl(splitRequests, window, "opc.tcp://localhost:4840");
+}
+
+static void
+initReadRequest(UA_ReadRequest *request, UA_ReadValueId *rvid, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        UA_ReadValueId_init(&rvid[i]);
+        rvid[i].nodeId = UA_NODEID_NUMERIC(1, VARIABLES_START + (UA_UInt32)i);
+        rvid[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest_init(request);
+    request->nodesToRead = rvid;
+    request->nodesToReadSize = size;
+}
+
+static void
+checkReadResponse(UA_ReadResponse *response, UA_Int32 factor) {
+    ck_assert_uint_eq(response->responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response->resultsSize, VARIABLES);
+    for(size_t i = 0; i < VARIABLES; i++) {
+        ck_assert(response->results[i].hasValue);
+        ck_assert(UA_Variant_hasScalarType(&response->results[i].value,
+                                           &UA_TYPES[UA_TYPES_INT32]));
+        ck_assert_int_eq(*(UA_Int32*)response->results[i].value.data,
+                         (UA_Int32)i * factor);
+    }
+}
+
+START_TEST(Client_split_read) {
+    UA_ReadValueId rvid[VARIABLES];
+    UA_ReadRequest request;
+    initReadRequest(&request, rvid, VARIABLES);
+
+    /* Rejected by the server without splitting */
+    UA_Client *client = newClient(false, 0);
+    UA_ReadResponse response = UA_Client_Service_read(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult,
+                      UA_STATUSCODE_BADTOOMANYOPERATIONS);
+    UA_ReadResponse_clear(&response);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    /* Split into ten requests. The results are in order. */
+    client = newClient(true, 4);
+    response = UA_Client_Service_read(client, request);
+    checkReadResponse(&response, 1);
+    UA_ReadResponse_clear(&response);
+
+    /* Small requests are sent as-is */
+    request.nodesToReadSize = 3;
+    response = UA_Client_Service_read(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 3);
+    UA_ReadResponse_clear(&response);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+START_TEST(Client_split_write) {
+    UA_Client *client = newClient(true, 3);
+
+    UA_Int32 values[VARIABLES];
+    UA_WriteValue wv[VARIABLES];
+    for(size_t i = 0; i < VARIABLES; i++) {
+        values[i] = (UA_Int32)i * 2;
+        UA_WriteValue_init(&wv[i]);
+        wv[i].nodeId = UA_NODEID_NUMERIC(1, VARIABLES_START + (UA_UInt32)i);
+        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        wv[i].value.hasValue = true;
+        UA_Variant_setScalar(&wv[i].value.value, &values[i], &UA_TYPES[UA_TYPES_INT32]);
+    }
+    UA_WriteRequest request;
+    UA_WriteRequest_init(&request);
+    request.nodesToWrite = wv;
+    request.nodesToWriteSize = VARIABLES;
+    UA_WriteResponse response = UA_Client_Service_write(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, VARIABLES);
+    for(size_t i = 0; i < VARIABLES; i++)
+        ck_assert_uint_eq(response.results[i], UA_STATUSCODE_GOOD);
+    UA_WriteResponse_clear(&response);
+
+    UA_ReadValueId rvid[VARIABLES];
+    UA_ReadRequest readRequest;
+    initReadRequest(&readRequest, rvid, VARIABLES);
+    UA_ReadResponse readResponse = UA_Client_Service_read(client, readRequest);
+    checkReadResponse(&readResponse, 2);
+    UA_ReadResponse_clear(&readResponse);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+START_TEST(Client_split_call) {
+    UA_Client *client = newClient(true, 2);
+
+    UA_Int32 inputs[23];
+    UA_CallMethodRequest cmr[23];
+    for(size_t i = 0; i < 23; i++) {
+        inputs[i] = (UA_Int32)i;
+        UA_CallMethodRequest_init(&cmr[i]);
+        cmr[i].objectId = UA_NS0ID(OBJECTSFOLDER);
+        cmr[i].methodId = UA_NODEID_STRING(1, "echo");
+        cmr[i].inputArgumentsSize = 1;
+        cmr[i].inputArguments = (UA_Variant*)UA_Variant_new();
+        UA_Variant_setScalarCopy(cmr[i].inputArguments, &inputs[i],
+                                 &UA_TYPES[UA_TYPES_INT32]);
+    }
+    UA_CallRequest request;
+    UA_CallRequest_init(&request);
+    request.methodsToCall = cmr;
+    request.methodsToCallSize = 23;
+    UA_CallResponse response = UA_Client_Service_call(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 23);
+    for(size_t i = 0; i < 23; i++) {
+        ck_assert_uint_eq(response.results[i].statusCode, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(response.results[i].outputArgumentsSize, 1);
+        ck_assert_int_eq(*(UA_Int32*)response.results[i].outputArguments[0].data,
+                         (UA_Int32)i);
+    }
+    UA_CallResponse_clear(&response);
+    for(size_t i = 0; i < 23; i++)
+        UA_Variant_delete(cmr[i].inputArguments);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+START_TEST(Client_split_browse) {
+    UA_Client *client = newClient(true, 4);
+
+    UA_BrowseDescription bd[25];
+    for(size_t i = 0; i < 25; i++) {
+        UA_BrowseDescription_init(&bd[i]);
+        bd[i].nodeId = UA_NODEID_NUMERIC(1, VARIABLES_START + (UA_UInt32)i);
+        bd[i].browseDirection = UA_BROWSEDIRECTION_INVERSE;
+        bd[i].referenceTypeId = UA_NS0ID(ORGANIZES);
+        bd[i].resultMask = UA_BROWSERESULTMASK_ALL;
+    }
+    UA_BrowseRequest request;
+    UA_BrowseRequest_init(&request);
+    request.nodesToBrowse = bd;
+    request.nodesToBrowseSize = 25;
+    UA_BrowseResponse response = UA_Client_Service_browse(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 25);
+    for(size_t i = 0; i < 25; i++) {
+        ck_assert_uint_eq(response.results[i].statusCode, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(response.results[i].referencesSize, 1);
+        ck_assert_uint_eq(response.results[i].references[0].nodeId.nodeId.identifier.numeric,
+                          UA_NS0ID_OBJECTSFOLDER);
+    }
+    UA_BrowseResponse_clear(&response);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+#define BENCHMARK_ROUNDS 20
+
+/* The application splits the request and sends the parts sequentially */
+static void
+readSequential(UA_Client *client, UA_ReadValueId *rvid) {
+    for(size_t i = 0; i < VARIABLES; i += 100) {
+        UA_ReadRequest request;
+        initReadRequest(&request, rvid, VARIABLES);
+        request.nodesToRead = &rvid[i];
+        request.nodesToReadSize = 100;
+        UA_ReadResponse response = UA_Client_Service_read(client, request);
+        ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+        UA_ReadResponse_clear(&response);
+    }
+}
+
+START_TEST(Client_split_benchmark) {
+    UA_ReadValueId rvid[VARIABLES];
+    UA_ReadRequest request;
+    initReadRequest(&request, rvid, VARIABLES);
+
+    UA_Client *client = newClient(false, 0);
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t r = 0; r < BENCHMARK_ROUNDS; r++)
+        readSequential(client, rvid);
+    UA_DateTime sequential = UA_DateTime_nowMonotonic() - begin;
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    UA_UInt16 windows[3] = {1, 4, 10};
+    for(size_t w = 0; w < 3; w++) {
+        client = newClient(true, windows[w]);
+        begin = UA_DateTime_nowMonotonic();
+        for(size_t r = 0; r < BENCHMARK_ROUNDS; r++) {
+            UA_ReadResponse response = UA_Client_Service_read(client, request);
+            ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+            UA_ReadResponse_clear(&response);
+        }
+        UA_DateTime split = UA_DateTime_nowMonotonic() - begin;
+        printf("Read of %u nodes (limit 100): sequential %.3f ms, "
+               "split with window %u %.3f ms\n", VARIABLES,
+               (double)sequential / BENCHMARK_ROUNDS / UA_DATETIME_MSEC,
+               (unsigned)windows[w], (double)split / BENCHMARK_ROUNDS / UA_DATETIME_MSEC);
+        UA_Client_disconnect(client);
+        UA_Client_delete(client);
+    }
+} END_TEST
+
+#ifdef UA_ARCHITECTURE_POSIX
+
+/* TCP proxy that delays the forwarded data to emulate the link latency */
+#define PROXY_PORT 4841
+#define PROXY_DELAY_MS 2 /* One-way */
+
+typedef struct DelayedPacket {
+    struct DelayedPacket *next;
+    UA_DateTime due;
+    ssize_t len;
+    char data[];
+} DelayedPacket;
+
+typedef struct {
+    int from;
+    int to;
+    DelayedPacket *first;
+    DelayedPacket *last;
+} ProxyDirection;
+
+static UA_Boolean proxyRunning;
+static THREAD_HANDLE proxy_thread;
+static int proxyListenSocket;
+
+static UA_Boolean
+proxyReceive(ProxyDirection *dir) {
+    char buf[65536];
+    ssize_t len = recv(dir->from, buf, sizeof(buf), 0);
+    if(len <= 0)
+        return false;
+    DelayedPacket *p = (DelayedPacket*)malloc(sizeof(DelayedPacket) + (size_t)len);
+    ck_assert(p != NULL);
+    p->next = NULL;
+    p->due = UA_DateTime_nowMonotonic() + PROXY_DELAY_MS * UA_DATETIME_MSEC;
+    p->len = len;
+    memcpy(p->data, buf, (size_t)len);
+    if(dir->last)
+        dir->last->next = p;
+    else
+        dir->first = p;
+    dir->last = p;
+    return true;
+}
+
+static void
+proxyForward(ProxyDirection *dir, UA_DateTime now) {
+    while(dir->first && dir->first->due <= now) {
+        DelayedPacket *p = dir->first;
+        ssize_t sent = 0;
+        while(sent < p->len) {
+            ssize_t res = send(dir->to, p->data + sent, (size_t)(p->len - sent),
+                               MSG_NOSIGNAL);
+            if(res <= 0)
+                break;
+            sent += res;
+        }
+        dir->first = p->next;
+        if(!dir->first)
+            dir->last = NULL;
+        free(p);
+    }
+}
+
+static void
+proxyClear(ProxyDirection *dir) {
+    while(dir->first) {
+        DelayedPacket *p = dir->first;
+        dir->first = p->next;
+        free(p);
+    }
+    dir->last = NULL;
+}
+
+THREAD_CALLBACK(proxyLoop) {
+    while(proxyRunning) {
+        /* Accept the next client */
+        struct pollfd lfd = {proxyListenSocket, POLLIN, 0};
+        if(poll(&lfd, 1, 10) <= 0)
+            continue;
+        int clientSocket = accept(proxyListenSocket, NULL, NULL);
+        if(clientSocket < 0)
+            continue;
+        int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(4840);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if(connect(serverSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(serverSocket);
+            close(clientSocket);
+            continue;
+        }
+        int one = 1;
+        setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(serverSocket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        /* Forward until one side closes the connection */
+        ProxyDirection dirs[2] = {{clientSocket, serverSocket, NULL, NULL},
+                                  {serverSocket, clientSocket, NULL, NULL}};
+        UA_Boolean open = true;
+        while(proxyRunning && open) {
+            struct pollfd fds[2] = {{clientSocket, POLLIN, 0}, {serverSocket, POLLIN, 0}};
+            poll(fds, 2, 1);
+            for(size_t i = 0; i < 2; i++) {
+                if(fds[i].revents && !proxyReceive(&dirs[i]))
+                    open = false;
+            }
+            UA_DateTime now = UA_DateTime_nowMonotonic();
+            proxyForward(&dirs[0], now);
+            proxyForward(&dirs[1], now);
+        }
+        proxyClear(&dirs[0]);
+        proxyClear(&dirs[1]);
+        close(clientSocket);
+        close(serverSocket);
+    }
+    return 0;
+}
+
+static void
+startProxy(void) {
+    proxyListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    ck_assert_int_ge(proxyListenSocket, 0);
+    int one = 1;
+    setsockopt(proxyListenSocket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PROXY_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ck_assert_int_eq(bind(proxyListenSocket, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    ck_assert_int_eq(listen(proxyListenSocket, 1), 0);
+    proxyRunning = true;
+    THREAD_CREATE(proxy_thread, proxyLoop);
+}
+
+static void
+stopProxy(void) {
+    proxyRunning = false;
+    THREAD_JOIN(proxy_thread);
+    close(proxyListenSocket);
+}
+
+#define LATENCY_ROUNDS 5
+
+/* With the link latency, the pipelined partial requests take a fraction of the
+ * round trips of the sequential requests */
+START_TEST(Client_split_benchmarkLatency) {
+    startProxy();
+
+    UA_ReadValueId rvid[VARIABLES];
+    UA_ReadRequest request;
+    initReadRequest(&request, rvid, VARIABLES);
+
+    UA_Client *client = newClientUrl(false, 0, "opc.tcp://127.0.0.1:4841");
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t r = 0; r < LATENCY_ROUNDS; r++)
+        readSequential(client, rvid);
+    UA_DateTime sequential = UA_DateTime_nowMonotonic() - begin;
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    client = newClientUrl(true, 10, "opc.tcp://127.0.0.1:4841");
+    begin = UA_DateTime_nowMonotonic();
+    for(size_t r = 0; r < LATENCY_ROUNDS; r++) {
+        UA_ReadResponse response = UA_Client_Service_read(client, request);
+        checkReadResponse(&response, 1);
+        UA_ReadResponse_clear(&response);
+    }
+    UA_DateTime split = UA_DateTime_nowMonotonic() - begin;
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+
+    printf("Read of %u nodes (limit 100) with %u ms latency: sequential %.3f ms, "
+           "split with window 10 %.3f ms\n", VARIABLES, PROXY_DELAY_MS,
+           (double)sequential / LATENCY_ROUNDS / UA_DATETIME_MSEC,
+           (double)split / LATENCY_ROUNDS / UA_DATETIME_MSEC);
+
+    /* Ten round trips vs. about one */
+    ck_assert_int_lt(split * 2, sequential);
+
+    stopProxy();
+} END_TEST
+
+#endif
+
+static Suite* testSuite_Client(void) {
+    Suite *s = suite_create("Client Split Requests");
+    TCase *tc_client = tcase_create("Split");
+    tcase_add_checked_fixture(tc_client, setup, teardown);
+    tcase_add_test(tc_client, Client_split_read);
+    tcase_add_test(tc_client, Client_split_write);
+    tcase_add_test(tc_client, Client_split_call);
+    tcase_add_test(tc_client, Client_split_browse);
+    tcase_add_test(tc_client, Client_split_benchmark);
+#ifdef UA_ARCHITECTURE_POSIX
+    tcase_add_test(tc_client, Client_split_benchmarkLatency);
+#endif
+    suite_add_tcase(s, tc_client);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_Client();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr,CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1084,6 +1084,196 @@ START_TEST(Client_subscription_writeBurst) {
 }
 END_TEST
 
+#define BATCH_ITEMS 100
+
+static size_t batchCallbackCount;
+static size_t batchNotificationCount;
+static size_t batchContextCount;
+
+static void
+dataChangeBatchHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                       size_t notificationsSize, UA_MonitoredItemNotification *notifications,
+                       void * const *monContexts) {
+    batchCallbackCount++;
+    batchNotificationCount += notificationsSize;
+    for(size_t i = 0; i < notificationsSize; i++) {
+        /* The context is the clientHandle of the MonitoredItem */
+        if(monContexts[i] == (void*)(uintptr_t)notifications[i].clientHandle)
+            batchContextCount++;
+    }
+}
+
+static UA_UInt32
+createBatchItems(UA_Client *client, size_t itemsSize) {
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    UA_CreateSubscriptionResponse response =
+        UA_Client_Subscriptions_create(client, request, NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    /* The client assigns the clientHandles 1..n on a fresh client */
+    UA_MonitoredItemCreateRequest *items = (UA_MonitoredItemCreateRequest*)
+        UA_malloc(itemsSize * sizeof(UA_MonitoredItemCreateRequest));
+    UA_Client_DataChangeNotificationCallback *callbacks =
+        (UA_Client_DataChangeNotificationCallback*)
+        UA_malloc(itemsSize * sizeof(UA_Client_DataChangeNotificationCallback));
+    void **contexts = (void**)UA_malloc(itemsSize * sizeof(void*));
+    ck_assert(items && callbacks && contexts);
+    for(size_t i = 0; i < itemsSize; i++) {
+        items[i] = UA_MonitoredItemCreateRequest_default(
+            UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE));
+        callbacks[i] = dataChangeHandler;
+        contexts[i] = (void*)(uintptr_t)(i + 1);
+    }
+
+    UA_CreateMonitoredItemsRequest createRequest;
+    UA_CreateMonitoredItemsRequest_init(&createRequest);
+    createRequest.subscriptionId = response.subscriptionId;
+    createRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    createRequest.itemsToCreate = items;
+    createRequest.itemsToCreateSize = itemsSize;
+    UA_CreateMonitoredItemsResponse createResponse =
+        UA_Client_MonitoredItems_createDataChanges(client, createRequest, contexts,
+                                                   callbacks, NULL);
+    ck_assert_uint_eq(createResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(createResponse.resultsSize, itemsSize);
+    for(size_t i = 0; i < itemsSize; i++)
+        ck_assert_uint_eq(createResponse.results[i].statusCode, UA_STATUSCODE_GOOD);
+    UA_CreateMonitoredItemsResponse_clear(&createResponse);
+
+    UA_free(items);
+    UA_free(callbacks);
+    UA_free(contexts);
+    return response.subscriptionId;
+}
+
+START_TEST(Client_subscription_batchCallback) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_UInt32 subId = createBatchItems(client, BATCH_ITEMS);
+
+    retval = UA_Client_Subscriptions_setDataChangeBatchCallback(client, subId + 1000,
+                                                                dataChangeBatchHandler);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID);
+    retval = UA_Client_Subscriptions_setDataChangeBatchCallback(client, subId,
+                                                                dataChangeBatchHandler);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* manually control the server thread */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    batchCallbackCount = 0;
+    batchNotificationCount = 0;
+    batchContextCount = 0;
+    countNotificationReceived = 0;
+    for(size_t i = 0; i < 5 && batchNotificationCount < BATCH_ITEMS; i++) {
+        UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+        UA_Server_run_iterate(server, true);
+        retval = UA_Client_run_iterate(client, 1);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* The initial values are delivered in a batch. The per-item callbacks are
+     * not called. */
+    ck_assert_uint_eq(batchNotificationCount, BATCH_ITEMS);
+    ck_assert_uint_eq(batchContextCount, BATCH_ITEMS);
+    ck_assert_uint_lt(batchCallbackCount, BATCH_ITEMS);
+    ck_assert_uint_eq(countNotificationReceived, 0);
+
+    /* run the server in an independent thread again */
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    retval = UA_Client_Subscriptions_deleteSingle(client, subId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* The subscription is no longer found */
+    retval = UA_Client_Subscriptions_setDataChangeBatchCallback(client, subId, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
+#define BENCHMARK_ITEMS 1000
+#define BENCHMARK_MESSAGES 1000
+
+/* Dispatch decoded PublishResponses to the application without the network
+ * and the server in the measurement */
+static double
+dispatchNotifications(UA_Client *client, UA_UInt32 subId) {
+    UA_DataChangeNotification *dcn = UA_DataChangeNotification_new();
+    dcn->monitoredItems = (UA_MonitoredItemNotification*)
+        UA_Array_new(BENCHMARK_ITEMS, &UA_TYPES[UA_TYPES_MONITOREDITEMNOTIFICATION]);
+    dcn->monitoredItemsSize = BENCHMARK_ITEMS;
+    for(size_t i = 0; i < BENCHMARK_ITEMS; i++) {
+        dcn->monitoredItems[i].clientHandle = (UA_UInt32)(i + 1);
+        UA_Int32 v = (UA_Int32)i;
+        UA_Variant_setScalarCopy(&dcn->monitoredItems[i].value.value,
+                                 &v, &UA_TYPES[UA_TYPES_INT32]);
+        dcn->monitoredItems[i].value.hasValue = true;
+    }
+
+    UA_PublishResponse response;
+    UA_PublishResponse_init(&response);
+    response.subscriptionId = subId;
+    response.notificationMessage.notificationDataSize = 1;
+    response.notificationMessage.notificationData = UA_ExtensionObject_new();
+    UA_ExtensionObject_setValue(response.notificationMessage.notificationData,
+                                dcn, &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+
+    lockClient(client);
+    UA_Client_Subscription *sub = LIST_FIRST(&client->subscriptions);
+    UA_UInt32 sequenceNumber = sub->sequenceNumber;
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < BENCHMARK_MESSAGES; i++) {
+        response.notificationMessage.sequenceNumber = ++sequenceNumber;
+        client->currentlyOutStandingPublishRequests++;
+        __Client_Subscriptions_processPublishResponse(client, NULL, &response);
+    }
+    UA_DateTime end = UA_DateTime_nowMonotonic();
+    unlockClient(client);
+
+    UA_PublishResponse_clear(&response);
+    return (double)(end - begin) / UA_DATETIME_SEC;
+}
+
+START_TEST(Client_subscription_batchCallback_benchmark) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_UInt32 subId = createBatchItems(client, BENCHMARK_ITEMS);
+
+    countNotificationReceived = 0;
+    double itemTime = dispatchNotifications(client, subId);
+    ck_assert_uint_eq(countNotificationReceived, BENCHMARK_ITEMS * BENCHMARK_MESSAGES);
+
+    retval = UA_Client_Subscriptions_setDataChangeBatchCallback(client, subId,
+                                                                dataChangeBatchHandler);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    batchNotificationCount = 0;
+    batchContextCount = 0;
+    double batchTime = dispatchNotifications(client, subId);
+    ck_assert_uint_eq(batchNotificationCount, BENCHMARK_ITEMS * BENCHMARK_MESSAGES);
+    ck_assert_uint_eq(batchContextCount, BENCHMARK_ITEMS * BENCHMARK_MESSAGES);
+
+    printf("Notifications per second delivered to the application: "
+           "per-item callback %.0f, batch callback %.0f\n",
+           BENCHMARK_ITEMS * BENCHMARK_MESSAGES / itemTime,
+           BENCHMARK_ITEMS * BENCHMARK_MESSAGES / batchTime);
+
+    retval = UA_Client_Subscriptions_deleteSingle(client, subId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
 START_TEST(Client_subscription_timeout) {
     UA_Client *client = UA_Client_newForUnitTest();
     UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
@@ -1665,6 +1855,8 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_client, Client_subscription_server_disappears);
     tcase_add_test(tc_client, Client_subscription_transfer);
     tcase_add_test(tc_client, Client_subscription_writeBurst);
+    tcase_add_test(tc_client, Client_subscription_batchCallback);
+    tcase_add_test(tc_client, Client_subscription_batchCallback_benchmark);
     suite_add_tcase(s,tc_client);
 
 #ifdef UA_ENABLE_METHODCALLS
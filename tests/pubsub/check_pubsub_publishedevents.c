@@ -0,0 +1,432 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <open62541/server_config_default.h>
+#include <open62541/server_pubsub.h>
+#include <check.h>
+#include <stdlib.h>
+
+#include "test_helpers.h"
+#include "testing_clock.h"
+#include "ua_pubsub_internal.h"
+#include "ua_server_internal.h"
+
+#define MULTICAST_URL      "opc.udp://224.0.0.22:4805/"
+#define UA_SUBSCRIBER_PORT 4805
+#define PUBLISH_INTERVAL   5
+#define PUBLISHER_ID       2234
+#define WRITER_GROUP_ID    100
+#define DATASET_WRITER_ID  62541
+#define MIN_SEVERITY       500
+#define KEEPALIVE_TIME     (3 * PUBLISH_INTERVAL)
+#define RECEIVE_TIMEOUT    (10 * PUBLISH_INTERVAL)
+
+UA_Server *server = NULL;
+UA_NodeId connectionId;
+UA_NodeId eventSourceId;
+UA_NodeId publishedDataSetId;
+UA_NodeId writerGroupId;
+UA_NodeId dataSetWriterId;
+UA_NodeId dataSetReaderId;
+UA_NodeId severityTargetId;
+UA_NodeId messageTargetId;
+
+static UA_SimpleAttributeOperand
+eventFieldOperand(UA_QualifiedName *fieldName) {
+    UA_SimpleAttributeOperand sao;
+    UA_SimpleAttributeOperand_init(&sao);
+    sao.typeDefinitionId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+    sao.browsePathSize = 1;
+    sao.browsePath = fieldName;
+    sao.attributeId = UA_ATTRIBUTEID_VALUE;
+    return sao;
+}
+
+static UA_StatusCode
+addEventField(char *fieldName) {
+    UA_QualifiedName qn = UA_QUALIFIEDNAME(0, fieldName);
+    UA_DataSetFieldConfig fieldConfig;
+    memset(&fieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+    fieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_EVENT;
+    fieldConfig.field.event.fieldNameAlias = UA_STRING(fieldName);
+    fieldConfig.field.event.selectedField = eventFieldOperand(&qn);
+    return UA_Server_addDataSetField(server, publishedDataSetId,
+                                     &fieldConfig, NULL).result;
+}
+
+static void
+addTargetVariable(char *name, const UA_DataType *type, UA_NodeId *outId) {
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    vAttr.displayName = UA_LOCALIZEDTEXT("en-US", name);
+    vAttr.dataType = type->typeId;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, UA_NODEID_NULL,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, name),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  vAttr, NULL, outId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    UA_ServerConfig_setMinimal(config, UA_SUBSCRIBER_PORT, NULL);
+    UA_Server_run_startup(server);
+
+    /* The object that acts as the EventNotifier of the PublishedDataSet */
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    oAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Event Source");
+    oAttr.eventNotifier = UA_EVENTNOTIFIER_SUBSCRIBE_TO_EVENT;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NULL,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Event Source"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oAttr, NULL, &eventSourceId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_PubSubConnectionConfig connectionConfig;
+    memset(&connectionConfig, 0, sizeof(UA_PubSubConnectionConfig));
+    connectionConfig.name = UA_STRING("UADP Test Connection");
+    UA_NetworkAddressUrlDataType networkAddressUrl =
+        {UA_STRING_NULL, UA_STRING(MULTICAST_URL)};
+    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl,
+                         &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    connectionConfig.transportProfileUri =
+        UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    connectionConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    connectionConfig.publisherId.id.uint16 = PUBLISHER_ID;
+    res = UA_Server_addPubSubConnection(server, &connectionConfig, &connectionId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void teardown(void) {
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+/* Add a PublishedEvents DataSet for the event source with the fields Severity
+ * and Message. Only events with Severity >= MIN_SEVERITY are published. */
+static void
+addPublishedEvents(void) {
+    UA_QualifiedName severityName = UA_QUALIFIEDNAME(0, "Severity");
+    UA_SimpleAttributeOperand severity = eventFieldOperand(&severityName);
+    UA_UInt16 minSeverity = MIN_SEVERITY;
+    UA_LiteralOperand literal;
+    UA_LiteralOperand_init(&literal);
+    UA_Variant_setScalar(&literal.value, &minSeverity, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_ExtensionObject operands[2];
+    UA_ExtensionObject_setValue(&operands[0], &severity,
+                                &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]);
+    UA_ExtensionObject_setValue(&operands[1], &literal,
+                                &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+    UA_ContentFilterElement element;
+    UA_ContentFilterElement_init(&element);
+    element.filterOperator = UA_FILTEROPERATOR_GREATERTHANOREQUAL;
+    element.filterOperandsSize = 2;
+    element.filterOperands = operands;
+
+    UA_PublishedDataSetConfig pdsConfig;
+    memset(&pdsConfig, 0, sizeof(UA_PublishedDataSetConfig));
+    pdsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDEVENTS;
+    pdsConfig.name = UA_STRING("PublishedEvents Test");
+    pdsConfig.config.event.eventNotfier = eventSourceId;
+    pdsConfig.config.event.filter.elementsSize = 1;
+    pdsConfig.config.event.filter.elements = &element;
+    UA_StatusCode res =
+        UA_Server_addPublishedDataSet(server, &pdsConfig, &publishedDataSetId).addResult;
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    ck_assert_int_eq(addEventField("Severity"), UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(addEventField("Message"), UA_STATUSCODE_GOOD);
+}
+
+static void
+addWriter(void) {
+    UA_WriterGroupConfig writerGroupConfig;
+    memset(&writerGroupConfig, 0, sizeof(writerGroupConfig));
+    writerGroupConfig.name = UA_STRING("WriterGroup Test");
+    writerGroupConfig.publishingInterval = PUBLISH_INTERVAL;
+    writerGroupConfig.keepAliveTime = KEEPALIVE_TIME;
+    writerGroupConfig.writerGroupId = WRITER_GROUP_ID;
+    writerGroupConfig.encodingMimeType = UA_PUBSUB_ENCODING_UADP;
+    writerGroupConfig.messageSettings.encoding = UA_EXTENSIONOBJECT_DECODED;
+    writerGroupConfig.messageSettings.content.decoded.type =
+        &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE];
+    UA_UadpWriterGroupMessageDataType *writerGroupMessage =
+        UA_UadpWriterGroupMessageDataType_new();
+    writerGroupMessage->networkMessageContentMask =
+        (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PUBLISHERID |
+        (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_GROUPHEADER |
+        (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_WRITERGROUPID |
+        (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER;
+    writerGroupConfig.messageSettings.content.decoded.data = writerGroupMessage;
+    UA_StatusCode res =
+        UA_Server_addWriterGroup(server, connectionId, &writerGroupConfig, &writerGroupId);
+    UA_UadpWriterGroupMessageDataType_delete(writerGroupMessage);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_DataSetWriterConfig dataSetWriterConfig;
+    memset(&dataSetWriterConfig, 0, sizeof(dataSetWriterConfig));
+    dataSetWriterConfig.name = UA_STRING("DataSetWriter Test");
+    dataSetWriterConfig.dataSetWriterId = DATASET_WRITER_ID;
+    res = UA_Server_addDataSetWriter(server, writerGroupId, publishedDataSetId,
+                                     &dataSetWriterConfig, &dataSetWriterId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void
+addReader(void) {
+    UA_NodeId readerGroupId;
+    UA_ReaderGroupConfig readerGroupConfig;
+    memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+    readerGroupConfig.name = UA_STRING("ReaderGroup Test");
+    UA_StatusCode res =
+        UA_Server_addReaderGroup(server, connectionId, &readerGroupConfig, &readerGroupId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_FieldMetaData fields[2];
+    UA_FieldMetaData_init(&fields[0]);
+    fields[0].name = UA_STRING("Severity");
+    fields[0].dataType = UA_TYPES[UA_TYPES_UINT16].typeId;
+    fields[0].builtInType = UA_NS0ID_UINT16;
+    fields[0].valueRank = UA_VALUERANK_SCALAR;
+    UA_FieldMetaData_init(&fields[1]);
+    fields[1].name = UA_STRING("Message");
+    fields[1].dataType = UA_TYPES[UA_TYPES_LOCALIZEDTEXT].typeId;
+    fields[1].builtInType = UA_NS0ID_LOCALIZEDTEXT;
+    fields[1].valueRank = UA_VALUERANK_SCALAR;
+
+    UA_DataSetReaderConfig readerConfig;
+    memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+    readerConfig.name = UA_STRING("DataSetReader Test");
+    readerConfig.messageReceiveTimeout = RECEIVE_TIMEOUT;
+    readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+    readerConfig.writerGroupId = WRITER_GROUP_ID;
+    readerConfig.dataSetWriterId = DATASET_WRITER_ID;
+    readerConfig.dataSetMetaData.name = UA_STRING("DataSet Test");
+    readerConfig.dataSetMetaData.fieldsSize = 2;
+    readerConfig.dataSetMetaData.fields = fields;
+    res = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                     &dataSetReaderId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    addTargetVariable("Received Severity", &UA_TYPES[UA_TYPES_UINT16], &severityTargetId);
+    addTargetVariable("Received Message", &UA_TYPES[UA_TYPES_LOCALIZEDTEXT], &messageTargetId);
+    UA_FieldTargetDataType targetVars[2];
+    UA_FieldTargetDataType_init(&targetVars[0]);
+    targetVars[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    targetVars[0].targetNodeId = severityTargetId;
+    UA_FieldTargetDataType_init(&targetVars[1]);
+    targetVars[1].attributeId = UA_ATTRIBUTEID_VALUE;
+    targetVars[1].targetNodeId = messageTargetId;
+    res = UA_Server_DataSetReader_createTargetVariables(server, dataSetReaderId,
+                                                       2, targetVars);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void
+emitEvent(UA_UInt16 severity, char *message) {
+    UA_StatusCode res =
+        UA_Server_createEvent(server, eventSourceId,
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE),
+                              severity, UA_LOCALIZEDTEXT("en-US", message),
+                              NULL, NULL, NULL);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static UA_UInt16
+receivedSeverity(void) {
+    UA_Variant value;
+    UA_StatusCode res = UA_Server_readValue(server, severityTargetId, &value);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    UA_UInt16 severity = 0;
+    if(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT16]))
+        severity = *(UA_UInt16*)value.data;
+    UA_Variant_clear(&value);
+    return severity;
+}
+
+/* Run the publisher and subscriber until the expected severity was received */
+static UA_Boolean
+waitForSeverity(UA_UInt16 expected) {
+    for(size_t i = 0; i < 100; i++) {
+        UA_fakeSleep(PUBLISH_INTERVAL + 1);
+        UA_Server_run_iterate(server, true);
+        if(receivedSeverity() == expected)
+            return true;
+    }
+    return false;
+}
+
+static size_t
+eventQueueSize(void) {
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(getPSM(server), dataSetWriterId);
+    ck_assert(dsw != NULL);
+    return dsw->eventQueueSize;
+}
+
+START_TEST(AddPublishedEventsDataSet) {
+    addPublishedEvents();
+
+    UA_PublishedDataSet *pds =
+        UA_PublishedDataSet_find(getPSM(server), publishedDataSetId);
+    ck_assert(pds != NULL);
+    ck_assert_uint_eq(pds->fieldSize, 2);
+    ck_assert_uint_eq(pds->selectClausesSize, 2);
+    ck_assert_uint_eq(pds->dataSetMetaData.fieldsSize, 2);
+    UA_String severityAlias = UA_STRING("Severity");
+    UA_NodeId baseDataType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE);
+    ck_assert(UA_String_equal(&pds->dataSetMetaData.fields[0].name, &severityAlias));
+    ck_assert(UA_NodeId_equal(&pds->dataSetMetaData.fields[0].dataType, &baseDataType));
+
+    /* The config is returned with the notifier and the filter */
+    UA_PublishedDataSetConfig pdsConfig;
+    UA_StatusCode res =
+        UA_Server_getPublishedDataSetConfig(server, publishedDataSetId, &pdsConfig);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(pdsConfig.publishedDataSetType, UA_PUBSUB_DATASET_PUBLISHEDEVENTS);
+    ck_assert(UA_NodeId_equal(&pdsConfig.config.event.eventNotfier, &eventSourceId));
+    ck_assert_uint_eq(pdsConfig.config.event.filter.elementsSize, 1);
+    UA_PublishedDataSetConfig_clear(&pdsConfig);
+
+    /* Variable fields cannot be added to a PublishedEvents DataSet */
+    UA_DataSetFieldConfig fieldConfig;
+    memset(&fieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+    fieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+    fieldConfig.field.variable.fieldNameAlias = UA_STRING("Variable");
+    fieldConfig.field.variable.publishParameters.publishedVariable =
+        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME);
+    fieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+    res = UA_Server_addDataSetField(server, publishedDataSetId, &fieldConfig, NULL).result;
+    ck_assert_int_eq(res, UA_STATUSCODE_BADCONFIGURATIONERROR);
+    ck_assert_uint_eq(pds->fieldSize, 2);
+
+    /* And the other way round */
+    UA_PublishedDataSetConfig itemsConfig;
+    memset(&itemsConfig, 0, sizeof(UA_PublishedDataSetConfig));
+    itemsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
+    itemsConfig.name = UA_STRING("PublishedItems Test");
+    UA_NodeId itemsId;
+    res = UA_Server_addPublishedDataSet(server, &itemsConfig, &itemsId).addResult;
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    memset(&fieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+    fieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_EVENT;
+    fieldConfig.field.event.fieldNameAlias = UA_STRING("Severity");
+    UA_QualifiedName severityName = UA_QUALIFIEDNAME(0, "Severity");
+    fieldConfig.field.event.selectedField = eventFieldOperand(&severityName);
+    res = UA_Server_addDataSetField(server, itemsId, &fieldConfig, NULL).result;
+    ck_assert_int_eq(res, UA_STATUSCODE_BADCONFIGURATIONERROR);
+
+    res = UA_Server_removePublishedDataSet(server, publishedDataSetId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(getPSM(server)->publishedEventsSize, 0);
+} END_TEST
+
+START_TEST(PublishSubscribeEvents) {
+    addPublishedEvents();
+    addWriter();
+    addReader();
+    ck_assert_int_eq(UA_Server_enableAllPubSubComponents(server), UA_STATUSCODE_GOOD);
+
+    /* Filtered out by the where clause */
+    emitEvent(100, "Ignored");
+    ck_assert_uint_eq(eventQueueSize(), 0);
+
+    emitEvent(700, "Alarm");
+    ck_assert_uint_eq(eventQueueSize(), 1);
+    ck_assert(waitForSeverity(700));
+    ck_assert_uint_eq(eventQueueSize(), 0);
+
+    UA_Variant value;
+    UA_StatusCode res = UA_Server_readValue(server, messageTargetId, &value);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]));
+    UA_LocalizedText *text = (UA_LocalizedText*)value.data;
+    UA_String alarm = UA_STRING("Alarm");
+    ck_assert(UA_String_equal(&text->text, &alarm));
+    UA_Variant_clear(&value);
+
+    /* Events queued within one publish interval are all sent. The last one
+     * remains in the target variables. */
+    emitEvent(600, "First");
+    emitEvent(800, "Second");
+    emitEvent(900, "Third");
+    ck_assert_uint_eq(eventQueueSize(), 3);
+    ck_assert(waitForSeverity(900));
+    ck_assert_uint_eq(eventQueueSize(), 0);
+} END_TEST
+
+START_TEST(IdleWriterKeepAlive) {
+    addPublishedEvents();
+    addWriter();
+    addReader();
+    ck_assert_int_eq(UA_Server_enableAllPubSubComponents(server), UA_STATUSCODE_GOOD);
+
+    emitEvent(700, "Alarm");
+    ck_assert(waitForSeverity(700));
+
+    /* Without events, the KeepAlives keep the Reader within the
+     * MessageReceiveTimeout */
+    for(size_t i = 0; i < 5 * RECEIVE_TIMEOUT / PUBLISH_INTERVAL; i++) {
+        UA_fakeSleep(PUBLISH_INTERVAL + 1);
+        UA_Server_run_iterate(server, true);
+    }
+    UA_PubSubState state;
+    UA_StatusCode res =
+        UA_Server_DataSetReader_getState(server, dataSetReaderId, &state);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(state, UA_PUBSUBSTATE_OPERATIONAL);
+
+    /* The KeepAlives don't change the target variables */
+    ck_assert_uint_eq(receivedSeverity(), 700);
+} END_TEST
+
+START_TEST(EventQueueOverflow) {
+    addPublishedEvents();
+    addWriter();
+    ck_assert_int_eq(UA_Server_enableAllPubSubComponents(server), UA_STATUSCODE_GOOD);
+
+    /* The oldest events are dropped when the queue is full */
+    for(size_t i = 0; i < UA_DATASETWRITER_MAXEVENTQUEUESIZE + 10; i++)
+        emitEvent(MIN_SEVERITY, "Overflow");
+    ck_assert_uint_eq(eventQueueSize(), UA_DATASETWRITER_MAXEVENTQUEUESIZE);
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(getPSM(server), dataSetWriterId);
+    ck_assert_uint_eq(dsw->eventQueueOverflows, 10);
+
+    /* Disabling the writer discards the queued events */
+    UA_StatusCode res = UA_Server_disableDataSetWriter(server, dataSetWriterId);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(eventQueueSize(), 0);
+
+    /* No events are queued for a disabled writer */
+    emitEvent(MIN_SEVERITY, "Disabled");
+    ck_assert_uint_eq(eventQueueSize(), 0);
+} END_TEST
+
+int main(void) {
+    TCase *tc_publishedevents = tcase_create("PubSub PublishedEvents");
+    tcase_add_checked_fixture(tc_publishedevents, setup, teardown);
+    tcase_add_test(tc_publishedevents, AddPublishedEventsDataSet);
+    tcase_add_test(tc_publishedevents, PublishSubscribeEvents);
+    tcase_add_test(tc_publishedevents, IdleWriterKeepAlive);
+    tcase_add_test(tc_publishedevents, EventQueueOverflow);
+
+    Suite *suite = suite_create("PubSub PublishedEvents DataSets");
+    suite_add_tcase(suite, tc_publishedevents);
+
+    SRunner *suiteRunner = srunner_create(suite);
+    srunner_set_fork_status(suiteRunner, CK_NOFORK);
+    srunner_run_all(suiteRunner, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(suiteRunner);
+    srunner_free(suiteRunner);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -88,13 +88,186 @@ START_TEST(PublishSpeedTest) {
 
 } END_TEST
 
+#define LARGE_FIELD_COUNT 3000
+
+UA_NodeId variables[LARGE_FIELD_COUNT];
+
+static void
+addVariable(size_t i, UA_Int32 v) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setScalar(&attr.value, &v, &UA_TYPES[UA_TYPES_INT32]);
+    attr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    attr.valueRank = UA_VALUERANK_SCALAR;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    variables[i] = UA_NODEID_NUMERIC(1, (UA_UInt32)(1000000 + i));
+    char name[32];
+    snprintf(name, sizeof(name), "Variable %u", (unsigned)i);
+    UA_StatusCode retval =
+        UA_Server_addVariableNode(server, variables[i],
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, name),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void setupLarge(void) {
+    setup();
+
+    /* One field for each variable */
+    UA_StatusCode retval;
+    for(size_t i = 0; i < LARGE_FIELD_COUNT; i++) {
+        addVariable(i, (UA_Int32)i);
+        UA_DataSetFieldConfig fieldConfig;
+        memset(&fieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+        fieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+        fieldConfig.field.variable.fieldNameAlias = UA_STRING("Field");
+        fieldConfig.field.variable.publishParameters.publishedVariable = variables[i];
+        fieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+        retval = UA_Server_addDataSetField(server, publishedDataSet1,
+                                           &fieldConfig, NULL).result;
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* The DataSetMessages are generated directly in the tests */
+    retval = UA_Server_disableWriterGroup(server, writerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DataSetWriterConfig writerConfig;
+    memset(&writerConfig, 0, sizeof(UA_DataSetWriterConfig));
+    writerConfig.name = UA_STRING("DataSetWriter 1");
+    writerConfig.dataSetWriterId = 1;
+    writerConfig.keyFrameCount = 1;
+    retval = UA_Server_addDataSetWriter(server, writerGroup1, publishedDataSet1,
+                                        &writerConfig, &dataSetWriter1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+/* Generate a KeyFrame and return the value of a field */
+static UA_Int32
+sampleField(size_t i, UA_Boolean borrow) {
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->pubSubConfig.enableZeroCopySampling = borrow;
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
+    UA_DataSetMessage dsm;
+    UA_StatusCode retval = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsm);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(dsm.header.dataSetMessageType, UA_DATASETMESSAGE_DATAKEYFRAME);
+    ck_assert_int_eq(dsm.fieldCount, LARGE_FIELD_COUNT);
+    UA_DataValue *field = &dsm.data.keyFrameFields[i];
+    UA_Int32 v = -1;
+    if(field->hasValue) {
+        ck_assert(UA_Variant_hasScalarType(&field->value, &UA_TYPES[UA_TYPES_INT32]));
+        ck_assert_int_eq(field->value.storageType, (borrow) ?
+                         UA_VARIANT_DATA_NODELETE : UA_VARIANT_DATA);
+        v = *(UA_Int32*)field->value.data;
+    }
+    UA_DataSetMessage_clear(&dsm);
+    unlockServer(server);
+    return v;
+}
+
+START_TEST(SampleLargeDataSetTest) {
+    ck_assert_int_eq(sampleField(5, false), 5);
+    ck_assert_int_eq(sampleField(5, true), 5);
+    ck_assert_int_eq(sampleField(LARGE_FIELD_COUNT - 1, true), LARGE_FIELD_COUNT - 1);
+
+    /* Written values are sampled from the resolved nodes */
+    UA_Int32 v = 42;
+    UA_Variant value;
+    UA_Variant_setScalar(&value, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode retval = UA_Server_writeValue(server, variables[5], value);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(sampleField(5, false), 42);
+    ck_assert_int_eq(sampleField(5, true), 42);
+
+    /* A deleted variable is detected. The other fields are still sampled. */
+    retval = UA_Server_deleteNode(server, variables[5], true);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(sampleField(5, true), -1);
+    ck_assert_int_eq(sampleField(6, true), 6);
+
+    /* A new variable with the same NodeId is sampled */
+    addVariable(5, 43);
+    ck_assert_int_eq(sampleField(5, true), 43);
+
+    /* The nodes are released when the PublishedDataSet is no longer used */
+    retval = UA_Server_enableDataSetWriter(server, dataSetWriter1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(sampleField(5, true), 43);
+    UA_PublishedDataSet *pds = UA_PublishedDataSet_find(getPSM(server), publishedDataSet1);
+    ck_assert(TAILQ_FIRST(&pds->fields)->node != NULL);
+    retval = UA_Server_disableDataSetWriter(server, dataSetWriter1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(TAILQ_FIRST(&pds->fields)->node == NULL);
+} END_TEST
+
+static double
+sampledFieldsPerSecond(UA_Boolean borrow, size_t messages) {
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->pubSubConfig.enableZeroCopySampling = borrow;
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, dataSetWriter1);
+    UA_DataSetMessage dsm;
+    clock_t begin = clock();
+    for(size_t i = 0; i < messages; i++) {
+        UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsm);
+        UA_DataSetMessage_clear(&dsm);
+    }
+    clock_t finish = clock();
+    unlockServer(server);
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    return (double)(messages * LARGE_FIELD_COUNT) / time_spent;
+}
+
+/* Sampling every field via the Read service (without resolved nodes) */
+static double
+readFieldsPerSecond(size_t messages) {
+    lockServer(server);
+    UA_ReadValueId rvid;
+    UA_ReadValueId_init(&rvid);
+    rvid.attributeId = UA_ATTRIBUTEID_VALUE;
+    clock_t begin = clock();
+    for(size_t i = 0; i < messages; i++) {
+        for(size_t j = 0; j < LARGE_FIELD_COUNT; j++) {
+            rvid.nodeId = variables[j];
+            UA_DataValue dv = readWithSession(server, &server->adminSession,
+                                              &rvid, UA_TIMESTAMPSTORETURN_BOTH);
+            UA_DataValue_clear(&dv);
+        }
+    }
+    clock_t finish = clock();
+    unlockServer(server);
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    return (double)(messages * LARGE_FIELD_COUNT) / time_spent;
+}
+
+START_TEST(SampleLargeDataSetSpeedTest) {
+    double read = readFieldsPerSecond(200);
+    double resolved = sampledFieldsPerSecond(false, 200);
+    double borrowed = sampledFieldsPerSecond(true, 200);
+    printf("fields sampled per second via the Read service: %.0f\n", read);
+    printf("fields sampled per second from resolved nodes: %.0f\n", resolved);
+    printf("fields sampled per second without copying: %.0f\n", borrowed);
+} END_TEST
+
 int main(void) {
     TCase *tc_publishspeed = tcase_create("Speed of the publisher");
     tcase_add_checked_fixture(tc_publishspeed, setup, teardown);
     tcase_add_test(tc_publishspeed, PublishSpeedTest);
 
+    TCase *tc_large = tcase_create("Sampling large DataSets");
+    tcase_add_checked_fixture(tc_large, setupLarge, teardown);
+    tcase_add_test(tc_large, SampleLargeDataSetTest);
+    tcase_add_test(tc_large, SampleLargeDataSetSpeedTest);
+
     Suite *s = suite_create("PubSub Speed Test");
     suite_add_tcase(s, tc_publishspeed);
+    suite_add_tcase(s, tc_large);
 
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
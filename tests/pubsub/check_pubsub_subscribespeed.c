@@ -0,0 +1,797 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <open62541/server_config_default.h>
+#include <open62541/server_pubsub.h>
+
+#include "test_helpers.h"
+#include "testing_clock.h"
+#include "ua_pubsub_internal.h"
+#include "ua_server_internal.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <time.h>
+#include <stdlib.h>
+
+#define READER_COUNT 512
+#define PUBLISHER_ID 2234
+#define WRITER_GROUP_ID 100
+
+UA_Server *server = NULL;
+UA_NodeId connection1, readerGroup1;
+UA_NodeId readers[READER_COUNT];
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_Server_run_startup(server);
+
+    UA_PubSubConnectionConfig connectionConfig;
+    memset(&connectionConfig, 0, sizeof(UA_PubSubConnectionConfig));
+    connectionConfig.name = UA_STRING("UADP Connection");
+    UA_NetworkAddressUrlDataType networkAddressUrl = {UA_STRING_NULL, UA_STRING("opc.udp://224.0.0.22:4840/")};
+    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl,
+                         &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    connectionConfig.transportProfileUri = UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    UA_StatusCode retval =
+        UA_Server_addPubSubConnection(server, &connectionConfig, &connection1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_ReaderGroupConfig readerGroupConfig;
+    memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+    readerGroupConfig.name = UA_STRING("ReaderGroup 1");
+    retval = UA_Server_addReaderGroup(server, connection1, &readerGroupConfig, &readerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* One Reader for each DataSetWriterId. Without fields, every received
+     * DataSetMessage is a heartbeat that (re)starts the timeout timer. */
+    UA_DataSetReaderConfig readerConfig;
+    memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+    readerConfig.name = UA_STRING("DataSetReader");
+    readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+    readerConfig.writerGroupId = WRITER_GROUP_ID;
+    readerConfig.messageReceiveTimeout = 10000.0;
+    for(UA_UInt16 i = 0; i < READER_COUNT; i++) {
+        readerConfig.dataSetWriterId = (UA_UInt16)(i + 1);
+        retval = UA_Server_addDataSetReader(server, readerGroup1,
+                                            &readerConfig, &readers[i]);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void teardown(void) {
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+static void
+initNetworkMessage(UA_NetworkMessage *nm, UA_DataSetMessage *dsm) {
+    memset(dsm, 0, sizeof(UA_DataSetMessage));
+    dsm->header.dataSetMessageValid = true;
+    dsm->header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+
+    memset(nm, 0, sizeof(UA_NetworkMessage));
+    nm->version = 1;
+    nm->networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    nm->publisherIdEnabled = true;
+    nm->publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    nm->publisherId.id.uint16 = PUBLISHER_ID;
+    nm->groupHeaderEnabled = true;
+    nm->groupHeader.writerGroupIdEnabled = true;
+    nm->groupHeader.writerGroupId = WRITER_GROUP_ID;
+    nm->payloadHeaderEnabled = true;
+    nm->messageCount = 1;
+    nm->payload.dataSetMessages = dsm;
+}
+
+static UA_Boolean
+readerReceived(UA_PubSubManager *psm, size_t i) {
+    UA_DataSetReader *dsr = UA_DataSetReader_find(psm, readers[i]);
+    ck_assert(dsr != NULL);
+    return (dsr->msgRcvTimeoutTimerId != 0);
+}
+
+START_TEST(SubscribeDispatchTest) {
+    UA_PubSubManager *psm = getPSM(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    ck_assert(rg != NULL);
+    lockServer(server);
+    for(size_t i = 0; i < READER_COUNT; i++)
+        ck_assert(!readerReceived(psm, i));
+
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+
+    /* Only the Readers with an even DataSetWriterId receive a message */
+    for(UA_UInt16 id = 2; id <= READER_COUNT; id += 2) {
+        nm.dataSetWriterIds[0] = id;
+        ck_assert(UA_ReaderGroup_process(psm, rg, &nm));
+    }
+    for(size_t i = 0; i < READER_COUNT; i++) {
+        ck_assert_int_eq(readerReceived(psm, i), ((i + 1) % 2 == 0));
+    }
+
+    /* Unknown identifiers are not processed */
+    nm.dataSetWriterIds[0] = READER_COUNT + 1;
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    nm.dataSetWriterIds[0] = 1;
+    nm.groupHeader.writerGroupId = WRITER_GROUP_ID + 1;
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    nm.groupHeader.writerGroupId = WRITER_GROUP_ID;
+    nm.publisherId.id.uint16 = PUBLISHER_ID + 1;
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    ck_assert(!readerReceived(psm, 0));
+
+    /* Reindex after the config of a Reader was updated */
+    unlockServer(server);
+    UA_DataSetReaderConfig config;
+    UA_StatusCode retval = UA_Server_getDataSetReaderConfig(server, readers[0], &config);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    config.dataSetWriterId = READER_COUNT + 1;
+    retval = UA_Server_disableDataSetReader(server, readers[0]);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Server_updateDataSetReaderConfig(server, readers[0], &config);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Server_enableDataSetReader(server, readers[0]);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_DataSetReaderConfig_clear(&config);
+    lockServer(server);
+
+    nm.publisherId.id.uint16 = PUBLISHER_ID;
+    nm.dataSetWriterIds[0] = 1;
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    nm.dataSetWriterIds[0] = READER_COUNT + 1;
+    ck_assert(UA_ReaderGroup_process(psm, rg, &nm));
+    ck_assert(readerReceived(psm, 0));
+
+    /* Without the payload header the message is processed by every Reader */
+    nm.payloadHeaderEnabled = false;
+    ck_assert(UA_ReaderGroup_process(psm, rg, &nm));
+    for(size_t i = 0; i < READER_COUNT; i++)
+        ck_assert(readerReceived(psm, i));
+    unlockServer(server);
+} END_TEST
+
+START_TEST(SubscribeSpeedTest) {
+    UA_PubSubManager *psm = getPSM(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    ck_assert(rg != NULL);
+
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+
+    printf("start processing 200000 NetworkMessages for %d DataSetReaders\n",
+           READER_COUNT);
+
+    lockServer(server);
+    clock_t begin, finish;
+    begin = clock();
+
+    for(size_t i = 0; i < 200000; i++) {
+        nm.dataSetWriterIds[0] = (UA_UInt16)((i % READER_COUNT) + 1);
+        UA_ReaderGroup_process(psm, rg, &nm);
+    }
+
+    finish = clock();
+    unlockServer(server);
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    printf("duration was %f s\n", time_spent);
+} END_TEST
+
+#define SAMEKEY_COUNT 8
+
+UA_NodeId sameKeyReaders[SAMEKEY_COUNT];
+UA_Boolean sameKeyArmed;
+size_t removedReaders;
+
+/* The Readers become operational when they process a message after the test
+ * has armed them */
+static UA_StatusCode
+sameKeyStateMachine(UA_Server *s, const UA_NodeId componentId,
+                    void *componentContext, UA_PubSubState *state,
+                    UA_PubSubState targetState) {
+    if(targetState == UA_PUBSUBSTATE_DISABLED ||
+       targetState == UA_PUBSUBSTATE_ERROR) {
+        *state = targetState;
+        return UA_STATUSCODE_GOOD;
+    }
+    UA_PubSubState rgState;
+    UA_StatusCode retval = UA_Server_getReaderGroupState(s, readerGroup1, &rgState);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    if(rgState != UA_PUBSUBSTATE_OPERATIONAL &&
+       rgState != UA_PUBSUBSTATE_PREOPERATIONAL) {
+        *state = UA_PUBSUBSTATE_PAUSED;
+        return UA_STATUSCODE_GOOD;
+    }
+    if(*state == UA_PUBSUBSTATE_PREOPERATIONAL &&
+       targetState == UA_PUBSUBSTATE_PREOPERATIONAL && sameKeyArmed)
+        *state = UA_PUBSUBSTATE_OPERATIONAL;
+    else if(*state != UA_PUBSUBSTATE_OPERATIONAL)
+        *state = UA_PUBSUBSTATE_PREOPERATIONAL;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Disable the ReaderGroup and remove all Readers when the first Reader becomes
+ * operational */
+static void
+removeReadersCallback(UA_Server *s, const UA_NodeId id,
+                      UA_PubSubState state, UA_StatusCode status) {
+    if(state != UA_PUBSUBSTATE_OPERATIONAL || removedReaders > 0)
+        return;
+    UA_Boolean isReader = false;
+    for(size_t i = 0; i < SAMEKEY_COUNT; i++)
+        isReader |= UA_NodeId_equal(&id, &sameKeyReaders[i]);
+    if(!isReader)
+        return;
+    UA_StatusCode retval = UA_Server_disableReaderGroup(s, readerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < SAMEKEY_COUNT; i++) {
+        retval = UA_Server_removeDataSetReader(s, sameKeyReaders[i]);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        removedReaders++;
+    }
+}
+
+static void setupSameKey(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_Server_run_startup(server);
+
+    UA_PubSubConnectionConfig connectionConfig;
+    memset(&connectionConfig, 0, sizeof(UA_PubSubConnectionConfig));
+    connectionConfig.name = UA_STRING("UADP Connection");
+    UA_NetworkAddressUrlDataType networkAddressUrl = {UA_STRING_NULL, UA_STRING("opc.udp://224.0.0.22:4840/")};
+    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl,
+                         &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    connectionConfig.transportProfileUri = UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    UA_StatusCode retval =
+        UA_Server_addPubSubConnection(server, &connectionConfig, &connection1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_ReaderGroupConfig readerGroupConfig;
+    memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+    readerGroupConfig.name = UA_STRING("ReaderGroup 1");
+    retval = UA_Server_addReaderGroup(server, connection1, &readerGroupConfig, &readerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* All Readers subscribe to the same DataSetWriter */
+    UA_DataSetReaderConfig readerConfig;
+    memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+    readerConfig.name = UA_STRING("DataSetReader");
+    readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+    readerConfig.writerGroupId = WRITER_GROUP_ID;
+    readerConfig.dataSetWriterId = 1;
+    readerConfig.customStateMachine = sameKeyStateMachine;
+    for(size_t i = 0; i < SAMEKEY_COUNT; i++) {
+        retval = UA_Server_addDataSetReader(server, readerGroup1,
+                                            &readerConfig, &sameKeyReaders[i]);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    sameKeyArmed = false;
+    removedReaders = 0;
+    retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+START_TEST(RemoveReadersDuringDispatchTest) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+
+    /* A message for another DataSetWriter sets the ReaderGroup operational.
+     * The Readers stay preoperational. */
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    ck_assert(rg != NULL);
+    nm.dataSetWriterIds[0] = 2;
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    ck_assert_int_eq(rg->head.state, UA_PUBSUBSTATE_OPERATIONAL);
+    ck_assert_uint_eq(rg->readersCount, SAMEKEY_COUNT);
+
+    /* The first Reader becomes operational and the state callback removes
+     * all Readers. The dispatch stops without touching them. */
+    sameKeyArmed = true;
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->pubSubConfig.stateChangeCallback = removeReadersCallback;
+    nm.dataSetWriterIds[0] = 1;
+    ck_assert(UA_ReaderGroup_process(psm, rg, &nm));
+    ck_assert_uint_eq(removedReaders, SAMEKEY_COUNT);
+    ck_assert_uint_eq(rg->readersCount, 0);
+    ck_assert_int_eq(rg->head.state, UA_PUBSUBSTATE_DISABLED);
+
+    /* The disabled ReaderGroup does not process messages */
+    ck_assert(!UA_ReaderGroup_process(psm, rg, &nm));
+    unlockServer(server);
+} END_TEST
+
+static void
+processHeartbeat(UA_UInt16 dataSetWriterId) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = dataSetWriterId;
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    ck_assert(UA_ReaderGroup_process(psm, rg, &nm));
+    unlockServer(server);
+}
+
+START_TEST(MessageReceiveTimeoutTest) {
+    UA_DataSetReader *dsr = UA_DataSetReader_find(getPSM(server), readers[0]);
+    ck_assert(dsr != NULL);
+    ck_assert_int_ne(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+
+    /* The timeout is measured from the last received message */
+    processHeartbeat(1);
+    UA_fakeSleep(9000);
+    processHeartbeat(1);
+    UA_fakeSleep(2000);
+    UA_Server_run_iterate(server, false);
+    ck_assert_int_ne(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+    UA_fakeSleep(7999);
+    UA_Server_run_iterate(server, false);
+    ck_assert_int_ne(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+
+    /* Every message moves the timeout forward */
+    for(size_t i = 0; i < 20; i++) {
+        UA_fakeSleep(1000);
+        processHeartbeat(1);
+        UA_Server_run_iterate(server, false);
+    }
+    UA_fakeSleep(9999);
+    UA_Server_run_iterate(server, false);
+    ck_assert_int_ne(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+
+    /* Timeout */
+    UA_fakeSleep(1);
+    UA_Server_run_iterate(server, false);
+    ck_assert_int_eq(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+    ck_assert_uint_eq(dsr->msgRcvTimeoutTimerId, 0);
+
+    /* The other Readers have not received messages and do not time out */
+    dsr = UA_DataSetReader_find(getPSM(server), readers[1]);
+    ck_assert_int_ne(dsr->head.state, UA_PUBSUBSTATE_ERROR);
+} END_TEST
+
+static double
+messagesPerSecond(UA_Duration messageReceiveTimeout, size_t messages) {
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    UA_DataSetReader *dsr = UA_DataSetReader_find(psm, readers[0]);
+    dsr->config.messageReceiveTimeout = messageReceiveTimeout;
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = 1;
+    clock_t begin = clock();
+    for(size_t i = 0; i < messages; i++)
+        UA_ReaderGroup_process(psm, rg, &nm);
+    clock_t finish = clock();
+    unlockServer(server);
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    return (double)messages / time_spent;
+}
+
+START_TEST(MessageReceiveTimeoutSpeedTest) {
+    double noTimeout = messagesPerSecond(0.0, 1000000);
+    double timeout = messagesPerSecond(10000.0, 1000000);
+    printf("messages received per second without timeout: %.0f\n", noTimeout);
+    printf("messages received per second with timeout: %.0f\n", timeout);
+} END_TEST
+
+#define FIELD_COUNT 100
+
+UA_NodeId fieldReader;
+UA_NodeId targets[FIELD_COUNT];
+
+static void
+addTargetVariable(size_t i) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 zero = 0;
+    UA_Variant_setScalar(&attr.value, &zero, &UA_TYPES[UA_TYPES_INT32]);
+    attr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    attr.valueRank = UA_VALUERANK_SCALAR;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    targets[i] = UA_NODEID_NUMERIC(1, (UA_UInt32)(1000000 + i));
+    char name[32];
+    snprintf(name, sizeof(name), "Target %u", (unsigned)i);
+    UA_StatusCode retval =
+        UA_Server_addVariableNode(server, targets[i],
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, name),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void setupTargets(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_Server_run_startup(server);
+
+    UA_PubSubConnectionConfig connectionConfig;
+    memset(&connectionConfig, 0, sizeof(UA_PubSubConnectionConfig));
+    connectionConfig.name = UA_STRING("UADP Connection");
+    UA_NetworkAddressUrlDataType networkAddressUrl = {UA_STRING_NULL, UA_STRING("opc.udp://224.0.0.22:4840/")};
+    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl,
+                         &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    connectionConfig.transportProfileUri = UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    UA_StatusCode retval =
+        UA_Server_addPubSubConnection(server, &connectionConfig, &connection1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_ReaderGroupConfig readerGroupConfig;
+    memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+    readerGroupConfig.name = UA_STRING("ReaderGroup 1");
+    retval = UA_Server_addReaderGroup(server, connection1, &readerGroupConfig, &readerGroup1);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* A Reader with Int32 fields that are written into target variables */
+    UA_FieldMetaData fields[FIELD_COUNT];
+    UA_FieldTargetDataType tvs[FIELD_COUNT];
+    for(size_t i = 0; i < FIELD_COUNT; i++) {
+        addTargetVariable(i);
+        UA_FieldMetaData_init(&fields[i]);
+        fields[i].dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+        fields[i].builtInType = UA_NS0ID_INT32;
+        fields[i].valueRank = UA_VALUERANK_SCALAR;
+        UA_FieldTargetDataType_init(&tvs[i]);
+        tvs[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        tvs[i].targetNodeId = targets[i];
+    }
+
+    UA_DataSetReaderConfig readerConfig;
+    memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+    readerConfig.name = UA_STRING("DataSetReader");
+    readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+    readerConfig.writerGroupId = WRITER_GROUP_ID;
+    readerConfig.dataSetWriterId = 1;
+    readerConfig.dataSetMetaData.fieldsSize = FIELD_COUNT;
+    readerConfig.dataSetMetaData.fields = fields;
+    readerConfig.subscribedDataSetType = UA_PUBSUB_SDS_TARGET;
+    readerConfig.subscribedDataSet.target.targetVariablesSize = FIELD_COUNT;
+    readerConfig.subscribedDataSet.target.targetVariables = tvs;
+    retval = UA_Server_addDataSetReader(server, readerGroup1,
+                                        &readerConfig, &fieldReader);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    retval = UA_Server_enableAllPubSubComponents(server);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+static void
+setFieldValues(UA_DataValue *values, UA_Int32 *data, UA_Int32 v) {
+    for(size_t i = 0; i < FIELD_COUNT; i++) {
+        data[i] = v;
+        UA_DataValue_init(&values[i]);
+        UA_Variant_setScalar(&values[i].value, &data[i], &UA_TYPES[UA_TYPES_INT32]);
+        values[i].hasValue = true;
+    }
+}
+
+static UA_Int32
+readTarget(size_t i) {
+    UA_Variant out;
+    UA_StatusCode retval = UA_Server_readValue(server, targets[i], &out);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&out, &UA_TYPES[UA_TYPES_INT32]));
+    UA_Int32 v = *(UA_Int32*)out.data;
+    UA_Variant_clear(&out);
+    return v;
+}
+
+static void
+processFields(UA_NetworkMessage *nm) {
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    ck_assert(rg != NULL);
+    ck_assert(UA_ReaderGroup_process(psm, rg, nm));
+    unlockServer(server);
+}
+
+START_TEST(TargetDeletedTest) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = 1;
+    UA_DataValue values[FIELD_COUNT];
+    UA_Int32 data[FIELD_COUNT];
+    dsm.fieldCount = FIELD_COUNT;
+    dsm.data.keyFrameFields = values;
+
+    /* Resolved with the first message */
+    setFieldValues(values, data, 1);
+    processFields(&nm);
+    ck_assert_int_eq(readTarget(0), 1);
+    ck_assert_int_eq(readTarget(FIELD_COUNT - 1), 1);
+    UA_DataSetReader *dsr = UA_DataSetReader_find(getPSM(server), fieldReader);
+    ck_assert(dsr->targets != NULL);
+    ck_assert(dsr->targets[0].node != NULL);
+
+    /* The deleted target is detected. The other fields are still written. */
+    UA_StatusCode retval = UA_Server_deleteNode(server, targets[0], true);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    setFieldValues(values, data, 2);
+    processFields(&nm);
+    ck_assert(dsr->targets[0].node == NULL);
+    ck_assert_int_eq(readTarget(FIELD_COUNT - 1), 2);
+
+    /* A new node with the same NodeId becomes the target */
+    addTargetVariable(0);
+    setFieldValues(values, data, 3);
+    processFields(&nm);
+    ck_assert(dsr->targets[0].node != NULL);
+    ck_assert_int_eq(readTarget(0), 3);
+
+    /* The wrong type is rejected also after the type was checked */
+    UA_Double d = 4.0;
+    UA_Variant_setScalar(&values[0].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+    processFields(&nm);
+    ck_assert_int_eq(readTarget(0), 3);
+
+    /* The targets are released when the Reader is disabled */
+    retval = UA_Server_disableDataSetReader(server, fieldReader);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(dsr->targets == NULL);
+} END_TEST
+
+static double
+fieldsPerSecond(UA_NetworkMessage *nm, size_t messages) {
+    UA_PubSubManager *psm = getPSM(server);
+    lockServer(server);
+    UA_ReaderGroup *rg = UA_ReaderGroup_find(psm, readerGroup1);
+    clock_t begin = clock();
+    for(size_t i = 0; i < messages; i++)
+        UA_ReaderGroup_process(psm, rg, nm);
+    clock_t finish = clock();
+    unlockServer(server);
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    return (double)(messages * FIELD_COUNT) / time_spent;
+}
+
+START_TEST(TargetWriteSpeedTest) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = 1;
+    UA_DataValue values[FIELD_COUNT];
+    UA_Int32 data[FIELD_COUNT];
+    dsm.fieldCount = FIELD_COUNT;
+    dsm.data.keyFrameFields = values;
+    setFieldValues(values, data, 42);
+
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->pubSubConfig.enableDirectTargetWrites = false;
+    double writeService = fieldsPerSecond(&nm, 20000);
+    config->pubSubConfig.enableDirectTargetWrites = true;
+    double direct = fieldsPerSecond(&nm, 20000);
+
+    printf("fields written per second via the Write service: %.0f\n", writeService);
+    printf("fields written per second into resolved targets: %.0f\n", direct);
+    ck_assert_int_eq(readTarget(0), 42);
+} END_TEST
+
+static void
+processKeyFrame(UA_UInt16 seq, UA_Int32 v) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = 1;
+    UA_DataValue values[FIELD_COUNT];
+    UA_Int32 data[FIELD_COUNT];
+    setFieldValues(values, data, v);
+    dsm.header.dataSetMessageSequenceNrEnabled = true;
+    dsm.header.dataSetMessageSequenceNr = seq;
+    dsm.fieldCount = FIELD_COUNT;
+    dsm.data.keyFrameFields = values;
+    processFields(&nm);
+}
+
+static void
+processDeltaFrame(UA_UInt16 seq, UA_UInt16 index, UA_Int32 v) {
+    UA_NetworkMessage nm;
+    UA_DataSetMessage dsm;
+    initNetworkMessage(&nm, &dsm);
+    nm.dataSetWriterIds[0] = 1;
+    UA_DataSetMessage_DeltaFrameField field;
+    memset(&field, 0, sizeof(UA_DataSetMessage_DeltaFrameField));
+    field.index = index;
+    UA_Variant_setScalar(&field.value.value, &v, &UA_TYPES[UA_TYPES_INT32]);
+    field.value.hasValue = true;
+    dsm.header.dataSetMessageType = UA_DATASETMESSAGE_DATADELTAFRAME;
+    dsm.header.dataSetMessageSequenceNrEnabled = true;
+    dsm.header.dataSetMessageSequenceNr = seq;
+    dsm.fieldCount = 1;
+    dsm.data.deltaFrameFields = &field;
+    processFields(&nm);
+}
+
+START_TEST(DeltaFrameLossTest) {
+    /* DeltaFrames before the first KeyFrame are discarded */
+    processDeltaFrame(1, 5, 7);
+    ck_assert_int_eq(readTarget(5), 0);
+
+    /* DeltaFrames are applied on top of the KeyFrame */
+    processKeyFrame(2, 1);
+    ck_assert_int_eq(readTarget(5), 1);
+    processDeltaFrame(3, 5, 7);
+    ck_assert_int_eq(readTarget(5), 7);
+    ck_assert_int_eq(readTarget(6), 1);
+
+    /* Duplicates are discarded */
+    processDeltaFrame(3, 5, 8);
+    ck_assert_int_eq(readTarget(5), 7);
+
+    /* Message 4 was lost. Wait for the next KeyFrame. */
+    processDeltaFrame(5, 5, 9);
+    ck_assert_int_eq(readTarget(5), 7);
+    processDeltaFrame(6, 6, 9);
+    ck_assert_int_eq(readTarget(6), 1);
+
+    /* Message 4 arrives late and is discarded */
+    processDeltaFrame(4, 6, 10);
+    ck_assert_int_eq(readTarget(6), 1);
+
+    /* The next KeyFrame resynchronizes */
+    processKeyFrame(7, 2);
+    ck_assert_int_eq(readTarget(5), 2);
+    processDeltaFrame(8, 5, 11);
+    ck_assert_int_eq(readTarget(5), 11);
+
+    /* A reordered KeyFrame is discarded as well */
+    processKeyFrame(6, 3);
+    ck_assert_int_eq(readTarget(0), 2);
+
+    /* The SequenceNumber rolls over */
+    UA_DataSetReader *dsr = UA_DataSetReader_find(getPSM(server), fieldReader);
+    dsr->lastSequenceNr = UA_UINT16_MAX;
+    processDeltaFrame(0, 5, 12);
+    ck_assert_int_eq(readTarget(5), 12);
+
+    /* Waiting for a new KeyFrame after the Reader was disabled */
+    UA_StatusCode retval = UA_Server_disableDataSetReader(server, fieldReader);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Server_enableDataSetReader(server, fieldReader);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    processDeltaFrame(1, 5, 13);
+    ck_assert_int_eq(readTarget(5), 12);
+} END_TEST
+
+START_TEST(DeltaFrameWriterTest) {
+    /* PublishedDataSet with four fields sampled from the target variables */
+    UA_PublishedDataSetConfig pdsConfig;
+    memset(&pdsConfig, 0, sizeof(UA_PublishedDataSetConfig));
+    pdsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
+    pdsConfig.name = UA_STRING("PublishedDataSet");
+    UA_NodeId pdsId;
+    UA_StatusCode retval =
+        UA_Server_addPublishedDataSet(server, &pdsConfig, &pdsId).addResult;
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 4; i++) {
+        UA_DataSetFieldConfig fieldConfig;
+        memset(&fieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+        fieldConfig.dataSetFieldType = UA_PUBSUB_DATASETFIELD_VARIABLE;
+        fieldConfig.field.variable.fieldNameAlias = UA_STRING("Field");
+        fieldConfig.field.variable.publishParameters.publishedVariable = targets[i];
+        fieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+        UA_NodeId fieldId;
+        retval = UA_Server_addDataSetField(server, pdsId, &fieldConfig, &fieldId).result;
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    UA_WriterGroupConfig writerGroupConfig;
+    memset(&writerGroupConfig, 0, sizeof(UA_WriterGroupConfig));
+    writerGroupConfig.name = UA_STRING("WriterGroup");
+    writerGroupConfig.publishingInterval = 100;
+    writerGroupConfig.writerGroupId = WRITER_GROUP_ID;
+    UA_NodeId writerGroup;
+    retval = UA_Server_addWriterGroup(server, connection1, &writerGroupConfig, &writerGroup);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Every third DataSetMessage is a KeyFrame */
+    UA_UadpDataSetWriterMessageDataType uadpConfig;
+    memset(&uadpConfig, 0, sizeof(UA_UadpDataSetWriterMessageDataType));
+    uadpConfig.dataSetMessageContentMask = UA_UADPDATASETMESSAGECONTENTMASK_SEQUENCENUMBER;
+    UA_DataSetWriterConfig writerConfig;
+    memset(&writerConfig, 0, sizeof(UA_DataSetWriterConfig));
+    writerConfig.name = UA_STRING("DataSetWriter");
+    writerConfig.dataSetWriterId = 1;
+    writerConfig.keyFrameCount = 3;
+    UA_ExtensionObject_setValue(&writerConfig.messageSettings, &uadpConfig,
+                                &UA_TYPES[UA_TYPES_UADPDATASETWRITERMESSAGEDATATYPE]);
+    UA_NodeId writerId;
+    retval = UA_Server_addDataSetWriter(server, writerGroup, pdsId,
+                                        &writerConfig, &writerId);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_PubSubManager *psm = getPSM(server);
+    UA_DataSetMessage dsm;
+    UA_Int32 v = 0;
+    UA_Variant value;
+    UA_Variant_setScalar(&value, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_DataSetMessageType expectedType[6] = {
+        UA_DATASETMESSAGE_DATAKEYFRAME, UA_DATASETMESSAGE_DATADELTAFRAME,
+        UA_DATASETMESSAGE_DATADELTAFRAME, UA_DATASETMESSAGE_DATAKEYFRAME,
+        UA_DATASETMESSAGE_DATADELTAFRAME, UA_DATASETMESSAGE_DATADELTAFRAME};
+    UA_UInt16 expectedFields[6] = {4, 1, 0, 4, 2, 0};
+    for(UA_UInt16 i = 0; i < 6; i++) {
+        /* Change one field before the first DeltaFrame and two fields before
+         * the second DeltaFrame */
+        v = 10 * i;
+        if(i == 1 || i == 4)
+            UA_Server_writeValue(server, targets[2], value);
+        if(i == 4)
+            UA_Server_writeValue(server, targets[3], value);
+
+        lockServer(server);
+        UA_DataSetWriter *dsw = UA_DataSetWriter_find(psm, writerId);
+        retval = UA_DataSetWriter_generateDataSetMessage(psm, dsw, &dsm);
+        unlockServer(server);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert_int_eq(dsm.header.dataSetMessageType, expectedType[i]);
+        ck_assert_int_eq(dsm.header.dataSetMessageSequenceNr, i);
+        ck_assert_int_eq(dsm.fieldCount, expectedFields[i]);
+        if(i == 1) {
+            ck_assert_int_eq(dsm.data.deltaFrameFields[0].index, 2);
+            ck_assert_int_eq(*(UA_Int32*)dsm.data.deltaFrameFields[0].value.value.data, 10);
+        }
+        if(i == 4) {
+            ck_assert_int_eq(dsm.data.deltaFrameFields[0].index, 2);
+            ck_assert_int_eq(dsm.data.deltaFrameFields[1].index, 3);
+        }
+        UA_DataSetMessage_clear(&dsm);
+    }
+} END_TEST
+
+int main(void) {
+    TCase *tc_subscribespeed = tcase_create("Speed of the subscriber");
+    tcase_add_checked_fixture(tc_subscribespeed, setup, teardown);
+    tcase_add_test(tc_subscribespeed, SubscribeDispatchTest);
+    tcase_add_test(tc_subscribespeed, SubscribeSpeedTest);
+    tcase_add_test(tc_subscribespeed, MessageReceiveTimeoutTest);
+    tcase_add_test(tc_subscribespeed, MessageReceiveTimeoutSpeedTest);
+
+    TCase *tc_samekey = tcase_create("Removing Readers during the dispatch");
+    tcase_add_checked_fixture(tc_samekey, setupSameKey, teardown);
+    tcase_add_test(tc_samekey, RemoveReadersDuringDispatchTest);
+
+    TCase *tc_targets = tcase_create("Writing into the target variables");
+    tcase_add_checked_fixture(tc_targets, setupTargets, teardown);
+    tcase_add_test(tc_targets, TargetDeletedTest);
+    tcase_add_test(tc_targets, TargetWriteSpeedTest);
+
+    TCase *tc_deltaframes = tcase_create("DeltaFrames");
+    tcase_add_checked_fixture(tc_deltaframes, setupTargets, teardown);
+    tcase_add_test(tc_deltaframes, DeltaFrameLossTest);
+    tcase_add_test(tc_deltaframes, DeltaFrameWriterTest);
+
+    Suite *s = suite_create("PubSub Subscriber Speed Test");
+    suite_add_tcase(s, tc_subscribespeed);
+    suite_add_tcase(s, tc_samekey);
+    suite_add_tcase(s, tc_targets);
+    suite_add_tcase(s, tc_deltaframes);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr,CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
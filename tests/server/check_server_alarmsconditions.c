@@ -7,10 +7,13 @@
 
 #include <open62541/server.h>
 #include <open62541/server_config_default.h>
+#include "server/ua_server_internal.h"
 #include "test_helpers.h"
 
 #include <check.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 UA_Server *server_ac;
 
@@ -122,6 +125,234 @@ START_TEST(splitCreation) {
 }
 END_TEST
 
+#define AC_BENCHMARK_CONDITIONS 1000
+
+static UA_StatusCode
+writeActiveState(const UA_NodeId condition, UA_Boolean active) {
+    UA_Variant value;
+    UA_Variant_setScalar(&value, &active, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    return UA_Server_setConditionVariableFieldProperty(server_ac, condition, &value,
+                                                       UA_QUALIFIEDNAME(0, "ActiveState"),
+                                                       UA_QUALIFIEDNAME(0, "Id"));
+}
+
+START_TEST(toggleActiveStateBenchmark) {
+    UA_NodeId *conditions = (UA_NodeId*)
+        UA_Array_new(AC_BENCHMARK_CONDITIONS, &UA_TYPES[UA_TYPES_NODEID]);
+    ck_assert_ptr_ne(conditions, NULL);
+
+    for(size_t i = 0; i < AC_BENCHMARK_CONDITIONS; i++) {
+        UA_StatusCode retval =
+            UA_Server_createCondition(server_ac, UA_NODEID_NULL,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OFFNORMALALARMTYPE),
+                                      UA_QUALIFIEDNAME(0, "Condition benchmark"),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                      UA_NODEID_NULL, &conditions[i]);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        /* Enable and retain the condition so that activating triggers an event */
+        UA_Boolean enabled = true;
+        UA_Variant value;
+        UA_Variant_setScalar(&value, &enabled, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        retval = UA_Server_setConditionVariableFieldProperty(server_ac, conditions[i], &value,
+                                                             UA_QUALIFIEDNAME(0, "EnabledState"),
+                                                             UA_QUALIFIEDNAME(0, "Id"));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        retval = UA_Server_setConditionField(server_ac, conditions[i], &value,
+                                             UA_QUALIFIEDNAME(0, "Retain"));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < AC_BENCHMARK_CONDITIONS; i++) {
+        ck_assert_uint_eq(writeActiveState(conditions[i], true), UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(writeActiveState(conditions[i], false), UA_STATUSCODE_GOOD);
+    }
+    double duration = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    printf("Toggling ActiveState of %u conditions: %f us per transition\n",
+           AC_BENCHMARK_CONDITIONS, duration * 1e6 / (2 * AC_BENCHMARK_CONDITIONS));
+
+    /* The ActiveState text follows the Id */
+    UA_Variant text;
+    UA_StatusCode retval =
+        UA_Server_readObjectProperty(server_ac, conditions[0],
+                                     UA_QUALIFIEDNAME(0, "ActiveState"), &text);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&text, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]));
+    UA_String inactive = UA_STRING("Inactive");
+    ck_assert(UA_String_equal(&((UA_LocalizedText*)text.data)->text, &inactive));
+    UA_Variant_clear(&text);
+
+    UA_Array_delete(conditions, AC_BENCHMARK_CONDITIONS, &UA_TYPES[UA_TYPES_NODEID]);
+} END_TEST
+
+static size_t refreshStartEvents;
+static size_t refreshEndEvents;
+static size_t conditionEvents;
+
+static void
+refreshEventCallback(UA_Server *server, UA_UInt32 monitoredItemId,
+                     void *monitoredItemContext, const UA_KeyValueMap eventFields) {
+    const UA_NodeId *eventType = (const UA_NodeId*)
+        UA_KeyValueMap_getScalar(&eventFields, UA_QUALIFIEDNAME(0, "/EventType"),
+                                 &UA_TYPES[UA_TYPES_NODEID]);
+    ck_assert_ptr_ne(eventType, NULL);
+    UA_NodeId startType = UA_NODEID_NUMERIC(0, UA_NS0ID_REFRESHSTARTEVENTTYPE);
+    UA_NodeId endType = UA_NODEID_NUMERIC(0, UA_NS0ID_REFRESHENDEVENTTYPE);
+    if(UA_NodeId_equal(eventType, &startType))
+        refreshStartEvents++;
+    else if(UA_NodeId_equal(eventType, &endType))
+        refreshEndEvents++;
+    else
+        conditionEvents++;
+}
+
+/* Create the conditions and trigger an event for each. Only the first
+ * retainedCount conditions are retained. Returns the Id of the local Event
+ * MonitoredItem on the Server object. The ConditionIds are written to
+ * conditions if it is not NULL. */
+static UA_UInt32
+setupRefresh(size_t conditionCount, size_t retainedCount, UA_NodeId *conditions) {
+    UA_ServerConfig *config = UA_Server_getConfig(server_ac);
+    config->queueSizeLimits.max = (UA_UInt32)conditionCount + 2;
+    UA_Server_run_startup(server_ac);
+
+    for(size_t i = 0; i < conditionCount; i++) {
+        UA_NodeId condition;
+        UA_StatusCode retval =
+            UA_Server_createCondition(server_ac, UA_NODEID_NULL,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OFFNORMALALARMTYPE),
+                                      UA_QUALIFIEDNAME(0, "Condition refresh"),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                      UA_NODEID_NULL, &condition);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        if(conditions)
+            conditions[i] = condition;
+
+        UA_Boolean enabled = true;
+        UA_Variant value;
+        UA_Variant_setScalar(&value, &enabled, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        retval = UA_Server_setConditionVariableFieldProperty(server_ac, condition, &value,
+                                                             UA_QUALIFIEDNAME(0, "EnabledState"),
+                                                             UA_QUALIFIEDNAME(0, "Id"));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        UA_Boolean retain = (i < retainedCount);
+        UA_Variant_setScalar(&value, &retain, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        retval = UA_Server_setConditionField(server_ac, condition, &value,
+                                             UA_QUALIFIEDNAME(0, "Retain"));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        retval = UA_Server_triggerConditionEvent(server_ac, condition,
+                                                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                                 NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    UA_EventFilter ef;
+    UA_EventFilter_init(&ef);
+    UA_SimpleAttributeOperand eventTypeClause;
+    UA_SimpleAttributeOperand_parse(&eventTypeClause, UA_STRING("/EventType"));
+    ef.selectClauses = &eventTypeClause;
+    ef.selectClausesSize = 1;
+    UA_MonitoredItemCreateResult res =
+        UA_Server_createEventMonitoredItem(server_ac, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                           ef, NULL, refreshEventCallback);
+    UA_SimpleAttributeOperand_clear(&eventTypeClause);
+    ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+
+    refreshStartEvents = 0;
+    refreshEndEvents = 0;
+    conditionEvents = 0;
+    return res.monitoredItemId;
+}
+
+static UA_StatusCode
+conditionRefresh2(UA_UInt32 monitoredItemId) {
+    UA_Variant input[2];
+    UA_UInt32 subscriptionId = server_ac->adminSubscription->subscriptionId;
+    UA_Variant_setScalar(&input[0], &subscriptionId, &UA_TYPES[UA_TYPES_UINT32]);
+    UA_Variant_setScalar(&input[1], &monitoredItemId, &UA_TYPES[UA_TYPES_UINT32]);
+    UA_CallMethodRequest req;
+    UA_CallMethodRequest_init(&req);
+    req.objectId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE);
+    req.methodId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE_CONDITIONREFRESH2);
+    req.inputArguments = input;
+    req.inputArgumentsSize = 2;
+    UA_CallMethodResult res = UA_Server_call(server_ac, &req);
+    UA_StatusCode retval = res.statusCode;
+    UA_CallMethodResult_clear(&res);
+    return retval;
+}
+
+START_TEST(conditionRefreshRetained) {
+    UA_UInt32 monId = setupRefresh(10, 3, NULL);
+
+    ck_assert_uint_eq(conditionRefresh2(monId), UA_STATUSCODE_GOOD);
+    UA_Server_run_iterate(server_ac, false);
+    ck_assert_uint_eq(refreshStartEvents, 1);
+    ck_assert_uint_eq(refreshEndEvents, 1);
+    ck_assert_uint_eq(conditionEvents, 3);
+
+    /* Unknown MonitoredItem */
+    ck_assert_uint_eq(conditionRefresh2(monId + 1000),
+                      UA_STATUSCODE_BADMONITOREDITEMIDINVALID);
+
+    UA_Server_run_shutdown(server_ac);
+} END_TEST
+
+/* Retain is written directly to the property node and not with
+ * UA_Server_setConditionField */
+START_TEST(conditionRefreshRetainWritten) {
+    UA_NodeId conditions[10];
+    UA_UInt32 monId = setupRefresh(10, 3, conditions);
+
+    UA_Boolean retain = true;
+    UA_StatusCode retval =
+        UA_Server_writeObjectProperty_scalar(server_ac, conditions[5],
+                                             UA_QUALIFIEDNAME(0, "Retain"),
+                                             &retain, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Server_writeObjectProperty_scalar(server_ac, conditions[6],
+                                                  UA_QUALIFIEDNAME(0, "Retain"),
+                                                  &retain, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retain = false;
+    retval = UA_Server_writeObjectProperty_scalar(server_ac, conditions[0],
+                                                  UA_QUALIFIEDNAME(0, "Retain"),
+                                                  &retain, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Retained: 1, 2, 5, 6 */
+    ck_assert_uint_eq(conditionRefresh2(monId), UA_STATUSCODE_GOOD);
+    UA_Server_run_iterate(server_ac, false);
+    ck_assert_uint_eq(refreshStartEvents, 1);
+    ck_assert_uint_eq(refreshEndEvents, 1);
+    ck_assert_uint_eq(conditionEvents, 4);
+
+    UA_Server_run_shutdown(server_ac);
+} END_TEST
+
+#define AC_REFRESH_BENCHMARK_CONDITIONS 1000
+#define AC_REFRESH_BENCHMARK_RETAINED 100
+
+START_TEST(conditionRefreshBenchmark) {
+    UA_UInt32 monId = setupRefresh(AC_REFRESH_BENCHMARK_CONDITIONS,
+                                   AC_REFRESH_BENCHMARK_RETAINED, NULL);
+
+    clock_t begin = clock();
+    ck_assert_uint_eq(conditionRefresh2(monId), UA_STATUSCODE_GOOD);
+    double duration = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    printf("ConditionRefresh with %u retained of %u conditions: %f ms\n",
+           AC_REFRESH_BENCHMARK_RETAINED, AC_REFRESH_BENCHMARK_CONDITIONS,
+           duration * 1e3);
+
+    UA_Server_run_iterate(server_ac, false);
+    ck_assert_uint_eq(conditionEvents, AC_REFRESH_BENCHMARK_RETAINED);
+
+    UA_Server_run_shutdown(server_ac);
+} END_TEST
+
 #endif
 
 int main(void) {
@@ -131,6 +362,10 @@ int main(void) {
 #ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
     tcase_add_test(tc_call, createDelete);
     tcase_add_test(tc_call, splitCreation);
+    tcase_add_test(tc_call, toggleActiveStateBenchmark);
+    tcase_add_test(tc_call, conditionRefreshRetained);
+    tcase_add_test(tc_call, conditionRefreshRetainWritten);
+    tcase_add_test(tc_call, conditionRefreshBenchmark);
 #endif
     tcase_add_checked_fixture(tc_call, setup, teardown);
 
@@ -10,6 +10,9 @@
 #include <open62541/client_highlevel.h>
 #include <open62541/plugin/historydata/history_data_backend.h>
 #include <open62541/plugin/historydata/history_data_backend_memory.h>
+#ifdef UA_ARCHITECTURE_POSIX
+#include <open62541/plugin/historydata/history_data_backend_file.h>
+#endif
 #include <open62541/plugin/historydata/history_data_gathering_default.h>
 #include <open62541/plugin/historydata/history_database_default.h>
 #include <open62541/plugin/historydatabase.h>
@@ -203,9 +206,9 @@ resultIsEqual(const UA_DataValue * result, const testTuple * tuple, size_t index
 }
 
 static UA_Boolean
-fillHistoricalDataBackend(UA_HistoryDataBackend backend) {
+fillHistoricalDataBackend(UA_HistoryDataBackend backend, const UA_DateTime *data) {
     int i = 0;
-    UA_DateTime currentDateTime = testData[i];
+    UA_DateTime currentDateTime = data[i];
     fprintf(stderr, "Adding to historical data backend: ");
     while (currentDateTime) {
         fprintf(stderr, "%lld, ", currentDateTime / UA_DATETIME_SEC);
@@ -225,7 +228,7 @@ fillHistoricalDataBackend(UA_HistoryDataBackend backend) {
             return false;
         }
         UA_DataValue_clear(&value);
-        currentDateTime = testData[++i];
+        currentDateTime = data[++i];
     }
     fprintf(stderr, "\n");
     return true;
@@ -571,7 +574,7 @@ START_TEST(Server_HistorizingUpdateDelete)
     ck_assert_str_eq(UA_StatusCode_name(ret), UA_StatusCode_name(UA_STATUSCODE_GOOD));
 
     // fill backend
-    ck_assert_uint_eq(fillHistoricalDataBackend(backend), true);
+    ck_assert_uint_eq(fillHistoricalDataBackend(backend, testData), true);
 
     // delete some values
     ck_assert_str_eq(UA_StatusCode_name(deleteHistory(DELETE_START_TIME, DELETE_STOP_TIME)),
@@ -905,7 +908,7 @@ START_TEST(Server_HistorizingBackendMemory)
     fprintf(stderr, "%x tests expected failed.\n", retval);
 
     // fill backend
-    ck_assert_uint_eq(fillHistoricalDataBackend(backend), true);
+    ck_assert_uint_eq(fillHistoricalDataBackend(backend, testData), true);
 
     // read all in one
     retval = testHistoricalDataBackend(100);
@@ -925,6 +928,59 @@ START_TEST(Server_HistorizingBackendMemory)
 }
 END_TEST
 
+#ifdef UA_ARCHITECTURE_POSIX
+START_TEST(Server_HistorizingBackendFile)
+{
+    char dir[] = "/tmp/open62541_historyXXXXXX";
+    ck_assert_ptr_ne(mkdtemp(dir), NULL);
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 0, 0);
+    ck_assert_ptr_ne(backend.context, NULL);
+    UA_HistorizingNodeIdSettings setting;
+    setting.historizingBackend = backend;
+    setting.maxHistoryDataResponseSize = 1000;
+    setting.historizingUpdateStrategy = UA_HISTORIZINGUPDATESTRATEGY_USER;
+    UA_StatusCode ret = gathering->registerNodeId(server, gathering->context, &outNodeId, setting);
+    ck_assert_str_eq(UA_StatusCode_name(ret), UA_StatusCode_name(UA_STATUSCODE_GOOD));
+
+    // empty backend should not crash
+    UA_UInt32 retval = testHistoricalDataBackend(100);
+    fprintf(stderr, "%x tests expected failed.\n", retval);
+
+    // the backend is append-only and requires sorted input
+    ck_assert_uint_eq(fillHistoricalDataBackend(backend, testDataSorted), true);
+
+    // read all in one
+    retval = testHistoricalDataBackend(100);
+    fprintf(stderr, "%x tests failed.\n", retval);
+    ck_assert_uint_eq(retval, 0);
+
+    // read continuous one at one request
+    retval = testHistoricalDataBackend(1);
+    fprintf(stderr, "%x tests failed.\n", retval);
+    ck_assert_uint_eq(retval, 0);
+
+    // read continuous two at one request
+    retval = testHistoricalDataBackend(2);
+    fprintf(stderr, "%x tests failed.\n", retval);
+    ck_assert_uint_eq(retval, 0);
+    UA_HistoryDataBackend_File_clear(&setting.historizingBackend);
+
+    // the values are restored from the segment files
+    backend = UA_HistoryDataBackend_File(dir, 0, 0);
+    setting.historizingBackend = backend;
+    gathering->updateNodeIdSetting(server, gathering->context, &outNodeId, setting);
+    retval = testHistoricalDataBackend(100);
+    fprintf(stderr, "%x tests failed.\n", retval);
+    ck_assert_uint_eq(retval, 0);
+    UA_HistoryDataBackend_File_clear(&setting.historizingBackend);
+
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    ck_assert_int_eq(system(cmd), 0);
+}
+END_TEST
+#endif
+
 START_TEST(Server_HistorizingRandomIndexBackend)
 {
     UA_HistoryDataBackend backend = UA_HistoryDataBackend_randomindextest(testData);
@@ -962,6 +1018,9 @@ testSuite_Client(void) {
     tcase_add_test(tc_server, Server_HistorizingStrategyUser);
     tcase_add_test(tc_server, Server_HistorizingStrategyValueSet);
     tcase_add_test(tc_server, Server_HistorizingBackendMemory);
+#ifdef UA_ARCHITECTURE_POSIX
+    tcase_add_test(tc_server, Server_HistorizingBackendFile);
+#endif
     tcase_add_test(tc_server, Server_HistorizingRandomIndexBackend);
     tcase_add_test(tc_server, Server_HistorizingUpdateDelete);
     tcase_add_test(tc_server, Server_HistorizingUpdateInsert);
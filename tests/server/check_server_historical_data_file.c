@@ -0,0 +1,438 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <open62541/plugin/historydata/history_data_backend_file.h>
+
+#include <check.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Size of the samples in the segment files (record header + encoded value) */
+#define SAMPLE_SIZE 40
+#define LARGE_SAMPLES 100000
+#define READ_CHUNK 10000
+
+static char dir[64];
+static UA_NodeId nodeId;
+
+/* Run on tmpfs if possible */
+static void setup(void) {
+    struct stat st;
+    const char *base = (stat("/dev/shm", &st) == 0) ? "/dev/shm" : "/tmp";
+    snprintf(dir, sizeof(dir), "%s/open62541_historyXXXXXX", base);
+    ck_assert_ptr_ne(mkdtemp(dir), NULL);
+    nodeId = UA_NODEID_STRING(1, "Plant/Line4.Cell2:Drive7");
+}
+
+/* The backend creates only the segment files in the directory */
+static void teardown(void) {
+    DIR *d = opendir(dir);
+    ck_assert_ptr_ne(d, NULL);
+    char path[512];
+    struct dirent *ent;
+    while((ent = readdir(d))) {
+        if(strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        ck_assert_int_eq(unlink(path), 0);
+    }
+    closedir(d);
+    ck_assert_int_eq(rmdir(dir), 0);
+}
+
+static UA_StatusCode
+addSample(UA_HistoryDataBackend *backend, UA_UInt32 value) {
+    UA_DataValue dv;
+    UA_DataValue_init(&dv);
+    UA_Variant_setScalar(&dv.value, &value, &UA_TYPES[UA_TYPES_UINT32]);
+    dv.hasValue = true;
+    dv.sourceTimestamp = (UA_DateTime)value * UA_DATETIME_MSEC;
+    dv.hasSourceTimestamp = true;
+    return backend->serverSetHistoryData(NULL, backend->context, NULL, NULL,
+                                         &nodeId, true, &dv);
+}
+
+static size_t
+countRecords(UA_HistoryDataBackend *backend) {
+    return backend->getEnd(NULL, backend->context, NULL, NULL, &nodeId) -
+        backend->firstIndex(NULL, backend->context, NULL, NULL, &nodeId);
+}
+
+static UA_UInt32
+valueAt(UA_HistoryDataBackend *backend, size_t index) {
+    const UA_DataValue *dv =
+        backend->getDataValue(NULL, backend->context, NULL, NULL, &nodeId, index);
+    ck_assert_ptr_ne(dv, NULL);
+    ck_assert(dv->value.type == &UA_TYPES[UA_TYPES_UINT32]);
+    return *(UA_UInt32*)dv->value.data;
+}
+
+static size_t
+countSegments(void) {
+    DIR *d = opendir(dir);
+    ck_assert_ptr_ne(d, NULL);
+    size_t count = 0;
+    struct dirent *ent;
+    while((ent = readdir(d))) {
+        if(strstr(ent->d_name, ".seg"))
+            count++;
+    }
+    closedir(d);
+    return count;
+}
+
+/* Returns the path of the segment file with the highest sequence number */
+static void
+lastSegment(char *path, size_t pathSize) {
+    DIR *d = opendir(dir);
+    ck_assert_ptr_ne(d, NULL);
+    char name[256] = {0};
+    struct dirent *ent;
+    while((ent = readdir(d))) {
+        if(strstr(ent->d_name, ".seg") && strcmp(ent->d_name, name) > 0)
+            snprintf(name, sizeof(name), "%s", ent->d_name);
+    }
+    closedir(d);
+    ck_assert(name[0] != 0);
+    snprintf(path, pathSize, "%s/%s", dir, name);
+}
+
+START_TEST(File_restore) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 4096, 0);
+    ck_assert_ptr_ne(backend.context, NULL);
+    for(UA_UInt32 i = 0; i < 1000; i++)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(countRecords(&backend), 1000);
+    ck_assert_uint_gt(countSegments(), 1);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    backend = UA_HistoryDataBackend_File(dir, 4096, 0);
+    ck_assert_uint_eq(countRecords(&backend), 1000);
+    for(size_t i = 0; i < 1000; i++)
+        ck_assert_uint_eq(valueAt(&backend, i), i);
+
+    /* Append after the restore */
+    ck_assert_uint_eq(addSample(&backend, 1000), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(valueAt(&backend, 1000), 1000);
+
+    /* Older values are rejected */
+    ck_assert_uint_ne(addSample(&backend, 10), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(countRecords(&backend), 1001);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+START_TEST(File_dateTimeMatch) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 4096, 0);
+    /* Only even timestamps */
+    for(UA_UInt32 i = 0; i < 2000; i += 2)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+    size_t end = backend.getEnd(NULL, backend.context, NULL, NULL, &nodeId);
+    ck_assert_uint_eq(end, 1000);
+
+    for(UA_UInt32 i = 0; i < 2000; i++) {
+        UA_DateTime t = (UA_DateTime)i * UA_DATETIME_MSEC;
+        size_t eq = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                             &nodeId, t, MATCH_EQUAL);
+        size_t after = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                                &nodeId, t, MATCH_AFTER);
+        size_t eqAfter = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                                  &nodeId, t, MATCH_EQUAL_OR_AFTER);
+        size_t before = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                                 &nodeId, t, MATCH_BEFORE);
+        size_t eqBefore = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                                   &nodeId, t, MATCH_EQUAL_OR_BEFORE);
+        if(i % 2 == 0) {
+            ck_assert_uint_eq(eq, i / 2);
+            ck_assert_uint_eq(eqAfter, i / 2);
+            ck_assert_uint_eq(eqBefore, i / 2);
+            ck_assert_uint_eq(after, (i / 2) + 1);
+            ck_assert_uint_eq(before, (i == 0) ? end : (i / 2) - 1);
+        } else {
+            ck_assert_uint_eq(eq, end);
+            ck_assert_uint_eq(eqAfter, (i / 2) + 1);
+            ck_assert_uint_eq(after, (i / 2) + 1);
+            ck_assert_uint_eq(eqBefore, i / 2);
+            ck_assert_uint_eq(before, i / 2);
+        }
+    }
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+START_TEST(File_truncatedTail) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 1 << 16, 0);
+    for(UA_UInt32 i = 0; i < 100; i++)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    /* Simulate a torn write of the last record. The length is committed but
+     * the payload is not completely written. */
+    char path[256];
+    lastSegment(path, sizeof(path));
+    int fd = open(path, O_RDWR);
+    ck_assert_int_ge(fd, 0);
+    struct stat st;
+    ck_assert_int_eq(fstat(fd, &st), 0);
+    UA_Byte *data = (UA_Byte*)mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED, fd, 0);
+    ck_assert(data != MAP_FAILED);
+    close(fd);
+    /* Find the record of the last sample */
+    size_t last = 0;
+    for(size_t i = 16; i + 16 < (size_t)st.st_size; i += 8) {
+        UA_UInt32 len;
+        UA_DateTime t;
+        memcpy(&len, &data[i], 4);
+        memcpy(&t, &data[i + 8], 8);
+        if(len > 0 && len < 64 && t == 99 * UA_DATETIME_MSEC) {
+            last = i;
+            break;
+        }
+    }
+    ck_assert_uint_gt(last, 0);
+    data[last + 16 + 5] ^= 0xff;
+    /* Garbage after the torn record is never interpreted */
+    memset(&data[last + 64], 0xab, 128);
+    munmap(data, (size_t)st.st_size);
+
+    /* The torn record is discarded */
+    backend = UA_HistoryDataBackend_File(dir, 1 << 16, 0);
+    ck_assert_uint_eq(countRecords(&backend), 99);
+    ck_assert_uint_eq(valueAt(&backend, 98), 98);
+
+    /* Appending continues at the position of the torn record */
+    for(UA_UInt32 i = 99; i < 120; i++)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    backend = UA_HistoryDataBackend_File(dir, 1 << 16, 0);
+    ck_assert_uint_eq(countRecords(&backend), 120);
+    for(size_t i = 0; i < 120; i++)
+        ck_assert_uint_eq(valueAt(&backend, i), i);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    /* A segment that was truncated by the file system is recovered as well */
+    lastSegment(path, sizeof(path));
+    ck_assert_int_eq(truncate(path, (off_t)(last + 20)), 0);
+    backend = UA_HistoryDataBackend_File(dir, 1 << 16, 0);
+    ck_assert_uint_eq(countRecords(&backend), 99);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+START_TEST(File_retention) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 4096, 3);
+    for(UA_UInt32 i = 0; i < 5000; i++)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(countSegments(), 3);
+
+    size_t first = backend.firstIndex(NULL, backend.context, NULL, NULL, &nodeId);
+    size_t end = backend.getEnd(NULL, backend.context, NULL, NULL, &nodeId);
+    ck_assert_uint_gt(first, 0);
+    ck_assert_uint_eq(end, 5000);
+    ck_assert_uint_eq(valueAt(&backend, first), first);
+    ck_assert_uint_eq(valueAt(&backend, end - 1), 4999);
+
+    /* Deleted values are not found */
+    size_t idx = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL, &nodeId,
+                                          0, MATCH_EQUAL);
+    ck_assert_uint_eq(idx, end);
+    idx = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL, &nodeId,
+                                   0, MATCH_EQUAL_OR_AFTER);
+    ck_assert_uint_eq(idx, first);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    /* The numbering restarts after a restore */
+    backend = UA_HistoryDataBackend_File(dir, 4096, 3);
+    ck_assert_uint_eq(countRecords(&backend), end - first);
+    ck_assert_uint_eq(valueAt(&backend, 0), first);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+START_TEST(File_segmentCreationFails) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 4096, 2);
+    UA_UInt32 v = 0;
+    while(countSegments() < 2)
+        ck_assert_uint_eq(addSample(&backend, v++), UA_STATUSCODE_GOOD);
+    size_t first = backend.firstIndex(NULL, backend.context, NULL, NULL, &nodeId);
+
+    /* The file size limit prevents new segments. Stores into the existing
+     * mapping are not affected. */
+    struct rlimit old, limit;
+    ck_assert_int_eq(getrlimit(RLIMIT_FSIZE, &old), 0);
+    limit = old;
+    limit.rlim_cur = 1024;
+    ck_assert_int_eq(setrlimit(RLIMIT_FSIZE, &limit), 0);
+    void (*oldHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < 1000 && res == UA_STATUSCODE_GOOD; i++)
+        res = addSample(&backend, v++);
+    ck_assert_int_eq(setrlimit(RLIMIT_FSIZE, &old), 0);
+    signal(SIGXFSZ, oldHandler);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+
+    /* The failed creation has not dropped the oldest segment */
+    ck_assert_uint_eq(countSegments(), 2);
+    ck_assert_uint_eq(backend.firstIndex(NULL, backend.context, NULL, NULL, &nodeId),
+                      first);
+    ck_assert_uint_eq(valueAt(&backend, first), first);
+
+    /* The next segment replaces the oldest one */
+    ck_assert_uint_eq(addSample(&backend, v++), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(countSegments(), 2);
+    ck_assert_uint_gt(backend.firstIndex(NULL, backend.context, NULL, NULL, &nodeId),
+                      first);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+START_TEST(File_indexRangeNoData) {
+    UA_HistoryDataBackend backend = UA_HistoryDataBackend_File(dir, 4096, 0);
+    for(UA_UInt32 i = 0; i < 10; i++)
+        ck_assert_uint_eq(addSample(&backend, i), UA_STATUSCODE_GOOD);
+
+    /* The range is outside of the scalar values. Every value gets the status
+     * instead of an empty value. */
+    UA_NumericRangeDimension dim = {5, 6};
+    UA_NumericRange range = {1, &dim};
+    UA_DataValue values[10];
+    UA_ByteString cp = UA_BYTESTRING_NULL;
+    UA_ByteString outCp = UA_BYTESTRING_NULL;
+    size_t provided = 0;
+    UA_StatusCode res =
+        backend.copyDataValues(NULL, backend.context, NULL, NULL, &nodeId,
+                               0, 9, false, 10, range, false, &cp, &outCp,
+                               &provided, values);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(provided, 10);
+    for(size_t i = 0; i < provided; i++) {
+        ck_assert(!values[i].hasValue);
+        ck_assert(values[i].hasStatus);
+        ck_assert_uint_eq(values[i].status, UA_STATUSCODE_BADINDEXRANGENODATA);
+        ck_assert(values[i].hasSourceTimestamp);
+        UA_DataValue_clear(&values[i]);
+    }
+    UA_ByteString_clear(&outCp);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+static double
+elapsed(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) +
+        (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+START_TEST(File_readRawLarge) {
+    /* Reduce the number of samples if the tmpfs is small */
+    size_t samples = LARGE_SAMPLES;
+    struct statvfs vfs;
+    if(statvfs(dir, &vfs) == 0) {
+        size_t avail = (size_t)vfs.f_bavail * (size_t)vfs.f_frsize / 2;
+        if(avail / SAMPLE_SIZE < samples)
+            samples = avail / SAMPLE_SIZE;
+    }
+    printf("Testing with %lu samples in %s\n", (unsigned long)samples, dir);
+
+    UA_HistoryDataBackend backend =
+        UA_HistoryDataBackend_File(dir, UA_HISTORYDATABACKEND_FILE_DEFAULT_SEGMENTSIZE, 0);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(size_t i = 0; i < samples; i++)
+        ck_assert_uint_eq(addSample(&backend, (UA_UInt32)i), UA_STATUSCODE_GOOD);
+    double t = elapsed(&start);
+    printf("Appended %lu samples in %.3fs (%.0f samples/s)\n",
+           (unsigned long)samples, t, (double)samples / t);
+    UA_HistoryDataBackend_File_clear(&backend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    backend = UA_HistoryDataBackend_File(dir, UA_HISTORYDATABACKEND_FILE_DEFAULT_SEGMENTSIZE, 0);
+    ck_assert_uint_eq(countRecords(&backend), samples);
+    t = elapsed(&start);
+    printf("Restored the index in %.3fs\n", t);
+
+    /* Read the complete history in chunks with continuation points */
+    UA_DataValue *values = (UA_DataValue*)
+        UA_Array_new(READ_CHUNK, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    ck_assert_ptr_ne(values, NULL);
+    UA_NumericRange range = {0, NULL};
+    UA_ByteString cp = UA_BYTESTRING_NULL;
+    size_t startIndex = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                                 &nodeId, 0, MATCH_EQUAL_OR_AFTER);
+    size_t endIndex = backend.lastIndex(NULL, backend.context, NULL, NULL, &nodeId);
+    ck_assert_uint_eq(startIndex, 0);
+    ck_assert_uint_eq(endIndex, samples - 1);
+    size_t read = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        UA_ByteString outCp = UA_BYTESTRING_NULL;
+        size_t provided = 0;
+        UA_StatusCode res =
+            backend.copyDataValues(NULL, backend.context, NULL, NULL, &nodeId,
+                                   startIndex, endIndex, false, READ_CHUNK, range,
+                                   false, &cp, &outCp, &provided, values);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        for(size_t i = 0; i < provided; i++) {
+            ck_assert_uint_eq(*(UA_UInt32*)values[i].value.data, read + i);
+            UA_DataValue_clear(&values[i]);
+        }
+        read += provided;
+        UA_ByteString_clear(&cp);
+        cp = outCp;
+    } while(cp.length > 0);
+    t = elapsed(&start);
+    printf("ReadRaw of %lu samples in %.3fs (%.0f samples/s)\n",
+           (unsigned long)read, t, (double)read / t);
+    ck_assert_uint_eq(read, samples);
+    UA_Array_delete(values, READ_CHUNK, &UA_TYPES[UA_TYPES_DATAVALUE]);
+
+    /* Timestamp lookups use the sparse index */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(size_t i = 0; i < 100000; i++) {
+        size_t expected = (i * 7919) % samples;
+        UA_DateTime ts = (UA_DateTime)expected * UA_DATETIME_MSEC;
+        size_t idx = backend.getDateTimeMatch(NULL, backend.context, NULL, NULL,
+                                              &nodeId, ts, MATCH_EQUAL);
+        ck_assert_uint_eq(idx, expected);
+    }
+    t = elapsed(&start);
+    printf("100000 timestamp lookups in %.3fs\n", t);
+    UA_HistoryDataBackend_File_clear(&backend);
+} END_TEST
+
+static Suite *
+testSuite_historyDataBackendFile(void) {
+    Suite *s = suite_create("History Data Backend File");
+    TCase *tc = tcase_create("File Backend");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, File_restore);
+    tcase_add_test(tc, File_dateTimeMatch);
+    tcase_add_test(tc, File_truncatedTail);
+    tcase_add_test(tc, File_retention);
+    tcase_add_test(tc, File_segmentCreationFails);
+    tcase_add_test(tc, File_indexRangeNoData);
+    tcase_add_test(tc, File_readRawLarge);
+    tcase_set_timeout(tc, 300);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_historyDataBackendFile();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,278 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include "server/ua_server_internal.h"
+#include "test_helpers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "check.h"
+
+static UA_Server *
+newServerFromImage(const UA_ByteString *image) {
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    UA_ServerConfig_setDefault(&config);
+    config.eventLoop->dateTime_now = UA_DateTime_now_fake;
+    config.eventLoop->dateTime_nowMonotonic = UA_DateTime_now_fake;
+    config.nodestoreImage = *image;
+    return UA_Server_newWithConfig(&config);
+}
+
+/* Add nodes outside of namespace zero */
+static void
+addTestNodes(UA_Server *server) {
+    UA_UInt16 nsIndex = UA_Server_addNamespace(server, "http://example.com/image/");
+    ck_assert_uint_eq(nsIndex, 2);
+
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    oAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Machine");
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_STRING(nsIndex, "machine"),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(nsIndex, "Machine"),
+                                UA_NS0ID(BASEOBJECTTYPE), oAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    UA_Double temperature = 21.5;
+    UA_Variant_setScalar(&vAttr.value, &temperature, &UA_TYPES[UA_TYPES_DOUBLE]);
+    vAttr.displayName = UA_LOCALIZEDTEXT("en-US", "Temperature");
+    vAttr.description = UA_LOCALIZEDTEXT("en-US", "Temperature of the machine");
+    vAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    res = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(nsIndex, 1000),
+                                    UA_NODEID_STRING(nsIndex, "machine"),
+                                    UA_NS0ID(HASCOMPONENT),
+                                    UA_QUALIFIEDNAME(nsIndex, "Temperature"),
+                                    UA_NS0ID(BASEDATAVARIABLETYPE), vAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Second locale for the DisplayName */
+    res = UA_Server_writeDisplayName(server, UA_NODEID_NUMERIC(nsIndex, 1000),
+                                     UA_LOCALIZEDTEXT("de-DE", "Temperatur"));
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+typedef struct {
+    UA_NodeId *ids;
+    size_t idsSize;
+} NodeIdCollection;
+
+static void
+collectNodeIds(void *context, const UA_Node *node) {
+    NodeIdCollection *c = (NodeIdCollection*)context;
+    UA_NodeId *ids = (UA_NodeId*)UA_realloc(c->ids, (c->idsSize + 1) * sizeof(UA_NodeId));
+    ck_assert_ptr_ne(ids, NULL);
+    c->ids = ids;
+    UA_NodeId_copy(&node->head.nodeId, &c->ids[c->idsSize]);
+    c->idsSize++;
+}
+
+/* Values from a callback can depend on the server configuration (e.g. the
+ * BuildDate) and are not part of the image */
+static UA_Boolean
+hasInternalValue(UA_Server *server, const UA_NodeId *id) {
+    UA_Nodestore *ns = UA_Server_getConfig(server)->nodestore;
+    const UA_Node *node = ns->getNode(ns, id, UA_NODEATTRIBUTESMASK_ALL,
+                                      UA_REFERENCETYPESET_NONE,
+                                      UA_BROWSEDIRECTION_INVALID);
+    ck_assert_ptr_ne(node, NULL);
+    UA_Boolean internal = true;
+    if(node->head.nodeClass == UA_NODECLASS_VARIABLE ||
+       node->head.nodeClass == UA_NODECLASS_VARIABLETYPE)
+        internal = (node->variableNode.valueSourceType == UA_VALUESOURCETYPE_INTERNAL);
+    ns->releaseNode(ns, node);
+    return internal;
+}
+
+static void
+compareNode(UA_Server *a, UA_Server *b, const UA_NodeId *id) {
+    /* Compare all attributes */
+    UA_Boolean internalValue = hasInternalValue(a, id);
+    for(UA_UInt32 attr = UA_ATTRIBUTEID_NODEID; attr <= UA_ATTRIBUTEID_ACCESSLEVELEX; attr++) {
+        if(attr == UA_ATTRIBUTEID_VALUE && !internalValue)
+            continue;
+        UA_ReadValueId rvi;
+        UA_ReadValueId_init(&rvi);
+        rvi.nodeId = *id;
+        rvi.attributeId = attr;
+        UA_DataValue va = UA_Server_read(a, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+        UA_DataValue vb = UA_Server_read(b, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+        if(UA_order(&va, &vb, &UA_TYPES[UA_TYPES_DATAVALUE]) != UA_ORDER_EQ) {
+            UA_String out = UA_STRING_NULL;
+            UA_NodeId_print(id, &out);
+            ck_abort_msg("Attribute %u of node %.*s differs", (unsigned)attr,
+                         (int)out.length, (char*)out.data);
+        }
+        UA_DataValue_clear(&va);
+        UA_DataValue_clear(&vb);
+    }
+
+    /* Compare the references in both directions */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = *id;
+    bd.browseDirection = UA_BROWSEDIRECTION_BOTH;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult ra = UA_Server_browse(a, 0, &bd);
+    UA_BrowseResult rb = UA_Server_browse(b, 0, &bd);
+    ck_assert_uint_eq(ra.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ra.referencesSize, rb.referencesSize);
+    ck_assert(UA_order(&ra, &rb, &UA_TYPES[UA_TYPES_BROWSERESULT]) == UA_ORDER_EQ);
+    UA_BrowseResult_clear(&ra);
+    UA_BrowseResult_clear(&rb);
+}
+
+START_TEST(Server_image_roundTrip) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert_ptr_ne(server, NULL);
+    addTestNodes(server);
+
+    UA_ByteString image = UA_BYTESTRING_NULL;
+    UA_StatusCode res = UA_Server_saveNodestoreImage(server, &image);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(image.length, 0);
+
+    UA_Server *loaded = newServerFromImage(&image);
+    ck_assert_ptr_ne(loaded, NULL);
+    ck_assert_uint_eq(UA_Server_getConfig(loaded)->nodestoreImage.length, 0);
+
+    /* The namespace is restored with the same index */
+    size_t nsIndex = 0;
+    res = UA_Server_getNamespaceByName(loaded, UA_STRING("http://example.com/image/"),
+                                       &nsIndex);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(nsIndex, 2);
+
+    /* Same nodes with the same attributes and references */
+    NodeIdCollection ca = {NULL, 0};
+    NodeIdCollection cb = {NULL, 0};
+    UA_Nodestore *nsa = UA_Server_getConfig(server)->nodestore;
+    UA_Nodestore *nsb = UA_Server_getConfig(loaded)->nodestore;
+    nsa->iterate(nsa, collectNodeIds, &ca);
+    nsb->iterate(nsb, collectNodeIds, &cb);
+    ck_assert_uint_eq(ca.idsSize, cb.idsSize);
+    for(size_t i = 0; i < ca.idsSize; i++)
+        compareNode(server, loaded, &ca.ids[i]);
+    UA_Array_delete(ca.ids, ca.idsSize, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_Array_delete(cb.ids, cb.idsSize, &UA_TYPES[UA_TYPES_NODEID]);
+
+    /* The ReferenceTypes have the same index and subtypes */
+    for(UA_Byte i = 0; nsa->getReferenceTypeId(nsa, i); i++) {
+        const UA_NodeId *refTypeId = nsa->getReferenceTypeId(nsa, i);
+        ck_assert(UA_NodeId_equal(refTypeId, nsb->getReferenceTypeId(nsb, i)));
+        const UA_Node *na = nsa->getNode(nsa, refTypeId, UA_NODEATTRIBUTESMASK_ALL,
+                                         UA_REFERENCETYPESET_NONE,
+                                         UA_BROWSEDIRECTION_INVALID);
+        const UA_Node *nb = nsb->getNode(nsb, refTypeId, UA_NODEATTRIBUTESMASK_ALL,
+                                         UA_REFERENCETYPESET_NONE,
+                                         UA_BROWSEDIRECTION_INVALID);
+        ck_assert_uint_eq(nb->referenceTypeNode.referenceTypeIndex, i);
+        ck_assert(memcmp(&na->referenceTypeNode.subTypes, &nb->referenceTypeNode.subTypes,
+                         sizeof(UA_ReferenceTypeSet)) == 0);
+        nsa->releaseNode(nsa, na);
+        nsb->releaseNode(nsb, nb);
+    }
+
+    /* The callbacks of namespace zero are set up again */
+    UA_Variant state;
+    res = UA_Server_readValue(loaded, UA_NS0ID(SERVER_SERVERSTATUS_STATE), &state);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&state, &UA_TYPES[UA_TYPES_SERVERSTATE]));
+    UA_Variant_clear(&state);
+
+    /* Saving the loaded server gives the same image */
+    UA_ByteString image2 = UA_BYTESTRING_NULL;
+    res = UA_Server_saveNodestoreImage(loaded, &image2);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_ByteString_equal(&image, &image2));
+
+    UA_ByteString_clear(&image);
+    UA_ByteString_clear(&image2);
+    UA_Server_delete(server);
+    UA_Server_delete(loaded);
+} END_TEST
+
+START_TEST(Server_image_invalid) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    UA_ByteString image = UA_BYTESTRING_NULL;
+    UA_StatusCode res = UA_Server_saveNodestoreImage(server, &image);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Server_delete(server);
+
+    /* Wrong version */
+    image.data[4]++;
+    ck_assert_ptr_eq(newServerFromImage(&image), NULL);
+    image.data[4]--;
+
+    /* BrowseName hashes from another hash function */
+    image.data[8]++;
+    ck_assert_ptr_eq(newServerFromImage(&image), NULL);
+    image.data[8]--;
+
+    /* Truncated */
+    UA_ByteString truncated = {image.length / 2, image.data};
+    ck_assert_ptr_eq(newServerFromImage(&truncated), NULL);
+
+    UA_ByteString_clear(&image);
+} END_TEST
+
+#define IMAGE_BENCHMARK_RUNS 20
+
+START_TEST(Server_image_benchmark) {
+    /* Only the startup is measured, not the shutdown */
+    UA_DateTime generatedTime = 0;
+    for(size_t i = 0; i < IMAGE_BENCHMARK_RUNS; i++) {
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        UA_Server *server = UA_Server_newForUnitTest();
+        generatedTime += UA_DateTime_nowMonotonic() - begin;
+        UA_Server_delete(server);
+    }
+
+    UA_Server *server = UA_Server_newForUnitTest();
+    UA_ByteString image = UA_BYTESTRING_NULL;
+    UA_StatusCode res = UA_Server_saveNodestoreImage(server, &image);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Server_delete(server);
+
+    UA_DateTime imageTime = 0;
+    for(size_t i = 0; i < IMAGE_BENCHMARK_RUNS; i++) {
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        server = newServerFromImage(&image);
+        imageTime += UA_DateTime_nowMonotonic() - begin;
+        ck_assert_ptr_ne(server, NULL);
+        UA_Server_delete(server);
+    }
+
+    printf("Server startup: generated namespace zero %.3f ms, "
+           "nodestore image %.3f ms (%lu bytes)\n",
+           (double)generatedTime / UA_DATETIME_MSEC / IMAGE_BENCHMARK_RUNS,
+           (double)imageTime / UA_DATETIME_MSEC / IMAGE_BENCHMARK_RUNS,
+           (unsigned long)image.length);
+    UA_ByteString_clear(&image);
+} END_TEST
+
+static Suite *testSuite_serverImage(void) {
+    Suite *s = suite_create("Server Nodestore Image");
+    TCase *tc = tcase_create("Core");
+    tcase_add_test(tc, Server_image_roundTrip);
+    tcase_add_test(tc, Server_image_invalid);
+    tcase_add_test(tc, Server_image_benchmark);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_serverImage();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
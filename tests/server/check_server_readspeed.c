@@ -189,6 +189,121 @@ START_TEST(readSpeedWithEncoding) {
 }
 END_TEST
 
+/* Encode, decode and execute READS ReadRequests for the NodeIds. Returns the
+ * duration in seconds. */
+static double
+timeReads(const UA_NodeId *nodeIds, size_t nodeIdsSize) {
+    UA_ByteString request_buffer;
+    UA_StatusCode retval = UA_ByteString_allocBuffer(&request_buffer, 1000);
+    ck_assert(retval == UA_STATUSCODE_GOOD);
+
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_NEITHER;
+    request.nodesToReadSize = 1;
+    request.nodesToRead = &rvi;
+
+    UA_ReadRequest req;
+    UA_ReadResponse res;
+    UA_ReadResponse_init(&res);
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < READS; i++) {
+        rvi.nodeId = nodeIds[i % nodeIdsSize];
+        UA_ByteString request_msg = request_buffer;
+        retval = UA_encodeBinary(&request, &UA_TYPES[UA_TYPES_READREQUEST],
+                                 &request_msg, NULL);
+        ck_assert(retval == UA_STATUSCODE_GOOD);
+        retval = UA_decodeBinary(&request_msg, &req,
+                                 &UA_TYPES[UA_TYPES_READREQUEST], NULL);
+        ck_assert(retval == UA_STATUSCODE_GOOD);
+
+        lockServer(server);
+        Service_Read(server, &server->adminSession, &req, &res);
+        unlockServer(server);
+
+        ck_assert_uint_eq(res.resultsSize, 1);
+        ck_assert(res.results[0].hasValue);
+        ck_assert_int_eq(*(UA_Int32*)res.results[0].value.data, 42);
+
+        UA_ReadRequest_clear(&req);
+        UA_ReadResponse_clear(&res);
+    }
+    clock_t finish = clock();
+
+    UA_ByteString_clear(&request_buffer);
+    return (double)(finish - begin) / CLOCKS_PER_SEC;
+}
+
+START_TEST(readSpeedRegistered) {
+    /* Add variable nodes with long string NodeIds */
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 42;
+    UA_Variant_setScalar(&attr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    for(size_t i = 0; i < READNODES; i++) {
+        char varName[64];
+        snprintf(varName, 64, "Plant.Line4.Cell2.Drive7.Torque.%u", (UA_UInt32)i);
+        UA_StatusCode retval =
+            UA_Server_addVariableNode(server, UA_NODEID_STRING(1, varName),
+                                      UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, varName), UA_NODEID_NULL,
+                                      attr, NULL, &readNodeIds[i]);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* Register the NodeIds */
+    UA_RegisterNodesRequest regReq;
+    UA_RegisterNodesRequest_init(&regReq);
+    regReq.nodesToRegister = readNodeIds;
+    regReq.nodesToRegisterSize = READNODES;
+    UA_RegisterNodesResponse regRes;
+    UA_RegisterNodesResponse_init(&regRes);
+    lockServer(server);
+    Service_RegisterNodes(server, &server->adminSession, &regReq, &regRes);
+    unlockServer(server);
+    ck_assert_uint_eq(regRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(regRes.registeredNodeIdsSize, READNODES);
+    for(size_t i = 0; i < READNODES; i++) {
+        ck_assert_uint_eq(regRes.registeredNodeIds[i].identifierType,
+                          UA_NODEIDTYPE_NUMERIC);
+        ck_assert_uint_ge(regRes.registeredNodeIds[i].identifier.numeric,
+                          UA_REGISTEREDNODEID_BASE);
+    }
+
+    double unregisteredTime = timeReads(readNodeIds, READNODES);
+    double registeredTime = timeReads(regRes.registeredNodeIds, READNODES);
+    printf("duration with string NodeIds was %f s\n", unregisteredTime);
+    printf("duration with registered NodeIds was %f s\n", registeredTime);
+
+    /* The alias is no longer resolved after unregistering */
+    UA_UnregisterNodesRequest unregReq;
+    UA_UnregisterNodesRequest_init(&unregReq);
+    unregReq.nodesToUnregister = regRes.registeredNodeIds;
+    unregReq.nodesToUnregisterSize = 1;
+    UA_UnregisterNodesResponse unregRes;
+    UA_UnregisterNodesResponse_init(&unregRes);
+    lockServer(server);
+    Service_UnregisterNodes(server, &server->adminSession, &unregReq, &unregRes);
+    unlockServer(server);
+    ck_assert_uint_eq(unregRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = regRes.registeredNodeIds[0];
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_DataValue dv = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+    ck_assert_uint_eq(dv.status, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue_clear(&dv);
+
+    UA_RegisterNodesResponse_clear(&regRes);
+    for(size_t i = 0; i < READNODES; i++)
+        UA_NodeId_clear(&readNodeIds[i]);
+}
+END_TEST
+
 static Suite * service_speed_suite (void) {
     Suite *s = suite_create ("Service Speed");
 
@@ -196,6 +311,7 @@ static Suite * service_speed_suite (void) {
     tcase_add_checked_fixture(tc_read, setup, teardown);
     tcase_add_test (tc_read, readSpeed);
     tcase_add_test (tc_read, readSpeedWithEncoding);
+    tcase_add_test (tc_read, readSpeedRegistered);
     suite_add_tcase (s, tc_read);
 
     return s;
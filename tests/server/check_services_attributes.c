@@ -21,6 +21,7 @@
 #endif
 
 static UA_Server *server = NULL;
+static size_t temperatureReads = 0;
 
 static UA_StatusCode
 readCPUTemperature(UA_Server *server_,
@@ -28,6 +29,7 @@ readCPUTemperature(UA_Server *server_,
                    const UA_NodeId *nodeId, void *nodeContext,
                    UA_Boolean sourceTimeStamp, const UA_NumericRange *range,
                    UA_DataValue *dataValue) {
+    temperatureReads++;
     UA_Float temp = 20.5f;
     UA_Variant_setScalarCopy(&dataValue->value, &temp, &UA_TYPES[UA_TYPES_FLOAT]);
     dataValue->hasValue = true;
@@ -165,6 +167,9 @@ static void setup(void) {
                                        UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
                                        lvattr, NULL, NULL);
     ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Don't count the reads during the creation of the nodes */
+    temperatureReads = 0;
 }
 
 static UA_VariableNode* makeCompareSequence(void) {
@@ -1235,6 +1240,114 @@ START_TEST(CheckDescriptionLocalization) {
     UA_LocalizedText_clear(&lt);
 } END_TEST
 
+static void
+readTemperatureWithMaxAge(UA_Double maxAge) {
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_STRING(1, "cpu.temperature");
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.maxAge = maxAge;
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SOURCE;
+    request.nodesToReadSize = 1;
+    request.nodesToRead = &rvi;
+
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+    lockServer(server);
+    Service_Read(server, &server->adminSession, &request, &response);
+    unlockServer(server);
+
+    ck_assert_uint_eq(response.resultsSize, 1);
+    ck_assert(response.results[0].hasValue);
+    ck_assert(response.results[0].hasSourceTimestamp);
+    ck_assert_ptr_eq(response.results[0].value.type, &UA_TYPES[UA_TYPES_FLOAT]);
+    ck_assert(*(UA_Float*)response.results[0].value.data == 20.5f);
+    UA_ReadResponse_clear(&response);
+}
+
+START_TEST(ValueCacheDisabled) {
+    for(size_t i = 0; i < 3; i++)
+        readTemperatureWithMaxAge(10000.0);
+    ck_assert_uint_eq(temperatureReads, 3);
+} END_TEST
+
+START_TEST(ValueCacheRepeatedReads) {
+    UA_StatusCode retval =
+        UA_Server_setVariableNode_valueCache(server, UA_NODEID_STRING(1, "cpu.temperature"),
+                                             100.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Only the first read calls the callback */
+    for(size_t i = 0; i < 5; i++)
+        readTemperatureWithMaxAge(10000.0);
+    ck_assert_uint_eq(temperatureReads, 1);
+
+    /* Internal reads (sampling, PubSub) use the same cache */
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_STRING(1, "cpu.temperature");
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_DataValue dv = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+    ck_assert(dv.hasValue);
+    ck_assert(!dv.hasSourceTimestamp);
+    UA_DataValue_clear(&dv);
+    ck_assert_uint_eq(temperatureReads, 1);
+
+    /* The cached value expires */
+    UA_fakeSleep(101);
+    readTemperatureWithMaxAge(10000.0);
+    ck_assert_uint_eq(temperatureReads, 2);
+
+    /* Disable the cache */
+    retval = UA_Server_setVariableNode_valueCache(server, UA_NODEID_STRING(1, "cpu.temperature"),
+                                                  0.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    readTemperatureWithMaxAge(10000.0);
+    readTemperatureWithMaxAge(10000.0);
+    ck_assert_uint_eq(temperatureReads, 4);
+} END_TEST
+
+START_TEST(ValueCacheRequestMaxAge) {
+    UA_StatusCode retval =
+        UA_Server_setVariableNode_valueCache(server, UA_NODEID_STRING(1, "cpu.temperature"),
+                                             100.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* maxAge zero always reads a new value */
+    readTemperatureWithMaxAge(0.0);
+    readTemperatureWithMaxAge(0.0);
+    ck_assert_uint_eq(temperatureReads, 2);
+
+    /* The request maxAge is below the age of the cached value */
+    UA_fakeSleep(20);
+    readTemperatureWithMaxAge(50.0);
+    ck_assert_uint_eq(temperatureReads, 2);
+    UA_fakeSleep(20);
+    readTemperatureWithMaxAge(10.0);
+    ck_assert_uint_eq(temperatureReads, 3);
+} END_TEST
+
+START_TEST(ValueCacheInvalidArguments) {
+    UA_StatusCode retval =
+        UA_Server_setVariableNode_valueCache(server, UA_NODEID_STRING(1, "does.not.exist"),
+                                             100.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    retval = UA_Server_setVariableNode_valueCache(server, UA_NS0ID(OBJECTSFOLDER), 100.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNODECLASSINVALID);
+
+    /* The cache entry is removed together with the node */
+    retval = UA_Server_setVariableNode_valueCache(server, UA_NODEID_STRING(1, "cpu.temperature"),
+                                                  100.0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    readTemperatureWithMaxAge(10000.0);
+    retval = UA_Server_deleteNode(server, UA_NODEID_STRING(1, "cpu.temperature"), true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(ZIP_ROOT(&server->valueCache) == NULL);
+} END_TEST
+
 static Suite * testSuite_services_attributes(void) {
     Suite *s = suite_create("services_attributes_read");
 
@@ -1311,6 +1424,14 @@ static Suite * testSuite_services_attributes(void) {
     tcase_add_test(tc_localization, CheckDescriptionLocalization);
     suite_add_tcase(s, tc_localization);
 
+    TCase *tc_valueCache = tcase_create("valueCache");
+    tcase_add_checked_fixture(tc_valueCache, setup, teardown);
+    tcase_add_test(tc_valueCache, ValueCacheDisabled);
+    tcase_add_test(tc_valueCache, ValueCacheRepeatedReads);
+    tcase_add_test(tc_valueCache, ValueCacheRequestMaxAge);
+    tcase_add_test(tc_valueCache, ValueCacheInvalidArguments);
+    suite_add_tcase(s, tc_valueCache);
+
     return s;
 }
 
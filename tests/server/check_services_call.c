@@ -322,6 +322,139 @@ START_TEST(callObjectTypeMethodOnInstance2) {
 #endif
 } END_TEST
 
+static UA_StatusCode
+echoMethodCallback(UA_Server *serverArg,
+                   const UA_NodeId *sessionId, void *sessionHandle,
+                   const UA_NodeId *methodId, void *methodContext,
+                   const UA_NodeId *objectId, void *objectContext,
+                   size_t inputSize, const UA_Variant *input,
+                   size_t outputSize, UA_Variant *output) {
+    return UA_Variant_copy(&input[0], &output[0]);
+}
+
+static void
+addEchoMethod(const UA_NodeId methodId) {
+    UA_Argument inputArgument;
+    UA_Argument_init(&inputArgument);
+    inputArgument.name = UA_STRING("Input");
+    inputArgument.dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+    inputArgument.valueRank = UA_VALUERANK_SCALAR;
+
+    UA_Argument outputArgument;
+    UA_Argument_init(&outputArgument);
+    outputArgument.name = UA_STRING("Output");
+    outputArgument.dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+    outputArgument.valueRank = UA_VALUERANK_SCALAR;
+
+    UA_MethodAttributes attr = UA_MethodAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","Echo");
+    attr.executable = true;
+    attr.userExecutable = true;
+    UA_StatusCode res =
+        UA_Server_addMethodNode(server, methodId,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                UA_QUALIFIEDNAME(1, "Echo"), attr, &echoMethodCallback,
+                                1, &inputArgument, 1, &outputArgument, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static UA_StatusCode
+callEcho(const UA_NodeId methodId, UA_Variant *input) {
+    UA_CallMethodRequest callMethodRequest;
+    UA_CallMethodRequest_init(&callMethodRequest);
+    callMethodRequest.inputArgumentsSize = 1;
+    callMethodRequest.inputArguments = input;
+    callMethodRequest.methodId = methodId;
+    callMethodRequest.objectId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    UA_CallMethodResult result = UA_Server_call(server, &callMethodRequest);
+    UA_StatusCode res = result.statusCode;
+    if(res == UA_STATUSCODE_GOOD) {
+        ck_assert_uint_eq(result.outputArgumentsSize, 1);
+        ck_assert(UA_order(&result.outputArguments[0], input,
+                           &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+    }
+    UA_CallMethodResult_clear(&result);
+    return res;
+}
+
+START_TEST(callMethodCached) {
+    UA_Server_getConfig(server)->methodCallCacheSize = 16;
+    UA_NodeId methodId = UA_NODEID_STRING(1, "echo");
+    addEchoMethod(methodId);
+
+    UA_UInt32 uintValue = 42;
+    UA_Double doubleValue = 42.5;
+    UA_Variant uintInput;
+    UA_Variant doubleInput;
+    UA_Variant_setScalar(&uintInput, &uintValue, &UA_TYPES[UA_TYPES_UINT32]);
+    UA_Variant_setScalar(&doubleInput, &doubleValue, &UA_TYPES[UA_TYPES_DOUBLE]);
+
+    /* The first call fills the cache */
+    ck_assert_uint_eq(callEcho(methodId, &uintInput), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(server->methodCacheSize, 16);
+    size_t validEntries = 0;
+    for(size_t i = 0; i < server->methodCacheSize; i++) {
+        if(server->methodCache[i].valid)
+            validEntries++;
+    }
+    ck_assert_uint_eq(validEntries, 1);
+
+    /* Type-checked against the cached argument definitions */
+    ck_assert_uint_eq(callEcho(methodId, &uintInput), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callEcho(methodId, &doubleInput), UA_STATUSCODE_BADINVALIDARGUMENT);
+
+    /* Changing the argument definition invalidates the cache */
+    UA_Argument inputArgument;
+    UA_Argument_init(&inputArgument);
+    inputArgument.name = UA_STRING("Input");
+    inputArgument.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    inputArgument.valueRank = UA_VALUERANK_SCALAR;
+    UA_Variant argValue;
+    UA_Variant_setArray(&argValue, &inputArgument, 1, &UA_TYPES[UA_TYPES_ARGUMENT]);
+    UA_StatusCode res =
+        UA_Server_writeObjectProperty(server, methodId,
+                                      UA_QUALIFIEDNAME(0, "InputArguments"), argValue);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callEcho(methodId, &doubleInput), UA_STATUSCODE_GOOD);
+
+    /* Removing the reference to the method invalidates the cache */
+    res = UA_Server_deleteReference(server, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), true,
+                                    UA_EXPANDEDNODEID_NODEID(methodId), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callEcho(methodId, &doubleInput), UA_STATUSCODE_BADMETHODINVALID);
+
+    /* Disabling frees the cache */
+    UA_Server_getConfig(server)->methodCallCacheSize = 0;
+    ck_assert_uint_eq(callEcho(methodId, &doubleInput), UA_STATUSCODE_BADMETHODINVALID);
+    ck_assert_uint_eq(server->methodCacheSize, 0);
+} END_TEST
+
+#define CALL_BENCHMARK_ITERATIONS 100000
+
+static double
+benchmarkCalls(const UA_NodeId methodId) {
+    UA_UInt32 uintValue = 42;
+    UA_Variant input;
+    UA_Variant_setScalar(&input, &uintValue, &UA_TYPES[UA_TYPES_UINT32]);
+    clock_t begin = clock();
+    for(size_t i = 0; i < CALL_BENCHMARK_ITERATIONS; i++)
+        ck_assert_uint_eq(callEcho(methodId, &input), UA_STATUSCODE_GOOD);
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+START_TEST(callMethodBenchmark) {
+    UA_NodeId methodId = UA_NODEID_STRING(1, "echo");
+    addEchoMethod(methodId);
+
+    double uncached = benchmarkCalls(methodId);
+    UA_Server_getConfig(server)->methodCallCacheSize = 64;
+    double cached = benchmarkCalls(methodId);
+    printf("Call throughput: %.0f calls/s without cache, %.0f calls/s with cache\n",
+           CALL_BENCHMARK_ITERATIONS / uncached, CALL_BENCHMARK_ITERATIONS / cached);
+} END_TEST
+
 int main(void) {
     Suite *s = suite_create("services_call");
 
@@ -339,6 +472,8 @@ int main(void) {
     tcase_add_test(tc_call, callMethodWithEmptyArgument);
     tcase_add_test(tc_call, callObjectTypeMethodOnInstance);
     tcase_add_test(tc_call, callObjectTypeMethodOnInstance2);
+    tcase_add_test(tc_call, callMethodCached);
+    tcase_add_test(tc_call, callMethodBenchmark);
     suite_add_tcase(s, tc_call);
 
     SRunner *sr = srunner_create(s);
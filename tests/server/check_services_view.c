@@ -12,6 +12,7 @@
 #include <check.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "test_helpers.h"
 #include "thread_wrapper.h"
@@ -129,6 +130,225 @@ START_TEST(Service_Browse_WithMaxResults) {
 }
 END_TEST
 
+#define LARGEFOLDER_SIZE 20000
+
+START_TEST(Service_Browse_LargeFolder_benchmark) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    /* Add a folder with many children */
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "LargeFolder"),
+                                UA_NS0ID(FOLDERTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(UA_UInt32 i = 0; i < LARGEFOLDER_SIZE; i++) {
+        res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1000 + i),
+                                      UA_NODEID_NUMERIC(1, 1), UA_NS0ID(ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "Child"),
+                                      UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    UA_Boolean *seen = (UA_Boolean*)UA_calloc(LARGEFOLDER_SIZE, sizeof(UA_Boolean));
+    ck_assert_ptr_ne(seen, NULL);
+
+    /* Page through the folder. Every child is returned exactly once. */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(1, 1);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NS0ID(ORGANIZES);
+    bd.resultMask = UA_BROWSERESULTMASK_NONE;
+
+    clock_t begin = clock();
+    size_t total = 0;
+    size_t pages = 0;
+    UA_BrowseResult br = UA_Server_browse(server, 100, &bd);
+    while(true) {
+        ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+        for(size_t i = 0; i < br.referencesSize; i++) {
+            UA_UInt32 id = br.references[i].nodeId.nodeId.identifier.numeric - 1000;
+            ck_assert_uint_lt(id, LARGEFOLDER_SIZE);
+            ck_assert(!seen[id]);
+            seen[id] = true;
+        }
+        total += br.referencesSize;
+        pages++;
+        UA_ByteString cp = br.continuationPoint;
+        br.continuationPoint = UA_BYTESTRING_NULL;
+        UA_BrowseResult_clear(&br);
+        if(cp.length == 0)
+            break;
+        br = UA_Server_browseNext(server, false, &cp);
+        UA_ByteString_clear(&cp);
+    }
+    clock_t finish = clock();
+
+    ck_assert_uint_eq(total, LARGEFOLDER_SIZE);
+    printf("Paging through %u children in %u pages took %f s\n",
+           (unsigned)total, (unsigned)pages,
+           (double)(finish - begin) / CLOCKS_PER_SEC);
+
+    UA_free(seen);
+    UA_Server_delete(server);
+}
+END_TEST
+
+START_TEST(Service_Browse_ContinuationPointSlots) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NS0ID(SERVER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_NONE;
+
+    /* Use up all continuation points */
+    UA_ByteString cps[UA_MAXCONTINUATIONPOINTS];
+    for(size_t i = 0; i < UA_MAXCONTINUATIONPOINTS; i++) {
+        UA_BrowseResult br = UA_Server_browse(server, 1, &bd);
+        ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+        ck_assert_uint_gt(br.continuationPoint.length, 0);
+        cps[i] = br.continuationPoint;
+        br.continuationPoint = UA_BYTESTRING_NULL;
+        UA_BrowseResult_clear(&br);
+    }
+    UA_BrowseResult br = UA_Server_browse(server, 1, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_BADNOCONTINUATIONPOINTS);
+    UA_BrowseResult_clear(&br);
+
+    /* Release one cp. Its identifier is no longer valid. */
+    br = UA_Server_browseNext(server, true, &cps[2]);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_BrowseResult_clear(&br);
+    br = UA_Server_browseNext(server, false, &cps[2]);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_BADCONTINUATIONPOINTINVALID);
+    UA_BrowseResult_clear(&br);
+    UA_ByteString_clear(&cps[2]);
+
+    /* A modified identifier is rejected */
+    UA_ByteString_copy(&cps[0], &cps[2]);
+    cps[2].data[cps[2].length - 1]++;
+    br = UA_Server_browseNext(server, false, &cps[2]);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_BADCONTINUATIONPOINTINVALID);
+    UA_BrowseResult_clear(&br);
+    UA_ByteString_clear(&cps[2]);
+
+    /* The free slot is reused */
+    br = UA_Server_browse(server, 1, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(br.continuationPoint.length, 0);
+    cps[2] = br.continuationPoint;
+    br.continuationPoint = UA_BYTESTRING_NULL;
+    UA_BrowseResult_clear(&br);
+
+    /* The remaining cps still work */
+    for(size_t i = 0; i < UA_MAXCONTINUATIONPOINTS; i++) {
+        br = UA_Server_browseNext(server, false, &cps[i]);
+        ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(br.referencesSize, 1);
+        UA_BrowseResult_clear(&br);
+        UA_ByteString_clear(&cps[i]);
+    }
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+#define MODFOLDER_SIZE 10
+
+/* Browse a folder with few children (stored as a reference array) in pages.
+ * Modify the children between the Browse and the BrowseNext. Every remaining
+ * child is returned exactly once. */
+static void
+browseModifiedFolder(UA_Boolean addChild, UA_UInt32 removeChild) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "ModFolder"),
+                                UA_NS0ID(FOLDERTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(UA_UInt32 i = 0; i < MODFOLDER_SIZE; i++) {
+        res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1000 + i),
+                                      UA_NODEID_NUMERIC(1, 1), UA_NS0ID(ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "Child"),
+                                      UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(1, 1);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NS0ID(ORGANIZES);
+    bd.resultMask = UA_BROWSERESULTMASK_NONE;
+
+    /* The first page returns the children 0-3 */
+    size_t seen[MODFOLDER_SIZE + 1] = {0};
+    UA_BrowseResult br = UA_Server_browse(server, 4, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, 4);
+    ck_assert_uint_gt(br.continuationPoint.length, 0);
+
+    /* Modify the folder */
+    if(addChild) {
+        res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1000 + MODFOLDER_SIZE),
+                                      UA_NODEID_NUMERIC(1, 1), UA_NS0ID(ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "Child"),
+                                      UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    } else {
+        res = UA_Server_deleteNode(server, UA_NODEID_NUMERIC(1, 1000 + removeChild),
+                                   true);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    /* Page through the remaining children */
+    while(true) {
+        ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+        for(size_t i = 0; i < br.referencesSize; i++) {
+            UA_UInt32 id = br.references[i].nodeId.nodeId.identifier.numeric - 1000;
+            ck_assert_uint_le(id, MODFOLDER_SIZE);
+            seen[id]++;
+        }
+        UA_ByteString cp = br.continuationPoint;
+        br.continuationPoint = UA_BYTESTRING_NULL;
+        UA_BrowseResult_clear(&br);
+        if(cp.length == 0)
+            break;
+        br = UA_Server_browseNext(server, false, &cp);
+        UA_ByteString_clear(&cp);
+    }
+
+    /* A removed child is missing only if it was not on the first page */
+    for(UA_UInt32 i = 0; i < MODFOLDER_SIZE; i++) {
+        if(!addChild && i == removeChild && i >= 4)
+            ck_assert_uint_eq(seen[i], 0);
+        else
+            ck_assert_uint_eq(seen[i], 1);
+    }
+    ck_assert_uint_eq(seen[MODFOLDER_SIZE], addChild ? 1 : 0);
+
+    UA_Server_delete(server);
+}
+
+START_TEST(Service_Browse_ContinuationPointModified) {
+    browseModifiedFolder(false, 1); /* Before the last returned target */
+    browseModifiedFolder(false, 3); /* The last returned target */
+    browseModifiedFolder(false, 5); /* Not returned yet */
+    browseModifiedFolder(false, MODFOLDER_SIZE - 1); /* The final target */
+    browseModifiedFolder(true, 0);  /* Add a target */
+}
+END_TEST
+
 START_TEST(Service_Browse_WithBrowseName) {
     UA_Server *server = UA_Server_newForUnitTest();
     ck_assert(server != NULL);
@@ -493,6 +713,221 @@ START_TEST(BrowseSimplifiedBrowsePath) {
 }
 END_TEST
 
+static UA_BrowsePathResult
+translateObjectsPath(UA_Server *server, const char *first, const char *second) {
+    UA_RelativePathElement rpe[2];
+    UA_RelativePathElement_init(&rpe[0]);
+    UA_RelativePathElement_init(&rpe[1]);
+    rpe[0].referenceTypeId = UA_NS0ID(HIERARCHICALREFERENCES);
+    rpe[0].includeSubtypes = true;
+    rpe[0].targetName = UA_QUALIFIEDNAME(1, (char*)(uintptr_t)first);
+    if(second) {
+        rpe[1].referenceTypeId = UA_NS0ID(HIERARCHICALREFERENCES);
+        rpe[1].includeSubtypes = true;
+        rpe[1].targetName = UA_QUALIFIEDNAME(1, (char*)(uintptr_t)second);
+    }
+
+    UA_BrowsePath bp;
+    UA_BrowsePath_init(&bp);
+    bp.startingNode = UA_NS0ID(OBJECTSFOLDER);
+    bp.relativePath.elements = rpe;
+    bp.relativePath.elementsSize = (second) ? 2 : 1;
+    return UA_Server_translateBrowsePathToNodeIds(server, &bp);
+}
+
+static UA_Server *
+newServerWithTranslateCache(void) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_Server_getConfig(server)->translateBrowsePathCacheSize = 64;
+    return server;
+}
+
+START_TEST(Service_TranslateCache_Hit) {
+    UA_Server *server = newServerWithTranslateCache();
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Cached"),
+                                UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_BrowsePathResult bpr = translateObjectsPath(server, "Cached", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    UA_BrowsePathResult_clear(&bpr);
+    ck_assert_uint_eq(server->translateCacheSize, 64);
+
+    /* The second lookup is served from the cache with the same result */
+    bpr = translateObjectsPath(server, "Cached", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    ck_assert_uint_eq(bpr.targets[0].targetId.nodeId.identifier.numeric, 1);
+    UA_BrowsePathResult_clear(&bpr);
+
+    size_t valid = 0;
+    for(size_t i = 0; i < server->translateCacheSize; i++) {
+        if(server->translateCache[i].valid)
+            valid++;
+    }
+    ck_assert_uint_eq(valid, 1);
+
+    /* Disabling the cache releases the entries */
+    UA_Server_getConfig(server)->translateBrowsePathCacheSize = 0;
+    bpr = translateObjectsPath(server, "Cached", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    UA_BrowsePathResult_clear(&bpr);
+    ck_assert_uint_eq(server->translateCacheSize, 0);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+START_TEST(Service_TranslateCache_AddDeleteNode) {
+    UA_Server *server = newServerWithTranslateCache();
+
+    UA_BrowsePathResult bpr = translateObjectsPath(server, "Machine", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_BADNOMATCH);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* Adding the node invalidates the cached BadNoMatch */
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Machine"),
+                                UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    bpr = translateObjectsPath(server, "Machine", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* Deleting the node invalidates the cached target */
+    res = UA_Server_deleteNode(server, UA_NODEID_NUMERIC(1, 1), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    bpr = translateObjectsPath(server, "Machine", NULL);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_BADNOMATCH);
+    ck_assert_uint_eq(bpr.targetsSize, 0);
+    UA_BrowsePathResult_clear(&bpr);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+START_TEST(Service_TranslateCache_AddDeleteReference) {
+    UA_Server *server = newServerWithTranslateCache();
+
+    /* Objects/Line and Server/Motor. Motor is not (yet) a child of Line. */
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1),
+                                UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "Line"),
+                                UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 2),
+                                  UA_NS0ID(SERVER), UA_NS0ID(HASCOMPONENT),
+                                  UA_QUALIFIEDNAME(1, "Motor"),
+                                  UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_BrowsePathResult bpr = translateObjectsPath(server, "Line", "Motor");
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_BADNOMATCH);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* Adding the reference invalidates the cached BadNoMatch */
+    UA_ExpandedNodeId target = UA_EXPANDEDNODEID_NUMERIC(1, 2);
+    res = UA_Server_addReference(server, UA_NODEID_NUMERIC(1, 1),
+                                 UA_NS0ID(ORGANIZES), target, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    bpr = translateObjectsPath(server, "Line", "Motor");
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    ck_assert_uint_eq(bpr.targets[0].targetId.nodeId.identifier.numeric, 2);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* Deleting the reference invalidates the cached target */
+    res = UA_Server_deleteReference(server, UA_NODEID_NUMERIC(1, 1),
+                                    UA_NS0ID(ORGANIZES), true, target, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    bpr = translateObjectsPath(server, "Line", "Motor");
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_BADNOMATCH);
+    UA_BrowsePathResult_clear(&bpr);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+#define TRANSLATE_MODEL_FOLDERS 100
+#define TRANSLATE_MODEL_CHILDREN 1000 /* 100k nodes in total */
+#define TRANSLATE_MODEL_PATHS 1000
+#define TRANSLATE_MODEL_ROUNDS 20
+
+static double
+timeTranslations(UA_Server *server) {
+    char folderName[32];
+    char childName[32];
+    clock_t begin = clock();
+    for(size_t r = 0; r < TRANSLATE_MODEL_ROUNDS; r++) {
+        for(UA_UInt32 i = 0; i < TRANSLATE_MODEL_PATHS; i++) {
+            UA_UInt32 folder = i % TRANSLATE_MODEL_FOLDERS;
+            UA_UInt32 child = (i * 7) % TRANSLATE_MODEL_CHILDREN;
+            snprintf(folderName, sizeof(folderName), "Folder%u", (unsigned)folder);
+            snprintf(childName, sizeof(childName), "Child%u", (unsigned)child);
+            UA_BrowsePathResult bpr = translateObjectsPath(server, folderName, childName);
+            ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+            ck_assert_uint_eq(bpr.targetsSize, 1);
+            UA_BrowsePathResult_clear(&bpr);
+        }
+    }
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+START_TEST(Service_TranslateCache_benchmark) {
+    UA_Server *server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+
+    /* Build the model */
+    char name[32];
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    for(UA_UInt32 f = 0; f < TRANSLATE_MODEL_FOLDERS; f++) {
+        snprintf(name, sizeof(name), "Folder%u", (unsigned)f);
+        UA_NodeId folderId = UA_NODEID_NUMERIC(1, 1 + f);
+        UA_StatusCode res =
+            UA_Server_addObjectNode(server, folderId, UA_NS0ID(OBJECTSFOLDER),
+                                    UA_NS0ID(ORGANIZES), UA_QUALIFIEDNAME(1, name),
+                                    UA_NS0ID(FOLDERTYPE), oattr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        for(UA_UInt32 c = 0; c < TRANSLATE_MODEL_CHILDREN; c++) {
+            snprintf(name, sizeof(name), "Child%u", (unsigned)c);
+            res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 1000 + f *
+                                                                    TRANSLATE_MODEL_CHILDREN + c),
+                                          folderId, UA_NS0ID(ORGANIZES),
+                                          UA_QUALIFIEDNAME(1, name),
+                                          UA_NS0ID(BASEOBJECTTYPE), oattr, NULL, NULL);
+            ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        }
+    }
+
+    double uncached = timeTranslations(server);
+    UA_Server_getConfig(server)->translateBrowsePathCacheSize = 4096;
+    double cached = timeTranslations(server);
+
+    printf("%u translations over %u nodes took %f s uncached and %f s cached\n",
+           (unsigned)(TRANSLATE_MODEL_ROUNDS * TRANSLATE_MODEL_PATHS),
+           (unsigned)(TRANSLATE_MODEL_FOLDERS * TRANSLATE_MODEL_CHILDREN),
+           uncached, cached);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
 static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     Suite *s = suite_create("Service_TranslateBrowsePathsToNodeIds");
     TCase *tc_browse = tcase_create("Browse Service");
@@ -501,6 +936,9 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     tcase_add_test(tc_browse, Service_Browse_ClassMask);
     tcase_add_test(tc_browse, Service_Browse_ReferenceTypes);
     tcase_add_test(tc_browse, Service_Browse_WithMaxResults);
+    tcase_add_test(tc_browse, Service_Browse_ContinuationPointSlots);
+    tcase_add_test(tc_browse, Service_Browse_ContinuationPointModified);
+    tcase_add_test(tc_browse, Service_Browse_LargeFolder_benchmark);
     tcase_add_test(tc_browse, Service_Browse_Recursive);
     tcase_add_test(tc_browse, Service_Browse_Localization);
     suite_add_tcase(s, tc_browse);
@@ -514,6 +952,13 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
 
     suite_add_tcase(s, tc_translate);
 
+    TCase *tc_cache = tcase_create("TranslateBrowsePathsCache");
+    tcase_add_test(tc_cache, Service_TranslateCache_Hit);
+    tcase_add_test(tc_cache, Service_TranslateCache_AddDeleteNode);
+    tcase_add_test(tc_cache, Service_TranslateCache_AddDeleteReference);
+    tcase_add_test(tc_cache, Service_TranslateCache_benchmark);
+    suite_add_tcase(s, tc_cache);
+
     return s;
 }
 
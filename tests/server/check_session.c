@@ -8,11 +8,13 @@
 #include <open62541/server_config_default.h>
 #include <open62541/types.h>
 
+#include "server/ua_server_internal.h"
 #include "server/ua_services.h"
 #include "client/ua_client_internal.h"
 #include "test_helpers.h"
 
 #include <check.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "thread_wrapper.h"
@@ -91,7 +93,8 @@ START_TEST(Session_init_ShallWork) {
     ck_assert_int_eq(session.availableContinuationPoints, UA_MAXCONTINUATIONPOINTS);
     ck_assert_ptr_eq(session.channel, NULL);
     ck_assert_ptr_eq(session.clientDescription.applicationName.locale.data, NULL);
-    ck_assert_ptr_eq(session.continuationPoints, NULL);
+    for(size_t i = 0; i < UA_MAXCONTINUATIONPOINTS; i++)
+        ck_assert_ptr_eq(session.continuationPoints[i], NULL);
     ck_assert_int_eq(session.maxRequestMessageSize, 0);
     ck_assert_int_eq(session.maxResponseMessageSize, 0);
     ck_assert_int_eq(session.sessionId.identifier.numeric, tmpNodeId.identifier.numeric);
@@ -186,6 +189,228 @@ START_TEST(Session_setSessionAttribute_ShallWork) {
 }
 END_TEST
 
+/* CreateSession, ActivateSession and CloseSession on an open SecureChannel */
+static void
+sessionCycle(UA_Client *client, UA_NodeId *sessionId) {
+    UA_CreateSessionRequest createReq;
+    UA_CreateSessionResponse createRes;
+    UA_CreateSessionRequest_init(&createReq);
+    createReq.sessionName = UA_STRING("BenchmarkSession");
+    __UA_Client_Service(client, &createReq, &UA_TYPES[UA_TYPES_CREATESESSIONREQUEST],
+                        &createRes, &UA_TYPES[UA_TYPES_CREATESESSIONRESPONSE]);
+    ck_assert_uint_eq(createRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_NodeId_copy(&createRes.authenticationToken, &client->authenticationToken);
+
+    UA_AnonymousIdentityToken token;
+    UA_AnonymousIdentityToken_init(&token);
+    token.policyId = UA_STRING("open62541-anonymous-policy#None");
+    UA_ActivateSessionRequest activateReq;
+    UA_ActivateSessionResponse activateRes;
+    UA_ActivateSessionRequest_init(&activateReq);
+    UA_ExtensionObject_setValue(&activateReq.userIdentityToken, &token,
+                                &UA_TYPES[UA_TYPES_ANONYMOUSIDENTITYTOKEN]);
+    __UA_Client_Service(client, &activateReq, &UA_TYPES[UA_TYPES_ACTIVATESESSIONREQUEST],
+                        &activateRes, &UA_TYPES[UA_TYPES_ACTIVATESESSIONRESPONSE]);
+    ck_assert_uint_eq(activateRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_ActivateSessionResponse_clear(&activateRes);
+
+    /* Inspect the active session before closing */
+    if(sessionId) {
+        UA_NodeId_copy(&createRes.sessionId, sessionId);
+        UA_CreateSessionResponse_clear(&createRes);
+        return;
+    }
+
+    UA_CloseSessionRequest closeReq;
+    UA_CloseSessionResponse closeRes;
+    UA_CloseSessionRequest_init(&closeReq);
+    closeReq.deleteSubscriptions = true;
+    __UA_Client_Service(client, &closeReq, &UA_TYPES[UA_TYPES_CLOSESESSIONREQUEST],
+                        &closeRes, &UA_TYPES[UA_TYPES_CLOSESESSIONRESPONSE]);
+    ck_assert_uint_eq(closeRes.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_CloseSessionResponse_clear(&closeRes);
+    UA_CreateSessionResponse_clear(&createRes);
+    UA_NodeId_clear(&client->authenticationToken);
+}
+
+#define SESSION_CYCLES 500
+
+static void
+benchmarkSessionCycles(const char *mode) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connectSecureChannel(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < SESSION_CYCLES; i++)
+        sessionCycle(client, NULL);
+    UA_DateTime finish = UA_DateTime_nowMonotonic();
+
+    double seconds = (double)(finish - begin) / UA_DATETIME_SEC;
+    printf("%u session cycles (%s) took %f s, %.0f cycles/s\n",
+           (unsigned)SESSION_CYCLES, mode, seconds, (double)SESSION_CYCLES / seconds);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+
+START_TEST(Session_cycles_benchmark) {
+    benchmarkSessionCycles("eager diagnostics");
+} END_TEST
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+
+static void setup_lazy(void) {
+    running = true;
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    UA_Server_getConfig(server)->lazyDiagnostics = true;
+    UA_Server_run_startup(server);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+START_TEST(Session_cycles_lazyDiagnostics_benchmark) {
+    benchmarkSessionCycles("lazy diagnostics");
+} END_TEST
+
+START_TEST(Session_lazyDiagnostics) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connectSecureChannel(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_NodeId sessionId;
+    sessionCycle(client, &sessionId);
+
+    /* The session object is not created yet */
+    ck_assert(server->diagnosticsPending);
+    session_list_entry *sentry;
+    LIST_FOREACH(sentry, &server->sessions, pointers) {
+        ck_assert(!sentry->session.diagnosticsObject);
+    }
+
+    /* Browsing the diagnostics summary creates the session object */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NS0ID(SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY);
+    bd.referenceTypeId = UA_NS0ID(HASCOMPONENT);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        if(UA_NodeId_equal(&br.references[i].nodeId.nodeId, &sessionId))
+            found = true;
+    }
+    ck_assert(found);
+    UA_BrowseResult_clear(&br);
+    ck_assert(!server->diagnosticsPending);
+
+    /* Read from the session object */
+    UA_QualifiedName sessionDiagnostics = UA_QUALIFIEDNAME(0, "SessionDiagnostics");
+    UA_BrowsePathResult bpr =
+        UA_Server_browseSimplifiedBrowsePath(server, sessionId, 1, &sessionDiagnostics);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    UA_Variant value;
+    retval = UA_Server_readValue(server, bpr.targets[0].targetId.nodeId, &value);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_SESSIONDIAGNOSTICSDATATYPE]));
+    UA_Variant_clear(&value);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* A new session is pending until it is accessed directly */
+    UA_Client *client2 = UA_Client_newForUnitTest();
+    retval = UA_Client_connectSecureChannel(client2, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeId sessionId2;
+    sessionCycle(client2, &sessionId2);
+    ck_assert(server->diagnosticsPending);
+    UA_NodeClass nc = UA_NODECLASS_UNSPECIFIED;
+    retval = UA_Server_readNodeClass(server, sessionId2, &nc);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(nc, UA_NODECLASS_OBJECT);
+    ck_assert(!server->diagnosticsPending);
+
+    UA_NodeId_clear(&sessionId2);
+    UA_Client_disconnect(client2);
+    UA_Client_delete(client2);
+    UA_NodeId_clear(&sessionId);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+static UA_Boolean
+hasDiagnosticsObject(const UA_NodeId *sessionId) {
+    session_list_entry *sentry;
+    LIST_FOREACH(sentry, &server->sessions, pointers) {
+        if(UA_NodeId_equal(&sentry->session.sessionId, sessionId))
+            return sentry->session.diagnosticsObject;
+    }
+    ck_abort_msg("Session not found");
+    return false;
+}
+
+START_TEST(Session_lazyDiagnosticsServices) {
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode retval = UA_Client_connectSecureChannel(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeId sessionId;
+    sessionCycle(client, &sessionId);
+    UA_Client *client2 = UA_Client_newForUnitTest();
+    retval = UA_Client_connectSecureChannel(client2, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeId sessionId2;
+    sessionCycle(client2, &sessionId2);
+    ck_assert(server->diagnosticsPending);
+
+    /* Application nodes with a Guid NodeId don't create the objects */
+    UA_NodeId appNode = UA_NODEID_GUID(1, UA_GUID("a2b8c3d4-0000-4000-8000-000000000001"));
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    retval = UA_Server_addObjectNode(server, appNode, UA_NS0ID(OBJECTSFOLDER),
+                                     UA_NS0ID(ORGANIZES), UA_QUALIFIEDNAME(1, "App"),
+                                     UA_NS0ID(BASEOBJECTTYPE), oAttr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeClass nc = UA_NODECLASS_UNSPECIFIED;
+    retval = UA_Server_readNodeClass(server, appNode, &nc);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_NodeId unknown = UA_NODEID_GUID(1, UA_GUID("a2b8c3d4-0000-4000-8000-000000000002"));
+    retval = UA_Server_readNodeClass(server, unknown, &nc);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    ck_assert(!hasDiagnosticsObject(&sessionId));
+    ck_assert(!hasDiagnosticsObject(&sessionId2));
+
+    /* Write creates only the object of the accessed session */
+    UA_LocalizedText name = UA_LOCALIZEDTEXT("", "Renamed");
+    retval = UA_Server_writeDisplayName(server, sessionId, name);
+    ck_assert_uint_ne(retval, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    ck_assert(hasDiagnosticsObject(&sessionId));
+    ck_assert(!hasDiagnosticsObject(&sessionId2));
+    ck_assert(server->diagnosticsPending);
+
+    /* CreateMonitoredItems on the object of the second session */
+    UA_MonitoredItemCreateRequest item =
+        UA_MonitoredItemCreateRequest_default(sessionId2);
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_DISPLAYNAME;
+    UA_MonitoredItemCreateResult mon =
+        UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_BOTH,
+                                                item, NULL, NULL);
+    ck_assert_uint_eq(mon.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert(hasDiagnosticsObject(&sessionId2));
+    ck_assert(!server->diagnosticsPending);
+    retval = UA_Server_deleteMonitoredItem(server, mon.monitoredItemId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_NodeId_clear(&sessionId2);
+    UA_Client_disconnect(client2);
+    UA_Client_delete(client2);
+    UA_NodeId_clear(&sessionId);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+#endif /* UA_ENABLE_DIAGNOSTICS */
+
 static Suite* testSuite_Session(void) {
     Suite *s = suite_create("Session");
     TCase *tc_session = tcase_create("Core");
@@ -195,7 +420,17 @@ static Suite* testSuite_Session(void) {
     tcase_add_test(tc_session, Session_updateLifetime_ShallWork);
     tcase_add_test(tc_session, Session_notificationCallback);
     tcase_add_test(tc_session, Session_setSessionAttribute_ShallWork);
+    tcase_add_test(tc_session, Session_cycles_benchmark);
     suite_add_tcase(s,tc_session);
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+    TCase *tc_lazy = tcase_create("LazyDiagnostics");
+    tcase_add_checked_fixture(tc_lazy, setup_lazy, teardown);
+    tcase_add_test(tc_lazy, Session_lazyDiagnostics);
+    tcase_add_test(tc_lazy, Session_lazyDiagnosticsServices);
+    tcase_add_test(tc_lazy, Session_cycles_lazyDiagnostics_benchmark);
+    suite_add_tcase(s,tc_lazy);
+#endif
     return s;
 }
 
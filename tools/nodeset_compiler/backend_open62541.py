@@ -540,7 +540,53 @@ def sortNodes(nodeset):
 # Generate C Code #
 ###################
 
-def generateOpen62541Code(nodeset, outfilename, internal_headers=False, typesArray=[]):
+def generateImageGenerator(outfilename):
+    # Program that writes the nodestore image of a server with the nodeset.
+    # The image is loaded with UA_ServerConfig.nodestoreImage.
+    outfilebase = basename(outfilename)
+    with codecs.open(outfilename + "_image.c", r"w+", encoding='utf-8') as outfile:
+        outfile.write("""/* WARNING: This is a generated file.
+ * Any manual changes will be overwritten. */
+
+#include <open62541/server.h>
+#include <stdio.h>
+
+#include "%s.h"
+
+int main(int argc, char **argv) {
+    if(argc != 2) {
+        printf("Usage: %%s <image-file>\\n", argv[0]);
+        return 1;
+    }
+
+    UA_Server *server = UA_Server_new();
+    if(!server)
+        return 1;
+
+    UA_ByteString image = UA_BYTESTRING_NULL;
+    UA_StatusCode res = %s(server);
+    if(res == UA_STATUSCODE_GOOD)
+        res = UA_Server_saveNodestoreImage(server, &image);
+    UA_Server_delete(server);
+    if(res != UA_STATUSCODE_GOOD) {
+        printf("Generating the nodestore image failed with %%s\\n",
+               UA_StatusCode_name(res));
+        return 1;
+    }
+
+    FILE *fp = fopen(argv[1], "wb");
+    UA_Boolean written = false;
+    if(fp) {
+        written = (fwrite(image.data, 1, image.length, fp) == image.length);
+        fclose(fp);
+    }
+    UA_ByteString_clear(&image);
+    return written ? 0 : 1;
+}
+""" % (outfilebase, outfilebase))
+
+def generateOpen62541Code(nodeset, outfilename, internal_headers=False, typesArray=[],
+                          image_generator=False):
     outfilebase = basename(outfilename)
     # Printing functions
     outfileh = codecs.open(outfilename + ".h", r"w+", encoding='utf-8')
@@ -750,3 +796,6 @@ UA_StatusCode retVal = UA_STATUSCODE_GOOD;""" % (outfilebase))
     os.fsync(outfilec)
     outfilec.close()
 
+    if image_generator:
+        generateImageGenerator(outfilename)
+
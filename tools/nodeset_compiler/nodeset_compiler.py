@@ -51,6 +51,11 @@ parser.add_argument('--internal-headers',
                     dest="internal_headers",
                     help='Include internal headers instead of amalgamated header')
 
+parser.add_argument('--image-generator',
+                    action='store_true',
+                    dest="image_generator",
+                    help='Also generate <output file>_image.c with a main function that writes the nodestore image of a server with the nodeset to a file')
+
 parser.add_argument('-b', '--blacklist',
                     metavar="<blacklistFile>",
                     type=argparse.FileType('r'),
@@ -219,7 +224,8 @@ logger.info(f"Generating Code for Backend: {args.backend}")
 if args.backend == "open62541":
     # Create the C code with the open62541 backend of the compiler
     from backend_open62541 import generateOpen62541Code
-    generateOpen62541Code(ns, args.outputFile, args.internal_headers, args.typesArray)
+    generateOpen62541Code(ns, args.outputFile, args.internal_headers, args.typesArray,
+                          args.image_generator)
 elif args.backend == "graphviz":
     from backend_graphviz import generateGraphvizCode
     generateGraphvizCode(ns, filename=args.outputFile)
@@ -0,0 +1,831 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Loopback latency benchmark for the server under mixed load. A server runs in
+ * its own thread and N client threads send a configurable mix of Read, Write,
+ * Browse and Call requests. Every client additionally monitors a set of
+ * variables. The latency of the Publish path is measured for every received
+ * DataChange notification as the delay since the SourceTimestamp that was set
+ * by the writing client. The results (percentiles per service and CPU time) are
+ * printed as a table to stderr and as JSON to stdout or the output file. */
+
+#include <open62541/client.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_subscriptions.h>
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define BENCH_FOLDER_ID   1000
+#define BENCH_METHOD_ID   1001
+#define BENCH_ITEM_BASEID 100000
+
+typedef enum {
+    BENCH_READ = 0,
+    BENCH_WRITE,
+    BENCH_BROWSE,
+    BENCH_CALL,
+    BENCH_PUBLISH,
+    BENCH_SERVICES
+} BenchService;
+
+/* Only the request/response services are part of the operation mix */
+#define BENCH_MIXSERVICES BENCH_PUBLISH
+
+static const char *serviceNames[BENCH_SERVICES] =
+    {"Read", "Write", "Browse", "Call", "Publish"};
+static const char *mixNames[BENCH_MIXSERVICES] =
+    {"read", "write", "browse", "call"};
+
+/*****************/
+/* Configuration */
+/*****************/
+
+static UA_UInt16 port = 4842;
+static size_t clientsSize = 4;
+static size_t itemsSize = 2000;
+static size_t monitoredSize = 1000; /* Per client */
+static UA_Double duration = 10.0; /* Seconds */
+static UA_Double warmup = 2.0; /* Seconds */
+static UA_Double publishingInterval = 50.0;
+static UA_Double samplingInterval = 0.0; /* Sample on every write */
+static UA_UInt32 mix[BENCH_MIXSERVICES] = {40, 30, 15, 15};
+static UA_UInt32 mixTotal = 100;
+static UA_UInt32 seed = 1;
+static const char *outputFile = NULL;
+static UA_LogLevel logLevel = UA_LOGLEVEL_ERROR;
+
+/***********/
+/* Samples */
+/***********/
+
+typedef struct {
+    size_t size;
+    size_t capacity;
+    UA_DateTime *latencies; /* In 100ns ticks */
+    size_t errors;
+} Samples;
+
+static void
+Samples_add(Samples *s, UA_DateTime latency) {
+    if(s->size == s->capacity) {
+        size_t newCapacity = (s->capacity == 0) ? 1024 : s->capacity * 2;
+        UA_DateTime *newLatencies = (UA_DateTime*)
+            UA_realloc(s->latencies, newCapacity * sizeof(UA_DateTime));
+        if(!newLatencies) {
+            s->errors++;
+            return;
+        }
+        s->latencies = newLatencies;
+        s->capacity = newCapacity;
+    }
+    s->latencies[s->size++] = latency;
+}
+
+/* Move all samples from src to dst */
+static void
+Samples_merge(Samples *dst, Samples *src) {
+    dst->errors += src->errors;
+    if(src->size > 0) {
+        UA_DateTime *newLatencies = (UA_DateTime*)
+            UA_realloc(dst->latencies, (dst->size + src->size) * sizeof(UA_DateTime));
+        if(newLatencies) {
+            memcpy(&newLatencies[dst->size], src->latencies,
+                   src->size * sizeof(UA_DateTime));
+            dst->latencies = newLatencies;
+            dst->size += src->size;
+            dst->capacity = dst->size;
+        } else {
+            dst->errors += src->size;
+        }
+    }
+    UA_free(src->latencies);
+    memset(src, 0, sizeof(Samples));
+}
+
+static int
+compareLatency(const void *a, const void *b) {
+    UA_DateTime la = *(const UA_DateTime*)a;
+    UA_DateTime lb = *(const UA_DateTime*)b;
+    return (la > lb) - (la < lb);
+}
+
+/* Nearest-rank percentile of the sorted samples in per mille */
+static UA_DateTime
+Samples_percentile(const Samples *s, size_t perMille) {
+    size_t rank = (s->size * perMille + 999) / 1000;
+    if(rank == 0)
+        rank = 1;
+    return s->latencies[rank - 1];
+}
+
+/**********/
+/* Server */
+/**********/
+
+static UA_StatusCode
+incrementMethod(UA_Server *server,
+                const UA_NodeId *sessionId, void *sessionContext,
+                const UA_NodeId *methodId, void *methodContext,
+                const UA_NodeId *objectId, void *objectContext,
+                size_t inputSize, const UA_Variant *input,
+                size_t outputSize, UA_Variant *output) {
+    if(!UA_Variant_hasScalarType(input, &UA_TYPES[UA_TYPES_INT32]))
+        return UA_STATUSCODE_BADTYPEMISMATCH;
+    UA_Int32 result = *(UA_Int32*)input->data + 1;
+    return UA_Variant_setScalarCopy(output, &result, &UA_TYPES[UA_TYPES_INT32]);
+}
+
+static UA_Server *
+createServer(void) {
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    config.logging = UA_Log_Stdout_new(logLevel);
+    UA_StatusCode res = UA_ServerConfig_setMinimal(&config, port, NULL);
+    if(res != UA_STATUSCODE_GOOD)
+        return NULL;
+    config.tcpReuseAddr = true;
+    if(config.maxSessions < clientsSize)
+        config.maxSessions = (UA_UInt32)clientsSize;
+    if(config.maxSecureChannels < clientsSize)
+        config.maxSecureChannels = (UA_UInt16)clientsSize;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    /* Allow the intervals configured for the benchmark */
+    config.publishingIntervalLimits.min = 1.0;
+    config.samplingIntervalLimits.min = 1.0;
+#endif
+    UA_Server *server = UA_Server_newWithConfig(&config);
+    if(!server)
+        return NULL;
+
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    oAttr.displayName = UA_LOCALIZEDTEXT("", "Benchmark");
+    res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, BENCH_FOLDER_ID),
+                                  UA_NS0ID(OBJECTSFOLDER), UA_NS0ID(ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Benchmark"),
+                                  UA_NS0ID(FOLDERTYPE), oAttr, NULL, NULL);
+
+    UA_Int32 zero = 0;
+    UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+    vAttr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    vAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE |
+        UA_ACCESSLEVELMASK_TIMESTAMPWRITE;
+    UA_Variant_setScalar(&vAttr.value, &zero, &UA_TYPES[UA_TYPES_INT32]);
+    char name[32];
+    for(size_t i = 0; i < itemsSize && res == UA_STATUSCODE_GOOD; i++) {
+        snprintf(name, sizeof(name), "Item%lu", (unsigned long)i);
+        vAttr.displayName = UA_LOCALIZEDTEXT("", name);
+        res = UA_Server_addVariableNode(server,
+                                        UA_NODEID_NUMERIC(1, (UA_UInt32)(BENCH_ITEM_BASEID + i)),
+                                        UA_NODEID_NUMERIC(1, BENCH_FOLDER_ID),
+                                        UA_NS0ID(HASCOMPONENT),
+                                        UA_QUALIFIEDNAME(1, name),
+                                        UA_NS0ID(BASEDATAVARIABLETYPE),
+                                        vAttr, NULL, NULL);
+    }
+
+#ifdef UA_ENABLE_METHODCALLS
+    if(res == UA_STATUSCODE_GOOD) {
+        UA_Argument arg;
+        UA_Argument_init(&arg);
+        arg.name = UA_STRING("Value");
+        arg.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+        arg.valueRank = UA_VALUERANK_SCALAR;
+        UA_MethodAttributes mAttr = UA_MethodAttributes_default;
+        mAttr.displayName = UA_LOCALIZEDTEXT("", "Increment");
+        mAttr.executable = true;
+        mAttr.userExecutable = true;
+        res = UA_Server_addMethodNode(server, UA_NODEID_NUMERIC(1, BENCH_METHOD_ID),
+                                      UA_NODEID_NUMERIC(1, BENCH_FOLDER_ID),
+                                      UA_NS0ID(HASCOMPONENT),
+                                      UA_QUALIFIEDNAME(1, "Increment"), mAttr,
+                                      incrementMethod, 1, &arg, 1, &arg, NULL, NULL);
+    }
+#endif
+
+    if(res != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "Could not create the information model (%s)\n",
+                UA_StatusCode_name(res));
+        UA_Server_delete(server);
+        return NULL;
+    }
+    return server;
+}
+
+static volatile UA_Boolean serverRunning = true;
+
+static void *
+serverLoop(void *context) {
+    UA_Server *server = (UA_Server*)context;
+    while(serverRunning)
+        UA_Server_run_iterate(server, true);
+    return NULL;
+}
+
+/***********/
+/* Clients */
+/***********/
+
+typedef struct {
+    size_t index;
+    pthread_t thread;
+    UA_Client *client;
+    UA_UInt32 rng;
+    UA_Int32 counter;
+    UA_StatusCode setupResult;
+    UA_Double cpuTime; /* Thread CPU time in the measurement window (seconds) */
+    Samples samples[BENCH_SERVICES];
+} BenchClient;
+
+/* The measurement window in monotonic time. Set before the clients are
+ * released from the start barrier. */
+static UA_DateTime measureStart;
+static UA_DateTime measureEnd;
+static pthread_barrier_t startBarrier;
+
+static UA_UInt32
+BenchClient_random(BenchClient *bc) {
+    /* xorshift32, the UA_UInt32_random state is not thread-local */
+    UA_UInt32 x = bc->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bc->rng = x;
+    return x;
+}
+
+static UA_NodeId
+BenchClient_randomItem(BenchClient *bc) {
+    return UA_NODEID_NUMERIC(1, (UA_UInt32)
+                             (BENCH_ITEM_BASEID + BenchClient_random(bc) % itemsSize));
+}
+
+static UA_Boolean
+inMeasureWindow(UA_DateTime monotonicNow) {
+    return monotonicNow >= measureStart && monotonicNow < measureEnd;
+}
+
+static UA_Double
+clockSeconds(clockid_t cid) {
+    struct timespec ts;
+    clock_gettime(cid, &ts);
+    return (UA_Double)ts.tv_sec + (UA_Double)ts.tv_nsec / 1e9;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+
+static void
+dataChangeCallback(UA_Client *client, UA_UInt32 subId, void *subContext,
+                   UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    BenchClient *bc = (BenchClient*)monContext;
+    if(!inMeasureWindow(UA_DateTime_nowMonotonic()))
+        return;
+    Samples *s = &bc->samples[BENCH_PUBLISH];
+    if(!value->hasSourceTimestamp) {
+        s->errors++;
+        return;
+    }
+    Samples_add(s, UA_DateTime_now() - value->sourceTimestamp);
+}
+
+static UA_StatusCode
+BenchClient_subscribe(BenchClient *bc) {
+    if(monitoredSize == 0)
+        return UA_STATUSCODE_GOOD;
+
+    UA_CreateSubscriptionRequest subReq = UA_CreateSubscriptionRequest_default();
+    subReq.requestedPublishingInterval = publishingInterval;
+    subReq.maxNotificationsPerPublish = 0;
+    UA_CreateSubscriptionResponse subResp =
+        UA_Client_Subscriptions_create(bc->client, subReq, NULL, NULL, NULL);
+    UA_StatusCode res = subResp.responseHeader.serviceResult;
+    UA_UInt32 subId = subResp.subscriptionId;
+    UA_CreateSubscriptionResponse_clear(&subResp);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Every client monitors a different window of the items */
+    UA_MonitoredItemCreateRequest *items = (UA_MonitoredItemCreateRequest*)
+        UA_calloc(monitoredSize, sizeof(UA_MonitoredItemCreateRequest));
+    void **contexts = (void**)UA_calloc(monitoredSize, sizeof(void*));
+    UA_Client_DataChangeNotificationCallback *callbacks =
+        (UA_Client_DataChangeNotificationCallback*)
+        UA_calloc(monitoredSize, sizeof(UA_Client_DataChangeNotificationCallback));
+    if(!items || !contexts || !callbacks) {
+        res = UA_STATUSCODE_BADOUTOFMEMORY;
+        goto cleanup;
+    }
+    for(size_t i = 0; i < monitoredSize; i++) {
+        size_t item = (bc->index * monitoredSize + i) % itemsSize;
+        items[i] = UA_MonitoredItemCreateRequest_default(
+            UA_NODEID_NUMERIC(1, (UA_UInt32)(BENCH_ITEM_BASEID + item)));
+        items[i].requestedParameters.samplingInterval = samplingInterval;
+        items[i].requestedParameters.queueSize = 10;
+        contexts[i] = bc;
+        callbacks[i] = dataChangeCallback;
+    }
+
+    UA_CreateMonitoredItemsRequest monReq;
+    UA_CreateMonitoredItemsRequest_init(&monReq);
+    monReq.subscriptionId = subId;
+    monReq.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    monReq.itemsToCreate = items;
+    monReq.itemsToCreateSize = monitoredSize;
+    UA_CreateMonitoredItemsResponse monResp =
+        UA_Client_MonitoredItems_createDataChanges(bc->client, monReq, contexts,
+                                                   callbacks, NULL);
+    res = monResp.responseHeader.serviceResult;
+    for(size_t i = 0; i < monResp.resultsSize && res == UA_STATUSCODE_GOOD; i++)
+        res = monResp.results[i].statusCode;
+    UA_CreateMonitoredItemsResponse_clear(&monResp);
+
+ cleanup:
+    UA_free(items);
+    UA_free(contexts);
+    UA_free(callbacks);
+    return res;
+}
+
+#endif /* UA_ENABLE_SUBSCRIPTIONS */
+
+static UA_StatusCode
+BenchClient_setup(BenchClient *bc) {
+    UA_ClientConfig cc;
+    memset(&cc, 0, sizeof(UA_ClientConfig));
+    cc.logging = UA_Log_Stdout_new(logLevel);
+    UA_StatusCode res = UA_ClientConfig_setDefault(&cc);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    cc.timeout = 10000;
+    bc->client = UA_Client_newWithConfig(&cc);
+    if(!bc->client)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    char url[64];
+    snprintf(url, sizeof(url), "opc.tcp://localhost:%u", (unsigned)port);
+    res = UA_Client_connect(bc->client, url);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    res = BenchClient_subscribe(bc);
+#endif
+    return res;
+}
+
+static UA_StatusCode
+BenchClient_read(BenchClient *bc) {
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = BenchClient_randomItem(bc);
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest req;
+    UA_ReadRequest_init(&req);
+    req.nodesToRead = &rvi;
+    req.nodesToReadSize = 1;
+    UA_ReadResponse resp = UA_Client_Service_read(bc->client, req);
+    UA_StatusCode res = resp.responseHeader.serviceResult;
+    if(res == UA_STATUSCODE_GOOD && resp.resultsSize == 1)
+        res = resp.results[0].status;
+    UA_ReadResponse_clear(&resp);
+    return res;
+}
+
+static UA_StatusCode
+BenchClient_write(BenchClient *bc) {
+    UA_Int32 value = (UA_Int32)((bc->index << 24) | (UA_UInt32)(++bc->counter & 0xffffff));
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = BenchClient_randomItem(bc);
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_Variant_setScalar(&wv.value.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    wv.value.hasValue = true;
+    wv.value.sourceTimestamp = UA_DateTime_now();
+    wv.value.hasSourceTimestamp = true;
+    UA_WriteRequest req;
+    UA_WriteRequest_init(&req);
+    req.nodesToWrite = &wv;
+    req.nodesToWriteSize = 1;
+    UA_WriteResponse resp = UA_Client_Service_write(bc->client, req);
+    UA_StatusCode res = resp.responseHeader.serviceResult;
+    if(res == UA_STATUSCODE_GOOD && resp.resultsSize == 1)
+        res = resp.results[0];
+    UA_WriteResponse_clear(&resp);
+    return res;
+}
+
+static UA_StatusCode
+BenchClient_browse(BenchClient *bc) {
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = BenchClient_randomItem(bc);
+    bd.browseDirection = UA_BROWSEDIRECTION_BOTH;
+    bd.includeSubtypes = true;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseRequest req;
+    UA_BrowseRequest_init(&req);
+    req.nodesToBrowse = &bd;
+    req.nodesToBrowseSize = 1;
+    UA_BrowseResponse resp = UA_Client_Service_browse(bc->client, req);
+    UA_StatusCode res = resp.responseHeader.serviceResult;
+    if(res == UA_STATUSCODE_GOOD && resp.resultsSize == 1)
+        res = resp.results[0].statusCode;
+    UA_BrowseResponse_clear(&resp);
+    return res;
+}
+
+static UA_StatusCode
+BenchClient_call(BenchClient *bc) {
+    UA_Int32 value = (UA_Int32)(BenchClient_random(bc) & 0xffff);
+    UA_CallMethodRequest cmr;
+    UA_CallMethodRequest_init(&cmr);
+    cmr.objectId = UA_NODEID_NUMERIC(1, BENCH_FOLDER_ID);
+    cmr.methodId = UA_NODEID_NUMERIC(1, BENCH_METHOD_ID);
+    UA_Variant input;
+    UA_Variant_setScalar(&input, &value, &UA_TYPES[UA_TYPES_INT32]);
+    cmr.inputArguments = &input;
+    cmr.inputArgumentsSize = 1;
+    UA_CallRequest req;
+    UA_CallRequest_init(&req);
+    req.methodsToCall = &cmr;
+    req.methodsToCallSize = 1;
+    UA_CallResponse resp = UA_Client_Service_call(bc->client, req);
+    UA_StatusCode res = resp.responseHeader.serviceResult;
+    if(res == UA_STATUSCODE_GOOD && resp.resultsSize == 1)
+        res = resp.results[0].statusCode;
+    UA_CallResponse_clear(&resp);
+    return res;
+}
+
+static UA_StatusCode (*const serviceOps[BENCH_MIXSERVICES])(BenchClient *bc) =
+    {BenchClient_read, BenchClient_write, BenchClient_browse, BenchClient_call};
+
+static BenchService
+BenchClient_nextService(BenchClient *bc) {
+    UA_UInt32 r = BenchClient_random(bc) % mixTotal;
+    size_t s = 0;
+    for(; s < BENCH_MIXSERVICES - 1; s++) {
+        if(r < mix[s])
+            break;
+        r -= mix[s];
+    }
+    return (BenchService)s;
+}
+
+static void *
+clientLoop(void *context) {
+    BenchClient *bc = (BenchClient*)context;
+    bc->setupResult = BenchClient_setup(bc);
+    pthread_barrier_wait(&startBarrier); /* All clients are set up */
+    pthread_barrier_wait(&startBarrier); /* The measurement window is set */
+    if(bc->setupResult != UA_STATUSCODE_GOOD)
+        return NULL;
+
+    UA_Boolean measuring = false;
+    UA_Double cpuStart = 0.0;
+    while(true) {
+        UA_DateTime now = UA_DateTime_nowMonotonic();
+        if(now >= measureEnd)
+            break;
+        if(!measuring && now >= measureStart) {
+            measuring = true;
+            cpuStart = clockSeconds(CLOCK_THREAD_CPUTIME_ID);
+        }
+
+        /* Without a request mix only the Publish responses are processed */
+        if(mixTotal == 0) {
+            UA_Client_run_iterate(bc->client, 10);
+            continue;
+        }
+
+        BenchService s = BenchClient_nextService(bc);
+        UA_DateTime start = UA_DateTime_nowMonotonic();
+        UA_StatusCode res = serviceOps[s](bc);
+        UA_DateTime end = UA_DateTime_nowMonotonic();
+        if(inMeasureWindow(start)) {
+            if(res == UA_STATUSCODE_GOOD)
+                Samples_add(&bc->samples[s], end - start);
+            else
+                bc->samples[s].errors++;
+        }
+
+        /* Process the outstanding Publish responses */
+        UA_Client_run_iterate(bc->client, 0);
+    }
+    if(measuring)
+        bc->cpuTime = clockSeconds(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+
+    UA_Client_disconnect(bc->client);
+    return NULL;
+}
+
+/**********/
+/* Report */
+/**********/
+
+typedef struct {
+    UA_Double processUser;
+    UA_Double processSystem;
+    UA_Double serverThread;
+    UA_Double clientThreads;
+} CpuTimes;
+
+static UA_Double
+timevalSeconds(struct timeval tv) {
+    return (UA_Double)tv.tv_sec + (UA_Double)tv.tv_usec / 1e6;
+}
+
+static UA_Double
+ticksToUs(UA_DateTime ticks) {
+    return (UA_Double)ticks / (UA_Double)UA_DATETIME_USEC;
+}
+
+static void
+printTable(Samples *results) {
+    fprintf(stderr, "%-8s %10s %8s %12s %10s %10s %10s %10s\n", "Service",
+            "Count", "Errors", "Ops/s", "p50 [us]", "p99 [us]", "p999 [us]", "max [us]");
+    for(size_t s = 0; s < BENCH_SERVICES; s++) {
+        Samples *r = &results[s];
+        fprintf(stderr, "%-8s %10lu %8lu %12.1f", serviceNames[s],
+                (unsigned long)r->size, (unsigned long)r->errors,
+                (UA_Double)r->size / duration);
+        if(r->size > 0)
+            fprintf(stderr, " %10.1f %10.1f %10.1f %10.1f",
+                    ticksToUs(Samples_percentile(r, 500)),
+                    ticksToUs(Samples_percentile(r, 990)),
+                    ticksToUs(Samples_percentile(r, 999)),
+                    ticksToUs(r->latencies[r->size - 1]));
+        fprintf(stderr, "\n");
+    }
+}
+
+static void
+printJson(FILE *out, Samples *results, const CpuTimes *cpu) {
+    fprintf(out, "{\n  \"benchmark\": \"ua-bench\",\n");
+    fprintf(out, "  \"config\": {\"clients\": %lu, \"items\": %lu, "
+            "\"monitoredItemsPerClient\": %lu, \"duration\": %.3f, \"warmup\": %.3f, "
+            "\"publishingInterval\": %.3f, \"samplingInterval\": %.3f, \"mix\": {",
+            (unsigned long)clientsSize, (unsigned long)itemsSize,
+            (unsigned long)monitoredSize, duration, warmup,
+            publishingInterval, samplingInterval);
+    for(size_t s = 0; s < BENCH_MIXSERVICES; s++)
+        fprintf(out, "%s\"%s\": %u", (s > 0) ? ", " : "", mixNames[s], mix[s]);
+    fprintf(out, "}},\n");
+    fprintf(out, "  \"cpu\": {\"processUser\": %.6f, \"processSystem\": %.6f, "
+            "\"serverThread\": %.6f, \"clientThreads\": %.6f},\n",
+            cpu->processUser, cpu->processSystem, cpu->serverThread, cpu->clientThreads);
+    fprintf(out, "  \"services\": [\n");
+    for(size_t s = 0; s < BENCH_SERVICES; s++) {
+        Samples *r = &results[s];
+        fprintf(out, "    {\"service\": \"%s\", \"count\": %lu, \"errors\": %lu, "
+                "\"throughput\": %.3f", serviceNames[s], (unsigned long)r->size,
+                (unsigned long)r->errors, (UA_Double)r->size / duration);
+        if(r->size > 0) {
+            UA_DateTime sum = 0;
+            for(size_t i = 0; i < r->size; i++)
+                sum += r->latencies[i];
+            fprintf(out, ", \"meanUs\": %.3f, \"minUs\": %.3f, \"p50Us\": %.3f, "
+                    "\"p99Us\": %.3f, \"p999Us\": %.3f, \"maxUs\": %.3f",
+                    ticksToUs(sum) / (UA_Double)r->size, ticksToUs(r->latencies[0]),
+                    ticksToUs(Samples_percentile(r, 500)),
+                    ticksToUs(Samples_percentile(r, 990)),
+                    ticksToUs(Samples_percentile(r, 999)),
+                    ticksToUs(r->latencies[r->size - 1]));
+        }
+        fprintf(out, "}%s\n", (s + 1 < BENCH_SERVICES) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/***********/
+/* Options */
+/***********/
+
+static void
+usage(void) {
+    fprintf(stderr, "Usage: ua-bench [--help | <options>]\n"
+            " Options:\n"
+            " --clients <n>: Number of client threads (default: 4)\n"
+            " --items <n>: Number of variables in the server (default: 2000)\n"
+            " --monitored <n>: MonitoredItems per client (default: 1000)\n"
+            " --duration <s>: Length of the measurement in seconds (default: 10)\n"
+            " --warmup <s>: Seconds before the measurement begins (default: 2)\n"
+            " --mix <read=n,write=n,browse=n,call=n>: Relative weights of the\n"
+            "     services sent by the clients (default: read=40,write=30,browse=15,call=15)\n"
+            " --publishinterval <ms>: Publishing interval of the Subscriptions (default: 50)\n"
+            " --samplinginterval <ms>: Sampling interval, 0 samples on every write (default: 0)\n"
+            " --port <port>: TCP port of the server (default: 4842)\n"
+            " --seed <n>: Seed for the random choice of services and nodes (default: 1)\n"
+            " --output <file>: Write the JSON report to a file (default: stdout)\n"
+            " --loglevel <level>: Logging detail [1 -> TRACE, 6 -> FATAL] (default: 5)\n"
+            " --help: Print this message\n");
+    exit(EXIT_FAILURE);
+}
+
+static void
+parseMix(char *arg) {
+    memset(mix, 0, sizeof(mix));
+    char *saveptr = NULL;
+    for(char *tok = strtok_r(arg, ",", &saveptr); tok;
+        tok = strtok_r(NULL, ",", &saveptr)) {
+        char *eq = strchr(tok, '=');
+        if(!eq)
+            usage();
+        *eq = 0;
+        size_t s = 0;
+        for(; s < BENCH_MIXSERVICES; s++) {
+            if(strcmp(tok, mixNames[s]) == 0)
+                break;
+        }
+        if(s == BENCH_MIXSERVICES) {
+            fprintf(stderr, "Unknown service %s in the mix\n", tok);
+            usage();
+        }
+        mix[s] = (UA_UInt32)strtoul(eq + 1, NULL, 10);
+    }
+}
+
+static void
+parseOptions(int argc, char **argv) {
+    for(int argpos = 1; argpos < argc; argpos++) {
+        if(strcmp(argv[argpos], "--help") == 0)
+            usage();
+
+        /* All other options have an argument */
+        if(argpos + 1 == argc)
+            usage();
+        const char *opt = argv[argpos++];
+        char *val = argv[argpos];
+
+        if(strcmp(opt, "--clients") == 0)
+            clientsSize = strtoul(val, NULL, 10);
+        else if(strcmp(opt, "--items") == 0)
+            itemsSize = strtoul(val, NULL, 10);
+        else if(strcmp(opt, "--monitored") == 0)
+            monitoredSize = strtoul(val, NULL, 10);
+        else if(strcmp(opt, "--duration") == 0)
+            duration = atof(val);
+        else if(strcmp(opt, "--warmup") == 0)
+            warmup = atof(val);
+        else if(strcmp(opt, "--mix") == 0)
+            parseMix(val);
+        else if(strcmp(opt, "--publishinterval") == 0)
+            publishingInterval = atof(val);
+        else if(strcmp(opt, "--samplinginterval") == 0)
+            samplingInterval = atof(val);
+        else if(strcmp(opt, "--port") == 0)
+            port = (UA_UInt16)atoi(val);
+        else if(strcmp(opt, "--seed") == 0)
+            seed = (UA_UInt32)strtoul(val, NULL, 10);
+        else if(strcmp(opt, "--output") == 0)
+            outputFile = val;
+        else if(strcmp(opt, "--loglevel") == 0)
+            logLevel = (UA_LogLevel)(atoi(val) * 100);
+        else
+            usage();
+    }
+
+    if(clientsSize == 0 || itemsSize == 0 || duration <= 0.0 || warmup < 0.0)
+        usage();
+    if(monitoredSize > itemsSize)
+        monitoredSize = itemsSize;
+#ifndef UA_ENABLE_SUBSCRIPTIONS
+    monitoredSize = 0;
+#endif
+#ifndef UA_ENABLE_METHODCALLS
+    if(mix[BENCH_CALL] > 0) {
+        fprintf(stderr, "Method calls are not enabled. Removing Call from the mix.\n");
+        mix[BENCH_CALL] = 0;
+    }
+#endif
+    mixTotal = 0;
+    for(size_t s = 0; s < BENCH_MIXSERVICES; s++)
+        mixTotal += mix[s];
+}
+
+/********/
+/* Main */
+/********/
+
+static void
+sleepUntil(UA_DateTime monotonicDeadline) {
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    if(now >= monotonicDeadline)
+        return;
+    UA_DateTime wait = monotonicDeadline - now;
+    struct timespec ts;
+    ts.tv_sec = (time_t)(wait / UA_DATETIME_SEC);
+    ts.tv_nsec = (long)((wait % UA_DATETIME_SEC) * 100);
+    nanosleep(&ts, NULL);
+}
+
+int
+main(int argc, char **argv) {
+    parseOptions(argc, argv);
+
+    UA_Server *server = createServer();
+    if(!server)
+        return EXIT_FAILURE;
+    UA_StatusCode res = UA_Server_run_startup(server);
+    if(res != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "Could not start the server (%s)\n", UA_StatusCode_name(res));
+        UA_Server_delete(server);
+        return EXIT_FAILURE;
+    }
+    pthread_t serverThread;
+    pthread_create(&serverThread, NULL, serverLoop, server);
+
+    /* Start the clients */
+    BenchClient *clients = (BenchClient*)UA_calloc(clientsSize, sizeof(BenchClient));
+    if(!clients) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    pthread_barrier_init(&startBarrier, NULL, (unsigned)clientsSize + 1);
+    for(size_t i = 0; i < clientsSize; i++) {
+        clients[i].index = i;
+        clients[i].rng = seed + (UA_UInt32)i * 2654435761u;
+        if(clients[i].rng == 0)
+            clients[i].rng = 1;
+        pthread_create(&clients[i].thread, NULL, clientLoop, &clients[i]);
+    }
+
+    /* Wait for the client setup and release the clients */
+    pthread_barrier_wait(&startBarrier);
+    int ret = EXIT_SUCCESS;
+    for(size_t i = 0; i < clientsSize; i++) {
+        if(clients[i].setupResult != UA_STATUSCODE_GOOD) {
+            fprintf(stderr, "Client %lu could not be set up (%s)\n", (unsigned long)i,
+                    UA_StatusCode_name(clients[i].setupResult));
+            ret = EXIT_FAILURE;
+        }
+    }
+    measureStart = UA_DateTime_nowMonotonic() + (UA_DateTime)(warmup * UA_DATETIME_SEC);
+    measureEnd = measureStart + (UA_DateTime)(duration * UA_DATETIME_SEC);
+    pthread_barrier_wait(&startBarrier);
+
+    /* CPU time during the measurement window */
+    clockid_t serverClock;
+    pthread_getcpuclockid(serverThread, &serverClock);
+    struct rusage usageStart, usageEnd;
+    sleepUntil(measureStart);
+    getrusage(RUSAGE_SELF, &usageStart);
+    UA_Double serverCpuStart = clockSeconds(serverClock);
+    sleepUntil(measureEnd);
+    getrusage(RUSAGE_SELF, &usageEnd);
+    UA_Double serverCpuEnd = clockSeconds(serverClock);
+
+    for(size_t i = 0; i < clientsSize; i++)
+        pthread_join(clients[i].thread, NULL);
+    serverRunning = false;
+    pthread_join(serverThread, NULL);
+    pthread_barrier_destroy(&startBarrier);
+
+    /* Merge and sort the samples of all clients */
+    CpuTimes cpu;
+    cpu.processUser = timevalSeconds(usageEnd.ru_utime) - timevalSeconds(usageStart.ru_utime);
+    cpu.processSystem = timevalSeconds(usageEnd.ru_stime) - timevalSeconds(usageStart.ru_stime);
+    cpu.serverThread = serverCpuEnd - serverCpuStart;
+    cpu.clientThreads = 0.0;
+    Samples results[BENCH_SERVICES];
+    memset(results, 0, sizeof(results));
+    for(size_t i = 0; i < clientsSize; i++) {
+        cpu.clientThreads += clients[i].cpuTime;
+        for(size_t s = 0; s < BENCH_SERVICES; s++)
+            Samples_merge(&results[s], &clients[i].samples[s]);
+        if(clients[i].client)
+            UA_Client_delete(clients[i].client);
+    }
+    UA_free(clients);
+    for(size_t s = 0; s < BENCH_SERVICES; s++)
+        qsort(results[s].latencies, results[s].size, sizeof(UA_DateTime), compareLatency);
+
+    printTable(results);
+    FILE *out = stdout;
+    if(outputFile) {
+        out = fopen(outputFile, "w");
+        if(!out) {
+            fprintf(stderr, "Cannot open the output file %s\n", outputFile);
+            out = stdout;
+            ret = EXIT_FAILURE;
+        }
+    }
+    printJson(out, results, &cpu);
+    if(out != stdout)
+        fclose(out);
+
+    for(size_t s = 0; s < BENCH_SERVICES; s++)
+        UA_free(results[s].latencies);
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+    return ret;
+}